@@ -0,0 +1,114 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// Netlist construction benchmark: per-object heap allocation vs. Arena.
+// usage: b_arena [heap|arena] [gates]
+// Each mode should run in its own process so that the RSS figures are clean.
+
+#include "c_gate.h"
+#include "c_arena.h"
+#include <chrono>     // std::chrono
+#include <cstdio>     // std::printf, std::fopen
+#include <cstdlib>    // std::strtoul
+#include <cstring>    // std::strcmp
+#include <memory>     // std::unique_ptr
+#include <string>     // std::string
+#include <vector>     // std::vector
+
+#if defined(__unix__)
+#include <unistd.h>   // sysconf
+#endif
+
+// return the resident set size of this process in bytes (0 if unknown)
+static size_t ResidentBytes() {
+#if defined(__unix__)
+  unsigned long pages = 0, resident = 0;
+  FILE* const statm = std::fopen("/proc/self/statm", "r");
+  if (statm == nullptr) {
+    return 0;
+  }
+  if (std::fscanf(statm, "%lu %lu", &pages, &resident) != 2) {
+    resident = 0;
+  }
+  std::fclose(statm);
+  return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#else
+  return 0;
+#endif
+}
+
+// build a chain of 2-input gates, each fed by the previous one
+template <typename MakeGate>
+static std::vector<Cim::Gate*> BuildChain(const uint32_t gate_num, MakeGate make_gate) {
+  static const char* const types[] = {"AND", "OR", "XOR", "NAND", "NOR", "XNOR"};
+  std::vector<Cim::Gate*> gates;
+  gates.reserve(gate_num);
+  for (uint32_t i = 0; i < gate_num; i++) {
+    Cim::Gate* const gate = make_gate("gate_" + std::to_string(i), types[i % 6]);
+    if (i != 0) {
+      gates.back()->GetPinConnection(2).push_back(Cim::Pin::Link{gate, 0});
+      gate->GetPinConnection(0).at(0) = Cim::Pin::Link{gates.back(), 2};
+    }
+    gates.push_back(gate);
+  }
+  return gates;
+}
+
+int main(int argc, char** argv) {
+  const bool use_arena = (argc > 1 && std::strcmp(argv[1], "arena") == 0);
+  const uint32_t gate_num = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 1000000;
+  const std::vector<std::string> pins{"IN1", "IN2"};
+  const size_t rss_before = ResidentBytes();
+
+  const auto start = std::chrono::steady_clock::now();
+  std::vector<std::unique_ptr<Cim::Gate>> owned;
+  Cim::Arena arena;
+  std::vector<Cim::Gate*> gates;
+  if (use_arena) {
+    gates = BuildChain(gate_num, [&](const std::string& name, const char* type) {
+      return arena.Create<Cim::Gate>(nullptr, name, type, pins, false, &arena);
+    });
+  } else {
+    owned.reserve(gate_num);
+    gates = BuildChain(gate_num, [&](const std::string& name, const char* type) {
+      owned.emplace_back(new Cim::Gate(nullptr, name, type, pins));
+      return owned.back().get();
+    });
+  }
+  const auto built = std::chrono::steady_clock::now();
+  const size_t rss_after = ResidentBytes();
+
+  // teardown
+  if (use_arena) {
+    arena.Release();
+  } else {
+    owned.clear();
+  }
+  const auto freed = std::chrono::steady_clock::now();
+
+  const double build_s = std::chrono::duration<double>(built - start).count();
+  const double free_s = std::chrono::duration<double>(freed - built).count();
+  std::printf("mode=%s gates=%u build_s=%.4f teardown_s=%.4f gates_per_s=%.0f rss_delta_bytes=%zu bytes_per_gate=%.1f\n",
+      use_arena ? "arena" : "heap", gate_num, build_s, free_s, gate_num / build_s,
+      rss_after - rss_before, static_cast<double>(rss_after - rss_before) / gate_num);
+  return 0;
+}
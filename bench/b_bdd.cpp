@@ -0,0 +1,137 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// Symbolic evaluation benchmark: BDDs of wide adders and of a multiplier.
+// usage: b_bdd [adder bits] [multiplier bits]
+// A chain of 4 ripple-carry adders of the given width (64 -> 324 inputs, far
+// beyond enumeration) is built symbolically with the depth-first variable
+// order, proven equivalent to its optimized copy and its output probabilities
+// computed; a single adder is also tried with the plain input order, which
+// puts every bit of one operand before the other and blows up against a node
+// limit. The multiplier (exponential in any order) is built twice, keeping
+// every net and releasing internal nets after their last reader (so garbage
+// collection reclaims them); it stresses the unique and computed tables, and
+// its output probabilities must match the ones counts of exhaustive
+// enumeration (exit code 1 otherwise).
+
+#include "b_circuits.h"
+#include "c_bdd.h"
+#include "c_exhaustive.h"
+#include "c_optimize.h"
+#include <chrono>     // std::chrono
+#include <cmath>      // std::ldexp
+#include <cstdio>     // std::printf
+#include <cstdlib>    // std::strtoul
+#include <stdexcept>  // std::runtime_error
+#include <vector>     // std::vector
+
+// seconds since start
+static double SecondsSince(const std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+  const uint32_t adder_bits = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 64;
+  const uint32_t mult_bits = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 11;
+  bool same = true;
+
+  // 1. adder chain, depth-first order, equivalence with the optimized copy
+  Cim::Netlist chain, optimized;
+  Bench::BuildAdderChain(chain, adder_bits, 4);
+  Cim::NetlistOptimizer(chain).Optimize(optimized);
+  Cim::BddManager manager;
+  const std::vector<uint32_t> order = Cim::ComputeBddOrder(chain, Cim::BddOrder::DepthFirst);
+  auto start = std::chrono::steady_clock::now();
+  Cim::BddSim chain_sim(chain, manager, order);
+  const double chain_s = SecondsSince(start);
+  const Cim::BddStats chain_stats = manager.GetStats();
+  start = std::chrono::steady_clock::now();
+  {
+    Cim::BddSim optimized_sim(optimized, manager, order);
+    same &= chain_sim.CheckEquivalence(optimized_sim).equivalent;
+  }
+  const double equivalence_s = SecondsSince(start);
+  start = std::chrono::steady_clock::now();
+  double probability_sum = 0;
+  for (const uint32_t each_net : chain.GetOutputs()) probability_sum += chain_sim.GetProbability(each_net);
+  const double probability_s = SecondsSince(start);
+
+  // 2. one adder in input order against a node limit
+  Cim::Netlist adder;
+  Bench::BuildAdderChain(adder, adder_bits, 1);
+  Cim::BddManager limited(18, 1u << 20);
+  start = std::chrono::steady_clock::now();
+  uint64_t input_order_nodes = 0;
+  try {
+    Cim::BddSim input_sim(adder, limited, Cim::ComputeBddOrder(adder, Cim::BddOrder::Input));
+    input_order_nodes = input_sim.GetOutputNodeNum();
+  } catch (const std::runtime_error&) {
+    input_order_nodes = UINT64_MAX;
+  }
+  const double input_order_s = SecondsSince(start);
+  Cim::BddManager adder_manager;
+  Cim::BddSim adder_sim(adder, adder_manager, Cim::ComputeBddOrder(adder, Cim::BddOrder::DepthFirst));
+  const uint64_t depth_first_nodes = adder_sim.GetOutputNodeNum();
+
+  // 3. multiplier: node throughput & collection, probabilities vs. enumeration
+  Cim::Netlist mult;
+  Bench::BuildMultiplier(mult, mult_bits);
+  uint64_t kept_peak = 0;
+  {
+    Cim::BddManager kept_manager(20);
+    Cim::BddSim kept_sim(mult, kept_manager);
+    kept_peak = kept_manager.GetStats().peak_nodes;
+  }
+  Cim::BddManager mult_manager(20);
+  start = std::chrono::steady_clock::now();
+  Cim::BddSim mult_sim(mult, mult_manager, {}, false);
+  const double mult_s = SecondsSince(start);
+  const Cim::BddStats stats = mult_manager.GetStats();
+  const std::vector<Cim::OutputSignature> signatures = Cim::ExhaustiveSim(mult).ComputeSignatures();
+  const uint32_t mult_inputs = mult.GetInputs().size();
+  for (uint32_t o = 0; o < signatures.size(); o++) {
+    const double ones = mult_sim.GetProbability(mult.GetOutputs()[o]) * std::ldexp(1.0, mult_inputs);
+    same &= ones == static_cast<double>(signatures[o].ones);
+  }
+
+  std::printf("chain_inputs=%u chain_gates=%u chain_s=%.3f chain_nodes=%llu chain_output_nodes=%llu "
+      "equivalence_s=%.3f probability_s=%.3f mean_probability=%.4f input_order_nodes=%s%llu input_order_s=%.3f "
+      "depth_first_nodes=%llu mult_inputs=%u mult_gates=%u mult_s=%.3f created_nodes=%llu mnodes_per_s=%.2f "
+      "kept_peak_nodes=%llu peak_nodes=%llu live_nodes=%llu output_nodes=%llu bytes=%llu cache_hit=%.3f unique_hit=%.3f gc_runs=%llu "
+      "gc_freed=%llu equivalent=%s\n",
+      static_cast<uint32_t>(chain.GetInputs().size()), chain.GetGateNum(), chain_s,
+      static_cast<unsigned long long>(chain_stats.live_nodes),
+      static_cast<unsigned long long>(chain_sim.GetOutputNodeNum()), equivalence_s, probability_s,
+      probability_sum / chain.GetOutputs().size(), (input_order_nodes == UINT64_MAX) ? ">" : "",
+      static_cast<unsigned long long>((input_order_nodes == UINT64_MAX) ? (1u << 20) : input_order_nodes),
+      input_order_s, static_cast<unsigned long long>(depth_first_nodes), mult_inputs, mult.GetGateNum(), mult_s,
+      static_cast<unsigned long long>(stats.created_nodes), stats.created_nodes / mult_s / 1e6,
+      static_cast<unsigned long long>(kept_peak), static_cast<unsigned long long>(stats.peak_nodes),
+      static_cast<unsigned long long>(stats.live_nodes),
+      static_cast<unsigned long long>(mult_sim.GetOutputNodeNum()),
+      static_cast<unsigned long long>(mult_manager.GetByteNum()),
+      static_cast<double>(stats.cache_hits) / stats.cache_lookups,
+      static_cast<double>(stats.unique_hits) / stats.unique_lookups,
+      static_cast<unsigned long long>(stats.gc_runs), static_cast<unsigned long long>(stats.gc_freed),
+      same ? "yes" : "NO");
+  return same ? 0 : 1;
+}
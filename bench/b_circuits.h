@@ -0,0 +1,241 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// Parameterized circuit generators shared by the benchmarks. Every generator
+// fills an empty Netlist through its builder interface and levelizes it; nets
+// nobody reads become primary outputs.
+
+// include guard for this header
+#ifndef B_CIRCUITS_H
+#define B_CIRCUITS_H
+
+// includes for this header
+#include <string>         // std::string
+#include <vector>         // std::vector
+#include <cstdint>        // standard int types
+#include <random>         // std::mt19937_64
+#include <algorithm>      // std::min, std::max
+#include <stdexcept>      // std::invalid_argument
+#include "c_netlist.h"    // class Netlist
+
+// namespace for the benchmarks
+namespace Bench {
+
+// gate statistics of one ISCAS-85 circuit
+struct IscasProfile {
+  const char* name;
+  uint32_t inputs;
+  uint32_t outputs;
+  uint32_t gates;
+  uint32_t levels;
+};
+
+// published sizes of the ISCAS-85 suite
+inline const std::vector<IscasProfile>& GetIscasProfiles() {
+  static const std::vector<IscasProfile> profiles = {
+    {"c432", 36, 7, 160, 17},     {"c499", 41, 32, 202, 11},    {"c880", 60, 26, 383, 24},
+    {"c1355", 41, 32, 546, 24},   {"c1908", 33, 25, 880, 40},   {"c2670", 233, 140, 1193, 32},
+    {"c3540", 50, 22, 1669, 47},  {"c5315", 178, 123, 2307, 49}, {"c6288", 32, 32, 2406, 124},
+    {"c7552", 207, 108, 3512, 43}
+  };
+  return profiles;
+}
+
+// mark every net without a reader as primary output, then levelize
+inline void Finish(Cim::Netlist& netlist, const std::vector<uint32_t>& read_count) {
+  for (uint32_t n = 0; n < netlist.GetNetNum(); n++) {
+    if (read_count[n] == 0) {
+      netlist.AddOutput(n);
+    }
+  }
+  netlist.Levelize();
+}
+
+// full adder on nets a, b, cin: returns {sum, cout}
+inline std::pair<uint32_t, uint32_t> AddFullAdder(Cim::Netlist& netlist, std::vector<uint32_t>& read_count,
+    const uint32_t a, const uint32_t b, const uint32_t cin) {
+  auto gate = [&](const Cim::GateKind kind, const uint32_t x, const uint32_t y) {
+    const uint32_t out = netlist.AddNet();
+    read_count.push_back(0);
+    netlist.AddGate(kind, {x, y}, out);
+    read_count[x]++;
+    read_count[y]++;
+    return out;
+  };
+  const uint32_t p = gate(Cim::GateKind::XOR, a, b);
+  const uint32_t sum = gate(Cim::GateKind::XOR, p, cin);
+  const uint32_t g = gate(Cim::GateKind::AND, a, b);
+  const uint32_t t = gate(Cim::GateKind::AND, p, cin);
+  return {sum, gate(Cim::GateKind::OR, g, t)};
+}
+
+// chain of ripple-carry adders: each adder adds a fresh operand to the previous sum
+inline void BuildAdderChain(Cim::Netlist& netlist, const uint32_t bits, const uint32_t adders) {
+  std::vector<uint32_t> read_count;
+  auto input = [&]() {
+    read_count.push_back(0);
+    return netlist.AddNet();
+  };
+  std::vector<uint32_t> acc(bits);
+  for (uint32_t& each_bit : acc) each_bit = input();
+  for (uint32_t a = 0; a < adders; a++) {
+    uint32_t carry = input();
+    for (uint32_t i = 0; i < bits; i++) {
+      const auto result = AddFullAdder(netlist, read_count, acc[i], input(), carry);
+      acc[i] = result.first;
+      carry = result.second;
+    }
+  }
+  Finish(netlist, read_count);
+}
+
+// n x n unsigned array multiplier (AND partial products, carry-save rows, ripple final row)
+inline void BuildMultiplier(Cim::Netlist& netlist, const uint32_t n) {
+  if (n < 2) {
+    throw std::invalid_argument("ERR: MULTIPLIER NEEDS AT LEAST 2 BITS! \n");
+  }
+  std::vector<uint32_t> read_count;
+  auto input = [&]() {
+    read_count.push_back(0);
+    return netlist.AddNet();
+  };
+  auto and_gate = [&](const uint32_t x, const uint32_t y) {
+    const uint32_t out = netlist.AddNet();
+    read_count.push_back(0);
+    netlist.AddGate(Cim::GateKind::AND, {x, y}, out);
+    read_count[x]++;
+    read_count[y]++;
+    return out;
+  };
+  std::vector<uint32_t> a(n), b(n);
+  for (uint32_t i = 0; i < n; i++) a[i] = input();
+  for (uint32_t i = 0; i < n; i++) b[i] = input();
+
+  // row 0: partial products of b[0]; column weights i .. i + n - 1
+  std::vector<uint32_t> sum(n), carry(n, UINT32_MAX);
+  for (uint32_t i = 0; i < n; i++) sum[i] = and_gate(a[i], b[0]);
+  // rows 1 .. n - 1: add a * b[j], shifted by j
+  for (uint32_t j = 1; j < n; j++) {
+    std::vector<uint32_t> next_sum(n), next_carry(n);
+    for (uint32_t i = 0; i < n; i++) {
+      const uint32_t pp = and_gate(a[i], b[j]);
+      // bit of weight i + j from the previous row
+      const uint32_t upper = (i + 1 < n) ? sum[i + 1] : UINT32_MAX;
+      const uint32_t cin = carry[i];
+      if (upper == UINT32_MAX && cin == UINT32_MAX) {
+        next_sum[i] = pp;
+        next_carry[i] = UINT32_MAX;
+      } else if (upper == UINT32_MAX || cin == UINT32_MAX) {
+        // half adder
+        const uint32_t other = (upper == UINT32_MAX) ? cin : upper;
+        const uint32_t s = netlist.AddNet();
+        read_count.push_back(0);
+        netlist.AddGate(Cim::GateKind::XOR, {pp, other}, s);
+        read_count[pp]++;
+        read_count[other]++;
+        next_sum[i] = s;
+        next_carry[i] = and_gate(pp, other);
+      } else {
+        const auto result = AddFullAdder(netlist, read_count, pp, upper, cin);
+        next_sum[i] = result.first;
+        next_carry[i] = result.second;
+      }
+    }
+    sum.swap(next_sum);
+    carry.swap(next_carry);
+  }
+  // final ripple row merges the remaining sums and carries
+  uint32_t ripple = UINT32_MAX;
+  for (uint32_t i = 0; i + 1 < n; i++) {
+    const uint32_t x = sum[i + 1], y = carry[i];
+    if (ripple == UINT32_MAX) {
+      const uint32_t s = netlist.AddNet();
+      read_count.push_back(0);
+      netlist.AddGate(Cim::GateKind::XOR, {x, y}, s);
+      read_count[x]++;
+      read_count[y]++;
+      ripple = and_gate(x, y);
+    } else {
+      ripple = AddFullAdder(netlist, read_count, x, y, ripple).second;
+    }
+  }
+  Finish(netlist, read_count);
+}
+
+// random DAG of layered gates: every gate reads one net of the level below and
+// up to three more nets of any lower level, biased towards recent levels
+inline void BuildLayeredDag(Cim::Netlist& netlist, const uint32_t inputs, const uint32_t gates,
+    const uint32_t levels, const uint64_t seed) {
+  static const Cim::GateKind kinds[] = {
+    Cim::GateKind::NAND, Cim::GateKind::NAND, Cim::GateKind::AND, Cim::GateKind::NOR,
+    Cim::GateKind::OR, Cim::GateKind::NOT, Cim::GateKind::NOT, Cim::GateKind::XOR
+  };
+  if (inputs == 0 || levels == 0 || gates < levels) {
+    throw std::invalid_argument("ERR: BAD RANDOM DAG SHAPE! \n");
+  }
+  std::mt19937_64 rng(seed);
+  std::vector<uint32_t> read_count;
+  std::vector<uint32_t> level_begin{0};   // nets of level l are [level_begin[l], level_begin[l + 1])
+  for (uint32_t i = 0; i < inputs; i++) {
+    netlist.AddNet();
+    read_count.push_back(0);
+  }
+  level_begin.push_back(inputs);
+  std::vector<uint32_t> fanin;
+  for (uint32_t l = 1; l <= levels; l++) {
+    const uint32_t count = gates / levels + (l <= gates % levels ? 1 : 0);
+    const uint32_t below_begin = level_begin[l - 1], below_end = level_begin[l];
+    for (uint32_t g = 0; g < count; g++) {
+      const Cim::GateKind kind = kinds[rng() % 8];
+      const uint32_t fanin_num = (kind == Cim::GateKind::NOT) ? 1 : 2 + (rng() % 8 == 0 ? rng() % 3 : 0);
+      fanin.assign(1, below_begin + rng() % (below_end - below_begin));
+      while (fanin.size() < fanin_num) {
+        // pick a level: half of the picks come from the last four levels
+        const uint32_t back = (rng() % 2 == 0) ? rng() % std::min<uint32_t>(l, 4) : rng() % l;
+        const uint32_t from = level_begin[l - 1 - back], to = level_begin[l - back];
+        fanin.push_back(from + rng() % (to - from));
+      }
+      const uint32_t out = netlist.AddNet();
+      read_count.push_back(0);
+      netlist.AddGate(kind, fanin, out);
+      for (const uint32_t each_net : fanin) read_count[each_net]++;
+    }
+    level_begin.push_back(netlist.GetNetNum());
+  }
+  Finish(netlist, read_count);
+}
+
+// random DAG of N gates with the depth of a typical synthesized block
+inline void BuildRandomDag(Cim::Netlist& netlist, const uint32_t gates, const uint64_t seed) {
+  const uint32_t levels = std::max<uint32_t>(8, std::min<uint32_t>(gates / 64 + 1, 64));
+  BuildLayeredDag(netlist, std::max<uint32_t>(32, gates / 100), std::max(gates, levels), levels, seed);
+}
+
+// random DAG with the inputs, gates and depth of an ISCAS-85 circuit, scaled in width
+inline void BuildIscasLike(Cim::Netlist& netlist, const IscasProfile& profile, const uint32_t scale,
+    const uint64_t seed) {
+  BuildLayeredDag(netlist, profile.inputs * scale, profile.gates * scale, profile.levels, seed);
+}
+
+}
+
+#endif  // B_CIRCUITS_H
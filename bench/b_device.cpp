@@ -0,0 +1,129 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// Device benchmark: one block definition instantiated many times.
+// usage: b_device [gates per block] [instances] [vectors]
+// The block is a random DAG of 2-input gates with 32 inputs and outputs, the
+// instances form a chain. The hierarchy (definitions + one state byte per net)
+// is compared with the flat netlist carrying a full name per net, as a tree of
+// Gate components with stored full names would. Evaluation of the interpreted
+// device and of the flattened netlist must agree (exit code 1 on a mismatch).
+
+#include "c_device.h"
+#include "c_levelized.h"
+#include <algorithm>  // std::min
+#include <chrono>     // std::chrono
+#include <cstdio>     // std::printf
+#include <cstdlib>    // std::strtoul
+#include <random>     // std::mt19937_64
+#include <string>     // std::string
+#include <vector>     // std::vector
+
+// seconds since start
+static double SecondsSince(const std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// random block: every gate reads two earlier nets, the last 32 nets are the outputs
+static void BuildBlock(Cim::DeviceDef& block, const uint32_t gate_num) {
+  const Cim::GateKind kinds[] = {Cim::GateKind::AND, Cim::GateKind::OR, Cim::GateKind::XOR, Cim::GateKind::NAND};
+  std::mt19937_64 rng(11);
+  for (uint32_t g = 0; g < gate_num; g++) {
+    const uint32_t net_num = block.GetLocalNetNum();
+    // mostly recent nets, so the block is deep rather than wide
+    const uint32_t a = net_num - 1 - rng() % std::min<uint32_t>(net_num, 64);
+    const uint32_t b = rng() % net_num;
+    block.AddGate("g" + std::to_string(g), kinds[rng() % 4], {a, b});
+  }
+  for (uint32_t k = 0; k < 32; k++) {
+    block.SetOutput(k, block.GetLocalNetNum() - 32 + k);
+  }
+}
+
+int main(int argc, char** argv) {
+  const uint32_t gate_num = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 10000;
+  const uint32_t inst_num = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 200;
+  const uint32_t vectors = (argc > 3) ? std::strtoul(argv[3], nullptr, 10) : 20;
+  std::vector<std::string> in_names, out_names;
+  for (uint32_t k = 0; k < 32; k++) {
+    in_names.push_back("in" + std::to_string(k));
+    out_names.push_back("out" + std::to_string(k));
+  }
+  Cim::DeviceDef block("block", in_names, out_names);
+  BuildBlock(block, (gate_num < 32) ? 32 : gate_num);
+  Cim::DeviceDef top("top", in_names, out_names);
+  std::vector<uint32_t> chain(32);
+  for (uint32_t k = 0; k < 32; k++) {
+    chain[k] = k;
+  }
+  for (uint32_t i = 0; i < inst_num; i++) {
+    chain = top.AddInstance("u" + std::to_string(i), block, chain);
+  }
+  for (uint32_t k = 0; k < 32; k++) {
+    top.SetOutput(k, chain[k]);
+  }
+  Cim::Device chip(nullptr, "chip", top);
+
+  // 1. flatten, then name every net the way stored full names would
+  auto start = std::chrono::steady_clock::now();
+  std::vector<uint64_t> state_of_net;
+  Cim::Netlist flat = chip.Flatten(&state_of_net);
+  const double flatten_s = SecondsSince(start);
+  const size_t flat_bytes = flat.GetByteNum();
+  start = std::chrono::steady_clock::now();
+  for (uint32_t n = 32; n < flat.GetNetNum(); n++) {
+    flat.SetNetName(n, chip.GetStateName(state_of_net[n]));
+  }
+  const double naming_s = SecondsSince(start);
+  const size_t name_bytes = flat.GetNameByteNum();
+  const size_t device_bytes = block.GetByteNum() + top.GetByteNum() + chip.GetByteNum();
+
+  // 2. interpreted hierarchy vs. flattened netlist on the same vectors
+  Cim::LevelizedSim sim(flat);
+  std::mt19937_64 rng(5);
+  double device_s = 0, flat_s = 0;
+  bool same = true;
+  for (uint32_t v = 0; v < vectors; v++) {
+    const uint64_t bits = rng();
+    for (uint32_t k = 0; k < 32; k++) {
+      chip.Set(k, (bits >> k) & 1);
+      sim.SetInput(k, (bits >> k) & 1);
+    }
+    start = std::chrono::steady_clock::now();
+    chip.Evaluate();
+    device_s += SecondsSince(start);
+    start = std::chrono::steady_clock::now();
+    sim.Evaluate();
+    flat_s += SecondsSince(start);
+    for (uint32_t k = 0; k < 32; k++) {
+      same &= (chip.GetPinState(32 + k) == sim.GetState(flat.GetOutputs()[k]));
+    }
+  }
+
+  std::printf("gates=%llu instances=%u nets=%llu device_bytes=%zu flat_bytes=%zu name_bytes=%zu "
+      "memory_ratio=%.1f flatten_ms=%.1f naming_ms=%.1f device_eval_ms=%.3f flat_eval_ms=%.3f equivalent=%s\n",
+      static_cast<unsigned long long>(top.GetFlatGateNum()), inst_num,
+      static_cast<unsigned long long>(top.GetStateSize()), device_bytes, flat_bytes, name_bytes,
+      static_cast<double>(flat_bytes + name_bytes) / device_bytes, flatten_s * 1e3, naming_s * 1e3,
+      device_s / vectors * 1e3, flat_s / vectors * 1e3, same ? "yes" : "NO");
+  return same ? 0 : 1;
+}
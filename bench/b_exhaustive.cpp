@@ -0,0 +1,131 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// Exhaustive enumeration benchmark: every input combination of a multiplier.
+// usage: b_exhaustive [multiplier bits] [threads]
+// An n x n multiplier has 2n inputs (n = 12 -> 16.8M combinations). Truth
+// tables and signatures are computed on the given threads (0 -> all) and on
+// one, then the multiplier is checked against its optimized copy and against
+// a copy with one output inverted. A scalar loop over the first 2^16
+// combinations gives the per-vector baseline and must agree with the tables
+// (exit code 1 otherwise).
+
+#include "b_circuits.h"
+#include "c_exhaustive.h"
+#include "c_levelized.h"
+#include "c_optimize.h"
+#include <chrono>     // std::chrono
+#include <cstdio>     // std::printf
+#include <cstdlib>    // std::strtoul
+#include <vector>     // std::vector
+
+// seconds since start
+static double SecondsSince(const std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+  const uint32_t bits = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 12;
+  const uint32_t threads = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 0;
+  Cim::Netlist netlist;
+  Bench::BuildMultiplier(netlist, bits);
+  Cim::ExhaustiveSim sim(netlist, threads);
+  Cim::ExhaustiveSim serial(netlist, 1);
+  const uint64_t combinations = sim.GetCombinationNum();
+
+  // 1. truth tables & signatures
+  auto start = std::chrono::steady_clock::now();
+  const std::vector<uint64_t> tables = sim.ComputeTruthTables();
+  const double table_s = SecondsSince(start);
+  start = std::chrono::steady_clock::now();
+  const std::vector<Cim::OutputSignature> signatures = sim.ComputeSignatures();
+  const double signature_s = SecondsSince(start);
+  start = std::chrono::steady_clock::now();
+  const std::vector<Cim::OutputSignature> serial_signatures = serial.ComputeSignatures();
+  const double serial_s = SecondsSince(start);
+  bool same = true;
+  for (uint32_t o = 0; o < signatures.size(); o++) {
+    same &= (signatures[o].hash == serial_signatures[o].hash && signatures[o].ones == serial_signatures[o].ones);
+  }
+
+  // 2. equivalence with the optimized copy, mismatch with an inverted output
+  Cim::Netlist optimized;
+  Cim::NetlistOptimizer(netlist).Optimize(optimized);
+  start = std::chrono::steady_clock::now();
+  const Cim::EquivalenceResult equal = sim.CheckEquivalence(optimized);
+  const double equal_s = SecondsSince(start);
+  Cim::Netlist broken;
+  Bench::BuildMultiplier(broken, bits);
+  Cim::Netlist inverted;
+  for (uint32_t n = 0; n < broken.GetNetNum(); n++) {
+    inverted.AddNet();
+  }
+  for (const Cim::Instruction& each_gate : broken.GetProgram()) {
+    const Cim::ArrayView<uint32_t> fanin = broken.GetFanin();
+    const std::vector<uint32_t> ins(fanin.begin() + each_gate.fanin_begin,
+        fanin.begin() + each_gate.fanin_begin + each_gate.fanin_count);
+    if (each_gate.op == Cim::GateKind::LUT) {
+      inverted.AddLut(broken.GetLuts()[each_gate.lut], ins, each_gate.out_net);
+    } else {
+      inverted.AddGate(each_gate.op, ins, each_gate.out_net);
+    }
+  }
+  const Cim::ArrayView<uint32_t> outputs = broken.GetOutputs();
+  const uint32_t flipped = inverted.AddNet();
+  inverted.AddGate(Cim::GateKind::NOT, {outputs[outputs.size() - 1]}, flipped);
+  for (uint32_t o = 0; o + 1 < outputs.size(); o++) {
+    inverted.AddOutput(outputs[o]);
+  }
+  inverted.AddOutput(flipped);
+  inverted.Levelize();
+  start = std::chrono::steady_clock::now();
+  const Cim::EquivalenceResult differ = sim.CheckEquivalence(inverted);
+  const double differ_s = SecondsSince(start);
+  same &= equal.equivalent && !differ.equivalent && differ.input == 0 && differ.output == outputs.size() - 1;
+
+  // 3. scalar baseline over the first 2^16 combinations
+  const uint64_t scalar_num = (combinations < 65536) ? combinations : 65536;
+  const uint64_t table_words = sim.GetTableWordNum();
+  Cim::LevelizedSim ref(netlist);
+  const Cim::ArrayView<uint32_t> inputs = netlist.GetInputs();
+  start = std::chrono::steady_clock::now();
+  for (uint64_t m = 0; m < scalar_num; m++) {
+    for (uint32_t k = 0; k < inputs.size(); k++) {
+      ref.SetInput(inputs[k], (m >> k) & 1);
+    }
+    ref.Evaluate();
+    for (uint32_t o = 0; o < netlist.GetOutputs().size(); o++) {
+      same &= ((tables[o * table_words + m / 64] >> (m % 64)) & 1) == ref.GetState(netlist.GetOutputs()[o]);
+    }
+  }
+  const double scalar_s = SecondsSince(start);
+
+  const double rate = combinations / signature_s;
+  std::printf("inputs=%u outputs=%u gates=%u combinations=%llu threads=%u table_s=%.3f signature_s=%.3f "
+      "serial_signature_s=%.3f equivalence_s=%.3f mismatch_s=%.5f mismatch_checked=%llu mcombinations_per_s=%.1f "
+      "scalar_mcombinations_per_s=%.3f speedup=%.0f equivalent=%s\n",
+      sim.GetInputNum(), sim.GetOutputNum(), netlist.GetGateNum(), static_cast<unsigned long long>(combinations),
+      sim.GetThreadNum(), table_s, signature_s, serial_s, equal_s, differ_s,
+      static_cast<unsigned long long>(differ.checked), rate / 1e6, scalar_num / scalar_s / 1e6,
+      rate / (scalar_num / scalar_s), same ? "yes" : "NO");
+  return same ? 0 : 1;
+}
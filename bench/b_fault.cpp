@@ -0,0 +1,73 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// Stuck-at fault simulation benchmark: random pattern fault grading.
+// usage: b_fault [multiplier|iscas|all] [size] [patterns]
+//   size: multiplier bits / ISCAS width scale
+// Reports coverage, patterns/s and the faulty-machine gate evaluations spent,
+// next to the faults x gates x patterns a serial fault simulator would need.
+
+#include "b_circuits.h"
+#include "c_fault.h"
+#include <chrono>     // std::chrono
+#include <cstdio>     // std::printf
+#include <cstdlib>    // std::strtoul
+#include <functional> // std::function
+#include <string>     // std::string
+
+// grade one circuit
+static void RunCircuit(const std::string& name, const std::function<void(Cim::Netlist&)>& build,
+    const uint64_t patterns) {
+  Cim::Netlist netlist;
+  build(netlist);
+  Cim::FaultSim sim(netlist);
+  const auto start = std::chrono::steady_clock::now();
+  sim.SimulateRandom(patterns, 1);
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  const double serial = static_cast<double>(sim.GetFaultNum()) * netlist.GetGateNum() * sim.GetPatternNum();
+  std::printf("%-16s gates=%u faults=%u detected=%u coverage=%.4f patterns=%llu seconds=%.4f "
+      "patterns_per_s=%.0f events=%llu serial_evals=%.3g work_ratio=%.3g\n",
+      name.c_str(), netlist.GetGateNum(), sim.GetFaultNum(), sim.GetDetectedNum(), sim.GetCoverage(),
+      static_cast<unsigned long long>(sim.GetPatternNum()), seconds, sim.GetPatternNum() / seconds,
+      static_cast<unsigned long long>(sim.GetEventNum()), serial, serial / sim.GetEventNum());
+}
+
+int main(int argc, char** argv) {
+  const std::string circuit = (argc > 1) ? argv[1] : "all";
+  const uint32_t size = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 0;
+  const uint64_t patterns = (argc > 3) ? std::strtoull(argv[3], nullptr, 10) : 4096;
+  const bool all = (circuit == "all");
+
+  if (all || circuit == "multiplier") {
+    const uint32_t bits = size ? size : 16;
+    RunCircuit("multiplier" + std::to_string(bits),
+        [bits](Cim::Netlist& netlist) { Bench::BuildMultiplier(netlist, bits); }, patterns);
+  }
+  if (all || circuit == "iscas") {
+    const uint32_t scale = size ? size : 1;
+    for (const Bench::IscasProfile& each_profile : Bench::GetIscasProfiles()) {
+      RunCircuit(std::string(each_profile.name) + "x" + std::to_string(scale),
+          [&](Cim::Netlist& netlist) { Bench::BuildIscasLike(netlist, each_profile, scale, 1); }, patterns);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,117 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// Netlist import benchmark: parse throughput and peak memory of the importer,
+// and start-up time when the compiled netlist is mapped from a cache file.
+// usage: b_import <file.bench|file.blif|file.v>
+//        b_import gen [gates]   (writes & imports a random .bench file)
+
+#include "c_import.h"
+#include "c_cache.h"
+#include <chrono>     // std::chrono
+#include <cstdio>     // std::printf, std::fopen
+#include <cstdlib>    // std::strtoul
+#include <cstring>    // std::strcmp
+#include <fstream>    // std::ofstream
+#include <random>     // std::mt19937
+#include <string>     // std::string
+
+// return the peak resident set size of this process in bytes (0 if unknown)
+static size_t PeakResidentBytes() {
+#if defined(__unix__)
+  FILE* const status = std::fopen("/proc/self/status", "r");
+  if (status == nullptr) {
+    return 0;
+  }
+  char line[256];
+  size_t peak_kb = 0;
+  while (std::fgets(line, sizeof(line), status) != nullptr) {
+    if (std::sscanf(line, "VmHWM: %zu kB", &peak_kb) == 1) {
+      break;
+    }
+  }
+  std::fclose(status);
+  return peak_kb * 1024;
+#else
+  return 0;
+#endif
+}
+
+// write a random combinational .bench file, every gate reads earlier signals
+static void WriteRandomBench(const std::string& path, const uint32_t gate_num) {
+  static const char* const types[] = {"AND", "OR", "XOR", "NAND", "NOR", "XNOR", "NOT", "BUFF"};
+  const uint32_t input_num = 64;
+  std::mt19937 rng(1);
+  std::ofstream out(path);
+  for (uint32_t i = 0; i < input_num; i++) {
+    out << "INPUT(I" << i << ")\n";
+  }
+  for (uint32_t i = gate_num - 16; i < gate_num; i++) {
+    out << "OUTPUT(G" << i << ")\n";
+  }
+  auto signal = [&](const uint32_t gate) {
+    const uint32_t pick = rng() % (input_num + gate);
+    return (pick < input_num) ? "I" + std::to_string(pick) : "G" + std::to_string(pick - input_num);
+  };
+  for (uint32_t i = 0; i < gate_num; i++) {
+    const uint32_t type = rng() % 8;
+    out << 'G' << i << " = " << types[type] << '(' << signal(i);
+    for (uint32_t k = (type < 6) ? 1 + rng() % 3 : 0; k > 0; k--) {
+      out << ", " << signal(i);
+    }
+    out << ")\n";
+  }
+}
+
+int main(int argc, char** argv) {
+  std::string path = (argc > 1) ? argv[1] : "gen";
+  if (path == "gen") {
+    const uint32_t gate_num = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 1000000;
+    path = "b_import_random.bench";
+    WriteRandomBench(path, gate_num);
+  }
+  const size_t rss_before = PeakResidentBytes();
+
+  Cim::ImportStats stats;
+  const Cim::Netlist netlist = Cim::ImportNetlist(path, Cim::NetlistFormat::Auto, &stats);
+
+  std::printf("file=%s bytes=%llu gates=%u nets=%u levels=%u seconds=%.4f mb_per_s=%.1f "
+      "peak_netlist_bytes=%zu bytes_per_gate=%.1f peak_rss_delta_bytes=%zu\n",
+      path.c_str(), static_cast<unsigned long long>(stats.byte_num), stats.gate_num, stats.net_num,
+      netlist.GetLevelNum(), stats.seconds, stats.mb_per_second, stats.peak_byte_num,
+      static_cast<double>(stats.peak_byte_num) / stats.gate_num, PeakResidentBytes() - rss_before);
+
+  // compiled-netlist cache: write once, then map with and without checksum
+  const std::string cache_path = path + ".cnl";
+  auto seconds_of = [](auto&& fn) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  };
+  const double save_s = seconds_of([&] { Cim::SaveNetlist(netlist, cache_path); });
+  const double map_s = seconds_of([&] { Cim::MapNetlist(cache_path, true); });
+  const double map_unverified_s = seconds_of([&] { Cim::MapNetlist(cache_path, false); });
+  std::printf("cache_save_s=%.4f cache_map_s=%.4f cache_map_unverified_s=%.6f speedup_vs_import=%.0fx\n",
+      save_s, map_s, map_unverified_s, stats.seconds / map_s);
+  std::remove(cache_path.c_str());
+  return 0;
+}
@@ -0,0 +1,132 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// Incremental engine benchmark: single input toggles and small netlist edits
+// on generated circuits, against a full evaluation / a full rebuild per change.
+// usage: b_incremental [random|iscas|all] [size] [changes]
+//   size: random gates / ISCAS width scale
+// Final states are checked against a full evaluation (exit code 1 on a mismatch).
+
+#include "b_circuits.h"
+#include "c_incremental.h"
+#include "c_levelized.h"
+#include <chrono>     // std::chrono
+#include <cstdio>     // std::printf
+#include <cstdlib>    // std::strtoul
+#include <functional> // std::function
+#include <random>     // std::mt19937_64
+#include <stdexcept>  // std::invalid_argument
+#include <string>     // std::string
+
+// seconds since start
+static double SecondsSince(const std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// toggle & edit one circuit, return false on a mismatch
+static bool RunCircuit(const std::string& name, const std::function<void(Cim::Netlist&)>& build,
+    const uint32_t changes) {
+  Cim::Netlist netlist;
+  build(netlist);
+  const auto inputs = netlist.GetInputs();
+  std::mt19937_64 rng(1);
+
+  // 1. input toggles: incremental update vs. full levelized pass
+  Cim::IncrementalSim inc(netlist);
+  Cim::LevelizedSim full(netlist);
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t c = 0; c < changes; c++) {
+    const uint32_t net = inputs[rng() % inputs.size()];
+    inc.SetInput(net, !inc.GetState(net));
+    inc.Update();
+  }
+  const double toggle_s = SecondsSince(start);
+  const uint64_t toggle_evals = inc.GetEvaluationNum();
+  start = std::chrono::steady_clock::now();
+  for (uint32_t c = 0; c < changes; c++) {
+    full.SetInput(inputs[c % inputs.size()], c & 1);
+    full.Evaluate();
+  }
+  const double full_s = SecondsSince(start);
+
+  // 2. edits: rewire one pin & update vs. rebuild, re-levelize & evaluate
+  start = std::chrono::steady_clock::now();
+  uint32_t loops = 0;
+  for (uint32_t c = 0; c < changes; c++) {
+    try {
+      inc.ReplaceFanin(rng() % inc.GetGateNum(), 0, rng() % inc.GetNetNum());
+    } catch (const std::invalid_argument&) {
+      loops++;
+    }
+    inc.Update();
+  }
+  const double edit_s = SecondsSince(start);
+  const uint32_t rebuilds = (changes < 20) ? changes : 20;
+  start = std::chrono::steady_clock::now();
+  for (uint32_t c = 0; c < rebuilds; c++) {
+    const Cim::Netlist rebuilt = inc.ToNetlist();
+    Cim::LevelizedSim sim(rebuilt);
+    sim.Evaluate();
+  }
+  const double rebuild_s = SecondsSince(start) / rebuilds;
+
+  // 3. the edited circuit settles to the same states as a full evaluation
+  const Cim::Netlist edited = inc.ToNetlist();
+  Cim::LevelizedSim check(edited);
+  for (const uint32_t each_net : edited.GetInputs()) {
+    check.SetInput(each_net, inc.GetState(each_net));
+  }
+  check.Evaluate();
+  bool same = true;
+  for (uint32_t n = 0; n < edited.GetNetNum(); n++) {
+    same &= (check.GetState(n) == inc.GetState(n));
+  }
+  std::printf("%-16s gates=%u toggles=%u evals_per_toggle=%.1f toggle_us=%.2f full_eval_us=%.2f "
+      "edits=%u loops_refused=%u relevels=%llu edit_us=%.2f rebuild_us=%.1f edit_speedup=%.0f equivalent=%s\n",
+      name.c_str(), netlist.GetGateNum(), changes, static_cast<double>(toggle_evals) / changes,
+      toggle_s / changes * 1e6, full_s / changes * 1e6, changes, loops,
+      static_cast<unsigned long long>(inc.GetRelevelNum()), edit_s / changes * 1e6, rebuild_s * 1e6,
+      rebuild_s / (edit_s / changes), same ? "yes" : "NO");
+  return same;
+}
+
+int main(int argc, char** argv) {
+  const std::string circuit = (argc > 1) ? argv[1] : "all";
+  const uint32_t size = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 0;
+  const uint32_t changes = (argc > 3) ? std::strtoul(argv[3], nullptr, 10) : 10000;
+  const bool all = (circuit == "all");
+  bool ok = true;
+
+  if (all || circuit == "random") {
+    const uint32_t gates = size ? size : 100000;
+    ok &= RunCircuit("random" + std::to_string(gates),
+        [gates](Cim::Netlist& netlist) { Bench::BuildRandomDag(netlist, gates, 1); }, changes);
+  }
+  if (all || circuit == "iscas") {
+    const uint32_t scale = size ? size : 1;
+    for (const Bench::IscasProfile& each_profile : Bench::GetIscasProfiles()) {
+      ok &= RunCircuit(std::string(each_profile.name) + "x" + std::to_string(scale),
+          [&](Cim::Netlist& netlist) { Bench::BuildIscasLike(netlist, each_profile, scale, 1); }, changes);
+    }
+  }
+  return ok ? 0 : 1;
+}
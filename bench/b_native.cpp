@@ -0,0 +1,118 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// Native backend benchmark: generated & compiled kernels vs. the interpreted
+// bit-parallel engine on generated circuits.
+// usage: b_native [multiplier|random|iscas|all] [size] [patterns]
+//   size: multiplier bits / random gates / ISCAS width scale
+// Reports code generation + compilation time (cache miss), load time (cache
+// hit) and evaluation throughput of both engines. Every net must agree
+// (exit code 1 on a mismatch).
+
+#include "b_circuits.h"
+#include "c_bitsim.h"
+#include "c_native.h"
+#include <algorithm>  // std::equal
+#include <chrono>     // std::chrono
+#include <cstdio>     // std::printf
+#include <cstdlib>    // std::strtoul
+#include <filesystem> // std::filesystem
+#include <functional> // std::function
+#include <string>     // std::string
+
+// return the mean seconds of one evaluation
+template <typename Sim>
+static double TimeEvaluate(Sim& sim) {
+  uint32_t rounds = 1;
+  double seconds = 0;
+  while (seconds < 0.2) {
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t r = 0; r < rounds; r++) {
+      sim.Evaluate();
+    }
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    rounds *= (seconds < 0.2) ? 2 : 1;
+  }
+  return seconds / rounds;
+}
+
+// compile & run one circuit, return false on a mismatch
+static bool RunCircuit(const std::string& name, const std::function<void(Cim::Netlist&)>& build,
+    const uint32_t patterns, const Cim::NativeOptions& options) {
+  Cim::Netlist netlist;
+  build(netlist);
+  Cim::NativeSim native(netlist, patterns, options);
+  const double compile_s = native.GetCompileSeconds();
+  const Cim::NativeSim reloaded(netlist, patterns, options);
+
+  Cim::BitParallelSim interpreted(netlist, patterns);
+  interpreted.Randomize(1);
+  for (const uint32_t each_net : netlist.GetInputs()) {
+    native.SetInputWords(each_net, interpreted.GetWords(each_net));
+  }
+  interpreted.Evaluate();
+  native.Evaluate();
+  bool same = true;
+  for (uint32_t n = 0; n < netlist.GetNetNum(); n++) {
+    same &= std::equal(interpreted.GetWords(n), interpreted.GetWords(n) + native.GetWordNum(), native.GetWords(n));
+  }
+  const double before = TimeEvaluate(interpreted), after = TimeEvaluate(native);
+  std::printf("%-16s gates=%u patterns=%u cached=%s compile_s=%.3f load_us=%.1f interpreted_gates_per_s=%.3e "
+      "native_gates_per_s=%.3e speedup=%.2f equivalent=%s\n",
+      name.c_str(), netlist.GetGateNum(), patterns, native.IsCacheHit() ? "yes" : "no", compile_s,
+      reloaded.GetLoadSeconds() * 1e6, netlist.GetGateNum() * (patterns / 64) / before,
+      netlist.GetGateNum() * (patterns / 64) / after, before / after, same ? "yes" : "NO");
+  return same;
+}
+
+int main(int argc, char** argv) {
+  const std::string circuit = (argc > 1) ? argv[1] : "all";
+  const uint32_t size = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 0;
+  const uint32_t patterns = (argc > 3) ? std::strtoul(argv[3], nullptr, 10) : 64;
+  const bool all = (circuit == "all");
+  if (!Cim::NativeSim::IsSupported()) {
+    std::printf("native backend not supported on this platform\n");
+    return 0;
+  }
+  Cim::NativeOptions options;
+  options.cache_dir = (std::filesystem::temp_directory_path() / "cim_native_bench").string();
+  bool ok = true;
+
+  if (all || circuit == "multiplier") {
+    const uint32_t bits = size ? size : 32;
+    ok &= RunCircuit("multiplier" + std::to_string(bits),
+        [bits](Cim::Netlist& netlist) { Bench::BuildMultiplier(netlist, bits); }, patterns, options);
+  }
+  if (all || circuit == "random") {
+    const uint32_t gates = size ? size : 50000;
+    ok &= RunCircuit("random" + std::to_string(gates),
+        [gates](Cim::Netlist& netlist) { Bench::BuildRandomDag(netlist, gates, 1); }, patterns, options);
+  }
+  if (all || circuit == "iscas") {
+    const uint32_t scale = size ? size : 1;
+    for (const Bench::IscasProfile& each_profile : Bench::GetIscasProfiles()) {
+      ok &= RunCircuit(std::string(each_profile.name) + "x" + std::to_string(scale),
+          [&](Cim::Netlist& netlist) { Bench::BuildIscasLike(netlist, each_profile, scale, 1); }, patterns, options);
+    }
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,168 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// Netlist optimization benchmark: redundant copies of the generated circuits
+// are optimized, then simulated bit-parallel before and after.
+// usage: b_optimize [multiplier|iscas|all] [size] [redundancy %]
+//   size: multiplier bits / ISCAS width scale
+// Redundancy is added the way generated netlists carry it: duplicated gates,
+// double inverters and logic nobody reads. The optimized netlist is checked
+// against the original on 64 random patterns (exit code 1 on a mismatch).
+
+#include "b_circuits.h"
+#include "c_bitsim.h"
+#include "c_optimize.h"
+#include <chrono>     // std::chrono
+#include <cstdio>     // std::printf
+#include <cstdlib>    // std::strtoul
+#include <functional> // std::function
+#include <random>     // std::mt19937_64
+#include <string>     // std::string
+#include <vector>     // std::vector
+
+// copy a levelized netlist, padding it with about percent % redundant gates
+static void AddRedundancy(const Cim::Netlist& source, Cim::Netlist& target, const uint32_t percent,
+    const uint64_t seed) {
+  std::mt19937_64 rng(seed);
+  auto chance = [&](const uint32_t pct) { return rng() % 100 < pct; };
+  // every source net has one or more equivalent nets in the target
+  std::vector<std::vector<uint32_t>> copies(source.GetNetNum());
+  for (const uint32_t each_net : source.GetInputs()) {
+    copies[each_net].push_back(target.AddNet());
+  }
+  const Cim::ArrayView<uint32_t> fanin = source.GetFanin();
+  std::vector<uint32_t> nets;
+  for (const Cim::Instruction& ins : source.GetProgram()) {
+    // each of percent / 3 %: a duplicate, a double inverter, a dead gate
+    const uint32_t variants = chance(percent / 3) ? 2 : 1;
+    for (uint32_t v = 0; v < variants; v++) {
+      nets.clear();
+      for (uint32_t k = 0; k < ins.fanin_count; k++) {
+        const std::vector<uint32_t>& options = copies[fanin[ins.fanin_begin + k]];
+        nets.push_back(options[rng() % options.size()]);
+      }
+      const uint32_t out = target.AddNet();
+      if (ins.op == Cim::GateKind::LUT) {
+        target.AddLut(source.GetLuts()[ins.lut], nets, out);
+      } else {
+        target.AddGate(ins.op, nets, out);
+      }
+      copies[ins.out_net].push_back(out);
+    }
+    if (chance(percent / 3)) {
+      const uint32_t inverted = target.AddNet(), restored = target.AddNet();
+      target.AddGate(Cim::GateKind::NOT, {copies[ins.out_net][0]}, inverted);
+      target.AddGate(Cim::GateKind::NOT, {inverted}, restored);
+      copies[ins.out_net].push_back(restored);
+    }
+    if (chance(percent / 3)) {
+      target.AddGate(Cim::GateKind::NAND, {copies[ins.out_net][0], nets[0]}, target.AddNet());
+    }
+  }
+  for (const uint32_t each_net : source.GetOutputs()) {
+    target.AddOutput(copies[each_net][0]);
+  }
+  target.Levelize();
+}
+
+// return the mean seconds of one 64-pattern evaluation
+static double TimeEvaluate(const Cim::Netlist& netlist, const std::vector<uint64_t>& words) {
+  Cim::BitParallelSim sim(netlist, 64);
+  for (uint32_t i = 0; i < words.size(); i++) {
+    sim.SetInputWords(netlist.GetInputs()[i], &words[i]);
+  }
+  sim.Evaluate();
+  uint32_t rounds = 1;
+  double seconds = 0;
+  while (seconds < 0.2) {
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t r = 0; r < rounds; r++) {
+      sim.Evaluate();
+    }
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    rounds *= (seconds < 0.2) ? 2 : 1;
+  }
+  return seconds / rounds;
+}
+
+// return true if both netlists compute the same outputs for the given input words
+static bool SameOutputs(const Cim::Netlist& first, const Cim::Netlist& second, const std::vector<uint64_t>& words) {
+  Cim::BitParallelSim first_sim(first, 64), second_sim(second, 64);
+  for (uint32_t i = 0; i < words.size(); i++) {
+    first_sim.SetInputWords(first.GetInputs()[i], &words[i]);
+    second_sim.SetInputWords(second.GetInputs()[i], &words[i]);
+  }
+  first_sim.Evaluate();
+  second_sim.Evaluate();
+  for (uint32_t o = 0; o < first.GetOutputs().size(); o++) {
+    if (*first_sim.GetWords(first.GetOutputs()[o]) != *second_sim.GetWords(second.GetOutputs()[o])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// pad, optimize & simulate one circuit, return false on a mismatch
+static bool RunCircuit(const std::string& name, const std::function<void(Cim::Netlist&)>& build,
+    const uint32_t percent) {
+  Cim::Netlist original, padded;
+  build(original);
+  AddRedundancy(original, padded, percent, 1);
+  Cim::OptimizeStats stats;
+  const Cim::Netlist optimized = Cim::OptimizeNetlist(padded, Cim::OptimizeOptions(), &stats);
+
+  std::mt19937_64 rng(2);
+  std::vector<uint64_t> words(original.GetInputs().size());
+  for (uint64_t& each_word : words) {
+    each_word = rng();
+  }
+  const bool same = SameOutputs(original, optimized, words);
+  const double before = TimeEvaluate(padded, words), after = TimeEvaluate(optimized, words);
+  std::printf("%-16s gates=%u padded=%u optimized=%u constant=%u alias=%u merged=%u dead=%u inverters=%u "
+      "optimize_s=%.4f eval_us_before=%.2f eval_us_after=%.2f speedup=%.2f equivalent=%s\n",
+      name.c_str(), original.GetGateNum(), stats.gate_num_before, stats.gate_num_after, stats.constant_num,
+      stats.alias_num, stats.merged_num, stats.dead_num, stats.inverter_num, stats.seconds, before * 1e6,
+      after * 1e6, before / after, same ? "yes" : "NO");
+  return same;
+}
+
+int main(int argc, char** argv) {
+  const std::string circuit = (argc > 1) ? argv[1] : "all";
+  const uint32_t size = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 0;
+  const uint32_t percent = (argc > 3) ? std::strtoul(argv[3], nullptr, 10) : 30;
+  const bool all = (circuit == "all");
+  bool ok = true;
+
+  if (all || circuit == "multiplier") {
+    const uint32_t bits = size ? size : 16;
+    ok &= RunCircuit("multiplier" + std::to_string(bits),
+        [bits](Cim::Netlist& netlist) { Bench::BuildMultiplier(netlist, bits); }, percent);
+  }
+  if (all || circuit == "iscas") {
+    const uint32_t scale = size ? size : 1;
+    for (const Bench::IscasProfile& each_profile : Bench::GetIscasProfiles()) {
+      ok &= RunCircuit(std::string(each_profile.name) + "x" + std::to_string(scale),
+          [&](Cim::Netlist& netlist) { Bench::BuildIscasLike(netlist, each_profile, scale, 1); }, percent);
+    }
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,135 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// Profiling benchmark: levelized and event-driven simulation with and without
+// a Profiler attached, i.e. the cost of the activity counters.
+// usage: b_profile [random|iscas|all] [size] [vectors] [report.json]
+//   size: random gates / ISCAS width scale
+// The JSON report of the last circuit is written to report.json if given.
+// Profiled states are checked against the plain engine (exit code 1 on a mismatch).
+
+#include "b_circuits.h"
+#include "c_levelized.h"
+#include "c_event.h"
+#include "c_profile.h"
+#include <chrono>     // std::chrono
+#include <cstdio>     // std::printf
+#include <cstdlib>    // std::strtoul
+#include <fstream>    // std::ofstream
+#include <functional> // std::function
+#include <random>     // std::mt19937_64
+#include <string>     // std::string
+#include <vector>     // std::vector
+
+// seconds since start
+static double SecondsSince(const std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// simulate one circuit plain & profiled, return false on a mismatch
+static bool RunCircuit(const std::string& name, const std::function<void(Cim::Netlist&)>& build,
+    const uint32_t vectors, const std::string& report) {
+  Cim::Netlist netlist;
+  build(netlist);
+  const auto inputs = netlist.GetInputs();
+  std::vector<std::vector<bool>> stimulus(vectors, std::vector<bool>(inputs.size()));
+  std::mt19937_64 rng(1);
+  for (std::vector<bool>& each_vector : stimulus) {
+    for (uint32_t i = 0; i < inputs.size(); i++) {
+      each_vector[i] = rng() & 1;
+    }
+  }
+
+  // 1. levelized, plain vs. profiled
+  Cim::LevelizedSim plain(netlist), profiled(netlist);
+  Cim::Profiler profiler(netlist);
+  profiled.SetProfiler(&profiler);
+  auto start = std::chrono::steady_clock::now();
+  for (const std::vector<bool>& each_vector : stimulus) {
+    plain.SetInputs(each_vector);
+    plain.Evaluate();
+  }
+  const double plain_s = SecondsSince(start);
+  start = std::chrono::steady_clock::now();
+  for (const std::vector<bool>& each_vector : stimulus) {
+    profiled.SetInputs(each_vector);
+    profiled.Evaluate();
+  }
+  const double profiled_s = SecondsSince(start);
+  const bool same = (plain.GetStates() == profiled.GetStates());
+
+  // 2. event driven, plain vs. profiled (one input toggle per vector)
+  Cim::EventSim event_plain(netlist), event_profiled(netlist);
+  Cim::Profiler event_profiler(netlist);
+  event_profiled.SetProfiler(&event_profiler);
+  start = std::chrono::steady_clock::now();
+  for (uint32_t v = 0; v < vectors; v++) {
+    event_plain.SetInput(inputs[v % inputs.size()], stimulus[v][0]);
+    event_plain.Run();
+  }
+  const double event_plain_s = SecondsSince(start);
+  start = std::chrono::steady_clock::now();
+  for (uint32_t v = 0; v < vectors; v++) {
+    event_profiled.SetInput(inputs[v % inputs.size()], stimulus[v][0]);
+    event_profiled.Run();
+  }
+  const double event_profiled_s = SecondsSince(start);
+
+  if (!report.empty()) {
+    std::ofstream out(report);
+    profiler.WriteJson(out);
+  }
+  std::printf("%-16s gates=%u levels=%u vectors=%u levelized_us=%.2f profiled_us=%.2f overhead=%.2fx "
+      "event_us=%.2f event_profiled_us=%.2f event_overhead=%.2fx mean_activity=%.3f equivalent=%s\n",
+      name.c_str(), netlist.GetGateNum(), netlist.GetLevelNum(), vectors, plain_s / vectors * 1e6,
+      profiled_s / vectors * 1e6, profiled_s / plain_s, event_plain_s / vectors * 1e6,
+      event_profiled_s / vectors * 1e6, event_profiled_s / event_plain_s,
+      static_cast<double>(profiler.GetTotalToggles()) / vectors / netlist.GetGateNum(), same ? "yes" : "NO");
+  return same;
+}
+
+int main(int argc, char** argv) {
+  const std::string circuit = (argc > 1) ? argv[1] : "all";
+  const uint32_t size = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 0;
+  const uint32_t vectors = (argc > 3) ? std::strtoul(argv[3], nullptr, 10) : 1000;
+  const std::string report = (argc > 4) ? argv[4] : "";
+  const bool all = (circuit == "all");
+  bool ok = true;
+
+  if (!Cim::Profiler::IsEnabled()) {
+    std::printf("built with CIM_PROFILE=0, nothing to measure\n");
+    return 0;
+  }
+  if (all || circuit == "random") {
+    const uint32_t gates = size ? size : 100000;
+    ok &= RunCircuit("random" + std::to_string(gates),
+        [gates](Cim::Netlist& netlist) { Bench::BuildRandomDag(netlist, gates, 1); }, vectors, report);
+  }
+  if (all || circuit == "iscas") {
+    const uint32_t scale = size ? size : 1;
+    for (const Bench::IscasProfile& each_profile : Bench::GetIscasProfiles()) {
+      ok &= RunCircuit(std::string(each_profile.name) + "x" + std::to_string(scale),
+          [&](Cim::Netlist& netlist) { Bench::BuildIscasLike(netlist, each_profile, scale, 1); }, vectors, report);
+    }
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,150 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// Snapshot benchmark: many what-if branches forked from one warmed-up state.
+// usage: b_snapshot [registers] [branches] [warmup cycles]
+// The circuit is a bank of shift registers, one enable and data input per
+// block of kSnapshotPageNets registers, so a branch only changes the blocks it enables.
+// Each branch is started by Restore() of the base and, for comparison, by
+// rebuilding the base state (Reset() + warmup). Both must end in the same
+// state (exit code 1 on a mismatch).
+
+#include "c_cycle.h"
+#include "c_snapshot.h"
+#include <chrono>     // std::chrono
+#include <cstdio>     // std::printf
+#include <cstdlib>    // std::strtoul
+#include <random>     // std::mt19937_64
+#include <vector>     // std::vector
+
+// seconds since start
+static double SecondsSince(const std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// register bank: q[i] <= rst ? 0 : en[b] ? q[i - 1] ^ data[b] : q[i]
+struct Bank {
+  Cim::Netlist netlist;
+  uint32_t rst;
+  std::vector<uint32_t> enables, data;
+
+  explicit Bank(const uint32_t reg_num) : netlist(), rst{netlist.AddNet()}, enables(), data() {
+    // LUT inputs: rst, en, q[i], q[i - 1], data
+    uint64_t table = 0;
+    for (uint32_t m = 0; m < 32; m++) {
+      const bool r = m & 1, en = m & 2, q = m & 4, prev = m & 8, d = m & 16;
+      table |= uint64_t{!r && (en ? (prev != d) : q)} << m;
+    }
+    const uint32_t block_num = (reg_num + Cim::kSnapshotPageNets - 1) / Cim::kSnapshotPageNets;
+    for (uint32_t b = 0; b < block_num; b++) {
+      enables.push_back(netlist.AddNet());
+      data.push_back(netlist.AddNet());
+    }
+    std::vector<uint32_t> q(reg_num), d(reg_num);
+    for (uint32_t i = 0; i < reg_num; i++) {
+      q[i] = netlist.AddNet();
+      d[i] = netlist.AddNet();
+    }
+    for (uint32_t i = 0; i < reg_num; i++) {
+      const uint32_t b = i / Cim::kSnapshotPageNets;
+      netlist.AddLut(table, {rst, enables[b], q[i], q[(i + reg_num - 1) % reg_num], data[b]}, d[i]);
+      netlist.AddRegister(Cim::GateKind::DFF, d[i], q[i]);
+      netlist.AddOutput(d[i]);
+    }
+    netlist.Levelize();
+  }
+
+  // reset, then run cycles with every block enabled and random data
+  void WarmUp(Cim::CycleSim& sim, const uint32_t cycles) const {
+    std::mt19937_64 rng(7);
+    sim.Reset();
+    sim.SetInput(rst, true);
+    sim.Clock();
+    sim.SetInput(rst, false);
+    for (uint32_t c = 0; c < cycles; c++) {
+      for (uint32_t b = 0; b < enables.size(); b++) {
+        sim.SetInput(enables[b], true);
+        sim.SetInput(data[b], rng() & 1);
+      }
+      sim.Clock();
+    }
+  }
+
+  // one what-if branch: enable a single block for a few cycles
+  void Branch(Cim::CycleSim& sim, const uint32_t branch) const {
+    for (uint32_t b = 0; b < enables.size(); b++) {
+      sim.SetInput(enables[b], b == branch % enables.size());
+      sim.SetInput(data[b], (branch >> 3) & 1);
+    }
+    sim.Run(4);
+  }
+};
+
+int main(int argc, char** argv) {
+  const uint32_t reg_num = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 1u << 18;
+  const uint32_t branches = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 1000;
+  const uint32_t warmup = (argc > 3) ? std::strtoul(argv[3], nullptr, 10) : 64;
+  const Bank bank(reg_num);
+  Cim::CycleSim sim(bank.netlist);
+  bank.WarmUp(sim, warmup);
+  const Cim::Snapshot base = sim.Save();
+
+  // 1. branches from the snapshot, each result saved against the base
+  std::vector<Cim::Snapshot> results;
+  results.reserve(branches);
+  double restore_s = 0, save_s = 0;
+  for (uint32_t i = 0; i < branches; i++) {
+    auto start = std::chrono::steady_clock::now();
+    sim.Restore(base);
+    restore_s += SecondsSince(start);
+    bank.Branch(sim, i);
+    start = std::chrono::steady_clock::now();
+    results.push_back(sim.Save(&base));
+    save_s += SecondsSince(start);
+  }
+  size_t unique_bytes = 0;
+  for (const Cim::Snapshot& each_result : results) {
+    unique_bytes += each_result.GetUniqueByteNum();
+  }
+
+  // 2. the same branches from a rebuilt state (fewer of them, it is slow)
+  const uint32_t rebuilds = (branches < 20) ? branches : 20;
+  bool same = true;
+  const auto start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < rebuilds; i++) {
+    bank.WarmUp(sim, warmup);
+    bank.Branch(sim, i);
+    const Cim::Snapshot check = sim.Save();
+    for (uint32_t n = 0; n < bank.netlist.GetNetNum(); n += 97) {
+      same &= (check.GetState(n) == results[i].GetState(n));
+    }
+  }
+  const double rebuild_s = SecondsSince(start) / rebuilds;
+
+  const size_t full_bytes = static_cast<size_t>(base.GetPageNum()) * Cim::kSnapshotPageNets / 8;
+  std::printf("registers=%u nets=%u pages=%u branches=%u restore_us=%.2f save_us=%.2f rebuild_us=%.1f "
+      "restore_speedup=%.0f bytes_per_state=%zu state_bytes_unpacked=%u unique_bytes_per_branch=%.0f equivalent=%s\n",
+      reg_num, bank.netlist.GetNetNum(), base.GetPageNum(), branches, restore_s / branches * 1e6,
+      save_s / branches * 1e6, rebuild_s * 1e6, rebuild_s / (restore_s / branches), full_bytes,
+      bank.netlist.GetNetNum(), static_cast<double>(unique_bytes) / branches, same ? "yes" : "NO");
+  return same ? 0 : 1;
+}
@@ -0,0 +1,133 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// Streaming benchmark: a vector file through the reader / simulation / writer pipeline.
+// usage: b_stream [multiplier bits] [vectors] [text|binary]
+// Random input vectors for an n x n multiplier are written to a temporary
+// file, streamed through StreamDriver into a result file of the same format
+// and compared with a scalar loop that reads the text lines, sets each input
+// and evaluates vector by vector (the per-pin path). The scalar loop covers at
+// most 100000 vectors and must agree with the stream (exit code 1 otherwise).
+
+#include "b_circuits.h"
+#include "c_levelized.h"
+#include "c_stream.h"
+#include <chrono>     // std::chrono
+#include <cstdio>     // std::printf
+#include <cstdlib>    // std::strtoul
+#include <cstring>    // std::strcmp
+#include <filesystem> // std::filesystem::temp_directory_path
+#include <fstream>    // std::ifstream, std::ofstream
+#include <random>     // std::mt19937_64, std::random_device
+#include <string>     // std::string
+#include <vector>     // std::vector
+
+// seconds since start
+static double SecondsSince(const std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+  const uint32_t bits = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 16;
+  const uint64_t vector_num = (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : 2000000;
+  const bool binary = (argc > 3) && std::strcmp(argv[3], "binary") == 0;
+  const Cim::VectorFormat format = binary ? Cim::VectorFormat::Binary : Cim::VectorFormat::Text;
+  Cim::Netlist netlist;
+  Bench::BuildMultiplier(netlist, bits);
+  const uint32_t input_num = netlist.GetInputs().size();
+  // names unique per run: concurrent runs (e.g. ctest -j) must not share or truncate each other's files
+  const std::string stem = std::string("cim_bench_stream_") + (binary ? "binary_" : "text_") +
+      std::to_string(std::random_device{}());
+  const std::filesystem::path dir = std::filesystem::temp_directory_path();
+  const std::string in_path = (dir / (stem + ".in")).string();
+  const std::string out_path = (dir / (stem + ".out")).string();
+  const std::string text_path = (dir / (stem + ".txt")).string();
+
+  // 1. random vectors, in the chosen format and as text for the scalar loop
+  const uint64_t check_num = (vector_num < 100000) ? vector_num : 100000;
+  {
+    std::mt19937_64 rng(9);
+    Cim::VectorWriter writer(in_path, input_num, format);
+    Cim::VectorWriter text(text_path, input_num, Cim::VectorFormat::Text);
+    std::vector<uint64_t> block(input_num);
+    for (uint64_t v = 0; v < vector_num; v += 64) {
+      for (uint64_t& each_word : block) {
+        each_word = rng();
+      }
+      const uint32_t count = (vector_num - v < 64) ? vector_num - v : 64;
+      writer.WriteBlock(block.data(), 1, count);
+      if (v < check_num) {
+        text.WriteBlock(block.data(), 1, (check_num - v < count) ? check_num - v : count);
+      }
+    }
+    writer.Close();
+    text.Close();
+  }
+
+  // 2. the pipeline
+  Cim::StreamDriver driver(netlist);
+  const Cim::StreamStats stats = driver.Run(in_path, out_path, format, format);
+
+  // 3. the scalar loop over the text vectors, checked against the streamed results
+  const std::vector<uint32_t>& results = driver.GetResultNets();
+  Cim::LevelizedSim sim(netlist);
+  Cim::VectorReader streamed(out_path);
+  std::vector<uint64_t> words(results.size());
+  std::ifstream in(text_path);
+  std::ofstream out(text_path + ".out");
+  std::string line, result(results.size(), '0');
+  bool same = true;
+  const auto start = std::chrono::steady_clock::now();
+  for (uint64_t v = 0; v < check_num && std::getline(in, line); v++) {
+    for (uint32_t c = 0; c < input_num; c++) {
+      sim.SetInput(netlist.GetInputs()[c], line[c] == '1');
+    }
+    sim.Evaluate();
+    for (uint32_t r = 0; r < results.size(); r++) {
+      result[r] = sim.GetState(results[r]) ? '1' : '0';
+    }
+    out << result << '\n';
+    if (v % 64 == 0) {
+      streamed.ReadBlock(words.data(), 1);
+    }
+    for (uint32_t r = 0; r < results.size(); r++) {
+      same &= ((words[r] >> (v % 64)) & 1) == (result[r] == '1');
+    }
+  }
+  out.close();
+  const double scalar_s = SecondsSince(start);
+  std::filesystem::remove(text_path + ".out");
+  for (const std::string& each_path : {in_path, out_path, text_path}) {
+    std::filesystem::remove(each_path);
+  }
+
+  const double stream_rate = stats.vectors / stats.seconds;
+  const double scalar_rate = check_num / scalar_s;
+  std::printf("format=%s inputs=%u outputs=%zu vectors=%llu blocks=%llu in_mb=%.1f out_mb=%.1f seconds=%.3f "
+      "read_s=%.3f simulate_s=%.3f write_s=%.3f mvectors_per_s=%.2f in_mb_per_s=%.1f scalar_mvectors_per_s=%.3f "
+      "speedup=%.1f equivalent=%s\n",
+      binary ? "binary" : "text", input_num, results.size(), static_cast<unsigned long long>(stats.vectors),
+      static_cast<unsigned long long>(stats.blocks), stats.bytes_in / 1e6, stats.bytes_out / 1e6, stats.seconds,
+      stats.read_seconds, stats.simulate_seconds, stats.write_seconds, stream_rate / 1e6,
+      stats.bytes_in / 1e6 / stats.seconds, scalar_rate / 1e6, stream_rate / scalar_rate, same ? "yes" : "NO");
+  return same ? 0 : 1;
+}
@@ -0,0 +1,228 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// Engine benchmark over generated circuits.
+// usage: b_suite [adder|multiplier|random|iscas|all] [size] [vectors]
+//   size: adder bits (x16 adders) / multiplier bits / random gates / ISCAS width scale
+// Every engine simulates the same random input vectors; the sum of all output
+// values (sig) must agree between engines.
+
+#include "b_circuits.h"
+#include "c_levelized.h"
+#include "c_event.h"
+#include "c_bitsim.h"
+#include "c_parallel.h"
+#include "c_logic4.h"
+#include <chrono>     // std::chrono
+#include <cstdio>     // std::printf
+#include <cstdlib>    // std::strtoul
+#include <cstring>    // std::strcmp
+#include <functional> // std::function
+#include <string>     // std::string
+#include <vector>     // std::vector
+
+// seconds since start
+static double SecondsSince(const std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// random input vectors: bit v of words[i * word_num + v / 64] is input i of vector v
+struct Stimulus {
+  uint32_t vector_num;
+  uint32_t word_num;
+  std::vector<uint64_t> words;
+
+  Stimulus(const uint32_t input_num, const uint32_t vectors, const uint64_t seed) :
+    vector_num{(vectors + 511) / 512 * 512}, word_num{vector_num / 64},
+    words(static_cast<size_t>(input_num) * word_num) {
+    std::mt19937_64 rng(seed);
+    for (uint64_t& each_word : words) each_word = rng();
+  }
+
+  bool Get(const uint32_t input, const uint32_t vector) const {
+    return (words[static_cast<size_t>(input) * word_num + vector / 64] >> (vector % 64)) & 1;
+  }
+};
+
+// one engine run: vectors simulated, gate evaluations, output signature
+struct RunResult {
+  double seconds;
+  uint64_t evaluations;
+  uint64_t signature;
+};
+
+static RunResult RunLevelized(const Cim::Netlist& netlist, const Stimulus& stimulus) {
+  Cim::LevelizedSim sim(netlist);
+  const auto inputs = netlist.GetInputs();
+  const auto outputs = netlist.GetOutputs();
+  uint64_t signature = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (uint32_t v = 0; v < stimulus.vector_num; v++) {
+    for (uint32_t i = 0; i < inputs.size(); i++) sim.SetInput(inputs[i], stimulus.Get(i, v));
+    sim.Evaluate();
+    for (const uint32_t each_net : outputs) signature += sim.GetState(each_net);
+  }
+  return RunResult{SecondsSince(start), uint64_t{stimulus.vector_num} * netlist.GetGateNum(), signature};
+}
+
+static RunResult RunEvent(const Cim::Netlist& netlist, const Stimulus& stimulus) {
+  Cim::EventSim sim(netlist);
+  const auto inputs = netlist.GetInputs();
+  const auto outputs = netlist.GetOutputs();
+  uint64_t signature = 0;
+  const auto start = std::chrono::steady_clock::now();
+  sim.Initialize();
+  for (uint32_t v = 0; v < stimulus.vector_num; v++) {
+    for (uint32_t i = 0; i < inputs.size(); i++) {
+      const bool state = stimulus.Get(i, v);
+      if (state != sim.GetState(inputs[i])) sim.SetInput(inputs[i], state);
+    }
+    sim.Run();
+    for (const uint32_t each_net : outputs) signature += sim.GetState(each_net);
+  }
+  return RunResult{SecondsSince(start), sim.GetEvaluationNum(), signature};
+}
+
+static RunResult RunBitParallel(const Cim::Netlist& netlist, const Stimulus& stimulus, const uint32_t patterns) {
+  Cim::BitParallelSim sim(netlist, patterns);
+  const auto inputs = netlist.GetInputs();
+  const auto outputs = netlist.GetOutputs();
+  const uint32_t words_per_block = patterns / 64;
+  uint64_t signature = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (uint32_t w = 0; w < stimulus.word_num; w += words_per_block) {
+    for (uint32_t i = 0; i < inputs.size(); i++) {
+      sim.SetInputWords(inputs[i], &stimulus.words[static_cast<size_t>(i) * stimulus.word_num + w]);
+    }
+    sim.Evaluate();
+    for (const uint32_t each_net : outputs) {
+      const uint64_t* const words = sim.GetWords(each_net);
+      for (uint32_t l = 0; l < words_per_block; l++) signature += __builtin_popcountll(words[l]);
+    }
+  }
+  return RunResult{SecondsSince(start), uint64_t{stimulus.vector_num} * netlist.GetGateNum(), signature};
+}
+
+static RunResult RunLogic4(const Cim::Netlist& netlist, const Stimulus& stimulus) {
+  Cim::Logic4Sim sim(netlist, 512);
+  const auto inputs = netlist.GetInputs();
+  const auto outputs = netlist.GetOutputs();
+  const std::vector<uint64_t> known(sim.GetWordNum(), 0);
+  uint64_t signature = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (uint32_t w = 0; w < stimulus.word_num; w += sim.GetWordNum()) {
+    for (uint32_t i = 0; i < inputs.size(); i++) {
+      sim.SetInputWords(inputs[i], &stimulus.words[static_cast<size_t>(i) * stimulus.word_num + w], known.data());
+    }
+    sim.Evaluate();
+    // known inputs -> known outputs, the value plane carries the result
+    for (const uint32_t each_net : outputs) {
+      const uint64_t* const words = sim.GetValueWords(each_net);
+      for (uint32_t l = 0; l < sim.GetWordNum(); l++) signature += __builtin_popcountll(words[l]);
+    }
+  }
+  return RunResult{SecondsSince(start), uint64_t{stimulus.vector_num} * netlist.GetGateNum(), signature};
+}
+
+static RunResult RunParallel(const Cim::Netlist& netlist, const Stimulus& stimulus) {
+  Cim::ParallelSim sim(netlist);
+  const auto inputs = netlist.GetInputs();
+  const auto outputs = netlist.GetOutputs();
+  uint64_t signature = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (uint32_t v = 0; v < stimulus.vector_num; v++) {
+    for (uint32_t i = 0; i < inputs.size(); i++) sim.SetInput(inputs[i], stimulus.Get(i, v));
+    sim.Evaluate();
+    for (const uint32_t each_net : outputs) signature += sim.GetState(each_net);
+  }
+  return RunResult{SecondsSince(start), uint64_t{stimulus.vector_num} * netlist.GetGateNum(), signature};
+}
+
+// build one circuit, then run every engine on it
+static bool RunCircuit(const std::string& name, const std::function<void(Cim::Netlist&)>& build,
+    const uint32_t vectors) {
+  Cim::Netlist netlist;
+  const auto start = std::chrono::steady_clock::now();
+  build(netlist);
+  const double build_s = SecondsSince(start);
+  const size_t bytes = netlist.GetByteNum() + netlist.GetNameByteNum();
+  std::printf("circuit=%s gates=%u nets=%u inputs=%zu outputs=%zu levels=%u build_s=%.4f bytes_per_gate=%.1f\n",
+      name.c_str(), netlist.GetGateNum(), netlist.GetNetNum(), netlist.GetInputs().size(),
+      netlist.GetOutputs().size(), netlist.GetLevelNum(), build_s,
+      static_cast<double>(bytes) / std::max(1u, netlist.GetGateNum()));
+
+  const Stimulus stimulus(netlist.GetInputs().size(), vectors, 1);
+  const std::pair<const char*, std::function<RunResult()>> engines[] = {
+    {"levelized", [&] { return RunLevelized(netlist, stimulus); }},
+    {"event", [&] { return RunEvent(netlist, stimulus); }},
+    {"bitparallel64", [&] { return RunBitParallel(netlist, stimulus, 64); }},
+    {"bitparallel512", [&] { return RunBitParallel(netlist, stimulus, 512); }},
+    {"parallel", [&] { return RunParallel(netlist, stimulus); }},
+    {"logic4_512", [&] { return RunLogic4(netlist, stimulus); }},
+  };
+  bool ok = true;
+  uint64_t reference = 0;
+  for (const auto& each_engine : engines) {
+    const RunResult result = each_engine.second();
+    if (&each_engine == &engines[0]) reference = result.signature;
+    const bool same = (result.signature == reference);
+    ok &= same;
+    std::printf("  engine=%-15s vectors=%u seconds=%.4f vectors_per_s=%.0f gates_per_s=%.3e evals_per_s=%.3e sig=%llu%s\n",
+        each_engine.first, stimulus.vector_num, result.seconds, stimulus.vector_num / result.seconds,
+        static_cast<double>(stimulus.vector_num) * netlist.GetGateNum() / result.seconds,
+        result.evaluations / result.seconds, static_cast<unsigned long long>(result.signature),
+        same ? "" : " MISMATCH");
+  }
+  return ok;
+}
+
+int main(int argc, char** argv) {
+  const std::string circuit = (argc > 1) ? argv[1] : "all";
+  const uint32_t size = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 0;
+  const uint32_t vectors = (argc > 3) ? std::strtoul(argv[3], nullptr, 10) : 1024;
+  const bool all = (circuit == "all");
+  bool ok = true;
+
+  if (all || circuit == "adder") {
+    const uint32_t bits = size ? size : 64;
+    ok &= RunCircuit("adder" + std::to_string(bits) + "x16",
+        [bits](Cim::Netlist& netlist) { Bench::BuildAdderChain(netlist, bits, 16); }, vectors);
+  }
+  if (all || circuit == "multiplier") {
+    const uint32_t bits = size ? size : 32;
+    ok &= RunCircuit("multiplier" + std::to_string(bits),
+        [bits](Cim::Netlist& netlist) { Bench::BuildMultiplier(netlist, bits); }, vectors);
+  }
+  if (all || circuit == "random") {
+    const uint32_t gates = size ? size : 50000;
+    ok &= RunCircuit("random" + std::to_string(gates),
+        [gates](Cim::Netlist& netlist) { Bench::BuildRandomDag(netlist, gates, 1); }, vectors);
+  }
+  if (all || circuit == "iscas") {
+    const uint32_t scale = size ? size : 1;
+    for (const Bench::IscasProfile& each_profile : Bench::GetIscasProfiles()) {
+      ok &= RunCircuit(std::string(each_profile.name) + "x" + std::to_string(scale),
+          [&](Cim::Netlist& netlist) { Bench::BuildIscasLike(netlist, each_profile, scale, 1); }, vectors);
+    }
+  }
+  return ok ? 0 : 1;
+}
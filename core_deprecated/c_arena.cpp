@@ -0,0 +1,102 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// includes for this file
+#include "c_arena.h"
+#include <stdexcept>
+#include <cstdlib>    // std::malloc, std::free
+
+// using namespace for this project
+using namespace Cim;
+
+// constructor
+Arena::Arena(const size_t ChunkSize) :
+  chunk_size{ChunkSize}, chunks(), cursor{nullptr}, limit{nullptr}, used{0}, reserved{0}, destructors() {
+  if (ChunkSize == 0) {
+    throw std::invalid_argument("ERR: CHUNK SIZE MUST NOT BE ZERO! \n");
+  }
+}
+
+// destructor
+Arena::~Arena() {
+  Release();
+}
+
+// hand out aligned memory from the current chunk, open a new one if needed
+void* Arena::do_allocate(size_t bytes, size_t alignment) {
+  uintptr_t aligned = (reinterpret_cast<uintptr_t>(cursor) + alignment - 1) & ~(uintptr_t{alignment} - 1);
+  if (cursor == nullptr || aligned + bytes > reinterpret_cast<uintptr_t>(limit)) {
+    // oversized requests get a chunk of their own
+    const size_t size = (bytes + alignment > chunk_size) ? bytes + alignment : chunk_size;
+    char* const chunk = static_cast<char*>(std::malloc(size));
+    if (chunk == nullptr) {
+      throw std::bad_alloc();
+    }
+    chunks.push_back(chunk);
+    reserved += size;
+    cursor = chunk;
+    limit = chunk + size;
+    aligned = (reinterpret_cast<uintptr_t>(cursor) + alignment - 1) & ~(uintptr_t{alignment} - 1);
+  }
+  cursor = reinterpret_cast<char*>(aligned + bytes);
+  used += bytes;
+  return reinterpret_cast<void*>(aligned);
+}
+
+// individual frees are no-ops, memory comes back with Release()
+void Arena::do_deallocate(void* p, size_t bytes, size_t alignment) {
+  (void)p;
+  (void)bytes;
+  (void)alignment;
+}
+
+// arenas are only equal to themselves
+bool Arena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+  return this == &other;
+}
+
+// destroy every created object and free every chunk at once
+void Arena::Release() noexcept {
+  // newest first, objects may refer to older ones
+  for (auto each = destructors.rbegin(); each != destructors.rend(); ++each) {
+    each->destroy(each->object);
+  }
+  destructors.clear();
+  for (char* const each_chunk : chunks) {
+    std::free(each_chunk);
+  }
+  chunks.clear();
+  cursor = nullptr;
+  limit = nullptr;
+  used = 0;
+  reserved = 0;
+}
+
+// return the bytes handed out
+size_t Arena::GetUsedByteNum() const noexcept {
+  return this->used;
+}
+
+// return the bytes reserved from the system
+size_t Arena::GetReservedByteNum() const noexcept {
+  return this->reserved;
+}
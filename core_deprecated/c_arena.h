@@ -0,0 +1,98 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// include guard for this header
+#ifndef C_ARENA_H
+#define C_ARENA_H
+
+// includes for this header
+#include <cstddef>          // size_t, std::max_align_t
+#include <cstdint>          // standard int types
+#include <new>              // placement new
+#include <utility>          // std::forward
+#include <vector>           // std::vector
+#include <memory_resource>  // std::pmr::memory_resource
+#include <type_traits>      // std::is_trivially_destructible
+
+// namespace for entire project
+namespace Cim {
+
+// Arena Class (memory resource)
+// Netlist-scoped bump allocator. Memory is carved out of large chunks and only
+// returned all at once by Release() or the destructor. Gates built with the
+// arena as their resource place their names, pins and connection lists in it,
+// so building a netlist costs one malloc per chunk instead of several per gate.
+class Arena : public std::pmr::memory_resource {
+ public:
+  // constructor
+  explicit Arena(const size_t ChunkSize = size_t{1} << 20);
+
+  // an arena owns its chunks -> not copyable
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  // destructor (same as Release())
+  ~Arena();
+
+  // construct an object in the arena, it is destroyed by Release()
+  template <typename T, typename... Args>
+  T* Create(Args&&... args) {
+    void* const memory = allocate(sizeof(T), alignof(T));
+    T* const object = new (memory) T(std::forward<Args>(args)...);
+    if (!std::is_trivially_destructible<T>::value) {
+      destructors.push_back(Destructor{object, [](void* p) { static_cast<T*>(p)->~T(); }});
+    }
+    return object;
+  }
+
+  // destroy every created object and free every chunk at once
+  void Release() noexcept;
+
+  // return the bytes handed out / reserved from the system
+  size_t GetUsedByteNum() const noexcept;
+  size_t GetReservedByteNum() const noexcept;
+
+ private:
+  // memory_resource interface
+  virtual void* do_allocate(size_t bytes, size_t alignment) override;
+  virtual void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+  virtual bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+ private:
+  // destructor of one created object
+  struct Destructor {
+    void* object;
+    void (*destroy)(void*);
+  };
+
+  size_t chunk_size;                    // default chunk size
+  std::vector<char*> chunks;            // every chunk, freed by Release()
+  char* cursor;                         // next free byte in the last chunk
+  char* limit;                          // end of the last chunk
+  size_t used;                          // bytes handed out
+  size_t reserved;                      // bytes of all chunks
+  std::vector<Destructor> destructors;  // objects built by Create()
+};
+
+}
+
+#endif  // C_ARENA_H
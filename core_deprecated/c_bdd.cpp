@@ -0,0 +1,683 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// includes for this file
+#include "c_bdd.h"
+#include <algorithm>      // std::min, std::max, std::swap
+#include <cmath>          // std::ldexp
+#include <unordered_map>  // std::unordered_map
+#include <unordered_set>  // std::unordered_set
+#include <stdexcept>
+
+// using namespace for this project
+using namespace Cim;
+
+// helpers private to this file
+namespace {
+
+// level of the constant / marker of a free node
+constexpr uint32_t kConstVar = UINT32_MAX;
+constexpr uint32_t kFreeVar = UINT32_MAX - 1;
+
+// no node
+constexpr uint32_t kNoNode = UINT32_MAX;
+
+// smallest unique table / live nodes before the first collection
+constexpr uint32_t kMinBuckets = 1u << 12;
+constexpr uint64_t kMinGcThreshold = 1u << 18;
+
+// finalizer spreading every bit of x over the low bits taken by the tables
+inline uint64_t mix(uint64_t x) noexcept {
+  x ^= x >> 31;
+  x *= 0xBF58476D1CE4E5B9ull;
+  x ^= x >> 29;
+  x *= 0x94D049BB133111EBull;
+  return x ^ (x >> 32);
+}
+
+// hash of a node triple
+inline uint64_t hash_node(const uint32_t var, const BddEdge low, const BddEdge high) noexcept {
+  return mix((uint64_t{low} << 32 | high) + var * 0x9E3779B97F4A7C15ull);
+}
+
+// hash of a computed table key
+inline uint64_t hash_ite(const BddEdge f, const BddEdge g, const BddEdge h) noexcept {
+  return mix((uint64_t{f} << 32 | g) + h * 0x9E3779B97F4A7C15ull);
+}
+
+// thrown by make_node() at the node limit, caught by the public operations
+struct NodeLimitHit {};
+
+// run an operation; at the node limit free the garbage (keeping the operands) and run it once more
+template <typename Operation>
+BddEdge run_within_limit(BddManager& manager, const BddEdge* const keep, const uint32_t count, Operation operation) {
+  try {
+    return operation();
+  } catch (const NodeLimitHit&) {
+    // the partial results of the failed attempt are garbage as well
+  }
+  for (uint32_t k = 0; k < count; k++) manager.Ref(keep[k]);
+  manager.CollectGarbage();
+  for (uint32_t k = 0; k < count; k++) manager.Deref(keep[k]);
+  try {
+    return operation();
+  } catch (const NodeLimitHit&) {
+    throw std::runtime_error("ERR: BDD NODE LIMIT EXCEEDED! \n");
+  }
+}
+
+}
+
+// constructor
+BddManager::BddManager(const uint32_t cache_bits, const uint32_t node_limit) :
+  // nodes
+  nodes(1, Node{kConstVar, kBddOne, kBddOne, kNoNode}), refs(1, 0), buckets(kMinBuckets, kNoNode),
+  // tables
+  cache(), free_list{kNoNode}, node_limit{node_limit}, gc_threshold{kMinGcThreshold}, var_num{0},
+  // counters
+  stats{1, 1, 0, 0, 0, 0, 0, 0, 0} {
+  if (cache_bits > 30) {
+    throw std::invalid_argument("ERR: BDD COMPUTED TABLE TOO LARGE! \n");
+  }
+  if (node_limit == 0 || node_limit > (1u << 30)) {
+    throw std::invalid_argument("ERR: BDD NODE LIMIT MUST BE IN [1, 2^30]! \n");
+  }
+  cache.assign(size_t{1} << cache_bits, CacheEntry{kNoNode, 0, 0, 0});
+}
+
+// return the function of variable v
+BddEdge BddManager::GetVar(const uint32_t v) {
+  if (v >= kFreeVar) {
+    throw std::out_of_range("ERR: BDD VARIABLE OUT OF RANGE! \n");
+  }
+  var_num = std::max(var_num, v + 1);
+  return run_within_limit(*this, nullptr, 0, [&]() { return make_node(v, kBddZero, kBddOne); });
+}
+
+// return the node var ? high : low
+BddEdge BddManager::make_node(const uint32_t var, BddEdge low, BddEdge high) {
+  if (low == high) {
+    return low;
+  }
+  // keep the high edge regular: var ? !h : !l = !(var ? h : l)
+  const BddEdge out = high & 1;
+  low ^= out;
+  high ^= out;
+  stats.unique_lookups++;
+  uint32_t& head = buckets[hash_node(var, low, high) & (buckets.size() - 1)];
+  for (uint32_t n = head; n != kNoNode; n = nodes[n].next) {
+    if (nodes[n].var == var && nodes[n].low == low && nodes[n].high == high) {
+      stats.unique_hits++;
+      return (n << 1) | out;
+    }
+  }
+  if (stats.live_nodes >= node_limit) {
+    throw NodeLimitHit();
+  }
+  uint32_t n = free_list;
+  if (n != kNoNode) {
+    free_list = nodes[n].next;
+    nodes[n] = Node{var, low, high, head};
+  } else {
+    n = static_cast<uint32_t>(nodes.size());
+    nodes.push_back(Node{var, low, high, head});
+    refs.push_back(0);
+  }
+  head = n;
+  stats.live_nodes++;
+  stats.created_nodes++;
+  stats.peak_nodes = std::max(stats.peak_nodes, stats.live_nodes);
+  if (stats.live_nodes > buckets.size()) {
+    rehash();
+  }
+  return (n << 1) | out;
+}
+
+// rebuild the buckets for the current node count
+void BddManager::rehash() {
+  size_t size = kMinBuckets;
+  while (size < stats.live_nodes) {
+    size *= 2;
+  }
+  buckets.assign(size, kNoNode);
+  for (uint32_t n = 1; n < nodes.size(); n++) {
+    if (nodes[n].var != kFreeVar) {
+      uint32_t& head = buckets[hash_node(nodes[n].var, nodes[n].low, nodes[n].high) & (size - 1)];
+      nodes[n].next = head;
+      head = n;
+    }
+  }
+}
+
+// If-Then-Else without collection
+BddEdge BddManager::ite(BddEdge f, BddEdge g, BddEdge h) {
+  // 1. terminal cases
+  if (f == kBddOne) return g;
+  if (f == kBddZero) return h;
+  if (g == f) {
+    g = kBddOne;
+  } else if (g == (f ^ 1)) {
+    g = kBddZero;
+  }
+  if (h == f) {
+    h = kBddZero;
+  } else if (h == (f ^ 1)) {
+    h = kBddOne;
+  }
+  if (g == h) return g;
+  if (g == kBddOne && h == kBddZero) return f;
+  if (g == kBddZero && h == kBddOne) return f ^ 1;
+
+  // 2. standard triple: f and g regular (ite(!f, g, h) = ite(f, h, g), ite(f, !g, !h) = !ite(f, g, h))
+  if (f & 1) {
+    f ^= 1;
+    std::swap(g, h);
+  }
+  const BddEdge out = g & 1;
+  g ^= out;
+  h ^= out;
+
+  // 3. computed table
+  stats.cache_lookups++;
+  CacheEntry& entry = cache[hash_ite(f, g, h) & (cache.size() - 1)];
+  if (entry.f == f && entry.g == g && entry.h == h) {
+    stats.cache_hits++;
+    return entry.result ^ out;
+  }
+
+  // 4. Shannon expansion on the top variable (no references into nodes survive the recursion)
+  const uint32_t v = std::min({nodes[f >> 1].var, nodes[g >> 1].var, nodes[h >> 1].var});
+  const BddEdge t = ite(GetHigh(f, v), GetHigh(g, v), GetHigh(h, v));
+  const BddEdge e = ite(GetLow(f, v), GetLow(g, v), GetLow(h, v));
+  const BddEdge result = make_node(v, e, t);
+  cache[hash_ite(f, g, h) & (cache.size() - 1)] = CacheEntry{f, g, h, result};
+  return result ^ out;
+}
+
+// collect if due, keeping the operands alive
+void BddManager::maybe_collect(const BddEdge* const keep, const uint32_t count) {
+  if (stats.live_nodes < gc_threshold) {
+    return;
+  }
+  for (uint32_t k = 0; k < count; k++) Ref(keep[k]);
+  CollectGarbage();
+  for (uint32_t k = 0; k < count; k++) Deref(keep[k]);
+}
+
+// return ite(f, g, h)
+BddEdge BddManager::Ite(const BddEdge f, const BddEdge g, const BddEdge h) {
+  const BddEdge keep[3] = {f, g, h};
+  maybe_collect(keep, 3);
+  return run_within_limit(*this, keep, 3, [&]() { return ite(f, g, h); });
+}
+
+// return f & g
+BddEdge BddManager::And(const BddEdge f, const BddEdge g) {
+  return Ite(f, g, kBddZero);
+}
+
+// return f | g
+BddEdge BddManager::Or(const BddEdge f, const BddEdge g) {
+  return Ite(f, kBddOne, g);
+}
+
+// return f ^ g
+BddEdge BddManager::Xor(const BddEdge f, const BddEdge g) {
+  return Ite(f, g ^ 1, g);
+}
+
+// LUT by Shannon expansion over inputs [k, count)
+BddEdge BddManager::apply_lut(const BddEdge* const fanin, const uint32_t k, const uint32_t count,
+    const uint64_t table, const uint32_t offset) {
+  if (k == count) {
+    return ((table >> offset) & 1) ? kBddOne : kBddZero;
+  }
+  const BddEdge high = apply_lut(fanin, k + 1, count, table, offset + (1u << k));
+  const BddEdge low = apply_lut(fanin, k + 1, count, table, offset);
+  return ite(fanin[k], high, low);
+}
+
+// apply a combinational gate kind to the BDDs of its inputs
+BddEdge BddManager::Apply(const GateKind kind, const BddEdge* const fanin, const uint32_t count,
+    const uint64_t table) {
+  maybe_collect(fanin, count);
+  return run_within_limit(*this, fanin, count, [&]() { return apply(kind, fanin, count, table); });
+}
+
+// Apply() without collection
+BddEdge BddManager::apply(const GateKind kind, const BddEdge* const fanin, const uint32_t count,
+    const uint64_t table) {
+  // fold the inputs, negate afterwards for the inverting kinds
+  BddEdge result = kBddZero;
+  switch (kind) {
+    case GateKind::AND:
+    case GateKind::NAND:
+      result = kBddOne;
+      for (uint32_t k = 0; k < count; k++) result = ite(result, fanin[k], kBddZero);
+      return (kind == GateKind::NAND) ? result ^ 1 : result;
+    case GateKind::OR:
+    case GateKind::NOR:
+      for (uint32_t k = 0; k < count; k++) result = ite(result, kBddOne, fanin[k]);
+      return (kind == GateKind::NOR) ? result ^ 1 : result;
+    case GateKind::XOR:
+    case GateKind::XNOR:
+      for (uint32_t k = 0; k < count; k++) result = ite(result, fanin[k] ^ 1, fanin[k]);
+      return (kind == GateKind::XNOR) ? result ^ 1 : result;
+    case GateKind::NOT:
+      if (count != 1) {
+        throw std::invalid_argument("ERR: NOT GATE NEEDS ONE INPUT! \n");
+      }
+      return fanin[0] ^ 1;
+    case GateKind::LUT:
+      if (count > kMaxLutInputs) {
+        throw std::invalid_argument("ERR: TOO MANY LUT INPUTS! \n");
+      }
+      return apply_lut(fanin, 0, count, table, 0);
+    default:
+      throw std::invalid_argument("ERR: BDDS ARE COMBINATIONAL! \n");
+  }
+}
+
+// protect an edge from garbage collection
+void BddManager::Ref(const BddEdge f) {
+  refs[f >> 1]++;
+}
+
+// release an edge
+void BddManager::Deref(const BddEdge f) {
+  if (refs[f >> 1] == 0) {
+    throw std::logic_error("ERR: BDD EDGE IS NOT REFERENCED! \n");
+  }
+  refs[f >> 1]--;
+}
+
+// free every node not reachable from a referenced edge
+void BddManager::CollectGarbage() {
+  // 1. mark from the referenced nodes
+  std::vector<uint8_t> marked(nodes.size(), 0);
+  std::vector<uint32_t> stack;
+  marked[0] = 1;
+  for (uint32_t n = 1; n < nodes.size(); n++) {
+    if (refs[n] == 0 || marked[n]) {
+      continue;
+    }
+    marked[n] = 1;
+    stack.push_back(n);
+    while (!stack.empty()) {
+      const Node& node = nodes[stack.back()];
+      stack.pop_back();
+      for (const BddEdge child : {node.low, node.high}) {
+        if (!marked[child >> 1]) {
+          marked[child >> 1] = 1;
+          stack.push_back(child >> 1);
+        }
+      }
+    }
+  }
+  // 2. sweep the rest onto the free list
+  uint64_t freed = 0;
+  for (uint32_t n = 1; n < nodes.size(); n++) {
+    if (!marked[n] && nodes[n].var != kFreeVar) {
+      nodes[n].var = kFreeVar;
+      nodes[n].next = free_list;
+      free_list = n;
+      freed++;
+    }
+  }
+  // 3. the tables may name freed nodes
+  stats.live_nodes -= freed;
+  stats.gc_runs++;
+  stats.gc_freed += freed;
+  rehash();
+  std::fill(cache.begin(), cache.end(), CacheEntry{kNoNode, 0, 0, 0});
+  gc_threshold = std::max(kMinGcThreshold, 2 * stats.live_nodes);
+}
+
+// return the number of variables used so far
+uint32_t BddManager::GetVarNum() const noexcept {
+  return this->var_num;
+}
+
+// return the variable at the root of f
+uint32_t BddManager::GetTopVar(const BddEdge f) const noexcept {
+  return nodes[f >> 1].var;
+}
+
+// return the cofactor of f for v = 0
+BddEdge BddManager::GetLow(const BddEdge f, const uint32_t v) const noexcept {
+  const Node& node = nodes[f >> 1];
+  return (node.var == v) ? node.low ^ (f & 1) : f;
+}
+
+// return the cofactor of f for v = 1
+BddEdge BddManager::GetHigh(const BddEdge f, const uint32_t v) const noexcept {
+  const Node& node = nodes[f >> 1];
+  return (node.var == v) ? node.high ^ (f & 1) : f;
+}
+
+// return the number of nodes of f
+uint64_t BddManager::GetNodeNum(const BddEdge f) const {
+  return GetNodeNum(std::vector<BddEdge>{f});
+}
+
+// return the number of nodes of several functions
+uint64_t BddManager::GetNodeNum(const std::vector<BddEdge>& roots) const {
+  std::unordered_set<uint32_t> seen;
+  std::vector<uint32_t> stack;
+  for (const BddEdge each_root : roots) {
+    if (seen.insert(each_root >> 1).second) {
+      stack.push_back(each_root >> 1);
+    }
+    while (!stack.empty()) {
+      const uint32_t n = stack.back();
+      stack.pop_back();
+      if (n == 0) {
+        continue;
+      }
+      for (const BddEdge child : {nodes[n].low, nodes[n].high}) {
+        if (seen.insert(child >> 1).second) {
+          stack.push_back(child >> 1);
+        }
+      }
+    }
+  }
+  return seen.size();
+}
+
+// return the probability of f being 1
+double BddManager::GetProbability(const BddEdge f, const std::vector<double>& var_prob) const {
+  // probability of each regular node, children first (no recursion: depth is the variable count)
+  std::unordered_map<uint32_t, double> prob{{0, 1.0}};
+  std::vector<uint32_t> stack{f >> 1};
+  auto edge_prob = [&](const BddEdge e) {
+    const double p = prob.at(e >> 1);
+    return (e & 1) ? 1.0 - p : p;
+  };
+  while (!stack.empty()) {
+    const uint32_t n = stack.back();
+    if (prob.count(n) != 0) {
+      stack.pop_back();
+      continue;
+    }
+    const Node& node = nodes[n];
+    const bool ready = prob.count(node.low >> 1) != 0 && prob.count(node.high >> 1) != 0;
+    if (!ready) {
+      stack.push_back(node.low >> 1);
+      stack.push_back(node.high >> 1);
+      continue;
+    }
+    const double p = (node.var < var_prob.size()) ? var_prob[node.var] : 0.5;
+    prob[n] = p * edge_prob(node.high) + (1.0 - p) * edge_prob(node.low);
+    stack.pop_back();
+  }
+  return edge_prob(f);
+}
+
+// return the number of satisfying assignments to the first var_num variables
+double BddManager::CountSat(const BddEdge f, const uint32_t var_num) const {
+  return GetProbability(f) * std::ldexp(1.0, var_num);
+}
+
+// return one assignment satisfying f
+std::vector<int8_t> BddManager::PickSat(BddEdge f) const {
+  if (f == kBddZero) {
+    return {};
+  }
+  std::vector<int8_t> assignment(var_num, -1);
+  while ((f >> 1) != 0) {
+    const uint32_t v = GetTopVar(f);
+    const BddEdge high = GetHigh(f, v);
+    // any edge other than kBddZero leads to kBddOne
+    assignment[v] = (high != kBddZero) ? 1 : 0;
+    f = (high != kBddZero) ? high : GetLow(f, v);
+  }
+  return assignment;
+}
+
+// return the counters
+BddStats BddManager::GetStats() const noexcept {
+  return this->stats;
+}
+
+// return the bytes held by the manager
+uint64_t BddManager::GetByteNum() const noexcept {
+  return sizeof(BddManager) + nodes.capacity() * sizeof(Node) + refs.capacity() * sizeof(uint32_t) +
+         buckets.capacity() * sizeof(uint32_t) + cache.capacity() * sizeof(CacheEntry);
+}
+
+// return the variable of every source of a netlist
+std::vector<uint32_t> Cim::ComputeBddOrder(const Netlist& netlist, const BddOrder order) {
+  if (!netlist.IsLevelized()) {
+    throw std::logic_error("ERR: NETLIST MUST BE LEVELIZED! \n");
+  }
+  // sources: primary inputs, then register outputs
+  std::vector<uint32_t> source_of_net(netlist.GetNetNum(), UINT32_MAX);
+  uint32_t source_num = 0;
+  for (const uint32_t each_net : netlist.GetInputs()) source_of_net[each_net] = source_num++;
+  for (const Register& each_reg : netlist.GetRegisters()) source_of_net[each_reg.q_net] = source_num++;
+  std::vector<uint32_t> var_of_source(source_num, UINT32_MAX);
+  uint32_t next_var = 0;
+  if (order == BddOrder::DepthFirst) {
+    // roots: primary outputs, then register inputs, shallowest first; fanin visited in order
+    std::vector<uint32_t> roots(netlist.GetOutputs().begin(), netlist.GetOutputs().end());
+    for (const Register& each_reg : netlist.GetRegisters()) roots.push_back(each_reg.d_net);
+    const ArrayView<Instruction> program = netlist.GetProgram();
+    const ArrayView<uint32_t> fanin = netlist.GetFanin();
+    std::vector<uint32_t> depth(netlist.GetNetNum(), 0);
+    for (const Instruction& each_ins : program) {
+      for (uint32_t k = 0; k < each_ins.fanin_count; k++) {
+        depth[each_ins.out_net] = std::max(depth[each_ins.out_net], depth[fanin[each_ins.fanin_begin + k]] + 1);
+      }
+    }
+    std::stable_sort(roots.begin(), roots.end(), [&](const uint32_t x, const uint32_t y) {
+      return depth[x] < depth[y];
+    });
+    std::vector<uint8_t> visited(netlist.GetNetNum(), 0);
+    std::vector<uint32_t> stack;
+    for (const uint32_t each_root : roots) {
+      stack.push_back(each_root);
+      while (!stack.empty()) {
+        const uint32_t net = stack.back();
+        stack.pop_back();
+        if (visited[net]) {
+          continue;
+        }
+        visited[net] = 1;
+        if (source_of_net[net] != UINT32_MAX) {
+          var_of_source[source_of_net[net]] = next_var++;
+          continue;
+        }
+        const Instruction& ins = program[netlist.GetNetDriver(net)];
+        for (uint32_t k = ins.fanin_count; k-- > 0;) {
+          stack.push_back(fanin[ins.fanin_begin + k]);
+        }
+      }
+    }
+  }
+  // unreached sources (all of them for BddOrder::Input) follow in source order
+  for (uint32_t& each_var : var_of_source) {
+    if (each_var == UINT32_MAX) {
+      each_var = next_var++;
+    }
+  }
+  return var_of_source;
+}
+
+// constructor
+BddSim::BddSim(const Netlist& TargetNetlist, BddManager& Manager, const std::vector<uint32_t>& var_of_source,
+    const bool keep_internal) :
+  pNetlist{&TargetNetlist}, pManager{&Manager}, var_of_source{var_of_source}, net_bdd(), held() {
+  if (!TargetNetlist.IsLevelized()) {
+    throw std::logic_error("ERR: NETLIST MUST BE LEVELIZED! \n");
+  }
+  const uint32_t source_num = TargetNetlist.GetInputs().size() + TargetNetlist.GetRegisterNum();
+  if (var_of_source.empty()) {
+    this->var_of_source = ComputeBddOrder(TargetNetlist, BddOrder::DepthFirst);
+  } else if (var_of_source.size() != source_num) {
+    throw std::invalid_argument("ERR: ONE VARIABLE PER SOURCE EXPECTED! \n");
+  }
+
+  net_bdd.assign(TargetNetlist.GetNetNum(), kBddZero);
+  held.assign(TargetNetlist.GetNetNum(), 0);
+  try {
+    // 1. sources are variables (every other net is driven by a gate)
+    std::vector<uint32_t> sources(TargetNetlist.GetInputs().begin(), TargetNetlist.GetInputs().end());
+    for (const Register& each_reg : TargetNetlist.GetRegisters()) sources.push_back(each_reg.q_net);
+    for (uint32_t s = 0; s < source_num; s++) {
+      net_bdd[sources[s]] = Manager.GetVar(this->var_of_source[s]);
+      Manager.Ref(net_bdd[sources[s]]);
+      held[sources[s]] = 1;
+    }
+
+    // 2. readers left per net; kept nets never run out
+    const ArrayView<Instruction> program = TargetNetlist.GetProgram();
+    const ArrayView<uint32_t> fanout_offsets = TargetNetlist.GetFanoutOffsets();
+    std::vector<uint32_t> readers(TargetNetlist.GetNetNum(), UINT32_MAX);
+    if (!keep_internal) {
+      for (uint32_t n = 0; n < readers.size(); n++) {
+        readers[n] = fanout_offsets[n + 1] - fanout_offsets[n];
+      }
+      for (const uint32_t each_net : TargetNetlist.GetOutputs()) readers[each_net] = UINT32_MAX;
+      for (const Register& each_reg : TargetNetlist.GetRegisters()) readers[each_reg.d_net] = UINT32_MAX;
+      for (uint32_t g = 0; g < program.size(); g++) {
+        if (TargetNetlist.IsMonitored(g)) {
+          readers[program[g].out_net] = UINT32_MAX;
+        }
+      }
+      for (const uint32_t each_source : sources) readers[each_source] = UINT32_MAX;
+    }
+
+    // 3. gates in program order
+    const ArrayView<uint32_t> fanin = TargetNetlist.GetFanin();
+    const ArrayView<uint64_t> luts = TargetNetlist.GetLuts();
+    std::vector<BddEdge> inputs;
+    for (const Instruction& each_ins : program) {
+      inputs.clear();
+      for (uint32_t k = 0; k < each_ins.fanin_count; k++) {
+        inputs.push_back(net_bdd[fanin[each_ins.fanin_begin + k]]);
+      }
+      const uint64_t table = (each_ins.op == GateKind::LUT) ? luts[each_ins.lut] : 0;
+      net_bdd[each_ins.out_net] = Manager.Apply(each_ins.op, inputs.data(), each_ins.fanin_count, table);
+      Manager.Ref(net_bdd[each_ins.out_net]);
+      held[each_ins.out_net] = 1;
+      // release inputs read for the last time (one fanout entry per fanin position)
+      for (uint32_t k = 0; k < each_ins.fanin_count; k++) {
+        const uint32_t net = fanin[each_ins.fanin_begin + k];
+        if (readers[net] != UINT32_MAX && --readers[net] == 0) {
+          Manager.Deref(net_bdd[net]);
+          held[net] = 0;
+        }
+      }
+    }
+  } catch (...) {
+    // no destructor runs for a throwing constructor: give back the BDDs held so far
+    for (uint32_t n = 0; n < net_bdd.size(); n++) {
+      if (held[n]) {
+        Manager.Deref(net_bdd[n]);
+      }
+    }
+    throw;
+  }
+}
+
+// destructor
+BddSim::~BddSim() {
+  for (uint32_t n = 0; n < net_bdd.size(); n++) {
+    if (held[n]) {
+      pManager->Deref(net_bdd[n]);
+    }
+  }
+}
+
+// return the variable of every source
+const std::vector<uint32_t>& BddSim::GetVarOfSource() const noexcept {
+  return this->var_of_source;
+}
+
+// return the BDD of a net
+BddEdge BddSim::GetNet(const uint32_t net) const {
+  if (net >= net_bdd.size()) {
+    throw std::out_of_range("ERR: NET INDEX OUT OF RANGE! \n");
+  }
+  if (!held[net]) {
+    throw std::logic_error("ERR: BDD OF THIS NET WAS RELEASED! \n");
+  }
+  return net_bdd[net];
+}
+
+// return the probability of a net being 1
+double BddSim::GetProbability(const uint32_t net, const std::vector<double>& source_prob) const {
+  if (source_prob.empty()) {
+    return pManager->GetProbability(GetNet(net));
+  }
+  if (source_prob.size() != var_of_source.size()) {
+    throw std::invalid_argument("ERR: ONE PROBABILITY PER SOURCE EXPECTED! \n");
+  }
+  std::vector<double> var_prob(pManager->GetVarNum(), 0.5);
+  for (uint32_t s = 0; s < var_of_source.size(); s++) {
+    var_prob[var_of_source[s]] = source_prob[s];
+  }
+  return pManager->GetProbability(GetNet(net), var_prob);
+}
+
+// return the number of nodes of the primary outputs
+uint64_t BddSim::GetOutputNodeNum() const {
+  std::vector<BddEdge> roots;
+  for (const uint32_t each_net : pNetlist->GetOutputs()) roots.push_back(net_bdd[each_net]);
+  return pManager->GetNodeNum(roots);
+}
+
+// compare the primary outputs with those of another engine
+BddEquivalence BddSim::CheckEquivalence(const BddSim& other) const {
+  if (other.pManager != pManager) {
+    throw std::logic_error("ERR: BDDS OF DIFFERENT MANAGERS! \n");
+  }
+  const ArrayView<uint32_t> outputs = pNetlist->GetOutputs(), other_outputs = other.pNetlist->GetOutputs();
+  if (outputs.size() != other_outputs.size() ||
+      pNetlist->GetInputs().size() != other.pNetlist->GetInputs().size() ||
+      pNetlist->GetRegisterNum() != other.pNetlist->GetRegisterNum()) {
+    throw std::invalid_argument("ERR: NETLISTS HAVE DIFFERENT INTERFACES! \n");
+  }
+  // edges only compare if source s is the same variable on both sides
+  if (other.var_of_source != var_of_source) {
+    throw std::invalid_argument("ERR: BDD ENGINES USE DIFFERENT VARIABLE ORDERS! \n");
+  }
+  BddEquivalence result{true, 0, {}};
+  for (uint32_t o = 0; o < outputs.size(); o++) {
+    const BddEdge f = net_bdd[outputs[o]], g = other.net_bdd[other_outputs[o]];
+    if (f == g) {
+      continue;
+    }
+    // canonical form: different edges differ on some assignment, any one of f ^ g shows it
+    const std::vector<int8_t> witness = pManager->PickSat(pManager->Xor(f, g));
+    result.equivalent = false;
+    result.output = o;
+    result.input.assign(var_of_source.size(), -1);
+    for (uint32_t s = 0; s < var_of_source.size(); s++) {
+      if (var_of_source[s] < witness.size()) {
+        result.input[s] = witness[var_of_source[s]];
+      }
+    }
+    break;
+  }
+  return result;
+}
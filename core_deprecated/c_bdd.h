@@ -0,0 +1,237 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// include guard for this header
+#ifndef C_BDD_H
+#define C_BDD_H
+
+// includes for this header
+#include <vector>         // std::vector
+#include <cstdint>        // standard int types
+#include "c_structs.h"    // GateKind
+#include "c_netlist.h"    // class Netlist
+
+// namespace for entire project
+namespace Cim {
+
+// reference to a BDD: node index << 1 | complement bit (node 0 is the constant 1)
+typedef uint32_t BddEdge;
+
+// the constant functions
+constexpr BddEdge kBddOne = 0;
+constexpr BddEdge kBddZero = 1;
+
+// counters of a BDD manager
+struct BddStats {
+  uint64_t  live_nodes;       // nodes currently allocated (including the constant)
+  uint64_t  peak_nodes;       // most nodes ever allocated at once
+  uint64_t  created_nodes;    // nodes created since construction
+  uint64_t  unique_lookups;   // unique table lookups
+  uint64_t  unique_hits;      // lookups that found an existing node
+  uint64_t  cache_lookups;    // computed table lookups
+  uint64_t  cache_hits;       // lookups that found the result
+  uint64_t  gc_runs;          // garbage collections
+  uint64_t  gc_freed;         // nodes freed by them
+};
+
+// BddManager Class
+// Owns reduced ordered BDDs with complement edges: every node is stored once in
+// a hash-consed unique table, a node's high edge is never complemented (so each
+// function has exactly one edge and equality is edge equality), and negation
+// only flips the low bit of an edge. All operations reduce to If-Then-Else,
+// whose results are kept in a lossy direct-mapped computed table. Variable v
+// sits at level v (lower levels nearer the root).
+// Memory is reclaimed by mark and sweep from the edges held through Ref(): a
+// collection runs at the start of a public operation once the node count has
+// doubled since the last one, so edges kept across operations must be Ref()'d.
+// An operation reaching the node limit collects and starts over once before
+// it throws, so the limit applies to nodes still in use, not to garbage.
+class BddManager {
+ public:
+  // constructor (computed table of 2^cache_bits entries; node_limit bounds the live nodes)
+  explicit BddManager(const uint32_t cache_bits = 18, const uint32_t node_limit = 1u << 28);
+
+  // destructor
+  ~BddManager() { /* DN */ }
+
+  // return the function of variable v (its negation is Not(GetVar(v)))
+  BddEdge GetVar(const uint32_t v);
+
+  // return the negation (never allocates)
+  static BddEdge Not(const BddEdge f) noexcept { return f ^ 1; }
+
+  // boolean operations
+  BddEdge Ite(const BddEdge f, const BddEdge g, const BddEdge h);
+  BddEdge And(const BddEdge f, const BddEdge g);
+  BddEdge Or(const BddEdge f, const BddEdge g);
+  BddEdge Xor(const BddEdge f, const BddEdge g);
+
+  // apply a combinational gate kind to the BDDs of its inputs (table: LUT only)
+  BddEdge Apply(const GateKind kind, const BddEdge* const fanin, const uint32_t count, const uint64_t table = 0);
+
+  // protect / release an edge from garbage collection (counted)
+  void Ref(const BddEdge f);
+  void Deref(const BddEdge f);
+
+  // free every node not reachable from a Ref()'d edge
+  void CollectGarbage();
+
+  // return the number of variables used so far (highest variable + 1)
+  uint32_t GetVarNum() const noexcept;
+
+  // return the variable at the root of f (UINT32_MAX for constants)
+  uint32_t GetTopVar(const BddEdge f) const noexcept;
+
+  // return the cofactors of f for variable v = 0 / 1
+  BddEdge GetLow(const BddEdge f, const uint32_t v) const noexcept;
+  BddEdge GetHigh(const BddEdge f, const uint32_t v) const noexcept;
+
+  // return the number of nodes of f / of several functions, shared nodes counted once (including the constant)
+  uint64_t GetNodeNum(const BddEdge f) const;
+  uint64_t GetNodeNum(const std::vector<BddEdge>& roots) const;
+
+  // return the probability of f being 1 if variable v is 1 with probability var_prob[v]
+  // (0.5 for variables past the end of var_prob)
+  double GetProbability(const BddEdge f, const std::vector<double>& var_prob = {}) const;
+
+  // return the number of assignments to the first var_num variables satisfying f (f must not depend on others)
+  double CountSat(const BddEdge f, const uint32_t var_num) const;
+
+  // return one assignment satisfying f: per variable 0, 1 or -1 (don't care); empty if f is 0
+  std::vector<int8_t> PickSat(const BddEdge f) const;
+
+  // return the counters / the bytes held by the manager
+  BddStats GetStats() const noexcept;
+  uint64_t GetByteNum() const noexcept;
+
+ private:
+  // one node: var ? high : low, chained in its unique table bucket
+  struct Node {
+    uint32_t var;     // level of the node (UINT32_MAX: constant, UINT32_MAX - 1: free)
+    BddEdge low;      // function for var = 0
+    BddEdge high;     // function for var = 1, never complemented
+    uint32_t next;    // next node of the bucket / of the free list
+  };
+
+  // one computed table entry: ite(f, g, h) = result
+  struct CacheEntry {
+    BddEdge f, g, h, result;
+  };
+
+  // return the node var ? high : low, reduced & normalized
+  BddEdge make_node(const uint32_t var, const BddEdge low, const BddEdge high);
+
+  // If-Then-Else / Apply() without collection
+  BddEdge ite(BddEdge f, BddEdge g, BddEdge h);
+  BddEdge apply(const GateKind kind, const BddEdge* const fanin, const uint32_t count, const uint64_t table);
+
+  // LUT by Shannon expansion over inputs [k, count), bits of table from offset on
+  BddEdge apply_lut(const BddEdge* const fanin, const uint32_t k, const uint32_t count,
+      const uint64_t table, const uint32_t offset);
+
+  // collect if due, keeping the operands alive
+  void maybe_collect(const BddEdge* const keep, const uint32_t count);
+
+  // rebuild the buckets for the current node count
+  void rehash();
+
+ private:
+  std::vector<Node> nodes;              // node store, index 0 is the constant 1
+  std::vector<uint32_t> refs;           // external references per node
+  std::vector<uint32_t> buckets;        // unique table: first node of each chain (UINT32_MAX: empty)
+  std::vector<CacheEntry> cache;        // computed table
+  uint32_t free_list;                   // first free node (UINT32_MAX: none)
+  uint32_t node_limit;                  // most live nodes allowed
+  uint64_t gc_threshold;                // live nodes that trigger the next collection
+  uint32_t var_num;                     // highest variable used + 1
+  BddStats stats;                       // counters
+};
+
+// variable ordering heuristics for the sources of a netlist
+enum class BddOrder : uint8_t {
+  Input = 0,    // sources in order: primary inputs, then register outputs
+  DepthFirst    // order of first visit by a depth-first search through the fanin, shallowest outputs first
+                // (keeps the inputs of a cone together, e.g. interleaves the operands of an adder)
+};
+
+// return the variable of every source of a netlist (primary inputs, then register outputs)
+std::vector<uint32_t> ComputeBddOrder(const Netlist& netlist, const BddOrder order);
+
+// outcome of a symbolic equivalence check
+struct BddEquivalence {
+  bool equivalent;              // every output pair has the same BDD
+  uint32_t output;              // first output that differs, if not equivalent
+  std::vector<int8_t> input;    // per source of the first netlist: 0, 1 or -1 (any) telling them apart
+};
+
+// BddSim Class
+// Symbolic evaluation of a levelized netlist: every source (primary input or
+// register output) becomes a BDD variable and every gate is applied to the BDDs
+// of its inputs in program order, so each net ends up holding its function of
+// the sources. Unlike exhaustive enumeration the cost follows the BDD sizes,
+// not 2^inputs, which makes equivalence proofs and exact signal probabilities
+// possible on wide cones (given a fitting variable order). Internal nets may
+// be released as soon as they are read for the last time, so that garbage
+// collection keeps only the BDDs still needed. Several engines may share a
+// manager, which is required to compare them.
+class BddSim {
+ public:
+  // constructor (builds every net; var_of_source empty -> ComputeBddOrder(DepthFirst); keep_internal false ->
+  // the BDD of a net that is no output, register input or monitored gate output is released after its last reader)
+  BddSim(const Netlist& TargetNetlist, BddManager& Manager, const std::vector<uint32_t>& var_of_source = {},
+      const bool keep_internal = true);
+
+  // not copyable, holds references in the manager
+  BddSim(const BddSim&) = delete;
+  BddSim& operator=(const BddSim&) = delete;
+
+  // destructor (releases the BDDs of the nets)
+  ~BddSim();
+
+  // return the variable of every source
+  const std::vector<uint32_t>& GetVarOfSource() const noexcept;
+
+  // return the BDD of a net (throws for released internal nets)
+  BddEdge GetNet(const uint32_t net) const;
+
+  // return the probability of a net being 1 (source_prob per source, 0.5 if empty)
+  double GetProbability(const uint32_t net, const std::vector<double>& source_prob = {}) const;
+
+  // return the number of nodes of the BDDs of all primary outputs (shared nodes counted once)
+  uint64_t GetOutputNodeNum() const;
+
+  // compare the primary outputs with those of another engine on the same manager (paired in order);
+  // both netlists need the same numbers of inputs, outputs & registers and both engines the same
+  // var_of_source, i.e. source s is the same variable on both sides (throws otherwise)
+  BddEquivalence CheckEquivalence(const BddSim& other) const;
+
+ private:
+  const Netlist* pNetlist;              // compiled circuit
+  BddManager* pManager;                 // owner of the BDDs
+  std::vector<uint32_t> var_of_source;  // source -> variable
+  std::vector<BddEdge> net_bdd;         // net -> its BDD (referenced while held)
+  std::vector<uint8_t> held;            // net -> 1 while its BDD is referenced
+};
+
+}
+
+#endif  // C_BDD_H
@@ -0,0 +1,272 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// includes for this file
+#include "c_bitsim.h"
+#include <stdexcept>
+#include <cassert>
+
+// runtime dispatch is only available for GCC-compatible x86 compilers
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define CIM_X86_DISPATCH 1
+#else
+#define CIM_X86_DISPATCH 0
+#endif
+
+// using namespace for this project
+using namespace Cim;
+
+namespace {
+
+// evaluate instructions on W-word nets, W is a constant so the lane loops vectorize
+template <uint32_t W>
+CIM_ALWAYS_INLINE void evaluate_block(const Instruction* program, const uint32_t count,
+    const uint32_t* fanin, const uint64_t* luts, uint64_t* words) {
+  for (uint32_t g = 0; g < count; g++) {
+    const Instruction& ins = program[g];
+    const uint32_t* in = fanin + ins.fanin_begin;
+    if (ins.op == GateKind::LUT) {
+      // multiplexer tree per word
+      for (uint32_t l = 0; l < W; l++) {
+        words[static_cast<size_t>(ins.out_net) * W + l] = EvaluateLut<uint64_t>(
+            [in, words, l](const uint32_t k) { return words[static_cast<size_t>(in[k]) * W + l]; },
+            ins.fanin_count, luts[ins.lut]);
+      }
+      continue;
+    }
+    const uint32_t* const end = in + ins.fanin_count;
+    uint64_t acc[W];
+    const uint64_t* src = words + static_cast<size_t>(*in) * W;
+    for (uint32_t l = 0; l < W; l++) {
+      acc[l] = src[l];
+    }
+    ++in;
+    switch (ins.op) {
+      case GateKind::AND:
+      case GateKind::NAND:
+      case GateKind::NOT:
+        for (; in != end; ++in) {
+          src = words + static_cast<size_t>(*in) * W;
+          for (uint32_t l = 0; l < W; l++) {
+            acc[l] &= src[l];
+          }
+        }
+        break;
+      case GateKind::OR:
+      case GateKind::NOR:
+        for (; in != end; ++in) {
+          src = words + static_cast<size_t>(*in) * W;
+          for (uint32_t l = 0; l < W; l++) {
+            acc[l] |= src[l];
+          }
+        }
+        break;
+      case GateKind::XOR:
+      case GateKind::XNOR:
+        // n-ary XOR is the parity of the inputs (see Gate::XOR) -> bitwise ^
+        for (; in != end; ++in) {
+          src = words + static_cast<size_t>(*in) * W;
+          for (uint32_t l = 0; l < W; l++) {
+            acc[l] ^= src[l];
+          }
+        }
+        break;
+      default:
+        // LUT gates take the path above, sequential kinds never reach the program
+        break;
+    }
+    const uint64_t invert = (ins.op == GateKind::NOT || ins.op == GateKind::NAND ||
+        ins.op == GateKind::NOR || ins.op == GateKind::XNOR) ? ~uint64_t{0} : 0;
+    uint64_t* const dst = words + static_cast<size_t>(ins.out_net) * W;
+    for (uint32_t l = 0; l < W; l++) {
+      dst[l] = acc[l] ^ invert;
+    }
+  }
+}
+
+// portable kernels
+template <uint32_t W>
+void evaluate_scalar(const Instruction* program, const uint32_t count, const uint32_t* fanin,
+    const uint64_t* luts, uint64_t* words) {
+  evaluate_block<W>(program, count, fanin, luts, words);
+}
+
+#if CIM_X86_DISPATCH
+// same loops, compiled for wider vector units
+template <uint32_t W>
+__attribute__((target("avx2")))
+void evaluate_avx2(const Instruction* program, const uint32_t count, const uint32_t* fanin,
+    const uint64_t* luts, uint64_t* words) {
+  evaluate_block<W>(program, count, fanin, luts, words);
+}
+
+template <uint32_t W>
+__attribute__((target("avx512f")))
+void evaluate_avx512(const Instruction* program, const uint32_t count, const uint32_t* fanin,
+    const uint64_t* luts, uint64_t* words) {
+  evaluate_block<W>(program, count, fanin, luts, words);
+}
+#endif
+
+// xorshift64* generator for Randomize()
+uint64_t next_random(uint64_t& state) {
+  state ^= state >> 12;
+  state ^= state << 25;
+  state ^= state >> 27;
+  return state * 0x2545F4914F6CDD1DULL;
+}
+
+}
+
+// constructor
+BitParallelSim::BitParallelSim(const Netlist& TargetNetlist, const uint32_t patterns) :
+  BitParallelSim(TargetNetlist, patterns, DetectIsa()) {
+}
+
+// constructor (force a kernel)
+BitParallelSim::BitParallelSim(const Netlist& TargetNetlist, const uint32_t patterns, const Isa isa) :
+  pNetlist{&TargetNetlist}, word_num{patterns / 64}, kernel_isa{Isa::Scalar}, kernel{nullptr}, words() {
+  if (!TargetNetlist.IsLevelized()) {
+    throw std::logic_error("ERR: NETLIST MUST BE LEVELIZED! \n");
+  }
+  if (patterns != 64 && patterns != 256 && patterns != 512) {
+    throw std::invalid_argument("ERR: PATTERN NUMBER MUST BE 64, 256 OR 512! \n");
+  }
+  words.assign(static_cast<size_t>(TargetNetlist.GetNetNum()) * word_num, 0);
+  select(isa);
+}
+
+// return the best kernel the running CPU supports
+BitParallelSim::Isa BitParallelSim::DetectIsa() noexcept {
+#if CIM_X86_DISPATCH
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return Isa::AVX512;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return Isa::AVX2;
+  }
+#endif
+  return Isa::Scalar;
+}
+
+// pick a kernel for the pattern width and instruction set
+void BitParallelSim::select(Isa isa) {
+  // never run a kernel the CPU cannot execute
+  const Isa best = DetectIsa();
+  if (static_cast<uint8_t>(isa) > static_cast<uint8_t>(best)) {
+    isa = best;
+  }
+  // a single word gains nothing from vector units
+  if (word_num == 1) {
+    isa = Isa::Scalar;
+  }
+#if CIM_X86_DISPATCH
+  if (isa == Isa::AVX512) {
+    kernel = (word_num == 4) ? &evaluate_avx512<4> : &evaluate_avx512<8>;
+    kernel_isa = isa;
+    return;
+  }
+  if (isa == Isa::AVX2) {
+    kernel = (word_num == 4) ? &evaluate_avx2<4> : &evaluate_avx2<8>;
+    kernel_isa = isa;
+    return;
+  }
+#endif
+  switch (word_num) {
+    case 1:  kernel = &evaluate_scalar<1>; break;
+    case 4:  kernel = &evaluate_scalar<4>; break;
+    default: kernel = &evaluate_scalar<8>; break;
+  }
+  kernel_isa = Isa::Scalar;
+}
+
+// return the number of patterns
+uint32_t BitParallelSim::GetPatternNum() const noexcept {
+  return this->word_num * 64;
+}
+
+// return the number of 64-bit words per net
+uint32_t BitParallelSim::GetWordNum() const noexcept {
+  return this->word_num;
+}
+
+// return the selected kernel
+BitParallelSim::Isa BitParallelSim::GetIsa() const noexcept {
+  return this->kernel_isa;
+}
+
+// return the words of a net
+const uint64_t* BitParallelSim::GetWords(const uint32_t net) const {
+  if (net >= pNetlist->GetNetNum()) {
+    throw std::out_of_range("ERR: NET DOES NOT EXIST! \n");
+  }
+  return words.data() + static_cast<size_t>(net) * word_num;
+}
+
+// set all patterns of a primary input net
+void BitParallelSim::SetInputWords(const uint32_t net, const uint64_t* const new_words) {
+  if (pNetlist->GetNetDriver(net) != UINT32_MAX) {
+    throw std::invalid_argument("ERR: NET IS NOT A PRIMARY INPUT! \n");
+  }
+  for (uint32_t l = 0; l < word_num; l++) {
+    words[static_cast<size_t>(net) * word_num + l] = new_words[l];
+  }
+}
+
+// set one pattern of a net
+void BitParallelSim::SetInput(const uint32_t net, const uint32_t pattern, const bool new_state) {
+  if (pNetlist->GetNetDriver(net) != UINT32_MAX) {
+    throw std::invalid_argument("ERR: NET IS NOT A PRIMARY INPUT! \n");
+  }
+  if (pattern >= GetPatternNum()) {
+    throw std::out_of_range("ERR: PATTERN DOES NOT EXIST! \n");
+  }
+  uint64_t& word = words[static_cast<size_t>(net) * word_num + pattern / 64];
+  const uint64_t bit = uint64_t{1} << (pattern % 64);
+  word = new_state ? (word | bit) : (word & ~bit);
+}
+
+// return one pattern of a net
+bool BitParallelSim::GetState(const uint32_t net, const uint32_t pattern) const {
+  if (pattern >= GetPatternNum()) {
+    throw std::out_of_range("ERR: PATTERN DOES NOT EXIST! \n");
+  }
+  return (GetWords(net)[pattern / 64] >> (pattern % 64)) & 1;
+}
+
+// fill every primary input with pseudo random patterns
+void BitParallelSim::Randomize(uint64_t seed) {
+  // xorshift state must not be zero
+  seed = (seed == 0) ? 0x9E3779B97F4A7C15ULL : seed;
+  for (const uint32_t each_net : pNetlist->GetInputs()) {
+    for (uint32_t l = 0; l < word_num; l++) {
+      words[static_cast<size_t>(each_net) * word_num + l] = next_random(seed);
+    }
+  }
+}
+
+// evaluate all patterns once
+void BitParallelSim::Evaluate() noexcept {
+  const ArrayView<Instruction> program = pNetlist->GetProgram();
+  kernel(program.data(), program.size(), pNetlist->GetFanin().data(), pNetlist->GetLuts().data(), words.data());
+}
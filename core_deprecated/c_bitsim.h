@@ -0,0 +1,102 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// include guard for this header
+#ifndef C_BITSIM_H
+#define C_BITSIM_H
+
+// includes for this header
+#include <vector>         // std::vector
+#include <cstdint>        // standard int types
+#include "c_netlist.h"    // class Netlist
+
+// namespace for entire project
+namespace Cim {
+
+// BitParallelSim Class
+// Multi-pattern simulation engine: every net holds 64, 256 or 512 independent
+// patterns (one bit each) and a levelized pass evaluates all of them with plain
+// bitwise operations. The kernel is picked at runtime from the CPU features
+// (AVX-512 / AVX2 builds of the same loop) with a portable scalar fallback.
+class BitParallelSim {
+ public:
+  // instruction set the evaluation kernel was selected for
+  enum class Isa : uint8_t {
+    Scalar = 0,
+    AVX2,
+    AVX512
+  };
+
+  // constructor (patterns must be 64, 256 or 512)
+  explicit BitParallelSim(const Netlist& TargetNetlist, const uint32_t patterns = 64);
+
+  // constructor (force a kernel, falls back to scalar if the CPU lacks it)
+  BitParallelSim(const Netlist& TargetNetlist, const uint32_t patterns, const Isa isa);
+
+  // destructor
+  ~BitParallelSim() { /* DN */ }
+
+  // return the number of patterns / 64-bit words per net
+  uint32_t GetPatternNum() const noexcept;
+  uint32_t GetWordNum() const noexcept;
+
+  // return the selected kernel
+  Isa GetIsa() const noexcept;
+
+  // return the words of a net (GetWordNum() of them)
+  const uint64_t* GetWords(const uint32_t net) const;
+
+  // set all patterns of a primary input net
+  void SetInputWords(const uint32_t net, const uint64_t* const words);
+
+  // set / return one pattern of a net
+  void SetInput(const uint32_t net, const uint32_t pattern, const bool new_state);
+  bool GetState(const uint32_t net, const uint32_t pattern) const;
+
+  // fill every primary input with pseudo random patterns
+  void Randomize(uint64_t seed);
+
+  // evaluate all patterns once
+  void Evaluate() noexcept;
+
+  // return the best kernel the running CPU supports
+  static Isa DetectIsa() noexcept;
+
+ private:
+  // kernel signature: evaluate count instructions on word_num-wide nets
+  typedef void (*Kernel)(const Instruction* program, const uint32_t count, const uint32_t* fanin,
+      const uint64_t* luts, uint64_t* words);
+
+  // pick a kernel for the pattern width and instruction set
+  void select(const Isa isa);
+
+ private:
+  const Netlist* pNetlist;      // compiled circuit
+  uint32_t word_num;            // 64-bit words per net
+  Isa kernel_isa;               // instruction set of kernel
+  Kernel kernel;                // evaluation loop
+  std::vector<uint64_t> words;  // net n owns words[n * word_num .. (n + 1) * word_num)
+};
+
+}
+
+#endif  // C_BITSIM_H
@@ -0,0 +1,393 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// includes for this file
+#include "c_cache.h"
+#include <stdexcept>
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+#include <random>
+#include <filesystem>     // std::filesystem::create_directories, rename
+#include <type_traits>    // std::is_trivially_copyable
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>        // open
+#include <sys/mman.h>     // mmap, munmap
+#include <sys/stat.h>     // fstat
+#include <unistd.h>       // close
+#define CIM_HAS_MMAP 1
+#endif
+
+// using namespace for this project
+using namespace Cim;
+
+// helpers private to this file
+namespace {
+
+// file layout: FileHeader, FileSection[kSectionNum], then every non-empty section aligned to kSectionAlign
+constexpr char kMagic[8] = {'C', 'I', 'M', 'N', 'E', 'T', 'L', 'S'};
+constexpr uint32_t kByteOrder = 0x01020304;
+constexpr uint32_t kSectionNum = 20;
+constexpr uint64_t kSectionAlign = 64;
+
+struct FileHeader {
+  char magic[8];          // kMagic
+  uint32_t version;       // kNetlistFileVersion
+  uint32_t byte_order;    // kByteOrder as written by the producer
+  uint64_t source_hash;   // hash of the source the netlist was built from
+  uint64_t file_size;     // size of the whole file
+  uint64_t checksum;      // hash of the section table
+  uint32_t net_num;       // number of nets
+  uint32_t section_num;   // kSectionNum
+};
+
+struct FileSection {
+  uint64_t offset;        // begin of the section in the file
+  uint64_t count;         // number of elements
+  uint64_t hash;          // hash of the elements
+  uint32_t element_size;  // size of one element
+  uint32_t reserved;      // zero
+};
+
+static_assert(std::is_trivially_copyable<Instruction>::value && sizeof(Instruction) == 16,
+    "cache files store Instruction as is");
+static_assert(sizeof(SymbolTable::Slot) == 8, "cache files store SymbolTable::Slot as is");
+static_assert(sizeof(FileHeader) == 48 && sizeof(FileSection) == 32, "cache file header layout");
+
+// one array of the image as raw bytes
+struct RawArray {
+  const void* data;
+  uint64_t count;
+  uint32_t element_size;
+};
+
+template <typename T>
+RawArray raw(const ArrayView<T>& view) {
+  return RawArray{view.data(), view.size(), sizeof(T)};
+}
+
+// list the arrays of an image in file order
+void list_arrays(const NetlistImage& image, RawArray* const arrays) {
+  const RawArray all[kSectionNum] = {
+    raw(image.inputs), raw(image.outputs), raw(image.program), raw(image.fanin), raw(image.luts),
+    raw(image.level_offsets), raw(image.net_driver), raw(image.fanout_offsets), raw(image.fanout),
+    raw(image.name_pool), raw(image.name_offsets), raw(image.name_slots), raw(image.gate_name),
+    raw(image.out_name), raw(image.pin_name), raw(image.net_name), raw(image.monitored),
+    raw(image.gate_by_name), raw(image.net_by_name), raw(image.registers)
+  };
+  std::copy(all, all + kSectionNum, arrays);
+}
+
+// point the arrays of an image into a mapped file
+template <typename T>
+void bind(ArrayView<T>& view, const char* const base, const FileSection& section) {
+  view = ArrayView<T>(reinterpret_cast<const T*>(base + section.offset), section.count);
+}
+
+void bind_arrays(NetlistImage& image, const char* const base, const FileSection* const s) {
+  bind(image.inputs, base, s[0]);
+  bind(image.outputs, base, s[1]);
+  bind(image.program, base, s[2]);
+  bind(image.fanin, base, s[3]);
+  bind(image.luts, base, s[4]);
+  bind(image.level_offsets, base, s[5]);
+  bind(image.net_driver, base, s[6]);
+  bind(image.fanout_offsets, base, s[7]);
+  bind(image.fanout, base, s[8]);
+  bind(image.name_pool, base, s[9]);
+  bind(image.name_offsets, base, s[10]);
+  bind(image.name_slots, base, s[11]);
+  bind(image.gate_name, base, s[12]);
+  bind(image.out_name, base, s[13]);
+  bind(image.pin_name, base, s[14]);
+  bind(image.net_name, base, s[15]);
+  bind(image.monitored, base, s[16]);
+  bind(image.gate_by_name, base, s[17]);
+  bind(image.net_by_name, base, s[18]);
+  bind(image.registers, base, s[19]);
+}
+
+// return the hash of a header with its checksum field cleared, chained with the section table
+uint64_t table_checksum(FileHeader header, const FileSection* const sections) {
+  header.checksum = 0;
+  return HashBytes(sections, sizeof(FileSection) * kSectionNum, HashBytes(&header, sizeof(header)));
+}
+
+// map (or read) a whole file, the returned owner releases it
+std::shared_ptr<const void> load_file(const std::string& path, uint64_t& size) {
+#if defined(CIM_HAS_MMAP)
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("ERR: CANNOT OPEN NETLIST FILE! \n");
+  }
+  struct stat info;
+  if (::fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(FileHeader))) {
+    ::close(fd);
+    throw std::runtime_error("ERR: NETLIST FILE TOO SHORT! \n");
+  }
+  size = static_cast<uint64_t>(info.st_size);
+  void* const base = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (base == MAP_FAILED) {
+    throw std::runtime_error("ERR: CANNOT MAP NETLIST FILE! \n");
+  }
+  const size_t length = size;
+  return std::shared_ptr<const void>(base, [length](const void* p) { ::munmap(const_cast<void*>(p), length); });
+#else
+  // no mmap -> one read into 8-byte aligned memory
+  std::ifstream in(path, std::ios::binary | std::ios::ate);
+  if (!in) {
+    throw std::runtime_error("ERR: CANNOT OPEN NETLIST FILE! \n");
+  }
+  size = static_cast<uint64_t>(in.tellg());
+  auto buffer = std::make_shared<std::vector<uint64_t>>((size + 7) / 8);
+  in.seekg(0);
+  in.read(reinterpret_cast<char*>(buffer->data()), static_cast<std::streamsize>(size));
+  if (size < sizeof(FileHeader) || !in) {
+    throw std::runtime_error("ERR: NETLIST FILE TOO SHORT! \n");
+  }
+  return std::shared_ptr<const void>(buffer, buffer->data());
+#endif
+}
+
+// mixing step of HashBytes()
+inline uint64_t mix(uint64_t x) noexcept {
+  x *= 0x9E3779B97F4A7C15ull;
+  return x ^ (x >> 29);
+}
+
+}
+
+// return a 64-bit hash of a byte range
+uint64_t Cim::HashBytes(const void* const data, const size_t size, const uint64_t seed) noexcept {
+  const unsigned char* const bytes = static_cast<const unsigned char*>(data);
+  // four independent lanes over 32-byte blocks
+  uint64_t lane[4] = {seed ^ 0x243F6A8885A308D3ull, seed ^ 0x13198A2E03707344ull,
+                      seed ^ 0xA4093822299F31D0ull, seed ^ 0x082EFA98EC4E6C89ull};
+  size_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    for (uint32_t k = 0; k < 4; k++) {
+      uint64_t word;
+      std::memcpy(&word, bytes + i + 8 * k, 8);
+      lane[k] = mix(lane[k] ^ word);
+    }
+  }
+  uint64_t hash = mix(seed ^ size);
+  for (uint32_t k = 0; k < 4; k++) {
+    hash = mix(hash ^ lane[k]);
+  }
+  for (; i + 8 <= size; i += 8) {
+    uint64_t word;
+    std::memcpy(&word, bytes + i, 8);
+    hash = mix(hash ^ word);
+  }
+  if (i < size) {
+    uint64_t word = 0;
+    std::memcpy(&word, bytes + i, size - i);
+    hash = mix(hash ^ word);
+  }
+  return mix(hash ^ (hash >> 32));
+}
+
+// return the hash of the contents of a file
+uint64_t Cim::HashFile(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    throw std::runtime_error("ERR: CANNOT OPEN FILE! \n");
+  }
+  std::vector<char> block(size_t{1} << 20);
+  uint64_t hash = 0;
+  do {
+    in.read(block.data(), static_cast<std::streamsize>(block.size()));
+    hash = HashBytes(block.data(), static_cast<size_t>(in.gcount()), hash);
+  } while (in);
+  return hash;
+}
+
+// write a levelized netlist as a cache file
+void Cim::SaveNetlist(const Netlist& netlist, const std::string& path, const uint64_t source_hash) {
+  // 1. layout
+  const NetlistImage image = netlist.GetImage();
+  RawArray arrays[kSectionNum];
+  list_arrays(image, arrays);
+  FileSection sections[kSectionNum];
+  uint64_t offset = sizeof(FileHeader) + sizeof(sections);
+  for (uint32_t s = 0; s < kSectionNum; s++) {
+    // empty sections take no padding -> the file ends with hashed bytes
+    if (arrays[s].count != 0) {
+      offset = (offset + kSectionAlign - 1) / kSectionAlign * kSectionAlign;
+    }
+    const uint64_t bytes = arrays[s].count * arrays[s].element_size;
+    sections[s] = FileSection{offset, arrays[s].count, HashBytes(arrays[s].data, bytes), arrays[s].element_size, 0};
+    offset += bytes;
+  }
+  FileHeader header;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kNetlistFileVersion;
+  header.byte_order = kByteOrder;
+  header.source_hash = source_hash;
+  header.file_size = offset;
+  header.net_num = netlist.GetNetNum();
+  header.section_num = kSectionNum;
+  header.checksum = table_checksum(header, sections);
+
+  // 2. write to a private temporary file, then rename it into place
+  std::random_device seed;
+  const std::string temp_path = path + ".tmp" + std::to_string(seed());
+  {
+    std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+      throw std::runtime_error("ERR: CANNOT CREATE NETLIST FILE! \n");
+    }
+    static const char padding[kSectionAlign] = {};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(sections), sizeof(sections));
+    uint64_t position = sizeof(header) + sizeof(sections);
+    for (uint32_t s = 0; s < kSectionNum; s++) {
+      out.write(padding, static_cast<std::streamsize>(sections[s].offset - position));
+      const uint64_t bytes = arrays[s].count * arrays[s].element_size;
+      out.write(static_cast<const char*>(arrays[s].data), static_cast<std::streamsize>(bytes));
+      position = sections[s].offset + bytes;
+    }
+    if (!out.flush()) {
+      out.close();
+      std::remove(temp_path.c_str());
+      throw std::runtime_error("ERR: CANNOT WRITE NETLIST FILE! \n");
+    }
+  }
+  std::error_code error;
+  std::filesystem::rename(temp_path, path, error);
+  if (error) {
+    std::remove(temp_path.c_str());
+    throw std::runtime_error("ERR: CANNOT WRITE NETLIST FILE! \n");
+  }
+}
+
+// map a cache file
+Netlist Cim::MapNetlist(const std::string& path, const bool verify, uint64_t* const source_hash) {
+  uint64_t size = 0;
+  std::shared_ptr<const void> owner = load_file(path, size);
+  const char* const base = static_cast<const char*>(owner.get());
+
+  // 1. header & section table
+  FileHeader header;
+  std::memcpy(&header, base, sizeof(header));
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+    throw std::runtime_error("ERR: NOT A NETLIST FILE! \n");
+  }
+  if (header.version != kNetlistFileVersion || header.byte_order != kByteOrder) {
+    throw std::runtime_error("ERR: NETLIST FILE VERSION MISMATCH! \n");
+  }
+  if (header.section_num != kSectionNum || header.file_size != size ||
+      size < sizeof(FileHeader) + sizeof(FileSection) * kSectionNum) {
+    throw std::runtime_error("ERR: NETLIST FILE DAMAGED! \n");
+  }
+  const FileSection* const sections = reinterpret_cast<const FileSection*>(base + sizeof(FileHeader));
+  if (table_checksum(header, sections) != header.checksum) {
+    throw std::runtime_error("ERR: NETLIST FILE DAMAGED! \n");
+  }
+  RawArray expected[kSectionNum];
+  list_arrays(NetlistImage(), expected);
+  for (uint32_t s = 0; s < kSectionNum; s++) {
+    const FileSection& section = sections[s];
+    if (section.element_size != expected[s].element_size ||
+        (section.count != 0 && section.offset % kSectionAlign != 0) ||
+        section.offset > size || section.count > (size - section.offset) / section.element_size) {
+      throw std::runtime_error("ERR: NETLIST FILE DAMAGED! \n");
+    }
+  }
+
+  // 2. contents
+  if (verify) {
+    for (uint32_t s = 0; s < kSectionNum; s++) {
+      const FileSection& section = sections[s];
+      if (HashBytes(base + section.offset, section.count * section.element_size) != section.hash) {
+        throw std::runtime_error("ERR: NETLIST FILE DAMAGED! \n");
+      }
+    }
+  }
+
+  // 3. the netlist borrows the mapping
+  NetlistImage image;
+  image.net_num = header.net_num;
+  bind_arrays(image, base, sections);
+  image.owner = std::move(owner);
+  if (source_hash != nullptr) {
+    *source_hash = header.source_hash;
+  }
+  return Netlist(std::move(image));
+}
+
+// constructor
+NetlistCache::NetlistCache(const std::string& Directory, const bool verify) :
+  directory{Directory}, verify{verify}, hit_num{0}, miss_num{0} {
+}
+
+// return the netlist of a source file, from the cache if possible
+Netlist NetlistCache::Load(const std::string& source_path, NetlistFormat format) {
+  if (format == NetlistFormat::Auto) {
+    format = GetNetlistFormat(source_path);
+  }
+  // key = contents + format + layout version
+  const uint64_t tag[2] = {static_cast<uint64_t>(format), kNetlistFileVersion};
+  const uint64_t key = HashBytes(tag, sizeof(tag), HashFile(source_path));
+  const std::string entry_path = GetEntryPath(key);
+
+  // hit
+  if (std::filesystem::exists(entry_path)) {
+    try {
+      uint64_t stored_key = 0;
+      Netlist netlist = MapNetlist(entry_path, verify, &stored_key);
+      if (stored_key == key) {
+        hit_num++;
+        return netlist;
+      }
+    } catch (const std::exception&) {
+      // damaged or outdated entry -> rebuild it
+    }
+  }
+
+  // miss
+  miss_num++;
+  Netlist netlist = ImportNetlist(source_path, format);
+  std::filesystem::create_directories(directory);
+  SaveNetlist(netlist, entry_path, key);
+  return netlist;
+}
+
+// return the cache file of a source hash
+std::string NetlistCache::GetEntryPath(const uint64_t source_hash) const {
+  char name[24];
+  std::snprintf(name, sizeof(name), "%016llx.cnl", static_cast<unsigned long long>(source_hash));
+  return (std::filesystem::path(directory) / name).string();
+}
+
+// return the number of loads served from the cache
+uint32_t NetlistCache::GetHitNum() const noexcept {
+  return this->hit_num;
+}
+
+// return the number of loads added to the cache
+uint32_t NetlistCache::GetMissNum() const noexcept {
+  return this->miss_num;
+}
@@ -0,0 +1,85 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// include guard for this header
+#ifndef C_CACHE_H
+#define C_CACHE_H
+
+// includes for this header
+#include <string>         // std::string
+#include <cstdint>        // standard int types
+#include "c_netlist.h"    // class Netlist
+#include "c_import.h"     // NetlistFormat
+
+// namespace for entire project
+namespace Cim {
+
+// version of the cache file layout (bump on any change to it or to Instruction)
+constexpr uint32_t kNetlistFileVersion = 2;
+
+// return a 64-bit hash of a byte range (fast, not cryptographic)
+uint64_t HashBytes(const void* const data, const size_t size, const uint64_t seed = 0) noexcept;
+
+// return the hash of the contents of a file
+uint64_t HashFile(const std::string& path);
+
+// write a levelized netlist as a cache file, tagged with the hash of its source
+void SaveNetlist(const Netlist& netlist, const std::string& path, const uint64_t source_hash = 0);
+
+// map a cache file; the netlist reads its arrays straight from the mapping.
+// verify = false skips hashing the arrays (the header is always checked)
+Netlist MapNetlist(const std::string& path, const bool verify = true, uint64_t* const source_hash = nullptr);
+
+// NetlistCache Class
+// Directory of compiled netlists keyed on the hash of their source file. A hit
+// maps the cached file instead of parsing and levelizing the source; a miss
+// imports the source and stores the result for the next run. Entries are
+// written to a temporary file and renamed, so concurrent runs never see a
+// partial entry.
+class NetlistCache {
+ public:
+  // constructor (directory is created on the first miss)
+  explicit NetlistCache(const std::string& Directory, const bool verify = true);
+
+  // destructor
+  ~NetlistCache() { /* DN */ }
+
+  // return the netlist of a source file, from the cache if possible
+  Netlist Load(const std::string& source_path, NetlistFormat format = NetlistFormat::Auto);
+
+  // return the cache file of a source hash
+  std::string GetEntryPath(const uint64_t source_hash) const;
+
+  // return the number of loads served from / added to the cache
+  uint32_t GetHitNum() const noexcept;
+  uint32_t GetMissNum() const noexcept;
+
+ private:
+  std::string directory;    // cache directory
+  bool verify;              // hash the arrays of mapped entries
+  uint32_t hit_num;         // loads served from the cache
+  uint32_t miss_num;        // loads added to the cache
+};
+
+}
+
+#endif  // C_CACHE_H
@@ -29,12 +29,15 @@
 #include <vector>     // std::vector
 #include <utility>    // std::pair
 #include <cstdint>    // standard int types
+#include <memory_resource>  // std::pmr::vector
 
 #include "c_structs.h"  // useful structure definitions
 
 // namespace for entire project
 namespace Cim {
 
+class PinRange;
+
 // Interface Component class (Gates & Device & Simulation)
 class Component {
  public:
@@ -77,6 +80,12 @@ class Component {
   // return component type
   virtual std::string GetType() const noexcept = 0;
 
+  // return component kind (throws for devices, which have no single kind)
+  virtual GateKind GetKind() const = 0;
+
+  // return the truth table of a LUT component (0 for other kinds, throws for devices)
+  virtual uint64_t GetTruthTable() const = 0;
+
   // return nesting level
   virtual uint32_t GetNestingLvl() const noexcept = 0;
 
@@ -86,14 +95,20 @@ class Component {
   // return if state changed after the last evaluation
   virtual bool IsPinStateChanged(const uint32_t pin_idx) const = 0;
 
+  // mark a pin change as consumed, without touching any state
+  virtual void ClearPinStateChanged(const uint32_t pin_idx) = 0;
+
   // return pin name
   virtual std::string GetPinName(const uint32_t pin_idx) const = 0;
 
-  // return list of input pins
-  virtual const std::vector<Pin> GetInPins() const = 0;
+  // return a non-owning view of the input pins
+  virtual PinRange GetInPins() const noexcept = 0;
 
-  // return list of output pins
-  virtual const std::vector<Pin> GetOutPins() const = 0;
+  // return a non-owning view of the output pins
+  virtual PinRange GetOutPins() const noexcept = 0;
+
+  // return the states of 64 input pins starting at pin (64 * word), one bit per pin
+  virtual uint64_t GetInPinStates(const uint32_t word = 0) const noexcept = 0;
 
   // return the pin's direction
   virtual Pin::Dir GetPinDirection(const uint32_t pin_idx) const = 0;
@@ -102,9 +117,15 @@ class Component {
   // return pin index
   virtual uint32_t GetPinIndex(const std::string& pin_name) const = 0;
 
+  // resolve a pin name once, the handle replaces the name in later calls
+  virtual PinHandle ResolvePin(const std::string& pin_name) = 0;
+
   // return & modify the connection of that pin
-  virtual std::vector<Pin::Link>& GetPinConnection(const uint32_t pin_idx) = 0;
-  virtual std::vector<Pin::Link>& GetPinConnection(const std::string& pin_name) = 0;
+  virtual std::pmr::vector<Pin::Link>& GetPinConnection(const uint32_t pin_idx) = 0;
+  virtual std::pmr::vector<Pin::Link>& GetPinConnection(const std::string& pin_name) = 0;
+
+  // return the connection of that pin, read only
+  virtual const std::pmr::vector<Pin::Link>& GetPinConnection(const uint32_t pin_idx) const = 0;
 
   // return whether a pin exist
   virtual bool DoesPinExist(const std::string& pin_name) const = 0;
@@ -120,6 +141,62 @@ class Component {
   virtual void PrintOutPinStates() const noexcept = 0;
 };
 
+// non-owning reference to one pin of a component
+struct PinRef {
+  const Component*  component;  // owning component
+  uint32_t          index;      // local index of pin in component
+
+  // pin properties, forwarded to the component
+  inline bool GetState() const { return component->GetPinState(index); }
+  inline bool IsStateChanged() const { return component->IsPinStateChanged(index); }
+  inline std::string GetName() const { return component->GetPinName(index); }
+  inline Pin::Dir GetDirection() const { return component->GetPinDirection(index); }
+  inline bool IsConnected() const { return component->IsPinConnected(index); }
+};
+
+// non-owning view of consecutive pins [first, last) of a component
+class PinRange {
+ public:
+  // iterator yielding PinRef
+  class Iterator {
+   public:
+    inline Iterator(const Component* const comp, const uint32_t idx) noexcept : comp{comp}, idx{idx} {}
+    inline PinRef operator*() const noexcept { return PinRef{comp, idx}; }
+    inline Iterator& operator++() noexcept { ++idx; return *this; }
+    inline bool operator==(const Iterator& other) const noexcept { return idx == other.idx; }
+    inline bool operator!=(const Iterator& other) const noexcept { return idx != other.idx; }
+   private:
+    const Component* comp;
+    uint32_t idx;
+  };
+
+  // constructor
+  inline PinRange(const Component* const comp, const uint32_t first, const uint32_t last) noexcept :
+    comp{comp}, first{first}, last{last} {}
+
+  // range access
+  inline Iterator begin() const noexcept { return Iterator(comp, first); }
+  inline Iterator end() const noexcept { return Iterator(comp, last); }
+  inline uint32_t size() const noexcept { return last - first; }
+  inline bool empty() const noexcept { return last == first; }
+  inline PinRef operator[](const uint32_t i) const noexcept { return PinRef{comp, first + i}; }
+
+ private:
+  const Component* comp;  // viewed component
+  uint32_t first;         // first pin index
+  uint32_t last;          // one past the last pin index
+};
+
+// Set a resolved pin to new state
+inline void Set(const PinHandle& pin, const bool new_state) {
+  pin.component->Set(pin.index, new_state);
+}
+
+// return the state of a resolved pin
+inline bool GetPinState(const PinHandle& pin) {
+  return pin.component->GetPinState(pin.index);
+}
+
 }
 
 #endif  // C_COMPONENT_H
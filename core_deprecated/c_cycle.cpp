@@ -0,0 +1,182 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// includes for this file
+#include "c_cycle.h"
+#include <stdexcept>
+#include <algorithm>  // std::binary_search
+
+// using namespace for this project
+using namespace Cim;
+
+// constructor
+CycleSim::CycleSim(const Netlist& TargetNetlist) :
+  pNetlist{&TargetNetlist}, nets(TargetNetlist.GetNetNum(), 0), next(TargetNetlist.GetRegisterNum(), 0),
+  cycle_num{0} {
+  if (!TargetNetlist.IsLevelized()) {
+    throw std::logic_error("ERR: NETLIST MUST BE LEVELIZED! \n");
+  }
+  Reset();
+}
+
+// set a primary input net
+void CycleSim::SetInput(const uint32_t net, const bool new_state) {
+  // inputs are sorted, register outputs are not among them
+  const ArrayView<uint32_t> inputs = pNetlist->GetInputs();
+  if (!std::binary_search(inputs.begin(), inputs.end(), net)) {
+    throw std::invalid_argument("ERR: NET IS NOT A PRIMARY INPUT! \n");
+  }
+  nets[net] = new_state;
+}
+
+// set all primary inputs
+void CycleSim::SetInputs(const std::vector<bool>& input_vector) {
+  const ArrayView<uint32_t> inputs = pNetlist->GetInputs();
+  if (input_vector.size() != inputs.size()) {
+    throw std::invalid_argument("ERR: INPUT VECTOR SIZE MISMATCH! \n");
+  }
+  for (uint32_t i = 0; i < inputs.size(); i++) {
+    nets[inputs[i]] = input_vector[i];
+  }
+}
+
+// return the state of a net
+bool CycleSim::GetState(const uint32_t net) const {
+  return this->nets.at(net) != 0;
+}
+
+// return the state of every net
+const std::vector<uint8_t>& CycleSim::GetStates() const noexcept {
+  return this->nets;
+}
+
+// return the state stored in a register
+bool CycleSim::GetRegisterState(const uint32_t reg) const {
+  return nets[pNetlist->GetRegisters().at(reg).q_net] != 0;
+}
+
+// load the initial state into every register
+void CycleSim::Reset() noexcept {
+  for (const Register& each_reg : pNetlist->GetRegisters()) {
+    nets[each_reg.q_net] = each_reg.init;
+  }
+  cycle_num = 0;
+}
+
+// compute phase only
+void CycleSim::Evaluate() noexcept {
+  // register outputs are sources -> one pass in level order settles everything
+  const Instruction* ins = pNetlist->GetProgram().data();
+  const Instruction* const end = ins + pNetlist->GetProgram().size();
+  const uint32_t* const fanin = pNetlist->GetFanin().data();
+  const uint64_t* const luts = pNetlist->GetLuts().data();
+  uint8_t* const states = nets.data();
+  for (; ins != end; ++ins) {
+    states[ins->out_net] = EvaluateInstruction(*ins, fanin, luts, states);
+  }
+}
+
+// one clock edge
+void CycleSim::Clock() noexcept {
+  Evaluate();
+  const Register* const regs = pNetlist->GetRegisters().data();
+  const uint32_t reg_num = next.size();
+  uint8_t* const states = nets.data();
+  uint8_t* const sampled = next.data();
+  // 1. compute: sample every input before any output changes
+  for (uint32_t r = 0; r < reg_num; r++) {
+    const Register& reg = regs[r];
+    const bool closed = reg.kind == GateKind::LATCH && reg.ctrl_net != UINT32_MAX && states[reg.ctrl_net] == 0;
+    sampled[r] = closed ? states[reg.q_net] : states[reg.d_net];
+  }
+  // 2. commit
+  for (uint32_t r = 0; r < reg_num; r++) {
+    states[regs[r].q_net] = sampled[r];
+  }
+  cycle_num++;
+}
+
+// run clock edges with unchanged inputs
+void CycleSim::Run(const uint64_t edge_num) noexcept {
+  for (uint64_t c = 0; c < edge_num; c++) {
+    Clock();
+  }
+}
+
+// return the number of clock edges since the last Reset()
+uint64_t CycleSim::GetCycleNum() const noexcept {
+  return this->cycle_num;
+}
+
+// capture every net state
+Snapshot CycleSim::Save(const Snapshot* const base) const {
+  return Snapshot(*pNetlist, nets.data(), cycle_num, base);
+}
+
+// load every net state of a snapshot of the same netlist
+void CycleSim::Restore(const Snapshot& snapshot) {
+  if (snapshot.GetNetlist() != pNetlist) {
+    throw std::invalid_argument("ERR: SNAPSHOT BELONGS TO ANOTHER NETLIST! \n");
+  }
+  snapshot.Unpack(nets.data());
+  cycle_num = snapshot.GetCycle();
+}
+
+// load primary inputs from the pins they were compiled from
+void CycleSim::ReadInputs() {
+  for (const uint32_t each_net : pNetlist->GetInputs()) {
+    const Pin::Link source = pNetlist->GetInputSource(each_net);
+    if (source.first != nullptr) {
+      nets[each_net] = source.first->GetPinState(source.second);
+    }
+  }
+}
+
+// store the net & register states back into the compiled components' pins
+void CycleSim::WriteBack() const {
+  const ArrayView<Instruction> program = pNetlist->GetProgram();
+  const ArrayView<uint32_t> fanin = pNetlist->GetFanin();
+  for (uint32_t g = 0; g < program.size(); g++) {
+    Component* const comp = pNetlist->GetGateSource(g);
+    if (comp == nullptr) {
+      continue;
+    }
+    const Instruction& ins = program[g];
+    for (uint32_t k = 0; k < ins.fanin_count; k++) {
+      comp->Set(k, nets[fanin[ins.fanin_begin + k]] != 0);
+    }
+    comp->Set(ins.fanin_count, nets[ins.out_net] != 0);
+  }
+  const ArrayView<Register> regs = pNetlist->GetRegisters();
+  for (uint32_t r = 0; r < regs.size(); r++) {
+    Component* const comp = pNetlist->GetRegisterSource(r);
+    if (comp == nullptr) {
+      continue;
+    }
+    // the stored state goes last, setting D & the control pin may capture
+    comp->Set(0u, nets[regs[r].d_net] != 0);
+    if (regs[r].ctrl_net != UINT32_MAX) {
+      comp->Set(1u, nets[regs[r].ctrl_net] != 0);
+    }
+    comp->Set(2u, nets[regs[r].q_net] != 0);
+  }
+}
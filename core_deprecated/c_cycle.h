@@ -0,0 +1,107 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// include guard for this header
+#ifndef C_CYCLE_H
+#define C_CYCLE_H
+
+// includes for this header
+#include <vector>         // std::vector
+#include <cstdint>        // standard int types
+#include "c_netlist.h"    // class Netlist
+#include "c_snapshot.h"   // class Snapshot
+
+// namespace for entire project
+namespace Cim {
+
+// CycleSim Class
+// Cycle-based simulation engine for synchronous circuits. Register outputs are
+// sources of the levelized program, so one pass over it settles all of the
+// combinational logic between register boundaries. Every clock edge is two
+// phases: compute (one pass, every register samples its input) and commit
+// (every register output takes the sampled value at once). Nothing iterates
+// to a fixpoint, and a register never sees a value committed in the same
+// edge, whatever order the registers are stored in.
+// All flip-flops share one implicit clock (Clock() is its rising edge) and
+// their clock nets are not read. A latch is sampled at the edge and only
+// takes the new value if its enable net is high after the compute phase.
+class CycleSim {
+ public:
+  // constructor (netlist must be levelized and outlive the engine)
+  explicit CycleSim(const Netlist& TargetNetlist);
+
+  // destructor
+  ~CycleSim() { /* DN */ }
+
+  // set a primary input net
+  void SetInput(const uint32_t net, const bool new_state);
+
+  // set all primary inputs, in Netlist::GetInputs() order
+  void SetInputs(const std::vector<bool>& input_vector);
+
+  // return the state of a net
+  bool GetState(const uint32_t net) const;
+
+  // return the state of every net
+  const std::vector<uint8_t>& GetStates() const noexcept;
+
+  // return the state stored in a register
+  bool GetRegisterState(const uint32_t reg) const;
+
+  // load the initial state into every register and restart the cycle count
+  void Reset() noexcept;
+
+  // compute phase only: settle the combinational logic for the current inputs & state
+  void Evaluate() noexcept;
+
+  // one clock edge: compute, then commit every register at once
+  // (afterwards the register outputs hold the new state, every other net its value at the edge)
+  void Clock() noexcept;
+
+  // run clock edges with unchanged inputs
+  void Run(const uint64_t edge_num) noexcept;
+
+  // return the number of clock edges since the last Reset()
+  uint64_t GetCycleNum() const noexcept;
+
+  // capture every net state and the cycle count (pages equal to those of base are shared)
+  Snapshot Save(const Snapshot* const base = nullptr) const;
+
+  // load every net state and the cycle count of a snapshot of the same netlist
+  void Restore(const Snapshot& snapshot);
+
+  // load primary inputs from the pins they were compiled from
+  void ReadInputs();
+
+  // store the net & register states back into the compiled components' pins
+  void WriteBack() const;
+
+ private:
+  const Netlist* pNetlist;      // compiled circuit
+  std::vector<uint8_t> nets;    // one state byte per net
+  std::vector<uint8_t> next;    // sampled state per register (compute -> commit)
+  uint64_t cycle_num;           // clock edges since reset
+};
+
+}
+
+#endif  // C_CYCLE_H
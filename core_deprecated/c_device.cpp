@@ -0,0 +1,612 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// includes for this file
+#include "c_device.h"
+#include "c_kernels.h"    // EvaluateKind()
+#include "c_symbols.h"    // InternSymbol(), GetSymbolName()
+#include <iostream>       // std::cout
+#include <algorithm>      // std::upper_bound, std::fill
+#include <stdexcept>
+#include <cassert>
+
+// using namespace for this project
+using namespace Cim;
+
+// constructor
+DeviceDef::DeviceDef(const std::string& DefName, const std::vector<std::string>& InPinNames,
+    const std::vector<std::string>& OutPinNames) :
+  // IDs
+  name{InternSymbol(DefName)}, pin_names(),
+  // Structure
+  elements(), fanin(), net_driver(InPinNames.size(), UINT32_MAX), instances(),
+  output_nets(OutPinNames.size(), UINT32_MAX),
+  // Hierarchy
+  instance_size{0}, flat_gate_num{0}, frozen{false} {
+  pin_names.reserve(InPinNames.size() + OutPinNames.size());
+  for (const std::string& each_name : InPinNames) {
+    pin_names.push_back(InternSymbol(each_name));
+  }
+  for (const std::string& each_name : OutPinNames) {
+    pin_names.push_back(InternSymbol(each_name));
+  }
+}
+
+// throw if the definition can no longer change
+void DeviceDef::check_editable() const {
+  if (frozen) {
+    throw std::logic_error("ERR: DEVICE DEFINITION IS ALREADY INSTANTIATED! \n");
+  }
+}
+
+// throw if a net does not exist
+void DeviceDef::check_nets(const std::vector<uint32_t>& nets) const {
+  for (const uint32_t each_net : nets) {
+    if (each_net >= net_driver.size()) {
+      throw std::out_of_range("ERR: NET DOES NOT EXIST! \n");
+    }
+  }
+}
+
+// add the element and its output nets
+uint32_t DeviceDef::push_element(const Element& element, const std::vector<uint32_t>& fanin_nets,
+    const uint32_t out_num) {
+  Element result = element;
+  result.fanin_begin = fanin.size();
+  result.fanin_count = fanin_nets.size();
+  result.out_net = net_driver.size();
+  fanin.insert(fanin.end(), fanin_nets.begin(), fanin_nets.end());
+  net_driver.insert(net_driver.end(), out_num, static_cast<uint32_t>(elements.size()));
+  elements.push_back(result);
+  return result.out_net;
+}
+
+// builder: add a gate reading fanin_nets
+uint32_t DeviceDef::AddGate(const std::string& gate_name, const GateKind kind,
+    const std::vector<uint32_t>& fanin_nets) {
+  check_editable();
+  // 1. registers would need clocking, definitions are evaluated in one pass
+  if (IsSequentialKind(kind)) {
+    throw std::invalid_argument("ERR: DEVICE DEFINITIONS ARE COMBINATIONAL! \n");
+  }
+  // 2. a LUT needs its truth table
+  if (kind == GateKind::LUT) {
+    throw std::invalid_argument("ERR: LUT GATE NEEDS A TRUTH TABLE! \n");
+  }
+  CheckGateInputs(kind, fanin_nets.size());
+  check_nets(fanin_nets);
+  flat_gate_num++;
+  return push_element(Element{nullptr, kind, InternSymbol(gate_name), 0, 0, 0, 0, 0}, fanin_nets, 1);
+}
+
+// builder: add a LUT gate
+uint32_t DeviceDef::AddLut(const std::string& gate_name, const uint64_t table,
+    const std::vector<uint32_t>& fanin_nets) {
+  check_editable();
+  CheckGateInputs(GateKind::LUT, fanin_nets.size());
+  check_nets(fanin_nets);
+  // only the first 2^n bits of the table are meaningful
+  const uint32_t size = 1u << fanin_nets.size();
+  const uint64_t mask = (size < 64) ? (uint64_t{1} << size) - 1 : ~uint64_t{0};
+  flat_gate_num++;
+  return push_element(Element{nullptr, GateKind::LUT, InternSymbol(gate_name), 0, 0, 0, table & mask, 0},
+      fanin_nets, 1);
+}
+
+// builder: instantiate a definition reading input_nets
+std::vector<uint32_t> DeviceDef::AddInstance(const std::string& inst_name, const DeviceDef& child,
+    const std::vector<uint32_t>& input_nets) {
+  check_editable();
+  // 1. the child must be complete (a definition being built cannot contain itself)
+  if (&child == this) {
+    throw std::invalid_argument("ERR: DEVICE CANNOT INSTANTIATE ITSELF! \n");
+  }
+  for (const uint32_t each_net : child.output_nets) {
+    if (each_net == UINT32_MAX) {
+      throw std::invalid_argument("ERR: DEVICE OUTPUT IS NOT DRIVEN! \n");
+    }
+  }
+  // 2. one net per input port
+  if (input_nets.size() != child.GetInputNum()) {
+    throw std::invalid_argument("ERR: WRONG NUMBER OF INSTANCE INPUTS! \n");
+  }
+  check_nets(input_nets);
+  // 3. the child is shared from now on
+  child.frozen = true;
+  instances.push_back(elements.size());
+  const uint32_t first = push_element(Element{&child, GateKind::LUT, InternSymbol(inst_name), 0, 0, 0, 0,
+      instance_size}, input_nets, child.GetOutputNum());
+  instance_size += child.GetStateSize();
+  flat_gate_num += child.flat_gate_num;
+  std::vector<uint32_t> result(child.GetOutputNum());
+  for (uint32_t k = 0; k < result.size(); k++) {
+    result[k] = first + k;
+  }
+  return result;
+}
+
+// builder: drive an output port from a local net
+void DeviceDef::SetOutput(const uint32_t port, const uint32_t net) {
+  check_editable();
+  if (port >= output_nets.size()) {
+    throw std::out_of_range("ERR: PIN DOES NOT EXIST! \n");
+  }
+  check_nets({net});
+  output_nets[port] = net;
+}
+
+// return the definition name
+std::string DeviceDef::GetName() const {
+  return GetSymbolName(this->name);
+}
+
+// return the number of input ports
+uint32_t DeviceDef::GetInputNum() const noexcept {
+  return pin_names.size() - output_nets.size();
+}
+
+// return the number of output ports
+uint32_t DeviceDef::GetOutputNum() const noexcept {
+  return output_nets.size();
+}
+
+// return the name of a port
+std::string DeviceDef::GetPinName(const uint32_t port) const {
+  return GetSymbolName(pin_names.at(port));
+}
+
+// return the local net driving an output port
+uint32_t DeviceDef::GetOutputNet(const uint32_t port) const {
+  return output_nets.at(port);
+}
+
+// return the number of local nets
+uint32_t DeviceDef::GetLocalNetNum() const noexcept {
+  return net_driver.size();
+}
+
+// return the number of nets over the whole hierarchy
+uint64_t DeviceDef::GetStateSize() const noexcept {
+  return net_driver.size() + instance_size;
+}
+
+// return the number of gates over the whole hierarchy
+uint64_t DeviceDef::GetFlatGateNum() const noexcept {
+  return this->flat_gate_num;
+}
+
+// return the name of a local net
+std::string DeviceDef::GetLocalNetName(const uint32_t net) const {
+  const uint32_t driver = net_driver.at(net);
+  // 1. input port
+  if (driver == UINT32_MAX) {
+    return GetSymbolName(pin_names[net]);
+  }
+  // 2. gate output
+  const Element& element = elements[driver];
+  if (element.child == nullptr) {
+    return GetSymbolName(element.name);
+  }
+  // 3. instance output -> instance::port
+  const DeviceDef& child = *element.child;
+  return GetSymbolName(element.name) + "::" + child.GetPinName(child.GetInputNum() + net - element.out_net);
+}
+
+// return the bytes held by this definition
+size_t DeviceDef::GetByteNum() const noexcept {
+  return sizeof(DeviceDef) + elements.capacity() * sizeof(Element) +
+      (pin_names.capacity() + fanin.capacity() + net_driver.capacity() + instances.capacity() +
+       output_nets.capacity()) * sizeof(uint32_t);
+}
+
+// evaluate the hierarchy on the state block starting at states
+void DeviceDef::Evaluate(uint8_t* const states) const noexcept {
+  uint8_t* const blocks = states + net_driver.size();
+  for (const Element& each_element : elements) {
+    const uint32_t* const in = fanin.data() + each_element.fanin_begin;
+    // 1. gate: one kernel call
+    if (each_element.child == nullptr) {
+      states[each_element.out_net] = EvaluateKind<uint8_t>(each_element.kind,
+          [in, states](const uint32_t k) { return states[in[k]]; }, each_element.fanin_count, each_element.table);
+      continue;
+    }
+    // 2. instance: inputs in, evaluate the child block, outputs out
+    const DeviceDef& child = *each_element.child;
+    uint8_t* const block = blocks + each_element.offset;
+    for (uint32_t k = 0; k < each_element.fanin_count; k++) {
+      block[k] = states[in[k]];
+    }
+    child.Evaluate(block);
+    for (uint32_t k = 0; k < child.output_nets.size(); k++) {
+      states[each_element.out_net + k] = block[child.output_nets[k]];
+    }
+  }
+}
+
+// add the gates of the hierarchy to a netlist builder
+std::vector<uint32_t> DeviceDef::Flatten(Netlist& netlist, const std::vector<uint32_t>& input_nets,
+    std::vector<uint64_t>* const state_of_net) const {
+  if (input_nets.size() != GetInputNum()) {
+    throw std::invalid_argument("ERR: WRONG NUMBER OF INSTANCE INPUTS! \n");
+  }
+  std::vector<uint32_t> local(net_driver.size(), UINT32_MAX);
+  std::copy(input_nets.begin(), input_nets.end(), local.begin());
+  flatten(netlist, local, 0, state_of_net);
+  std::vector<uint32_t> result(output_nets.size());
+  for (uint32_t k = 0; k < result.size(); k++) {
+    result[k] = local.at(output_nets[k]);
+  }
+  return result;
+}
+
+// flatten on a net map of this definition
+void DeviceDef::flatten(Netlist& netlist, std::vector<uint32_t>& local, const uint64_t base,
+    std::vector<uint64_t>* const state_of_net) const {
+  std::vector<uint32_t> fanin_nets;
+  for (const Element& each_element : elements) {
+    // 1. inputs of the element as nets of the netlist
+    fanin_nets.resize(each_element.fanin_count);
+    for (uint32_t k = 0; k < each_element.fanin_count; k++) {
+      fanin_nets[k] = local[fanin[each_element.fanin_begin + k]];
+    }
+    // 2. gate: one new net, no name (see GetStateName())
+    if (each_element.child == nullptr) {
+      const uint32_t out = netlist.AddNet();
+      if (each_element.kind == GateKind::LUT) {
+        netlist.AddLut(each_element.table, fanin_nets, out);
+      } else {
+        netlist.AddGate(each_element.kind, fanin_nets, out);
+      }
+      local[each_element.out_net] = out;
+      if (state_of_net != nullptr) {
+        state_of_net->resize(out + 1, UINT64_MAX);
+        (*state_of_net)[out] = base + each_element.out_net;
+      }
+      continue;
+    }
+    // 3. instance: child ports are aliased to the nets they connect to
+    const DeviceDef& child = *each_element.child;
+    std::vector<uint32_t> child_local(child.net_driver.size(), UINT32_MAX);
+    std::copy(fanin_nets.begin(), fanin_nets.end(), child_local.begin());
+    child.flatten(netlist, child_local, base + net_driver.size() + each_element.offset, state_of_net);
+    for (uint32_t k = 0; k < child.output_nets.size(); k++) {
+      local[each_element.out_net + k] = child_local[child.output_nets[k]];
+    }
+  }
+}
+
+// return the full name of a state index, below the given prefix
+std::string DeviceDef::GetStateName(const std::string& prefix, uint64_t state) const {
+  // 1. local net
+  if (state < net_driver.size()) {
+    return prefix + "::" + GetLocalNetName(state);
+  }
+  if (state >= GetStateSize()) {
+    throw std::out_of_range("ERR: NET DOES NOT EXIST! \n");
+  }
+  // 2. net of an instance: the last block starting at or before state (blocks are sorted by offset)
+  state -= net_driver.size();
+  const auto found = std::upper_bound(instances.begin(), instances.end(), state,
+      [this](const uint64_t value, const uint32_t element) { return value < elements[element].offset; });
+  assert(found != instances.begin());
+  const Element& element = elements[*(found - 1)];
+  return element.child->GetStateName(prefix + "::" + GetSymbolName(element.name), state - element.offset);
+}
+
+// constructor
+Device::Device(const Component* const ParentDevice, const std::string& DeviceName, const DeviceDef& Definition,
+    bool isMonitored, std::pmr::memory_resource* const Resource) :
+  // IDs
+  pDef{&Definition}, name{DeviceName.data(), DeviceName.size(), Resource},
+  // Properties
+  monitored{isMonitored}, pParent{const_cast<Component*>(ParentDevice)}, index{UINT32_MAX},
+  nesting_lvl{(ParentDevice == nullptr) ? 0 : ParentDevice->GetNestingLvl() + 1},
+  // IO & State
+  Pins(Resource), pin_index(Resource), states(Definition.GetStateSize(), 0, Resource) {
+  // codes & error-handling
+  // 1. every output needs a driver
+  for (uint32_t k = 0; k < Definition.GetOutputNum(); k++) {
+    if (Definition.GetOutputNet(k) == UINT32_MAX) {
+      throw std::invalid_argument("ERR: DEVICE OUTPUT IS NOT DRIVEN! \n");
+    }
+  }
+  // 2. the definition is shared from now on
+  Definition.frozen = true;
+  // initialize input and output Pins
+  const uint32_t in_num = Definition.GetInputNum();
+  const uint32_t pin_num = in_num + Definition.GetOutputNum();
+  Pins.reserve(pin_num);
+  for (uint32_t k = 0; k < pin_num; k++) {
+    Pins.emplace_back(Pin{Definition.GetPinName(k), k, (k < in_num) ? Pin::Dir::Input : Pin::Dir::Output,
+        Pins.get_allocator().resource()});
+  }
+  pin_index.Build(Pins);
+}
+
+// initialize components to initial state
+void Device::Initialize() {
+  // every net 0, then outputs consistent with the input pins
+  std::fill(states.begin(), states.end(), 0);
+  Evaluate();
+}
+
+// evaluate the hierarchy from the input pins and update the output pins
+void Device::Evaluate() {
+  const uint32_t in_num = pDef->GetInputNum();
+  for (uint32_t k = 0; k < in_num; k++) {
+    states[k] = Pins[k].state;
+  }
+  pDef->Evaluate(states.data());
+  for (uint32_t k = 0; k < pDef->GetOutputNum(); k++) {
+    Set(in_num + k, states[pDef->GetOutputNet(k)] != 0);
+  }
+}
+
+// return the definition
+const DeviceDef& Device::GetDefinition() const noexcept {
+  return *this->pDef;
+}
+
+// return the state of a net of the hierarchy
+bool Device::GetState(const uint64_t state) const {
+  return this->states.at(state) != 0;
+}
+
+// return the full name of a net of the hierarchy
+std::string Device::GetStateName(const uint64_t state) const {
+  return pDef->GetStateName(GetFullName(), state);
+}
+
+// lower the hierarchy into a levelized netlist
+Netlist Device::Flatten(std::vector<uint64_t>* const state_of_net) const {
+  Netlist netlist;
+  if (state_of_net != nullptr) {
+    state_of_net->clear();
+  }
+  // 1. one primary input per input port, named after it
+  std::vector<uint32_t> inputs(pDef->GetInputNum());
+  for (uint32_t k = 0; k < inputs.size(); k++) {
+    inputs[k] = netlist.AddNet();
+    netlist.SetNetName(inputs[k], GetPinName(k));
+    if (state_of_net != nullptr) {
+      state_of_net->push_back(k);
+    }
+  }
+  // 2. the gates of the hierarchy, outputs in port order
+  for (const uint32_t each_net : pDef->Flatten(netlist, inputs, state_of_net)) {
+    netlist.AddOutput(each_net);
+  }
+  netlist.Levelize();
+  return netlist;
+}
+
+// return the bytes held by this instance
+size_t Device::GetByteNum() const noexcept {
+  size_t result = sizeof(Device) + name.capacity() + states.capacity() + Pins.capacity() * sizeof(Pin);
+  for (const Pin& each_pin : Pins) {
+    result += each_pin.name.capacity() + each_pin.connections.capacity() * sizeof(Pin::Link);
+  }
+  return result;
+}
+
+// return component full name (parent full name + "::" + name, built on every call)
+std::string Device::GetFullName() const noexcept {
+  if (pParent == nullptr) {
+    return std::string(this->name);
+  }
+  std::string result = pParent->GetFullName();
+  result += "::";
+  result += this->name;
+  return result;
+}
+
+// return nesting level
+uint32_t Device::GetNestingLvl() const noexcept {
+  return this->nesting_lvl;
+}
+
+// return component type
+std::string Device::GetType() const noexcept {
+  return pDef->GetName();
+}
+
+// return component kind (none: a device is a hierarchy, see Evaluate() & Flatten())
+GateKind Device::GetKind() const {
+  throw std::logic_error("ERR: A DEVICE HAS NO GATE KIND, FLATTEN IT! \n");
+}
+
+// return the truth table of a LUT component (none: a device is no LUT)
+uint64_t Device::GetTruthTable() const {
+  throw std::logic_error("ERR: A DEVICE HAS NO TRUTH TABLE, FLATTEN IT! \n");
+}
+
+// return component name
+std::string Device::GetName() const noexcept {
+  return std::string(this->name);
+}
+
+// get inpins and outpins number
+std::pair<uint32_t, uint32_t> Device::GetIONum() const noexcept {
+  return std::make_pair(pDef->GetInputNum(), pDef->GetOutputNum());
+}
+
+// return true if component is a device
+bool Device::IsDevice() const noexcept {
+  return true;
+}
+
+// return true if component is monitored
+bool Device::IsMonitored() const noexcept {
+  return this->monitored;
+}
+
+// set local index
+void Device::SetLocalIndex(const uint32_t new_idx) noexcept {
+  this->index = new_idx;
+}
+
+// return local index
+uint32_t Device::GetLocalIndex() const noexcept {
+  return this->index;
+}
+
+// return the pointer to parent device
+const Component* const Device::GetParentDevice() const noexcept {
+  return this->pParent;
+}
+
+// return pin state
+bool Device::GetPinState(const uint32_t pin_idx) const {
+  return this->Pins.at(pin_idx).state;
+}
+
+// return if state changed after the last evaluation
+bool Device::IsPinStateChanged(const uint32_t pin_idx) const {
+  return this->Pins.at(pin_idx).state_changed;
+}
+
+// mark a pin change as consumed, without touching any state
+void Device::ClearPinStateChanged(const uint32_t pin_idx) {
+  this->Pins.at(pin_idx).state_changed = false;
+}
+
+// return pin name
+std::string Device::GetPinName(const uint32_t pin_idx) const {
+  return std::string(this->Pins.at(pin_idx).name);
+}
+
+// return whether a pin exist
+bool Device::DoesPinExist(const std::string& pin_name) const {
+  return search(pin_name) != nullptr;
+}
+
+// return pin index
+uint32_t Device::GetPinIndex(const std::string& pin_name) const {
+  Pin* const pin = search(pin_name);
+  if (pin == nullptr) {
+    throw std::invalid_argument("ERR: PIN DOES NOT EXIST! \n");
+  }
+  return pin->index;
+}
+
+// resolve a pin name once
+PinHandle Device::ResolvePin(const std::string& pin_name) {
+  return PinHandle{this, GetPinIndex(pin_name)};
+}
+
+// check if pin is connected
+bool Device::IsPinConnected(const uint32_t pin_idx) const {
+  for (const auto& each_connection : this->Pins.at(pin_idx).connections) {
+    if (each_connection.first != nullptr) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// check if pin is connected
+bool Device::IsPinConnected(const std::string& pin_name) const {
+  return IsPinConnected(GetPinIndex(pin_name));
+}
+
+// return & modify the connection of that pin
+std::pmr::vector<Pin::Link>& Device::GetPinConnection(const uint32_t pin_idx) {
+  return this->Pins.at(pin_idx).connections;
+}
+
+// return the connection of that pin, read only
+const std::pmr::vector<Pin::Link>& Device::GetPinConnection(const uint32_t pin_idx) const {
+  return this->Pins.at(pin_idx).connections;
+}
+
+// return & modify the connection of that pin
+std::pmr::vector<Pin::Link>& Device::GetPinConnection(const std::string& pin_name) {
+  return GetPinConnection(GetPinIndex(pin_name));
+}
+
+// return the pin's direction
+Pin::Dir Device::GetPinDirection(const uint32_t pin_idx) const {
+  return this->Pins.at(pin_idx).direction;
+}
+
+// return the pin's direction
+Pin::Dir Device::GetPinDirection(const std::string& pin_name) const {
+  return GetPinDirection(GetPinIndex(pin_name));
+}
+
+// return a non-owning view of the output pins
+PinRange Device::GetOutPins() const noexcept {
+  return PinRange(this, pDef->GetInputNum(), Pins.size());
+}
+
+// return a non-owning view of the input pins
+PinRange Device::GetInPins() const noexcept {
+  // inputs come first (see constructor)
+  return PinRange(this, 0, pDef->GetInputNum());
+}
+
+// return the states of 64 input pins starting at pin (64 * word)
+uint64_t Device::GetInPinStates(const uint32_t word) const noexcept {
+  uint64_t result = 0;
+  const uint32_t in_num = pDef->GetInputNum();
+  for (uint32_t i = word * 64, b = 0; i < in_num && b < 64; i++, b++) {
+    result |= static_cast<uint64_t>(Pins[i].state) << b;
+  }
+  return result;
+}
+
+// search for a pin by name
+Pin* const Device::search(const std::string& pin_name) const {
+  // hashed per component, no shared table involved
+  const uint32_t pin_idx = pin_index.Find(Pins, pin_name);
+  return (pin_idx == UINT32_MAX) ? nullptr : const_cast<Pin* const>(&Pins[pin_idx]);
+}
+
+// print input pins' states
+void Device::PrintInPinStates() const noexcept {
+  std::cout << "[ " << GetFullName() << " ] \n";
+  for (const PinRef each_pin : GetInPins()) {
+    std::cout << "> " << each_pin.GetName() << ": " << (each_pin.GetState() ? "T \n" : "F \n");
+  }
+  std::cout << '\n';
+}
+
+// print output pins' states
+void Device::PrintOutPinStates() const noexcept {
+  std::cout << "[ " << GetFullName() << " ] \n";
+  for (const PinRef each_pin : GetOutPins()) {
+    std::cout << "> " << each_pin.GetName() << ": " << (each_pin.GetState() ? "T \n" : "F \n");
+  }
+  std::cout << '\n';
+}
+
+// Set a pin to new state and update the state_changed flag
+void Device::Set(const uint32_t pin_idx, const bool new_state) {
+  Pin& pin = this->Pins.at(pin_idx);
+  pin.state_changed = (pin.state != new_state);
+  pin.state = new_state;
+}
+
+// Set a pin to new state and update the state_changed flag
+void Device::Set(const std::string& pin_name, const bool new_state) {
+  Set(GetPinIndex(pin_name), new_state);
+}
@@ -0,0 +1,305 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// include guard for this header
+#ifndef C_DEVICE_H
+#define C_DEVICE_H
+
+// includes for this header
+#include <string>         // std::string
+#include <vector>         // std::vector
+#include <utility>        // std::pair
+#include <cstdint>        // standard int types
+#include <memory_resource>  // std::pmr::vector
+
+#include "c_component.h"  // class Component
+#include "c_netlist.h"    // class Netlist
+
+// namespace for entire project
+namespace Cim {
+
+// DeviceDef Class
+// Definition of a combinational sub-circuit, stored once however often it is
+// instantiated. Local nets are numbered in creation order: the input ports
+// first, then one net per gate output and per instance output. Every element
+// reads nets that already exist, so creation order is evaluation order and no
+// loop can be built. An instance of another definition is a definition pointer
+// plus the offset of its state block inside the state of this definition:
+//   [local nets][state of instance 0][state of instance 1]...
+// Names are interned symbols, full names are never stored. A definition is
+// frozen once it is instantiated or wrapped in a Device.
+class DeviceDef {
+ public:
+  // constructor
+  DeviceDef(const std::string& DefName, const std::vector<std::string>& InPinNames,
+      const std::vector<std::string>& OutPinNames);
+
+  // destructor
+  ~DeviceDef() { /* DN */ }
+
+  // builder: add a gate reading fanin_nets, returns its output net
+  uint32_t AddGate(const std::string& gate_name, const GateKind kind, const std::vector<uint32_t>& fanin_nets);
+
+  // builder: add a LUT gate, bit (sum of input k << k) of table is its output, returns its output net
+  uint32_t AddLut(const std::string& gate_name, const uint64_t table, const std::vector<uint32_t>& fanin_nets);
+
+  // builder: instantiate a definition reading input_nets, returns the nets of its outputs
+  std::vector<uint32_t> AddInstance(const std::string& inst_name, const DeviceDef& child,
+      const std::vector<uint32_t>& input_nets);
+
+  // builder: drive an output port from a local net
+  void SetOutput(const uint32_t port, const uint32_t net);
+
+  // return the definition name
+  std::string GetName() const;
+
+  // return the number of input / output ports
+  uint32_t GetInputNum() const noexcept;
+  uint32_t GetOutputNum() const noexcept;
+
+  // return the name of a port (inputs first, then outputs)
+  std::string GetPinName(const uint32_t port) const;
+
+  // return the local net driving an output port
+  uint32_t GetOutputNet(const uint32_t port) const;
+
+  // return the number of local nets / of nets over the whole hierarchy
+  uint32_t GetLocalNetNum() const noexcept;
+  uint64_t GetStateSize() const noexcept;
+
+  // return the number of gates over the whole hierarchy
+  uint64_t GetFlatGateNum() const noexcept;
+
+  // return the name of a local net ("gate", "inst.port" or an input port)
+  std::string GetLocalNetName(const uint32_t net) const;
+
+  // return the bytes held by this definition (instantiated definitions not included)
+  size_t GetByteNum() const noexcept;
+
+  // evaluate the hierarchy on the state block starting at states
+  void Evaluate(uint8_t* const states) const noexcept;
+
+  // add the gates of the hierarchy to a netlist builder, input ports read input_nets;
+  // returns the output nets, state_of_net (if given) maps every added net to its state index
+  std::vector<uint32_t> Flatten(Netlist& netlist, const std::vector<uint32_t>& input_nets,
+      std::vector<uint64_t>* const state_of_net = nullptr) const;
+
+  // return the full name of a state index, below the given prefix
+  std::string GetStateName(const std::string& prefix, uint64_t state) const;
+
+ private:
+  // one gate or instance
+  struct Element {
+    const DeviceDef*  child;        // instantiated definition (nullptr for a gate)
+    GateKind          kind;         // gate kind (gates only)
+    uint32_t          name;         // interned name
+    uint32_t          fanin_begin;  // inputs are fanin[fanin_begin .. + fanin_count)
+    uint32_t          fanin_count;
+    uint32_t          out_net;      // first output net (instances own GetOutputNum() nets)
+    uint64_t          table;        // truth table (LUT only)
+    uint64_t          offset;       // state block of the instance, relative to the first block
+  };
+
+  // throw if the definition can no longer change / a net does not exist
+  void check_editable() const;
+  void check_nets(const std::vector<uint32_t>& nets) const;
+
+  // add the element and its output nets
+  uint32_t push_element(const Element& element, const std::vector<uint32_t>& fanin_nets, const uint32_t out_num);
+
+  // flatten on a net map of this definition
+  void flatten(Netlist& netlist, std::vector<uint32_t>& local, const uint64_t base,
+      std::vector<uint64_t>* const state_of_net) const;
+
+ private:
+  // IDs
+  uint32_t name;                      // interned definition name
+  std::vector<uint32_t> pin_names;    // interned port names, inputs first
+
+  // Structure
+  std::vector<Element> elements;      // gates & instances in evaluation order
+  std::vector<uint32_t> fanin;        // local nets read by the elements
+  std::vector<uint32_t> net_driver;   // local net -> element (UINT32_MAX for input ports)
+  std::vector<uint32_t> instances;    // elements that are instances, by offset
+  std::vector<uint32_t> output_nets;  // output port -> local net (UINT32_MAX until set)
+
+  // Hierarchy
+  uint64_t instance_size;             // nets of all instance blocks
+  uint64_t flat_gate_num;             // gates over the whole hierarchy
+  mutable bool frozen;                // instantiated, no more changes
+
+  // a device freezes its definition
+  friend class Device;
+};
+
+// Device Class (Derived class from Component Interface)
+// One instance of a DeviceDef as a component: the ports are its pins, the
+// nets of the whole hierarchy live in one state array (one byte per net) that
+// the definitions are evaluated on. Nothing is stored per inner gate or inner
+// instance; full names are built on demand from the definitions. Flatten()
+// lowers the hierarchy into a Netlist for the compiled engines.
+class Device : public Component {
+ public:
+  // constructor (names & pins are allocated from Resource, e.g. an Arena)
+  Device(const Component* const ParentDevice, const std::string& DeviceName, const DeviceDef& Definition,
+      bool isMonitored = false, std::pmr::memory_resource* const Resource = std::pmr::get_default_resource());
+
+  // destructor
+  ~Device() { /* DN */ }
+
+  // initialize components to initial state
+  virtual void Initialize() override;
+
+  // Set a pin to new state and update the state_changed flag
+  virtual void Set(const uint32_t pin_idx, const bool new_state) override;
+  virtual void Set(const std::string& pin_name, const bool new_state) override;
+
+  // return true if component is monitored
+  virtual bool IsMonitored() const noexcept override;
+
+  // return true if component is a device
+  virtual bool IsDevice() const noexcept override;
+
+  // return the pointer to parent device
+  virtual const Component* const GetParentDevice() const noexcept override;
+
+  // return local index
+  virtual uint32_t GetLocalIndex() const noexcept override;
+
+  // set local index
+  virtual void SetLocalIndex(const uint32_t new_idx) noexcept override;
+
+  // get inpins and outpins number
+  virtual std::pair<uint32_t, uint32_t> GetIONum() const noexcept override;
+
+  // return component name
+  virtual std::string GetName() const noexcept override;
+
+  // return component full name (built from the parents on every call)
+  virtual std::string GetFullName() const noexcept override;
+
+  // return component type (the definition name)
+  virtual std::string GetType() const noexcept override;
+
+  // return component kind (throws: a device is a hierarchy, not one gate)
+  virtual GateKind GetKind() const override;
+
+  // return the truth table of a LUT component (throws for devices)
+  virtual uint64_t GetTruthTable() const override;
+
+  // return nesting level
+  virtual uint32_t GetNestingLvl() const noexcept override;
+
+  // return pin state
+  virtual bool GetPinState(const uint32_t pin_idx) const override;
+
+  // return if state changed after the last evaluation
+  virtual bool IsPinStateChanged(const uint32_t pin_idx) const override;
+
+  // mark a pin change as consumed, without touching any state
+  virtual void ClearPinStateChanged(const uint32_t pin_idx) override;
+
+  // return pin name
+  virtual std::string GetPinName(const uint32_t pin_idx) const override;
+
+  // return a non-owning view of the input pins
+  virtual PinRange GetInPins() const noexcept override;
+
+  // return a non-owning view of the output pins
+  virtual PinRange GetOutPins() const noexcept override;
+
+  // return the states of 64 input pins starting at pin (64 * word), one bit per pin
+  virtual uint64_t GetInPinStates(const uint32_t word = 0) const noexcept override;
+
+  // return the pin's direction
+  virtual Pin::Dir GetPinDirection(const uint32_t pin_idx) const override;
+  virtual Pin::Dir GetPinDirection(const std::string& pin_name) const override;
+
+  // return pin index
+  virtual uint32_t GetPinIndex(const std::string& pin_name) const override;
+
+  // resolve a pin name once, the handle replaces the name in later calls
+  virtual PinHandle ResolvePin(const std::string& pin_name) override;
+
+  // return & modify the connection of that pin
+  virtual std::pmr::vector<Pin::Link>& GetPinConnection(const uint32_t pin_idx) override;
+  virtual std::pmr::vector<Pin::Link>& GetPinConnection(const std::string& pin_name) override;
+
+  // return the connection of that pin, read only
+  virtual const std::pmr::vector<Pin::Link>& GetPinConnection(const uint32_t pin_idx) const override;
+
+  // return whether a pin exist
+  virtual bool DoesPinExist(const std::string& pin_name) const override;
+
+  // check if pin is connected
+  virtual bool IsPinConnected(const uint32_t pin_idx) const override;
+  virtual bool IsPinConnected(const std::string& pin_name) const override;
+
+  // print input pins' states
+  virtual void PrintInPinStates() const noexcept override;
+
+  // print output pins' states
+  virtual void PrintOutPinStates() const noexcept override;
+
+  // evaluate the hierarchy from the input pins and update the output pins
+  void Evaluate();
+
+  // return the definition
+  const DeviceDef& GetDefinition() const noexcept;
+
+  // return the state of a net of the hierarchy (index into the state array)
+  bool GetState(const uint64_t state) const;
+
+  // return the full name of a net of the hierarchy
+  std::string GetStateName(const uint64_t state) const;
+
+  // lower the hierarchy into a levelized netlist: ports are the primary inputs & outputs,
+  // state_of_net (if given) maps every net to its state index for GetStateName()
+  Netlist Flatten(std::vector<uint64_t>* const state_of_net = nullptr) const;
+
+  // return the bytes held by this instance (definitions not included)
+  size_t GetByteNum() const noexcept;
+
+ private:
+  // search for a pin by name
+  Pin* const search(const std::string& pin_name) const;
+
+ private:
+  // IDs
+  const DeviceDef* pDef;      // definition, shared by all instances
+  std::pmr::string name;      // instance name
+
+  // Property
+  bool monitored;             // if outputs of device are monitored
+  Component* pParent;         // parent device
+  uint32_t index;             // index in local device
+  uint32_t nesting_lvl;       // level of nesting
+
+  // I/O & State
+  std::pmr::vector<Pin> Pins;         // In & Out pin list
+  PinIndex pin_index;                 // pin name -> index
+  std::pmr::vector<uint8_t> states;   // one byte per net of the hierarchy
+};
+
+}
+
+#endif  // C_DEVICE_H
@@ -0,0 +1,290 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// includes for this file
+#include "c_event.h"
+#include <chrono>         // std::chrono
+#include <stdexcept>
+#include <cassert>
+
+// using namespace for this project
+using namespace Cim;
+
+// constructor
+EventSim::EventSim(const Netlist& TargetNetlist) :
+  pNetlist{&TargetNetlist},
+  // State
+  nets(TargetNetlist.GetNetNum(), 0), projected(TargetNetlist.GetNetNum(), 0),
+  touched(), is_touched(TargetNetlist.GetNetNum(), 0),
+  // Timing wheel
+  wheel(2), now{0}, pending{0},
+  // Scratch
+  bucket(), changed(), active(), stamp(TargetNetlist.GetGateNum(), UINT64_MAX),
+  // Statistics
+  evaluations{0}, changes{0}, pProfiler{nullptr} {
+  if (!TargetNetlist.IsLevelized()) {
+    throw std::logic_error("ERR: NETLIST MUST BE LEVELIZED! \n");
+  }
+  // unit delay for every gate kind by default
+  delays.fill(1);
+  Initialize();
+}
+
+// set the propagation delay of a gate kind
+void EventSim::SetDelay(const GateKind op, const uint32_t delay) {
+  if (IsSequentialKind(op) || static_cast<uint32_t>(op) >= kGateKindNum) {
+    throw std::invalid_argument("ERR: ONLY COMBINATIONAL GATE KINDS HAVE A DELAY! \n");
+  }
+  if (delay == 0) {
+    throw std::invalid_argument("ERR: DELAY MUST BE AT LEAST 1! \n");
+  }
+  if (pending != 0) {
+    throw std::logic_error("ERR: CANNOT CHANGE DELAY WHILE EVENTS ARE PENDING! \n");
+  }
+  delays[static_cast<uint32_t>(op)] = delay;
+  // the wheel must span the longest delay
+  uint32_t size = 2;
+  for (const uint32_t each_delay : delays) {
+    while (size <= each_delay) {
+      size <<= 1;
+    }
+  }
+  wheel.assign(size, std::vector<Event>());
+}
+
+// return the propagation delay of a gate kind
+uint32_t EventSim::GetDelay(const GateKind op) const {
+  if (IsSequentialKind(op) || static_cast<uint32_t>(op) >= kGateKindNum) {
+    throw std::invalid_argument("ERR: ONLY COMBINATIONAL GATE KINDS HAVE A DELAY! \n");
+  }
+  return this->delays[static_cast<uint32_t>(op)];
+}
+
+// settle every net from the current primary inputs
+void EventSim::Initialize() noexcept {
+  const ArrayView<Instruction> program = pNetlist->GetProgram();
+  const uint32_t* const fanin = pNetlist->GetFanin().data();
+  const uint64_t* const luts = pNetlist->GetLuts().data();
+  for (const Instruction& ins : program) {
+    nets[ins.out_net] = EvaluateInstruction(ins, fanin, luts, nets.data());
+  }
+  projected = nets;
+  for (std::vector<Event>& each_bucket : wheel) {
+    each_bucket.clear();
+  }
+  pending = 0;
+}
+
+// schedule a primary input change at the current time
+void EventSim::SetInput(const uint32_t net, const bool new_state) {
+  if (pNetlist->GetNetDriver(net) != UINT32_MAX) {
+    throw std::invalid_argument("ERR: NET IS NOT A PRIMARY INPUT! \n");
+  }
+  if (projected[net] == new_state) {
+    return;
+  }
+  projected[net] = new_state;
+  schedule(net, new_state, 0);
+}
+
+// schedule every compiled input pin whose Pin::state_changed flag is set
+void EventSim::ApplyPinChanges() {
+  for (const uint32_t each_net : pNetlist->GetInputs()) {
+    const Pin::Link source = pNetlist->GetInputSource(each_net);
+    if (source.first == nullptr || !source.first->IsPinStateChanged(source.second)) {
+      continue;
+    }
+    const bool state = source.first->GetPinState(source.second);
+    SetInput(each_net, state);
+    // consume the change; Set() again could make a sequential component capture
+    source.first->ClearPinStateChanged(source.second);
+  }
+}
+
+// put an event into the bucket of time now + delay
+void EventSim::schedule(const uint32_t net, const uint8_t state, const uint32_t delay) {
+  assert(delay < wheel.size());
+  wheel[(now + delay) & (wheel.size() - 1)].push_back(Event{net, state});
+  pending++;
+}
+
+// process the next time step holding events up to limit
+bool EventSim::Step(const uint64_t limit) {
+  if (pending == 0 || now > limit) {
+    return false;
+  }
+  // 1. advance to the next non-empty bucket, stop right after limit
+  const uint64_t mask = wheel.size() - 1;
+  while (wheel[now & mask].empty()) {
+    if (now++ == limit) {
+      return false;
+    }
+  }
+  bucket.clear();
+  bucket.swap(wheel[now & mask]);
+  pending -= bucket.size();
+
+  // 2. apply the net changes of this time step
+  changed.clear();
+  for (const Event& each_event : bucket) {
+    if (nets[each_event.net] == each_event.state) {
+      continue;
+    }
+    nets[each_event.net] = each_event.state;
+    changed.push_back(each_event.net);
+#if CIM_PROFILE
+    // every applied change of a gate output is a toggle, glitches included
+    if (pProfiler != nullptr) {
+      const uint32_t driver = pNetlist->GetNetDriver(each_event.net);
+      if (driver != UINT32_MAX) {
+        pProfiler->CountToggle(driver);
+      }
+    }
+#endif
+    if (!is_touched[each_event.net]) {
+      is_touched[each_event.net] = 1;
+      touched.push_back(each_event.net);
+    }
+  }
+  changes += changed.size();
+
+  // 3. collect the fanout of the changed nets (each gate once)
+  const uint32_t* const offsets = pNetlist->GetFanoutOffsets().data();
+  const uint32_t* const fanout = pNetlist->GetFanout().data();
+  active.clear();
+  for (const uint32_t each_net : changed) {
+    for (uint32_t r = offsets[each_net]; r < offsets[each_net + 1]; r++) {
+      const uint32_t gate = fanout[r];
+      if (stamp[gate] != now) {
+        stamp[gate] = now;
+        active.push_back(gate);
+      }
+    }
+  }
+
+  // 4. evaluate them and schedule output changes after the gate delay
+  const Instruction* const program = pNetlist->GetProgram().data();
+  const uint32_t* const fanin = pNetlist->GetFanin().data();
+  const uint64_t* const luts = pNetlist->GetLuts().data();
+  for (const uint32_t each_gate : active) {
+    const Instruction& ins = program[each_gate];
+    const uint8_t state = EvaluateInstruction(ins, fanin, luts, nets.data());
+    if (state != projected[ins.out_net]) {
+      projected[ins.out_net] = state;
+      schedule(ins.out_net, state, delays[static_cast<uint32_t>(ins.op)]);
+    }
+  }
+  evaluations += active.size();
+#if CIM_PROFILE
+  if (pProfiler != nullptr) {
+    for (const uint32_t each_gate : active) {
+      pProfiler->CountEvaluation(each_gate);
+    }
+  }
+#endif
+
+  now++;
+  return true;
+}
+
+// process events until the circuit is stable or max_time is reached
+void EventSim::Run(const uint64_t max_time) {
+#if CIM_PROFILE
+  if (pProfiler != nullptr) {
+    const auto start = std::chrono::steady_clock::now();
+    while (Step(max_time)) {
+    }
+    pProfiler->AddVectors(1, std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count());
+    return;
+  }
+#endif
+  while (Step(max_time)) {
+  }
+}
+
+// return true if no event is pending
+bool EventSim::IsStable() const noexcept {
+  return this->pending == 0;
+}
+
+// return the next time step to be processed
+uint64_t EventSim::GetTime() const noexcept {
+  return this->now;
+}
+
+// return the state of a net
+bool EventSim::GetState(const uint32_t net) const {
+  return this->nets.at(net) != 0;
+}
+
+// return the number of gate evaluations so far
+uint64_t EventSim::GetEvaluationNum() const noexcept {
+  return this->evaluations;
+}
+
+// return the number of applied net changes so far
+uint64_t EventSim::GetChangeNum() const noexcept {
+  return this->changes;
+}
+
+// store changed nets back into the compiled components' pins
+void EventSim::WriteBack() {
+  const ArrayView<Instruction> program = pNetlist->GetProgram();
+  const ArrayView<uint32_t> fanin = pNetlist->GetFanin();
+  const ArrayView<uint32_t> offsets = pNetlist->GetFanoutOffsets();
+  const ArrayView<uint32_t> fanout = pNetlist->GetFanout();
+  for (const uint32_t each_net : touched) {
+    is_touched[each_net] = 0;
+    const bool state = nets[each_net] != 0;
+    // driving pin
+    const uint32_t driver = pNetlist->GetNetDriver(each_net);
+    if (driver != UINT32_MAX && pNetlist->GetGateSource(driver) != nullptr) {
+      pNetlist->GetGateSource(driver)->Set(program[driver].fanin_count, state);
+    }
+    // reading pins
+    for (uint32_t r = offsets[each_net]; r < offsets[each_net + 1]; r++) {
+      const Instruction& ins = program[fanout[r]];
+      Component* const comp = pNetlist->GetGateSource(fanout[r]);
+      if (comp == nullptr) {
+        continue;
+      }
+      for (uint32_t k = 0; k < ins.fanin_count; k++) {
+        if (fanin[ins.fanin_begin + k] == each_net) {
+          comp->Set(k, state);
+        }
+      }
+    }
+  }
+  touched.clear();
+}
+
+// attach a profiler of the same netlist
+void EventSim::SetProfiler(Profiler* const profiler) {
+  if (profiler != nullptr && &profiler->GetNetlist() != pNetlist) {
+    throw std::invalid_argument("ERR: PROFILER BELONGS TO ANOTHER NETLIST! \n");
+  }
+  if (profiler != nullptr && !Profiler::IsEnabled()) {
+    throw std::logic_error("ERR: PROFILING IS COMPILED OUT! \n");
+  }
+  pProfiler = profiler;
+}
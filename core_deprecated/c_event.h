@@ -0,0 +1,127 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// include guard for this header
+#ifndef C_EVENT_H
+#define C_EVENT_H
+
+// includes for this header
+#include <array>          // std::array
+#include <vector>         // std::vector
+#include <cstdint>        // standard int types
+#include "c_netlist.h"    // class Netlist, GateKind
+#include "c_profile.h"    // class Profiler, CIM_PROFILE
+
+// namespace for entire project
+namespace Cim {
+
+// EventSim Class
+// Activity-driven simulation engine: only gates reading a net whose state
+// actually changed are re-evaluated. Value changes are scheduled on a timing
+// wheel (one bucket per time step) using per-gate-type propagation delays.
+class EventSim {
+ public:
+  // constructor (netlist must be levelized and outlive the engine)
+  explicit EventSim(const Netlist& TargetNetlist);
+
+  // destructor
+  ~EventSim() { /* DN */ }
+
+  // set / return the propagation delay of a combinational gate kind (in time steps, >= 1)
+  void SetDelay(const GateKind op, const uint32_t delay);
+  uint32_t GetDelay(const GateKind op) const;
+
+  // settle every net from the current primary inputs, drop pending events
+  void Initialize() noexcept;
+
+  // schedule a primary input change at the current time
+  void SetInput(const uint32_t net, const bool new_state);
+
+  // schedule every compiled input pin whose Pin::state_changed flag is set
+  void ApplyPinChanges();
+
+  // process the next time step holding events up to limit, false if there is none
+  // (time then moves past limit, later events stay pending)
+  bool Step(const uint64_t limit = UINT64_MAX);
+
+  // process events until the circuit is stable or max_time is reached
+  void Run(const uint64_t max_time = UINT64_MAX);
+
+  // return true if no event is pending
+  bool IsStable() const noexcept;
+
+  // return the next time step to be processed
+  uint64_t GetTime() const noexcept;
+
+  // return the state of a net
+  bool GetState(const uint32_t net) const;
+
+  // return the number of gate evaluations / applied net changes so far
+  uint64_t GetEvaluationNum() const noexcept;
+  uint64_t GetChangeNum() const noexcept;
+
+  // store changed nets back into the compiled components' pins
+  void WriteBack();
+
+  // attach a profiler of the same netlist (nullptr detaches), each Run() is one vector
+  void SetProfiler(Profiler* const profiler);
+
+ private:
+  // one scheduled net change
+  struct Event {
+    uint32_t  net;    // net to change
+    uint8_t   state;  // new state
+  };
+
+  // put an event into the bucket of time now + delay
+  void schedule(const uint32_t net, const uint8_t state, const uint32_t delay);
+
+ private:
+  const Netlist* pNetlist;                  // compiled circuit
+  std::array<uint32_t, kGateKindNum> delays; // delay per gate kind
+
+  // State
+  std::vector<uint8_t> nets;                // current state per net
+  std::vector<uint8_t> projected;           // last scheduled state per net
+  std::vector<uint32_t> touched;            // nets changed since WriteBack()
+  std::vector<uint8_t> is_touched;          // membership of touched
+
+  // Timing wheel
+  std::vector<std::vector<Event>> wheel;    // one bucket per time step (power of 2)
+  uint64_t now;                             // next time step to process
+  uint64_t pending;                         // events in the wheel
+
+  // Scratch
+  std::vector<Event> bucket;                // bucket being processed
+  std::vector<uint32_t> changed;            // nets changed in this step
+  std::vector<uint32_t> active;             // gates to evaluate in this step
+  std::vector<uint64_t> stamp;              // last step a gate was activated
+
+  // Statistics
+  uint64_t evaluations;                     // gate evaluations
+  uint64_t changes;                         // applied net changes
+  Profiler* pProfiler;                      // activity counters (nullptr if not profiled)
+};
+
+}
+
+#endif  // C_EVENT_H
@@ -0,0 +1,275 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// includes for this file
+#include "c_exhaustive.h"
+#include "c_bitsim.h"     // class BitParallelSim
+#include <algorithm>      // std::min
+#include <atomic>         // std::atomic
+#include <bitset>         // std::bitset::count
+#include <memory>         // std::unique_ptr
+#include <stdexcept>
+
+// using namespace for this project
+using namespace Cim;
+
+// helpers private to this file
+namespace {
+
+// combinations per chunk / 64-bit words per chunk and net
+constexpr uint32_t kChunkPatterns = 512;
+constexpr uint32_t kChunkWords = kChunkPatterns / 64;
+
+// chunks taken from the shared counter at once
+constexpr uint64_t kGrain = 16;
+
+// inputs 0 .. 5 vary inside a word: bit b of the pattern of input k is bit k of b
+constexpr uint64_t kInWord[6] = {
+  0xAAAAAAAAAAAAAAAAull, 0xCCCCCCCCCCCCCCCCull, 0xF0F0F0F0F0F0F0F0ull,
+  0xFF00FF00FF00FF00ull, 0xFFFF0000FFFF0000ull, 0xFFFFFFFF00000000ull
+};
+
+// mixing step of the signature hash
+inline uint64_t mix(uint64_t x) noexcept {
+  x ^= x >> 30;
+  x *= 0xBF58476D1CE4E5B9ull;
+  x ^= x >> 27;
+  x *= 0x94D049BB133111EBull;
+  return x ^ (x >> 31);
+}
+
+// set every input to its bit pattern for combinations [chunk * 512, (chunk + 1) * 512)
+void load_chunk(BitParallelSim& sim, const ArrayView<uint32_t> inputs, const uint64_t chunk) {
+  uint64_t words[kChunkWords];
+  for (uint32_t k = 0; k < inputs.size(); k++) {
+    for (uint32_t w = 0; w < kChunkWords; w++) {
+      if (k < 6) {
+        words[w] = kInWord[k];
+      } else if (k < 9) {
+        words[w] = ((w >> (k - 6)) & 1) ? ~uint64_t{0} : 0;
+      } else {
+        words[w] = ((chunk >> (k - 9)) & 1) ? ~uint64_t{0} : 0;
+      }
+    }
+    sim.SetInputWords(inputs[k], words);
+  }
+}
+
+// throw unless a netlist can be enumerated
+void check_netlist(const Netlist& netlist) {
+  if (!netlist.IsLevelized()) {
+    throw std::logic_error("ERR: NETLIST MUST BE LEVELIZED! \n");
+  }
+  if (netlist.GetRegisterNum() != 0) {
+    throw std::invalid_argument("ERR: EXHAUSTIVE ENUMERATION NEEDS A COMBINATIONAL NETLIST! \n");
+  }
+  if (netlist.GetInputs().size() > kMaxExhaustiveInputs) {
+    throw std::invalid_argument("ERR: TOO MANY INPUTS FOR EXHAUSTIVE ENUMERATION! \n");
+  }
+}
+
+}
+
+// constructor
+ExhaustiveSim::ExhaustiveSim(const Netlist& TargetNetlist, const uint32_t thread_num) :
+  pNetlist{&TargetNetlist}, pool(thread_num), input_num{0}, chunk_num{1} {
+  check_netlist(TargetNetlist);
+  input_num = TargetNetlist.GetInputs().size();
+  chunk_num = std::max<uint64_t>(GetCombinationNum() / kChunkPatterns, 1);
+}
+
+// return the number of primary inputs
+uint32_t ExhaustiveSim::GetInputNum() const noexcept {
+  return this->input_num;
+}
+
+// return the number of primary outputs
+uint32_t ExhaustiveSim::GetOutputNum() const noexcept {
+  return pNetlist->GetOutputs().size();
+}
+
+// return the number of input combinations
+uint64_t ExhaustiveSim::GetCombinationNum() const noexcept {
+  return uint64_t{1} << input_num;
+}
+
+// return the number of threads
+uint32_t ExhaustiveSim::GetThreadNum() const noexcept {
+  return pool.GetThreadNum();
+}
+
+// return the number of words of one truth table
+uint64_t ExhaustiveSim::GetTableWordNum() const noexcept {
+  return std::max<uint64_t>(GetCombinationNum() / 64, 1);
+}
+
+// run fn(thread, chunk) on every chunk
+template <typename Function>
+void ExhaustiveSim::for_each_chunk(Function&& fn) {
+  std::atomic<uint64_t> next{0};
+  std::atomic<bool> stop{false};
+  pool.Run([&](const uint32_t self) {
+    while (!stop.load(std::memory_order_relaxed)) {
+      const uint64_t first = next.fetch_add(kGrain, std::memory_order_relaxed);
+      if (first >= chunk_num) {
+        return;
+      }
+      const uint64_t last = std::min(first + kGrain, chunk_num);
+      for (uint64_t chunk = first; chunk < last; chunk++) {
+        if (!fn(self, chunk)) {
+          stop.store(true, std::memory_order_relaxed);
+          return;
+        }
+      }
+    }
+  });
+}
+
+// return the truth tables of all outputs
+std::vector<uint64_t> ExhaustiveSim::ComputeTruthTables() {
+  const ArrayView<uint32_t> inputs = pNetlist->GetInputs();
+  const ArrayView<uint32_t> outputs = pNetlist->GetOutputs();
+  const uint64_t table_words = GetTableWordNum();
+  // fewer than 512 combinations: one chunk, the patterns repeat beyond 2^n
+  const uint32_t used = static_cast<uint32_t>(std::min<uint64_t>(table_words, kChunkWords));
+  const uint64_t mask = (input_num < 6) ? (uint64_t{1} << GetCombinationNum()) - 1 : ~uint64_t{0};
+  std::vector<uint64_t> tables(outputs.size() * table_words);
+  std::vector<std::unique_ptr<BitParallelSim>> sims(GetThreadNum());
+  for_each_chunk([&](const uint32_t self, const uint64_t chunk) {
+    if (!sims[self]) {
+      sims[self] = std::make_unique<BitParallelSim>(*pNetlist, kChunkPatterns);
+    }
+    BitParallelSim& sim = *sims[self];
+    load_chunk(sim, inputs, chunk);
+    sim.Evaluate();
+    // chunks write disjoint words of every table
+    for (uint32_t o = 0; o < outputs.size(); o++) {
+      const uint64_t* const words = sim.GetWords(outputs[o]);
+      uint64_t* const table = tables.data() + o * table_words + chunk * kChunkWords;
+      for (uint32_t w = 0; w < used; w++) {
+        table[w] = words[w] & mask;
+      }
+    }
+    return true;
+  });
+  return tables;
+}
+
+// return one signature per output
+std::vector<OutputSignature> ExhaustiveSim::ComputeSignatures() {
+  const ArrayView<uint32_t> inputs = pNetlist->GetInputs();
+  const ArrayView<uint32_t> outputs = pNetlist->GetOutputs();
+  const uint32_t used = static_cast<uint32_t>(std::min<uint64_t>(GetTableWordNum(), kChunkWords));
+  const uint64_t mask = (input_num < 6) ? (uint64_t{1} << GetCombinationNum()) - 1 : ~uint64_t{0};
+  // per thread sums, combined at the end (xor & + do not depend on the chunk order)
+  std::vector<std::vector<OutputSignature>> partial(GetThreadNum(),
+      std::vector<OutputSignature>(outputs.size(), OutputSignature{0, 0}));
+  std::vector<std::unique_ptr<BitParallelSim>> sims(GetThreadNum());
+  for_each_chunk([&](const uint32_t self, const uint64_t chunk) {
+    if (!sims[self]) {
+      sims[self] = std::make_unique<BitParallelSim>(*pNetlist, kChunkPatterns);
+    }
+    BitParallelSim& sim = *sims[self];
+    load_chunk(sim, inputs, chunk);
+    sim.Evaluate();
+    for (uint32_t o = 0; o < outputs.size(); o++) {
+      const uint64_t* const words = sim.GetWords(outputs[o]);
+      uint64_t hash = mix(chunk + 1);
+      for (uint32_t w = 0; w < used; w++) {
+        const uint64_t bits = words[w] & mask;
+        partial[self][o].ones += std::bitset<64>(bits).count();
+        hash = mix(hash ^ bits);
+      }
+      partial[self][o].hash ^= hash;
+    }
+    return true;
+  });
+  std::vector<OutputSignature> result(outputs.size(), OutputSignature{0, 0});
+  for (const std::vector<OutputSignature>& each_thread : partial) {
+    for (uint32_t o = 0; o < outputs.size(); o++) {
+      result[o].ones += each_thread[o].ones;
+      result[o].hash ^= each_thread[o].hash;
+    }
+  }
+  return result;
+}
+
+// compare with another netlist of as many inputs & outputs
+EquivalenceResult ExhaustiveSim::CheckEquivalence(const Netlist& other) {
+  check_netlist(other);
+  const ArrayView<uint32_t> inputs = pNetlist->GetInputs(), other_inputs = other.GetInputs();
+  const ArrayView<uint32_t> outputs = pNetlist->GetOutputs(), other_outputs = other.GetOutputs();
+  if (other_inputs.size() != inputs.size() || other_outputs.size() != outputs.size()) {
+    throw std::invalid_argument("ERR: NETLISTS HAVE DIFFERENT INTERFACES! \n");
+  }
+  const uint32_t used = static_cast<uint32_t>(std::min<uint64_t>(GetTableWordNum(), kChunkWords));
+  const uint64_t mask = (input_num < 6) ? (uint64_t{1} << GetCombinationNum()) - 1 : ~uint64_t{0};
+  // lowest mismatch as (combination << 32 | output), combinations are below 2^32
+  std::atomic<uint64_t> first{UINT64_MAX};
+  std::vector<uint64_t> checked(GetThreadNum(), 0);
+  std::vector<std::unique_ptr<BitParallelSim>> sims(GetThreadNum()), other_sims(GetThreadNum());
+  for_each_chunk([&](const uint32_t self, const uint64_t chunk) {
+    if (!sims[self]) {
+      sims[self] = std::make_unique<BitParallelSim>(*pNetlist, kChunkPatterns);
+      other_sims[self] = std::make_unique<BitParallelSim>(other, kChunkPatterns);
+    }
+    BitParallelSim& sim = *sims[self];
+    BitParallelSim& other_sim = *other_sims[self];
+    load_chunk(sim, inputs, chunk);
+    load_chunk(other_sim, other_inputs, chunk);
+    sim.Evaluate();
+    other_sim.Evaluate();
+    checked[self] += std::min<uint64_t>(GetCombinationNum(), kChunkPatterns);
+    // 1. lowest word with any difference
+    for (uint32_t w = 0; w < used; w++) {
+      uint64_t any = 0;
+      for (uint32_t o = 0; o < outputs.size(); o++) {
+        any |= (sim.GetWords(outputs[o])[w] ^ other_sim.GetWords(other_outputs[o])[w]) & mask;
+      }
+      if (any == 0) {
+        continue;
+      }
+      // 2. lowest combination of it, lowest output differing on that combination
+      const uint32_t bit = std::bitset<64>((any & (~any + 1)) - 1).count();
+      uint32_t output = 0;
+      while ((((sim.GetWords(outputs[output])[w] ^ other_sim.GetWords(other_outputs[output])[w]) >> bit) & 1) == 0) {
+        output++;
+      }
+      const uint64_t key = ((chunk * kChunkPatterns + 64 * w + bit) << 32) | output;
+      uint64_t current = first.load();
+      while (key < current && !first.compare_exchange_weak(current, key)) {
+      }
+      return false;
+    }
+    return true;
+  });
+  EquivalenceResult result{true, 0, 0, 0};
+  for (const uint64_t each_count : checked) {
+    result.checked += each_count;
+  }
+  if (first.load() != UINT64_MAX) {
+    result.equivalent = false;
+    result.input = first.load() >> 32;
+    result.output = static_cast<uint32_t>(first.load());
+  }
+  return result;
+}
@@ -0,0 +1,107 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// include guard for this header
+#ifndef C_EXHAUSTIVE_H
+#define C_EXHAUSTIVE_H
+
+// includes for this header
+#include <vector>         // std::vector
+#include <cstdint>        // standard int types
+#include "c_netlist.h"    // class Netlist
+#include "c_threads.h"    // class ThreadPool
+
+// namespace for entire project
+namespace Cim {
+
+// most primary inputs an exhaustive run accepts (2^32 combinations)
+constexpr uint32_t kMaxExhaustiveInputs = 32;
+
+// summary of one output over every input combination
+struct OutputSignature {
+  uint64_t  ones;   // number of combinations on which the output is 1
+  uint64_t  hash;   // hash of the whole truth table (equal tables -> equal hashes)
+};
+
+// outcome of an exhaustive equivalence check
+struct EquivalenceResult {
+  bool      equivalent;   // no input combination tells the netlists apart
+  uint64_t  input;        // lowest combination that does (bit k = input k), if not equivalent
+  uint32_t  output;       // lowest output that differs on it
+  uint64_t  checked;      // combinations evaluated
+};
+
+// ExhaustiveSim Class
+// Evaluates a combinational netlist on every combination of its primary inputs.
+// Combination m sets input k (in Netlist::GetInputs() order) to bit k of m. The
+// combinations are cut into chunks of 512, each one pass of a 512-pattern
+// BitParallelSim whose input words are the fixed bit patterns of the chunk, and
+// the threads of a pool take chunks in increasing order from a shared counter.
+// The results are full truth tables (one bit per combination and output),
+// signatures that need no table, or the first combination on which two
+// netlists with the same interface disagree.
+class ExhaustiveSim {
+ public:
+  // constructor (netlist must be levelized, combinational, with at most kMaxExhaustiveInputs inputs;
+  // thread_num 0 -> hardware threads)
+  explicit ExhaustiveSim(const Netlist& TargetNetlist, const uint32_t thread_num = 0);
+
+  // destructor
+  ~ExhaustiveSim() { /* DN */ }
+
+  // return the number of primary inputs / outputs / input combinations
+  uint32_t GetInputNum() const noexcept;
+  uint32_t GetOutputNum() const noexcept;
+  uint64_t GetCombinationNum() const noexcept;
+
+  // return the number of threads
+  uint32_t GetThreadNum() const noexcept;
+
+  // return the number of words of one truth table (bits above 2^n of a short table are 0)
+  uint64_t GetTableWordNum() const noexcept;
+
+  // return the truth tables of all outputs: output o owns words [o * GetTableWordNum(), (o + 1) * ...),
+  // bit m of a table is the output for combination m
+  std::vector<uint64_t> ComputeTruthTables();
+
+  // return one signature per output (memory independent of the input number)
+  std::vector<OutputSignature> ComputeSignatures();
+
+  // compare with another netlist of as many inputs & outputs (paired in order), stops at the first mismatch
+  EquivalenceResult CheckEquivalence(const Netlist& other);
+
+ private:
+  // run fn(thread, sim, chunk) on every chunk, the chunks of a thread in increasing order;
+  // no chunk is started after fn returned false
+  template <typename Function>
+  void for_each_chunk(Function&& fn);
+
+ private:
+  const Netlist* pNetlist;      // compiled circuit
+  ThreadPool pool;              // worker threads
+  uint32_t input_num;           // primary inputs
+  uint64_t chunk_num;           // chunks of 512 combinations (at least 1)
+};
+
+}
+
+#endif  // C_EXHAUSTIVE_H
@@ -0,0 +1,271 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// includes for this file
+#include "c_fault.h"
+#include <stdexcept>
+#include <random>     // std::mt19937_64
+#include <algorithm>  // std::fill
+
+// using namespace for this project
+using namespace Cim;
+
+// constructor
+FaultSim::FaultSim(const Netlist& TargetNetlist) :
+  pNetlist{&TargetNetlist}, good(TargetNetlist, 64),
+  good_words{(TargetNetlist.GetNetNum() == 0) ? nullptr : good.GetWords(0)},
+  // Faults
+  faults(), detecting(), live(), detected_num{0},
+  // Cone
+  control(), observed(TargetNetlist.GetNetNum(), 0), gate_level(TargetNetlist.GetGateNum(), 0),
+  faulty(TargetNetlist.GetNetNum(), 0), stamp(TargetNetlist.GetNetNum(), 0),
+  queued(TargetNetlist.GetGateNum(), 0), buckets(TargetNetlist.GetLevelNum()), epoch{0}, top_level{0},
+  // Statistics
+  pattern_num{0}, event_num{0} {
+  // 1. two faults per pin
+  const ArrayView<Instruction> program = TargetNetlist.GetProgram();
+  for (uint32_t g = 0; g < program.size(); g++) {
+    for (uint32_t k = 0; k <= program[g].fanin_count; k++) {
+      faults.push_back(Fault{g, static_cast<uint16_t>(k), 0, 0});
+      faults.push_back(Fault{g, static_cast<uint16_t>(k), 1, 0});
+    }
+  }
+  detecting.assign(faults.size(), UINT64_MAX);
+  live.reserve(faults.size());
+  for (uint32_t f = 0; f < faults.size(); f++) {
+    live.push_back(f);
+  }
+  // 2. controlled & observed nets (registers are scanned)
+  const ArrayView<uint32_t> inputs = TargetNetlist.GetInputs();
+  control.assign(inputs.begin(), inputs.end());
+  for (const Register& each_reg : TargetNetlist.GetRegisters()) {
+    control.push_back(each_reg.q_net);
+    observed[each_reg.d_net] = 1;
+  }
+  for (const uint32_t each_net : TargetNetlist.GetOutputs()) {
+    observed[each_net] = 1;
+  }
+  // 3. level of every gate
+  const ArrayView<uint32_t> levels = TargetNetlist.GetLevelOffsets();
+  for (uint32_t l = 0; l + 1 < levels.size(); l++) {
+    for (uint32_t g = levels[l]; g < levels[l + 1]; g++) {
+      gate_level[g] = l;
+    }
+  }
+}
+
+// return the fault list
+const std::vector<Fault>& FaultSim::GetFaults() const noexcept {
+  return this->faults;
+}
+
+// return the number of faults
+uint32_t FaultSim::GetFaultNum() const noexcept {
+  return this->faults.size();
+}
+
+// return "gate.pin/SA0" for a fault
+std::string FaultSim::GetFaultName(const uint32_t fault) const {
+  const Fault& each_fault = faults.at(fault);
+  const Instruction& ins = pNetlist->GetProgram()[each_fault.gate];
+  std::string name(pNetlist->GetGateName(each_fault.gate));
+  if (name.empty()) {
+    name = "g" + std::to_string(each_fault.gate);
+  }
+  const std::string_view pin = pNetlist->GetPinName(each_fault.gate, each_fault.pin);
+  if (!pin.empty()) {
+    name += "." + std::string(pin);
+  } else if (each_fault.pin == ins.fanin_count) {
+    name += ".out";
+  } else {
+    name += ".in" + std::to_string(each_fault.pin);
+  }
+  return name + (each_fault.stuck_at ? "/SA1" : "/SA0");
+}
+
+// return the number of controlled nets
+uint32_t FaultSim::GetControlNum() const noexcept {
+  return this->control.size();
+}
+
+// evaluate a gate in the current faulty machine
+uint64_t FaultSim::evaluate(const uint32_t gate, const uint32_t forced_pin, const uint64_t forced) const noexcept {
+  const Instruction& ins = pNetlist->GetProgram()[gate];
+  const uint32_t* const in = pNetlist->GetFanin().data() + ins.fanin_begin;
+  return EvaluateVariant<uint64_t>(ins.variant,
+      [this, in, forced_pin, forced](const uint32_t k) { return (k == forced_pin) ? forced : value(in[k]); },
+      ins.fanin_count, (ins.op == GateKind::LUT) ? pNetlist->GetLuts()[ins.lut] : 0);
+}
+
+// store a faulty value, schedule the readers if it differs from the good machine
+void FaultSim::assign(const uint32_t net, const uint64_t new_value, uint64_t& care, uint64_t& detect) {
+  const uint64_t diff = (new_value ^ good_words[net]) & care;
+  if (diff == 0) {
+    // same as the good machine -> the fault effect dies here
+    return;
+  }
+  stamp[net] = epoch;
+  faulty[net] = new_value;
+  if (observed[net] != 0) {
+    // only patterns before the first detecting one matter from now on
+    detect |= diff;
+    care = (detect & (~detect + 1)) - 1;
+  }
+  const ArrayView<uint32_t> offsets = pNetlist->GetFanoutOffsets();
+  const uint32_t* const readers = pNetlist->GetFanout().data();
+  for (uint32_t r = offsets[net]; r < offsets[net + 1]; r++) {
+    const uint32_t reader = readers[r];
+    if (queued[reader] != epoch) {
+      queued[reader] = epoch;
+      buckets[gate_level[reader]].push_back(reader);
+      if (gate_level[reader] > top_level) {
+        top_level = gate_level[reader];
+      }
+    }
+  }
+}
+
+// propagate one fault through its cone
+uint64_t FaultSim::propagate(const Fault& fault, const uint64_t valid) {
+  // a fresh epoch invalidates every faulty value of the previous fault
+  if (++epoch == 0) {
+    std::fill(stamp.begin(), stamp.end(), 0);
+    std::fill(queued.begin(), queued.end(), 0);
+    epoch = 1;
+  }
+  const Instruction& site = pNetlist->GetProgram()[fault.gate];
+  const uint64_t stuck = fault.stuck_at ? ~uint64_t{0} : 0;
+  uint64_t care = valid, detect = 0;
+  // 1. fault site
+  event_num++;
+  const uint64_t site_value = (fault.pin == site.fanin_count) ? stuck : evaluate(fault.gate, fault.pin, stuck);
+  const uint32_t first_level = gate_level[fault.gate] + 1;
+  top_level = 0;
+  assign(site.out_net, site_value, care, detect);
+  // 2. cone, level by level, until no earlier pattern can see the fault
+  for (uint32_t l = first_level; l <= top_level && l < buckets.size(); l++) {
+    std::vector<uint32_t>& bucket = buckets[l];
+    for (uint32_t i = 0; i < bucket.size() && care != 0; i++) {
+      const uint32_t gate = bucket[i];
+      event_num++;
+      assign(pNetlist->GetProgram()[gate].out_net, evaluate(gate, UINT32_MAX, 0), care, detect);
+    }
+    bucket.clear();
+  }
+  // 3. drop what an early exit left scheduled
+  for (uint32_t l = first_level; l <= top_level && l < buckets.size(); l++) {
+    buckets[l].clear();
+  }
+  return detect;
+}
+
+// simulate up to 64 patterns
+uint32_t FaultSim::Simulate(const std::vector<uint64_t>& input_words, const uint32_t pattern_num) {
+  if (input_words.size() != control.size()) {
+    throw std::invalid_argument("ERR: INPUT VECTOR SIZE MISMATCH! \n");
+  }
+  if (pattern_num == 0 || pattern_num > 64) {
+    throw std::invalid_argument("ERR: PATTERN NUMBER MUST BE 1 TO 64! \n");
+  }
+  // 1. good machine
+  for (uint32_t i = 0; i < control.size(); i++) {
+    good.SetInputWords(control[i], &input_words[i]);
+  }
+  good.Evaluate();
+  // 2. every live fault, dropped once detected
+  const uint64_t valid = (pattern_num == 64) ? ~uint64_t{0} : ((uint64_t{1} << pattern_num) - 1);
+  uint32_t found = 0;
+  uint32_t kept = 0;
+  for (const uint32_t f : live) {
+    const uint64_t detect = propagate(faults[f], valid);
+    if (detect != 0) {
+      uint32_t first = 0;
+      while (((detect >> first) & 1) == 0) {
+        first++;
+      }
+      detecting[f] = this->pattern_num + first;
+      found++;
+    } else {
+      live[kept++] = f;
+    }
+  }
+  live.resize(kept);
+  detected_num += found;
+  this->pattern_num += pattern_num;
+  return found;
+}
+
+// simulate pseudo random patterns
+uint32_t FaultSim::SimulateRandom(const uint64_t pattern_num, const uint64_t seed) {
+  std::mt19937_64 rng(seed);
+  std::vector<uint64_t> input_words(control.size());
+  uint32_t found = 0;
+  for (uint64_t done = 0; done < pattern_num && !live.empty(); done += 64) {
+    for (uint64_t& each_word : input_words) {
+      each_word = rng();
+    }
+    found += Simulate(input_words, (pattern_num - done < 64) ? pattern_num - done : 64);
+  }
+  return found;
+}
+
+// return whether a fault was detected
+bool FaultSim::IsDetected(const uint32_t fault) const {
+  return this->detecting.at(fault) != UINT64_MAX;
+}
+
+// return the first pattern detecting a fault
+uint64_t FaultSim::GetDetectingPattern(const uint32_t fault) const {
+  return this->detecting.at(fault);
+}
+
+// return the number of detected faults
+uint32_t FaultSim::GetDetectedNum() const noexcept {
+  return this->detected_num;
+}
+
+// return the detected fraction of all faults
+double FaultSim::GetCoverage() const noexcept {
+  return faults.empty() ? 1.0 : static_cast<double>(detected_num) / faults.size();
+}
+
+// return the patterns simulated
+uint64_t FaultSim::GetPatternNum() const noexcept {
+  return this->pattern_num;
+}
+
+// return the gate evaluations spent on faulty machines
+uint64_t FaultSim::GetEventNum() const noexcept {
+  return this->event_num;
+}
+
+// forget all detections
+void FaultSim::Reset() noexcept {
+  detecting.assign(faults.size(), UINT64_MAX);
+  live.clear();
+  for (uint32_t f = 0; f < faults.size(); f++) {
+    live.push_back(f);
+  }
+  detected_num = 0;
+  pattern_num = 0;
+  event_num = 0;
+}
@@ -0,0 +1,140 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// include guard for this header
+#ifndef C_FAULT_H
+#define C_FAULT_H
+
+// includes for this header
+#include <vector>         // std::vector
+#include <string>         // std::string
+#include <cstdint>        // standard int types
+#include "c_netlist.h"    // class Netlist
+#include "c_bitsim.h"     // class BitParallelSim
+
+// namespace for entire project
+namespace Cim {
+
+// one stuck-at fault: a pin of a gate (input pins first, output pin last) stuck at 0 or 1
+struct Fault {
+  uint32_t  gate;         // gate index in the program
+  uint16_t  pin;          // pin index, fanin_count for the output pin
+  uint8_t   stuck_at;     // stuck-at value
+  uint8_t   reserved;     // padding, always 0
+};
+
+// FaultSim Class
+// Parallel-pattern single-fault propagation: the good machine is simulated
+// for 64 patterns at once, then every fault that is still undetected is
+// injected at its site and only the gates of its fanout cone whose inputs
+// differ from the good machine are re-evaluated, in level order, with the
+// faulty values kept in an overlay on top of the good values. A fault is
+// detected (and dropped from all later batches) when a pattern makes an
+// observed net differ; propagation stops once no earlier pattern of the batch
+// is left to detect it. Observed nets are the primary outputs and the data
+// inputs of registers; register outputs are controlled like primary inputs
+// (full scan).
+class FaultSim {
+ public:
+  // constructor (netlist must be levelized and outlive the engine)
+  explicit FaultSim(const Netlist& TargetNetlist);
+
+  // destructor
+  ~FaultSim() { /* DN */ }
+
+  // return the fault list: stuck-at-0 & stuck-at-1 on every pin of every gate
+  const std::vector<Fault>& GetFaults() const noexcept;
+  uint32_t GetFaultNum() const noexcept;
+
+  // return "gate.pin/SA0" for a fault (indices stand in for missing names)
+  std::string GetFaultName(const uint32_t fault) const;
+
+  // return the number of controlled nets: primary inputs, then register outputs
+  uint32_t GetControlNum() const noexcept;
+
+  // simulate up to 64 patterns, bit p of input_words[i] is controlled net i in pattern p,
+  // returns the number of faults detected by them
+  uint32_t Simulate(const std::vector<uint64_t>& input_words, const uint32_t pattern_num = 64);
+
+  // simulate pseudo random patterns until all faults are detected or pattern_num ran out
+  uint32_t SimulateRandom(const uint64_t pattern_num, const uint64_t seed);
+
+  // return whether a fault was detected / the first pattern detecting it (UINT64_MAX if none)
+  bool IsDetected(const uint32_t fault) const;
+  uint64_t GetDetectingPattern(const uint32_t fault) const;
+
+  // return the number of detected faults / the detected fraction of all faults
+  uint32_t GetDetectedNum() const noexcept;
+  double GetCoverage() const noexcept;
+
+  // return the patterns simulated / the gate evaluations spent on faulty machines
+  uint64_t GetPatternNum() const noexcept;
+  uint64_t GetEventNum() const noexcept;
+
+  // forget all detections
+  void Reset() noexcept;
+
+ private:
+  // return the value of a net in the current faulty machine
+  inline uint64_t value(const uint32_t net) const noexcept {
+    return (stamp[net] == epoch) ? faulty[net] : good_words[net];
+  }
+
+  // evaluate a gate in the current faulty machine, forced_pin (if any) reads forced
+  uint64_t evaluate(const uint32_t gate, const uint32_t forced_pin, const uint64_t forced) const noexcept;
+
+  // store a faulty value, schedule the readers if it differs from the good machine
+  void assign(const uint32_t net, const uint64_t new_value, uint64_t& care, uint64_t& detect);
+
+  // propagate one fault through its cone, return a mask whose lowest bit is the first detecting pattern
+  uint64_t propagate(const Fault& fault, const uint64_t valid);
+
+ private:
+  const Netlist* pNetlist;                  // compiled circuit
+  BitParallelSim good;                      // good machine, 64 patterns
+  const uint64_t* good_words;               // one word per net of the good machine
+
+  // Faults
+  std::vector<Fault> faults;                // full fault list
+  std::vector<uint64_t> detecting;          // fault -> first detecting pattern
+  std::vector<uint32_t> live;               // undetected faults
+  uint32_t detected_num;                    // detected faults
+
+  // Cone
+  std::vector<uint32_t> control;            // controlled nets
+  std::vector<uint8_t> observed;            // net -> observed flag
+  std::vector<uint32_t> gate_level;         // gate -> level
+  std::vector<uint64_t> faulty;             // net -> faulty value (valid if stamped)
+  std::vector<uint32_t> stamp;              // net -> epoch of faulty value
+  std::vector<uint32_t> queued;             // gate -> epoch it was scheduled in
+  std::vector<std::vector<uint32_t>> buckets;  // level -> scheduled gates
+  uint32_t epoch;                           // current faulty machine
+  uint32_t top_level;                       // deepest scheduled level
+
+  // Statistics
+  uint64_t pattern_num;                     // patterns simulated
+  uint64_t event_num;                       // faulty gate evaluations
+};
+
+}
+
+#endif  // C_FAULT_H
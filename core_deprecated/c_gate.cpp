@@ -31,43 +31,72 @@ using namespace Cim;
 
 // constructor
 Gate::Gate(const Component* const ParentDevice, const std::string& GateName, const std::string& GateType,
-    const std::vector<std::string>& InPinNames, bool isMonitored) : 
+    const std::vector<std::string>& InPinNames, bool isMonitored, std::pmr::memory_resource* const Resource) : 
   // ID
-  name{GateName}, type{GateType},
+  name{GateName.data(), GateName.size(), Resource}, kind{ParseGateKind(GateType)}, table{0},
   // Properties
   monitored{isMonitored}, pParent{const_cast<Component*>(ParentDevice)}, index{UINT32_MAX},
   // IO
-  Pins() {
+  Pins(Resource), pin_index(Resource) {
   // codes & error-handling
-  // 1. check the number of inputs
-  const int input_size = InPinNames.size();
-  if (GateType == "NOT") {
-    if (input_size != 1) {
-      throw std::invalid_argument("ERR: NOT GATE MUST ONLY HAVE 1 INPUT! \n");
-    }
-  } else {
-    if (input_size < 2) {
-      throw std::invalid_argument("ERR: AT LEAST 2 INPUTS FOR THIS LOGIC GATES! \n");
-    }
+  // 1. a LUT needs its truth table
+  if (kind == GateKind::LUT) {
+    throw std::invalid_argument("ERR: LUT GATE NEEDS A TRUTH TABLE! \n");
   }
-  // 2. check nullptr
-  if (ParentDevice == nullptr) {
-    nesting_lvl = 0;
-    fullname = GateName;
-  } else {
-    nesting_lvl = pParent->GetNestingLvl() + 1;
-    fullname = pParent->GetFullName() + "::" + GateName;
+  // 2. flip-flops & latches are separate components
+  if (IsSequentialKind(kind)) {
+    throw std::invalid_argument("ERR: USE FlipFlop OR Latch FOR SEQUENTIAL ELEMENTS! \n");
+  }
+  make_pins(InPinNames);
+}
+
+// constructor (any kind)
+Gate::Gate(const Component* const ParentDevice, const std::string& GateName, const GateKind Kind,
+    const std::vector<std::string>& InPinNames, bool isMonitored, std::pmr::memory_resource* const Resource) :
+  // ID
+  name{GateName.data(), GateName.size(), Resource}, kind{Kind}, table{0},
+  // Properties
+  monitored{isMonitored}, pParent{const_cast<Component*>(ParentDevice)}, index{UINT32_MAX},
+  // IO
+  Pins(Resource), pin_index(Resource) {
+  make_pins(InPinNames);
+}
+
+// constructor (LUT gate)
+Gate::Gate(const Component* const ParentDevice, const std::string& GateName, const uint64_t TruthTable,
+    const std::vector<std::string>& InPinNames, bool isMonitored, std::pmr::memory_resource* const Resource) :
+  // ID
+  name{GateName.data(), GateName.size(), Resource}, kind{GateKind::LUT}, table{TruthTable},
+  // Properties
+  monitored{isMonitored}, pParent{const_cast<Component*>(ParentDevice)}, index{UINT32_MAX},
+  // IO
+  Pins(Resource), pin_index(Resource) {
+  make_pins(InPinNames);
+  // only the first 2^n bits of the table are meaningful
+  const uint32_t size = 1u << InPinNames.size();
+  if (size < 64) {
+    table &= (uint64_t{1} << size) - 1;
   }
+}
+
+// initialize input and output Pins
+void Gate::make_pins(const std::vector<std::string>& InPinNames) {
+  // 1. check the number of inputs
+  CheckGateInputs(kind, InPinNames.size());
+  // 2. check nullptr (the full name is not stored, see GetFullName())
+  nesting_lvl = (pParent == nullptr) ? 0 : pParent->GetNestingLvl() + 1;
   // initialize input and output Pins
   Pins.reserve(InPinNames.size() + 1);
   // 1. INPUTS
   uint32_t cur_pin_index = 0;
   for (const std::string& each_name : InPinNames) {
-    Pins.emplace_back(Pin{each_name, cur_pin_index, Pin::Dir::Input});
+    Pins.emplace_back(Pin{each_name, cur_pin_index, Pin::Dir::Input, Pins.get_allocator().resource()});
     cur_pin_index++;
   }
   // 2. OUTPUT
-  Pins.emplace_back(Pin{"out", cur_pin_index, Pin::Dir::Output});
+  Pins.emplace_back(Pin{"out", cur_pin_index, Pin::Dir::Output, Pins.get_allocator().resource()});
+  // 3. name index
+  pin_index.Build(Pins);
 }
 
 // initialize components to initial state
@@ -83,9 +112,15 @@ void Gate::Initialize() {
 }
 
 
-// return component full name
+// return component full name (parent full name + "::" + name, built on every call)
 std::string Gate::GetFullName() const noexcept {
-  return this->fullname;
+  if (pParent == nullptr) {
+    return std::string(this->name);
+  }
+  std::string result = pParent->GetFullName();
+  result += "::";
+  result += this->name;
+  return result;
 }
 
 // return nesting level
@@ -95,12 +130,22 @@ uint32_t Gate::GetNestingLvl() const noexcept {
 
 // return component type
 std::string Gate::GetType() const noexcept {
-  return this->type;
+  return GetGateKindName(this->kind);
+}
+
+// return component kind
+GateKind Gate::GetKind() const {
+  return this->kind;
+}
+
+// return the truth table of a LUT component
+uint64_t Gate::GetTruthTable() const {
+  return this->table;
 }
 
 // return component name
 std::string Gate::GetName() const noexcept {
-  return this->name;
+  return std::string(this->name);
 }
 
 // get inpins and outpins number
@@ -143,9 +188,14 @@ bool Gate::IsPinStateChanged(const uint32_t pin_idx) const {
   return this->Pins.at(pin_idx).state_changed;
 }
 
+// mark a pin change as consumed, without touching any state
+void Gate::ClearPinStateChanged(const uint32_t pin_idx) {
+  this->Pins.at(pin_idx).state_changed = false;
+}
+
 // return pin name
 std::string Gate::GetPinName(const uint32_t pin_idx) const {
-  return this->Pins.at(pin_idx).name;
+  return std::string(this->Pins.at(pin_idx).name);
 }
 
 // return whether a pin exist
@@ -163,6 +213,11 @@ uint32_t Gate::GetPinIndex(const std::string& pin_name) const {
   return pin->index;
 }
 
+// resolve a pin name once
+PinHandle Gate::ResolvePin(const std::string& pin_name) {
+  return PinHandle{this, GetPinIndex(pin_name)};
+}
+
 // check if pin is connected
 bool Gate::IsPinConnected(const uint32_t pin_idx) const {
   const auto& connections = this->Pins.at(pin_idx).connections;
@@ -204,12 +259,17 @@ bool Gate::IsPinConnected(const std::string& pin_name) const {
 }
 
 // return & modify the connection of that pin
-std::vector<Pin::Link>& Gate::GetPinConnection(const uint32_t pin_idx) {
+std::pmr::vector<Pin::Link>& Gate::GetPinConnection(const uint32_t pin_idx) {
+  return this->Pins.at(pin_idx).connections;
+}
+
+// return the connection of that pin, read only
+const std::pmr::vector<Pin::Link>& Gate::GetPinConnection(const uint32_t pin_idx) const {
   return this->Pins.at(pin_idx).connections;
 }
 
 // return & modify the connection of that pin
-std::vector<Pin::Link>& Gate::GetPinConnection(const std::string& pin_name) {
+std::pmr::vector<Pin::Link>& Gate::GetPinConnection(const std::string& pin_name) {
   Pin* const pin = search(pin_name);
   if (pin == nullptr) {
     throw std::invalid_argument("ERR: PIN DOES NOT EXIST! \n");
@@ -232,36 +292,33 @@ Pin::Dir Gate::GetPinDirection(const std::string& pin_name) const {
   return pin->direction;
 }
 
-// return list of output pins
-const std::vector<Pin> Gate::GetOutPins() const {
+// return a non-owning view of the output pins
+PinRange Gate::GetOutPins() const noexcept {
   assert(Pins.rbegin()->direction == Pin::Dir::Output);
-  return std::vector<Pin>{*this->Pins.rbegin()};
+  return PinRange(this, Pins.size() - 1, Pins.size());
 }
 
-// return list of input pins
-const std::vector<Pin> Gate::GetInPins() const {
-  std::vector<Pin> in_pins;
-  in_pins.reserve(this->Pins.size() - 1);
-  for (uint32_t i = 0; i < Pins.size() - 1; i++) {
-    if (Pins.at(i).direction != Pin::Dir::Input) {
-      throw std::logic_error("ERR: OUTPUT PIN MISPLACED! CHECK OUTPUT PIN! \n");
-    } else {
-      in_pins.push_back(Pins.at(i));
-    }
+// return a non-owning view of the input pins
+PinRange Gate::GetInPins() const noexcept {
+  // output pin is always the last one (see constructor)
+  return PinRange(this, 0, Pins.size() - 1);
+}
+
+// return the states of 64 input pins starting at pin (64 * word)
+uint64_t Gate::GetInPinStates(const uint32_t word) const noexcept {
+  uint64_t states = 0;
+  const uint32_t in_num = Pins.size() - 1;
+  for (uint32_t i = word * 64, b = 0; i < in_num && b < 64; i++, b++) {
+    states |= static_cast<uint64_t>(Pins[i].state) << b;
   }
-  assert(in_pins.size() == this->Pins.size() - 1);
-  return in_pins;
+  return states;
 }
 
 // search for a pin by name
 Pin* const Gate::search(const std::string& pin_name) const {
-  for (uint32_t i = 0; i < Pins.size(); i++) {
-    if (Pins[i].name == pin_name) {
-      return const_cast<Pin* const>(&Pins[i]);
-    }
-  }
-  // if not found -> nullptr
-  return nullptr;
+  // hashed per component, no shared table involved
+  const uint32_t pin_idx = pin_index.Find(Pins, pin_name);
+  return (pin_idx == UINT32_MAX) ? nullptr : const_cast<Pin* const>(&Pins[pin_idx]);
 }
 
 // print input pins' states
@@ -326,74 +383,10 @@ void Gate::Set(const std::string& pin_name, const bool new_state) {
   pin->state = new_state;
 }
 
-// evaluation of each type of gate
-bool Gate::AND(const std::vector<Pin>& pins) {
-  int assert_counter = 0;
-  bool output = true;
-  for (const Pin& each_pin : pins) {
-    if (each_pin.direction == Pin::Dir::Input) {
-      output &= each_pin.state;
-      assert_counter++;
-    }
-  }
-  assert(assert_counter == pins.size() - 1);
-  return output;
-} // AND
-
-bool Gate::OR(const std::vector<Pin>& pins) {
-  int assert_counter = 0;
-  bool output = false;
-  for (const Pin& each_pin : pins) {
-    if (each_pin.direction == Pin::Dir::Input) {
-      output |= each_pin.state;
-      assert_counter++;
-    }
-  }
-  assert(assert_counter == pins.size() - 1);
-  return output;
-} // OR
-
-bool Gate::NOT(const std::vector<Pin>& pins) {
-  int assert_counter = 0;
-  bool output = false;
-  for (const Pin& each_pin : pins) {
-    if (each_pin.direction == Pin::Dir::Input) {
-      output = !each_pin.state;
-      assert_counter++;
-    }
-  }
-  assert(assert_counter == 1 && pins.size() == 2);
-  return output;
-} // NOT
-
-bool Gate::NAND(const std::vector<Pin>& pins) {
-  return !AND(pins);
-} // NAND
-
-bool Gate::NOR(const std::vector<Pin>& pins) {
-  return !OR(pins);
-} // NOR
-
-// Special Note for XOR:
-// For 3 or more inputs, the XOR gate has a value of 1, when there is an odd number of
-// 1's in the inputs, otherwise, it is a 0.
-// This also applies when there are only two inputs.
-bool Gate::XOR(const std::vector<Pin>& pins) {
-  int input_counter = 0;
-  int num_of_1 = 0;
-  for (const Pin& each_pin : pins) {
-    if (each_pin.direction != Pin::Dir::Input) {
-      continue;
-    }
-    input_counter++;
-    if (each_pin.state == true) {
-      num_of_1++;
-    }
-  }
-  assert(input_counter == pins.size() - 1);
-  return (num_of_1 % 2 != 0) ? true : false;
-} // XOR
-
-bool Gate::XNOR(const std::vector<Pin>& pins) {
-  return !XOR(pins);
-} // XNOR
+// return the output state computed from the current input pins
+bool Gate::Evaluate() const noexcept {
+  // input pins are [0, n - 1) by construction -> no direction checks
+  const Pin* const pins = Pins.data();
+  return EvaluateKind<uint8_t>(kind, [pins](const uint32_t k) { return static_cast<uint8_t>(pins[k].state); },
+      Pins.size() - 1, table) != 0;
+}
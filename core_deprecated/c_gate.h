@@ -28,6 +28,7 @@
 #include <iostream>       // std::cout, std::endl
 #include "c_component.h"  // class Component
 #include "c_structs.h"    // Pin, forward declaration
+#include "c_kernels.h"    // EvaluateKind()
 
 // namespace for entire project
 namespace Cim {
@@ -36,9 +37,15 @@ namespace Cim {
 // Gate is the most basic component -> building block for other devices
 class Gate : public Component {
  public:
-  // constructor
+  // constructor (names & pins are allocated from Resource, e.g. an Arena)
   Gate(const Component* const ParentDevice, const std::string& GateName, const std::string& GateType,
-      const std::vector<std::string>& InPinNames, bool isMonitored = false);
+      const std::vector<std::string>& InPinNames, bool isMonitored = false,
+      std::pmr::memory_resource* const Resource = std::pmr::get_default_resource());
+
+  // constructor (LUT gate, bit (sum of input k << k) of TruthTable is the output)
+  Gate(const Component* const ParentDevice, const std::string& GateName, const uint64_t TruthTable,
+      const std::vector<std::string>& InPinNames, bool isMonitored = false,
+      std::pmr::memory_resource* const Resource = std::pmr::get_default_resource());
 
   // destructor
   ~Gate() { /* DN */ }
@@ -74,12 +81,18 @@ class Gate : public Component {
   // return component name
   virtual std::string GetName() const noexcept override;
 
-  // return component full name
+  // return component full name (built from the parents on every call)
   virtual std::string GetFullName() const noexcept override;
 
   // return component type
   virtual std::string GetType() const noexcept override;
 
+  // return component kind
+  virtual GateKind GetKind() const override;
+
+  // return the truth table of a LUT component (0 for other kinds)
+  virtual uint64_t GetTruthTable() const override;
+
   // return nesting level
   virtual uint32_t GetNestingLvl() const noexcept override;
 
@@ -89,14 +102,20 @@ class Gate : public Component {
   // return if state changed after the last evaluation
   virtual bool IsPinStateChanged(const uint32_t pin_idx) const override;
 
+  // mark a pin change as consumed, without touching any state
+  virtual void ClearPinStateChanged(const uint32_t pin_idx) override;
+
   // return pin name
   virtual std::string GetPinName(const uint32_t pin_idx) const override;
 
-  // return list of input pins
-  virtual const std::vector<Pin> GetInPins() const override;
+  // return a non-owning view of the input pins
+  virtual PinRange GetInPins() const noexcept override;
+
+  // return a non-owning view of the output pins
+  virtual PinRange GetOutPins() const noexcept override;
 
-  // return list of output pins
-  virtual const std::vector<Pin> GetOutPins() const override;
+  // return the states of 64 input pins starting at pin (64 * word), one bit per pin
+  virtual uint64_t GetInPinStates(const uint32_t word = 0) const noexcept override;
 
   // return the pin's direction
   virtual Pin::Dir GetPinDirection(const uint32_t pin_idx) const override;
@@ -105,9 +124,15 @@ class Gate : public Component {
   // return pin index
   virtual uint32_t GetPinIndex(const std::string& pin_name) const override;
 
+  // resolve a pin name once, the handle replaces the name in later calls
+  virtual PinHandle ResolvePin(const std::string& pin_name) override;
+
   // return & modify the connection of that pin
-  virtual std::vector<Pin::Link>& GetPinConnection(const uint32_t pin_idx) override;
-  virtual std::vector<Pin::Link>& GetPinConnection(const std::string& pin_name) override;
+  virtual std::pmr::vector<Pin::Link>& GetPinConnection(const uint32_t pin_idx) override;
+  virtual std::pmr::vector<Pin::Link>& GetPinConnection(const std::string& pin_name) override;
+
+  // return the connection of that pin, read only
+  virtual const std::pmr::vector<Pin::Link>& GetPinConnection(const uint32_t pin_idx) const override;
 
   // return whether a pin exist
   virtual bool DoesPinExist(const std::string& pin_name) const override;
@@ -122,24 +147,26 @@ class Gate : public Component {
   // print output pins' states
   virtual void PrintOutPinStates() const noexcept override;
 
+  // return the output state computed from the current input pins
+  bool Evaluate() const noexcept;
+
+ protected:
+  // constructor (any kind, used by the sequential elements, see c_sequential.h)
+  Gate(const Component* const ParentDevice, const std::string& GateName, const GateKind Kind,
+      const std::vector<std::string>& InPinNames, bool isMonitored, std::pmr::memory_resource* const Resource);
+
  private:
   // search for a pin by name
   Pin* const search(const std::string& pin_name) const;
 
-  // evaluation of each type of gate
-  static bool AND(const std::vector<Pin>& pins);    // AND
-  static bool OR(const std::vector<Pin>& pins);     // OR
-  static bool XOR(const std::vector<Pin>& pins);    // XOR
-  static bool NOT(const std::vector<Pin>& pins);    // NOT
-  static bool NAND(const std::vector<Pin>& pins);   // NAND
-  static bool NOR(const std::vector<Pin>& pins);    // NOR
-  static bool XNOR(const std::vector<Pin>& pins);   // XNOR
+  // initialize input and output Pins
+  void make_pins(const std::vector<std::string>& InPinNames);
 
  private:
   // IDs
-  std::string name;     // gate name
-  std::string fullname; // gate fullname = name + parent name
-  std::string type;     // gate type
+  std::pmr::string name;      // gate name (the full name is built from the parents on demand)
+  GateKind kind;        // gate type
+  uint64_t table;       // truth table (LUT only)
 
   // Property
   bool monitored;       // if output of gate is monitored
@@ -148,7 +175,8 @@ class Gate : public Component {
   uint32_t nesting_lvl; // level of nesting
 
   // I/O
-  std::vector<Pin> Pins; // In & Out pin list
+  std::pmr::vector<Pin> Pins; // In & Out pin list
+  PinIndex pin_index;         // pin name -> index
 };
 
 }
@@ -0,0 +1,830 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// includes for this file
+#include "c_import.h"
+#include <fstream>
+#include <stdexcept>
+#include <chrono>
+#include <cstring>
+#include <cctype>
+#include <algorithm>
+
+// using namespace for this project
+using namespace Cim;
+
+// helpers private to this file
+namespace {
+
+// size of one block read from the stream
+constexpr size_t kBlockSize = size_t{1} << 16;
+
+// throw a parse error carrying the line number
+[[noreturn]] void fail(const char* const what, const uint64_t line) {
+  throw std::invalid_argument(std::string("ERR: ") + what + " AT LINE " + std::to_string(line) + "! \n");
+}
+
+// return true for characters allowed in an identifier
+bool is_ident(const char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$' || c == '\'' ||
+      c == '.' || c == '[' || c == ']';
+}
+
+// return s without leading / trailing white space
+std::string_view trim(std::string_view s) {
+  while (!s.empty() && std::isspace(static_cast<unsigned char>(s.front()))) s.remove_prefix(1);
+  while (!s.empty() && std::isspace(static_cast<unsigned char>(s.back()))) s.remove_suffix(1);
+  return s;
+}
+
+// return s in upper case
+std::string upper(const std::string_view s) {
+  std::string result(s);
+  for (char& c : result) {
+    c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+  }
+  return result;
+}
+
+// split s at white space into tokens (views into s)
+void split(const std::string_view s, std::vector<std::string_view>& tokens) {
+  tokens.clear();
+  size_t i = 0;
+  while (i < s.size()) {
+    while (i < s.size() && std::isspace(static_cast<unsigned char>(s[i]))) i++;
+    const size_t begin = i;
+    while (i < s.size() && !std::isspace(static_cast<unsigned char>(s[i]))) i++;
+    if (i > begin) {
+      tokens.push_back(s.substr(begin, i - begin));
+    }
+  }
+}
+
+// BlockReader Class
+// Pulls a stream through one fixed-size block and hands out lines or
+// ';'-terminated statements, reusing the caller's string as storage.
+class BlockReader {
+ public:
+  explicit BlockReader(std::istream& In) : in{In}, block(kBlockSize), pos{0}, size{0}, byte_num{0}, line_num{0} {}
+
+  // read the next line without its terminator, false at end of stream
+  bool NextLine(std::string& line) {
+    line.clear();
+    bool any = false;
+    for (;;) {
+      if (pos == size && !fill()) {
+        break;
+      }
+      any = true;
+      const char* const begin = block.data() + pos;
+      const char* const end = static_cast<const char*>(std::memchr(begin, '\n', size - pos));
+      if (end == nullptr) {
+        line.append(begin, size - pos);
+        pos = size;
+        continue;
+      }
+      line.append(begin, end - begin);
+      pos += (end - begin) + 1;
+      break;
+    }
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    line_num += any;
+    return any;
+  }
+
+  // read the next statement up to ';' with comments removed, false at end of stream
+  bool NextStatement(std::string& stmt) {
+    stmt.clear();
+    int c;
+    while ((c = get()) != EOF) {
+      if (c == ';') {
+        return true;
+      }
+      if (c == '/' && peek() == '/') {
+        while ((c = get()) != EOF && c != '\n') {}
+        stmt.push_back(' ');
+      } else if (c == '/' && peek() == '*') {
+        get();
+        int prev = 0;
+        while ((c = get()) != EOF && !(prev == '*' && c == '/')) prev = c;
+        stmt.push_back(' ');
+      } else {
+        stmt.push_back(static_cast<char>(c));
+      }
+    }
+    return !trim(stmt).empty();
+  }
+
+  // return bytes read / lines started so far
+  uint64_t GetByteNum() const noexcept { return byte_num; }
+  uint64_t GetLineNum() const noexcept { return line_num + 1; }
+
+  // return the bytes held by the reader
+  size_t GetBufferByteNum() const noexcept { return block.capacity(); }
+
+ private:
+  // load the next block, false at end of stream
+  bool fill() {
+    in.read(block.data(), static_cast<std::streamsize>(block.size()));
+    size = static_cast<size_t>(in.gcount());
+    pos = 0;
+    byte_num += size;
+    return size != 0;
+  }
+
+  int get() {
+    if (pos == size && !fill()) return EOF;
+    const char c = block[pos++];
+    line_num += (c == '\n');
+    return static_cast<unsigned char>(c);
+  }
+
+  int peek() {
+    if (pos == size && !fill()) return EOF;
+    return static_cast<unsigned char>(block[pos]);
+  }
+
+ private:
+  std::istream& in;           // source stream
+  std::vector<char> block;    // current block
+  size_t pos;                 // read position in block
+  size_t size;                // valid bytes in block
+  uint64_t byte_num;          // bytes read so far
+  uint64_t line_num;          // complete lines read so far
+};
+
+// Builder Class
+// Thin layer over the Netlist builder that names nets on first use and maps
+// the gate flavours of the file formats onto GateKind / LUT gates. It also
+// tracks how every named net is used, so that a net driven twice, an input
+// driven by a gate, or a net nobody drives is reported with its line instead
+// of turning into a primary input.
+class Builder {
+ public:
+  explicit Builder(Netlist& TargetNetlist) : netlist{TargetNetlist}, fanin(), line_num{0}, role(), first_line() {}
+
+  // return the net with that name, created on first use
+  uint32_t Net(const std::string_view name) {
+    uint32_t net = netlist.FindNet(name);
+    if (net == UINT32_MAX) {
+      net = netlist.AddNet();
+      netlist.SetNetName(net, name);
+      role.resize(net + 1, kUnnamed);
+      first_line.resize(net + 1, 0);
+      role[net] = kUnused;
+      first_line[net] = line_num;
+    }
+    return net;
+  }
+
+  // declare a named net as primary input
+  void Input(const std::string_view name, const char* const format) {
+    const uint32_t net = Net(name);
+    if (role[net] == kDriven) {
+      reject(format, "INPUT NET IS DRIVEN BY A GATE", line_num);
+    }
+    role[net] = kInput;
+  }
+
+  // return the named net a gate or register is about to drive
+  uint32_t Driven(const std::string_view name, const char* const format) {
+    const uint32_t net = Net(name);
+    if (role[net] == kInput) {
+      reject(format, "INPUT NET IS DRIVEN BY A GATE", line_num);
+    }
+    if (role[net] == kDriven) {
+      reject(format, "NET HAS MULTIPLE DRIVERS", line_num);
+    }
+    role[net] = kDriven;
+    return net;
+  }
+
+  // mark a named net as primary output
+  void Output(const std::string_view name) {
+    netlist.AddOutput(Net(name));
+  }
+
+  // reject named nets that are neither inputs nor driven, at the line they first appear
+  void CheckDriven(const char* const format) const {
+    for (uint32_t net = 0; net < role.size(); net++) {
+      if (role[net] == kUnused) {
+        reject(format, "NET IS NEVER DRIVEN", first_line[net]);
+      }
+    }
+  }
+
+  // add a gate reading the nets in fanin; single-input gates degrade to buffer / inverter
+  void Gate(const GateKind kind, const uint32_t out, const std::string_view name) {
+    if (fanin.size() == 1 && kind != GateKind::NOT) {
+      const bool invert = (kind == GateKind::NAND || kind == GateKind::NOR || kind == GateKind::XNOR);
+      Lut(invert ? 0x1 : 0x2, out, name);
+      return;
+    }
+    name_gate(netlist.AddGate(kind, fanin, out), name);
+  }
+
+  // add a LUT gate reading the nets in fanin
+  void Lut(const uint64_t table, const uint32_t out, const std::string_view name) {
+    name_gate(netlist.AddLut(table, fanin, out), name);
+  }
+
+  // add a buffer / constant driving out
+  void Buffer(const uint32_t in, const uint32_t out, const std::string_view name) {
+    fanin.assign(1, in);
+    Lut(0x2, out, name);
+  }
+  void Constant(const bool value, const uint32_t out, const std::string_view name) {
+    fanin.clear();
+    Lut(value ? 0x1 : 0x0, out, name);
+  }
+
+  // add a register storing in into out
+  void Register(const GateKind kind, const uint32_t in, const uint32_t out, const uint32_t ctrl, const bool init) {
+    netlist.AddRegister(kind, in, out, ctrl, init);
+  }
+
+  Netlist& netlist;               // netlist being built
+  std::vector<uint32_t> fanin;    // input nets of the next gate
+  uint64_t line_num;              // line of the statement being parsed
+
+ private:
+  // how a named net is used so far
+  enum : uint8_t { kUnnamed = 0, kUnused, kInput, kDriven };
+
+  // throw a parse error of one format
+  [[noreturn]] static void reject(const char* const format, const char* const what, const uint64_t line) {
+    fail((std::string(format) + ": " + what).c_str(), line);
+  }
+
+  void name_gate(const uint32_t gate, const std::string_view name) {
+    if (!name.empty()) {
+      netlist.SetGateName(gate, name);
+    }
+  }
+
+ private:
+  std::vector<uint8_t> role;          // net -> how it is used (kUnnamed for helper nets)
+  std::vector<uint64_t> first_line;   // net -> line of its first appearance
+};
+
+// ---------------------------------------------------------------------------
+// ISCAS .bench: INPUT(a) / OUTPUT(y) / y = NAND(a, b)
+// ---------------------------------------------------------------------------
+
+void parse_bench_line(Builder& builder, std::string_view line, const uint64_t line_num) {
+  builder.line_num = line_num;
+  const size_t comment = line.find('#');
+  if (comment != std::string_view::npos) {
+    line = line.substr(0, comment);
+  }
+  line = trim(line);
+  if (line.empty()) {
+    return;
+  }
+  const size_t open = line.find('(');
+  const size_t close = line.rfind(')');
+  if (open == std::string_view::npos || close == std::string_view::npos || close < open) {
+    fail("BENCH: MALFORMED STATEMENT", line_num);
+  }
+  const std::string_view args = line.substr(open + 1, close - open - 1);
+  const size_t eq = line.find('=');
+
+  // declaration
+  if (eq == std::string_view::npos || eq > open) {
+    const std::string keyword = upper(trim(line.substr(0, open)));
+    const std::string_view name = trim(args);
+    if (name.empty()) {
+      fail("BENCH: MISSING NET NAME", line_num);
+    }
+    if (keyword == "INPUT") {
+      builder.Input(name, "BENCH");
+    } else if (keyword == "OUTPUT") {
+      builder.Output(name);
+    } else {
+      fail("BENCH: UNKNOWN DECLARATION", line_num);
+    }
+    return;
+  }
+
+  // gate
+  const std::string_view out_name = trim(line.substr(0, eq));
+  const std::string func = upper(trim(line.substr(eq + 1, open - eq - 1)));
+  builder.fanin.clear();
+  size_t begin = 0;
+  while (begin <= args.size()) {
+    size_t end = args.find(',', begin);
+    if (end == std::string_view::npos) end = args.size();
+    const std::string_view arg = trim(args.substr(begin, end - begin));
+    if (arg.empty()) {
+      fail("BENCH: EMPTY GATE INPUT", line_num);
+    }
+    builder.fanin.push_back(builder.Net(arg));
+    begin = end + 1;
+  }
+  const uint32_t out = builder.Driven(out_name, "BENCH");
+  if (func == "BUFF" || func == "BUF") {
+    if (builder.fanin.size() != 1) {
+      fail("BENCH: BUFFER MUST HAVE 1 INPUT", line_num);
+    }
+    builder.Lut(0x2, out, out_name);
+  } else if (func == "DFF") {
+    // single implicit clock, reset state 0
+    if (builder.fanin.size() != 1) {
+      fail("BENCH: DFF MUST HAVE 1 INPUT", line_num);
+    }
+    builder.Register(GateKind::DFF, builder.fanin[0], out, UINT32_MAX, false);
+  } else {
+    GateKind kind;
+    try {
+      kind = ParseGateKind(func);
+    } catch (const std::invalid_argument&) {
+      fail("BENCH: UNKNOWN GATE TYPE", line_num);
+    }
+    if (kind == GateKind::LUT) {
+      fail("BENCH: UNKNOWN GATE TYPE", line_num);
+    }
+    if (kind == GateKind::LATCH) {
+      // no enable in the format: only the implicitly clocked DFF is a register
+      fail("BENCH: LATCH IS NOT SUPPORTED, ONLY DFF", line_num);
+    }
+    try {
+      builder.Gate(kind, out, out_name);
+    } catch (const std::invalid_argument&) {
+      fail("BENCH: WRONG NUMBER OF GATE INPUTS", line_num);
+    }
+  }
+}
+
+void parse_bench(Builder& builder, BlockReader& reader, ImportStats& stats) {
+  std::string line;
+  while (reader.NextLine(line)) {
+    parse_bench_line(builder, line, reader.GetLineNum() - 1);
+    if ((reader.GetLineNum() & 0xfff) == 0) {
+      stats.peak_byte_num = std::max(stats.peak_byte_num, builder.netlist.GetByteNum() +
+          builder.netlist.GetNameByteNum() + reader.GetBufferByteNum() + line.capacity());
+    }
+  }
+  builder.CheckDriven("BENCH");
+}
+
+// ---------------------------------------------------------------------------
+// BLIF: .inputs / .outputs / .names covers / .latch
+// ---------------------------------------------------------------------------
+
+// one .names block being collected
+struct Cover {
+  bool open = false;                // a .names block is pending
+  std::vector<uint32_t> inputs;     // input nets
+  uint32_t out = UINT32_MAX;        // output net
+  std::string out_name;             // output net name
+  char phase = 0;                   // '1' on-set rows, '0' off-set rows
+  bool tautology = false;           // a row without literals was seen
+  uint64_t table = 0;               // on-set minterms (inputs <= 6)
+  std::vector<uint32_t> terms;      // product term nets (inputs > 6)
+  std::vector<uint32_t> negated;    // inverted inputs (inputs > 6), lazily created
+};
+
+// add one cover row
+void add_cube(Builder& builder, Cover& cover, const std::string_view cube, const char out_bit,
+    const uint64_t line_num) {
+  if (cube.size() != cover.inputs.size() || (out_bit != '0' && out_bit != '1')) {
+    fail("BLIF: MALFORMED COVER ROW", line_num);
+  }
+  if (cover.phase != 0 && cover.phase != out_bit) {
+    fail("BLIF: MIXED ON-SET AND OFF-SET ROWS", line_num);
+  }
+  cover.phase = out_bit;
+  const uint32_t n = static_cast<uint32_t>(cube.size());
+  for (const char c : cube) {
+    if (c != '0' && c != '1' && c != '-') {
+      fail("BLIF: MALFORMED COVER ROW", line_num);
+    }
+  }
+  if (std::all_of(cube.begin(), cube.end(), [](const char c) { return c == '-'; })) {
+    cover.tautology = true;
+    return;
+  }
+
+  // small cover: accumulate the minterms of the cube
+  if (n <= kMaxLutInputs) {
+    for (uint32_t m = 0; m < (1u << n); m++) {
+      bool match = true;
+      for (uint32_t k = 0; k < n && match; k++) {
+        match = (cube[k] == '-') || ((cube[k] == '1') == (((m >> k) & 1) != 0));
+      }
+      cover.table |= static_cast<uint64_t>(match) << m;
+    }
+    return;
+  }
+
+  // large cover: one AND per cube
+  builder.fanin.clear();
+  for (uint32_t k = 0; k < n; k++) {
+    if (cube[k] == '1') {
+      builder.fanin.push_back(cover.inputs[k]);
+    } else if (cube[k] == '0') {
+      if (cover.negated[k] == UINT32_MAX) {
+        cover.negated[k] = builder.netlist.AddNet();
+        std::vector<uint32_t> saved;
+        saved.swap(builder.fanin);
+        builder.fanin.assign(1, cover.inputs[k]);
+        builder.Gate(GateKind::NOT, cover.negated[k], {});
+        builder.fanin.swap(saved);
+      }
+      builder.fanin.push_back(cover.negated[k]);
+    }
+  }
+  if (builder.fanin.size() == 1) {
+    cover.terms.push_back(builder.fanin[0]);
+  } else {
+    const uint32_t term = builder.netlist.AddNet();
+    builder.Gate(GateKind::AND, term, {});
+    cover.terms.push_back(term);
+  }
+}
+
+// emit the gate(s) of a finished cover
+void close_cover(Builder& builder, Cover& cover) {
+  if (!cover.open) {
+    return;
+  }
+  cover.open = false;
+  const bool on_set = (cover.phase != '0');
+  const uint32_t n = static_cast<uint32_t>(cover.inputs.size());
+
+  if (cover.tautology || (cover.phase == 0)) {
+    // no rows: constant 0; a row without literals: constant function of the phase
+    builder.Constant(cover.tautology && on_set, cover.out, cover.out_name);
+  } else if (n <= kMaxLutInputs) {
+    const uint64_t mask = (n == kMaxLutInputs) ? ~uint64_t{0} : ((uint64_t{1} << (1u << n)) - 1);
+    builder.fanin = cover.inputs;
+    builder.Lut(on_set ? cover.table : (~cover.table & mask), cover.out, cover.out_name);
+  } else if (cover.terms.size() == 1) {
+    builder.fanin.assign(1, cover.terms[0]);
+    builder.Gate(on_set ? GateKind::AND : GateKind::NOT, cover.out, cover.out_name);
+  } else {
+    builder.fanin = cover.terms;
+    builder.Gate(on_set ? GateKind::OR : GateKind::NOR, cover.out, cover.out_name);
+  }
+}
+
+// .latch <input> <output> [<type> <control>] [<init>]
+void add_latch(Builder& builder, const std::vector<std::string_view>& tokens, const uint64_t line_num) {
+  if (tokens.size() < 3 || tokens.size() > 6) {
+    fail("BLIF: MALFORMED .latch", line_num);
+  }
+  const uint32_t in = builder.Net(tokens[1]);
+  const uint32_t out = builder.Driven(tokens[2], "BLIF");
+  // init 0 / 1, 2 (don't care) & 3 (unknown) reset to 0
+  bool init = false;
+  if (tokens.size() == 4 || tokens.size() == 6) {
+    const std::string_view value = tokens.back();
+    if (value.size() != 1 || value[0] < '0' || value[0] > '3') {
+      fail("BLIF: MALFORMED .latch INITIAL VALUE", line_num);
+    }
+    init = (value[0] == '1');
+  }
+  if (tokens.size() < 5) {
+    builder.Register(GateKind::DFF, in, out, UINT32_MAX, init);
+    return;
+  }
+  const std::string_view type = tokens[3];
+  const uint32_t ctrl = (tokens[4] == "NIL") ? UINT32_MAX : builder.Net(tokens[4]);
+  if (type == "re") {
+    // rising edge: one Clock() of the cycle model
+    builder.Register(GateKind::DFF, in, out, ctrl, init);
+  } else if (type == "fe") {
+    // would capture half a cycle after the rising-edge registers, which one Clock() cannot express
+    fail("BLIF: FALLING-EDGE .latch IS NOT SUPPORTED", line_num);
+  } else if (type == "as") {
+    fail("BLIF: ASYNCHRONOUS .latch IS NOT SUPPORTED", line_num);
+  } else if (type == "ah" || (type == "al" && ctrl == UINT32_MAX)) {
+    builder.Register(GateKind::LATCH, in, out, ctrl, init);
+  } else if (type == "al") {
+    // active-low enable -> latch behind an inverter
+    const uint32_t enable = builder.netlist.AddNet();
+    builder.fanin.assign(1, ctrl);
+    builder.Gate(GateKind::NOT, enable, {});
+    builder.Register(GateKind::LATCH, in, out, enable, init);
+  } else {
+    fail("BLIF: UNKNOWN .latch TYPE", line_num);
+  }
+}
+
+void parse_blif(Builder& builder, BlockReader& reader, ImportStats& stats) {
+  std::string line, logical;
+  std::vector<std::string_view> tokens;
+  Cover cover;
+  bool done = false;
+  while (!done && reader.NextLine(line)) {
+    const uint64_t line_num = reader.GetLineNum() - 1;
+    builder.line_num = line_num;
+    const size_t comment = line.find('#');
+    if (comment != std::string::npos) {
+      line.resize(comment);
+    }
+    // join continued lines
+    const std::string_view view = trim(line);
+    if (!view.empty() && view.back() == '\\') {
+      logical.append(view.substr(0, view.size() - 1));
+      logical.push_back(' ');
+      continue;
+    }
+    logical.append(view);
+    split(logical, tokens);
+    if (tokens.empty()) {
+      logical.clear();
+      continue;
+    }
+
+    if (tokens[0][0] != '.') {
+      // cover row of the pending .names
+      if (!cover.open) {
+        fail("BLIF: COVER ROW OUTSIDE .names", line_num);
+      }
+      if (tokens.size() == 1 && cover.inputs.empty()) {
+        add_cube(builder, cover, {}, tokens[0][0], line_num);
+      } else if (tokens.size() == 2 && tokens[1].size() == 1) {
+        add_cube(builder, cover, tokens[0], tokens[1][0], line_num);
+      } else {
+        fail("BLIF: MALFORMED COVER ROW", line_num);
+      }
+    } else {
+      close_cover(builder, cover);
+      const std::string_view directive = tokens[0];
+      if (directive == ".model") {
+        // single flat model, name not needed
+      } else if (directive == ".inputs") {
+        for (size_t i = 1; i < tokens.size(); i++) builder.Input(tokens[i], "BLIF");
+      } else if (directive == ".outputs") {
+        for (size_t i = 1; i < tokens.size(); i++) builder.Output(tokens[i]);
+      } else if (directive == ".names") {
+        if (tokens.size() < 2) {
+          fail("BLIF: .names WITHOUT OUTPUT", line_num);
+        }
+        cover.open = true;
+        cover.inputs.clear();
+        for (size_t i = 1; i + 1 < tokens.size(); i++) cover.inputs.push_back(builder.Net(tokens[i]));
+        cover.out = builder.Driven(tokens.back(), "BLIF");
+        cover.out_name.assign(tokens.back());
+        cover.phase = 0;
+        cover.tautology = false;
+        cover.table = 0;
+        cover.terms.clear();
+        cover.negated.assign(cover.inputs.size(), UINT32_MAX);
+      } else if (directive == ".end") {
+        done = true;
+      } else if (directive == ".latch") {
+        add_latch(builder, tokens, line_num);
+      } else {
+        fail("BLIF: UNSUPPORTED DIRECTIVE", line_num);
+      }
+    }
+    logical.clear();
+    if ((line_num & 0xfff) == 0) {
+      stats.peak_byte_num = std::max(stats.peak_byte_num, builder.netlist.GetByteNum() +
+          builder.netlist.GetNameByteNum() + reader.GetBufferByteNum() + line.capacity() + logical.capacity());
+    }
+  }
+  close_cover(builder, cover);
+  builder.CheckDriven("BLIF");
+}
+
+// ---------------------------------------------------------------------------
+// structural Verilog: input / output / wire / assign / gate primitives
+// ---------------------------------------------------------------------------
+
+// split a statement into identifiers and single-character punctuation
+void tokenize(const std::string_view s, std::vector<std::string_view>& tokens) {
+  tokens.clear();
+  size_t i = 0;
+  while (i < s.size()) {
+    const char c = s[i];
+    if (std::isspace(static_cast<unsigned char>(c))) {
+      i++;
+    } else if (c == '\\') {
+      // escaped identifier runs to the next white space
+      const size_t begin = i++;
+      while (i < s.size() && !std::isspace(static_cast<unsigned char>(s[i]))) i++;
+      tokens.push_back(s.substr(begin, i - begin));
+    } else if (is_ident(c) && c != '[' && c != ']') {
+      const size_t begin = i;
+      while (i < s.size() && is_ident(s[i])) i++;
+      tokens.push_back(s.substr(begin, i - begin));
+    } else {
+      tokens.push_back(s.substr(i++, 1));
+    }
+  }
+}
+
+void parse_verilog_statement(Builder& builder, const std::vector<std::string_view>& t, const uint64_t line_num) {
+  builder.line_num = line_num;
+  size_t i = 0;
+  while (i < t.size() && t[i] == "endmodule") i++;
+  if (i == t.size()) {
+    return;
+  }
+  const std::string_view keyword = t[i++];
+
+  // module header: ports are declared again by input / output
+  if (keyword == "module") {
+    return;
+  }
+
+  // declarations
+  if (keyword == "input" || keyword == "output" || keyword == "wire") {
+    if (i < t.size() && (t[i] == "wire" || t[i] == "reg")) i++;
+    if (i < t.size() && t[i] == "[") {
+      fail("VERILOG: VECTOR NETS ARE NOT SUPPORTED", line_num);
+    }
+    for (; i < t.size(); i++) {
+      if (t[i] == ",") continue;
+      if (t[i].size() == 1 && !is_ident(t[i][0])) {
+        fail("VERILOG: MALFORMED DECLARATION", line_num);
+      }
+      if (keyword == "input") builder.Input(t[i], "VERILOG");
+      else if (keyword == "output") builder.Output(t[i]);
+    }
+    return;
+  }
+
+  // continuous assignment of a net or a constant
+  if (keyword == "assign") {
+    if (t.size() - i != 3 || t[i + 1] != "=") {
+      fail("VERILOG: ONLY SIMPLE ASSIGN IS SUPPORTED", line_num);
+    }
+    const std::string_view rhs = t[i + 2];
+    const uint32_t out = builder.Driven(t[i], "VERILOG");
+    if (rhs == "1'b0" || rhs == "1'b1" || rhs == "0" || rhs == "1") {
+      builder.Constant(rhs.back() == '1', out, t[i]);
+    } else {
+      builder.Buffer(builder.Net(rhs), out, t[i]);
+    }
+    return;
+  }
+
+  // gate primitives
+  GateKind kind = GateKind::LUT;
+  const std::string func = upper(keyword);
+  if (func != "BUF") {
+    try {
+      kind = ParseGateKind(func);
+    } catch (const std::invalid_argument&) {
+      fail("VERILOG: ONLY GATE PRIMITIVES ARE SUPPORTED", line_num);
+    }
+    if (kind == GateKind::LUT) {
+      fail("VERILOG: ONLY GATE PRIMITIVES ARE SUPPORTED", line_num);
+    }
+    if (IsSequentialKind(kind)) {
+      // no standard primitive, port order differs between tools
+      fail("VERILOG: DFF AND LATCH INSTANCES ARE NOT SUPPORTED", line_num);
+    }
+  }
+  std::vector<std::string_view> ports;
+  while (i < t.size()) {
+    // [name] ( port, port, ... )
+    std::string_view name;
+    if (t[i] != "(") name = t[i++];
+    if (i >= t.size() || t[i] != "(") {
+      fail("VERILOG: MALFORMED GATE INSTANCE", line_num);
+    }
+    ports.clear();
+    for (i++; i < t.size() && t[i] != ")"; i++) {
+      if (t[i] != ",") ports.push_back(t[i]);
+    }
+    if (i++ >= t.size() || ports.size() < 2) {
+      fail("VERILOG: MALFORMED GATE INSTANCE", line_num);
+    }
+    if (kind == GateKind::NOT || kind == GateKind::LUT) {
+      // not / buf: every port but the last is an output
+      const uint32_t in = builder.Net(ports.back());
+      for (size_t p = 0; p + 1 < ports.size(); p++) {
+        builder.fanin.assign(1, in);
+        const std::string_view gate_name = (ports.size() == 2 && !name.empty()) ? name : ports[p];
+        const uint32_t out = builder.Driven(ports[p], "VERILOG");
+        if (kind == GateKind::NOT) builder.Gate(kind, out, gate_name);
+        else builder.Lut(0x2, out, gate_name);
+      }
+    } else {
+      builder.fanin.clear();
+      for (size_t p = 1; p < ports.size(); p++) builder.fanin.push_back(builder.Net(ports[p]));
+      const uint32_t out = builder.Driven(ports[0], "VERILOG");
+      builder.Gate(kind, out, name.empty() ? ports[0] : name);
+    }
+    if (i < t.size()) {
+      if (t[i] != ",") {
+        fail("VERILOG: MALFORMED GATE INSTANCE", line_num);
+      }
+      i++;
+    }
+  }
+}
+
+void parse_verilog(Builder& builder, BlockReader& reader, ImportStats& stats) {
+  std::string stmt;
+  std::vector<std::string_view> tokens;
+  uint64_t stmt_num = 0;
+  while (reader.NextStatement(stmt)) {
+    tokenize(stmt, tokens);
+    parse_verilog_statement(builder, tokens, reader.GetLineNum());
+    if ((++stmt_num & 0xfff) == 0) {
+      stats.peak_byte_num = std::max(stats.peak_byte_num, builder.netlist.GetByteNum() +
+          builder.netlist.GetNameByteNum() + reader.GetBufferByteNum() + stmt.capacity());
+    }
+  }
+  builder.CheckDriven("VERILOG");
+}
+
+}
+
+// return the format matching a file extension
+NetlistFormat Cim::GetNetlistFormat(const std::string& path) {
+  const size_t dot = path.rfind('.');
+  const std::string ext = (dot == std::string::npos) ? std::string() : upper(path.substr(dot + 1));
+  if (ext == "BENCH") return NetlistFormat::Bench;
+  if (ext == "BLIF")  return NetlistFormat::Blif;
+  if (ext == "V")     return NetlistFormat::Verilog;
+  throw std::invalid_argument("ERR: UNKNOWN NETLIST FILE EXTENSION! \n");
+}
+
+// constructor
+NetlistImporter::NetlistImporter(Netlist& TargetNetlist) :
+  pNetlist{&TargetNetlist}, stats() {
+  if (TargetNetlist.GetNetNum() != 0 || TargetNetlist.GetGateNum() != 0) {
+    throw std::logic_error("ERR: IMPORT TARGET MUST BE AN EMPTY NETLIST! \n");
+  }
+}
+
+// parse a whole file, then levelize the netlist
+void NetlistImporter::ImportFile(const std::string& path, NetlistFormat format) {
+  if (format == NetlistFormat::Auto) {
+    format = GetNetlistFormat(path);
+  }
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    throw std::runtime_error("ERR: CANNOT OPEN NETLIST FILE! \n");
+  }
+  ImportStream(in, format);
+}
+
+// parse a whole stream, then levelize the netlist
+void NetlistImporter::ImportStream(std::istream& in, const NetlistFormat format) {
+  const auto start = std::chrono::steady_clock::now();
+  stats = ImportStats();
+  BlockReader reader(in);
+  Builder builder(*pNetlist);
+  switch (format) {
+    case NetlistFormat::Bench:    parse_bench(builder, reader, stats); break;
+    case NetlistFormat::Blif:     parse_blif(builder, reader, stats); break;
+    case NetlistFormat::Verilog:  parse_verilog(builder, reader, stats); break;
+    default: throw std::invalid_argument("ERR: NETLIST FORMAT OF A STREAM MUST BE GIVEN! \n");
+  }
+  pNetlist->Levelize();
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  stats.byte_num = reader.GetByteNum();
+  stats.line_num = reader.GetLineNum() - 1;
+  stats.gate_num = pNetlist->GetGateNum();
+  stats.net_num = pNetlist->GetNetNum();
+  stats.seconds = seconds;
+  stats.mb_per_second = (seconds > 0) ? (static_cast<double>(stats.byte_num) / 1e6 / seconds) : 0;
+  stats.peak_byte_num = std::max(stats.peak_byte_num,
+      pNetlist->GetByteNum() + pNetlist->GetNameByteNum() + reader.GetBufferByteNum());
+}
+
+// return the statistics of the last import
+const ImportStats& NetlistImporter::GetStats() const noexcept {
+  return this->stats;
+}
+
+// read a netlist file into a new levelized netlist
+Netlist Cim::ImportNetlist(const std::string& path, const NetlistFormat format, ImportStats* stats) {
+  Netlist netlist;
+  NetlistImporter importer(netlist);
+  importer.ImportFile(path, format);
+  if (stats != nullptr) {
+    *stats = importer.GetStats();
+  }
+  return netlist;
+}
@@ -0,0 +1,94 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// include guard for this header
+#ifndef C_IMPORT_H
+#define C_IMPORT_H
+
+// includes for this header
+#include <string>         // std::string
+#include <istream>        // std::istream
+#include <cstdint>        // standard int types
+#include "c_netlist.h"    // class Netlist
+
+// namespace for entire project
+namespace Cim {
+
+// netlist file formats understood by the importer
+enum class NetlistFormat : uint8_t {
+  Auto,       // guess from the file extension
+  Bench,      // ISCAS-85/89 .bench
+  Blif,       // Berkeley Logic Interchange Format (flat, .names & .latch)
+  Verilog     // structural Verilog with gate primitives only
+};
+
+// return the format matching a file extension (.bench / .blif / .v)
+NetlistFormat GetNetlistFormat(const std::string& path);
+
+// throughput & footprint of one import
+struct ImportStats {
+  uint64_t byte_num = 0;        // bytes read from the stream
+  uint64_t line_num = 0;        // lines read from the stream
+  uint32_t gate_num = 0;        // gates created
+  uint32_t net_num = 0;         // nets created
+  double seconds = 0;           // wall time of parse + levelize
+  double mb_per_second = 0;     // parse throughput
+  size_t peak_byte_num = 0;     // largest netlist + parser buffer footprint seen
+};
+
+// NetlistImporter Class
+// Single-pass streaming reader for gate-level netlist files. The input is read
+// in fixed-size blocks and consumed one statement at a time, so memory use is
+// bounded by the netlist being built plus one statement. Nets are created on
+// first mention by name, which resolves forward references without a second
+// pass. Flip-flops (.bench DFF / BLIF .latch re, ah, al) become Netlist registers;
+// hierarchy is rejected. Every net must be a declared input or have exactly
+// one driver, errors name the offending line.
+class NetlistImporter {
+ public:
+  // constructor (importer fills TargetNetlist, which must be empty)
+  explicit NetlistImporter(Netlist& TargetNetlist);
+
+  // destructor
+  ~NetlistImporter() { /* DN */ }
+
+  // parse a whole file, then levelize the netlist
+  void ImportFile(const std::string& path, NetlistFormat format = NetlistFormat::Auto);
+
+  // parse a whole stream, then levelize the netlist
+  void ImportStream(std::istream& in, const NetlistFormat format);
+
+  // return the statistics of the last import
+  const ImportStats& GetStats() const noexcept;
+
+ private:
+  Netlist* pNetlist;    // netlist being built
+  ImportStats stats;    // statistics of the last import
+};
+
+// read a netlist file into a new levelized netlist
+Netlist ImportNetlist(const std::string& path, NetlistFormat format = NetlistFormat::Auto,
+    ImportStats* stats = nullptr);
+
+}
+
+#endif  // C_IMPORT_H
@@ -0,0 +1,562 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// includes for this file
+#include "c_incremental.h"
+#include <stdexcept>
+#include <algorithm>  // std::find, std::sort
+
+// using namespace for this project
+using namespace Cim;
+
+// constructor
+IncrementalSim::IncrementalSim(const Netlist& TargetNetlist) :
+  pNetlist{&TargetNetlist},
+  // Gates
+  gate_op(), gate_variant(), gate_table(), gate_begin(), gate_count(), gate_out(), gate_level(), removed(), fanin(),
+  // Nets
+  nets(TargetNetlist.GetNetNum(), 0), dirty(TargetNetlist.GetNetNum(), 0),
+  driver(TargetNetlist.GetNetNum(), UINT32_MAX), readers(TargetNetlist.GetNetNum()), input_source(),
+  // Scheduling
+  buckets(), queued(), queued_num{0}, first_level{0},
+  // Cones
+  cones(), stamp(), search{0}, stack(),
+  // Statistics
+  evaluations{0}, relevels{0} {
+  if (!TargetNetlist.IsLevelized()) {
+    throw std::logic_error("ERR: NETLIST MUST BE LEVELIZED! \n");
+  }
+  // 1. copy the gates, the program order is a level order
+  const ArrayView<Instruction> program = TargetNetlist.GetProgram();
+  const ArrayView<uint32_t> offsets = TargetNetlist.GetLevelOffsets();
+  fanin.assign(TargetNetlist.GetFanin().begin(), TargetNetlist.GetFanin().end());
+  for (uint32_t l = 0; l + 1 < offsets.size(); l++) {
+    for (uint32_t g = offsets[l]; g < offsets[l + 1]; g++) {
+      const Instruction& ins = program[g];
+      gate_op.push_back(ins.op);
+      gate_variant.push_back(ins.variant);
+      gate_table.push_back((ins.op == GateKind::LUT) ? TargetNetlist.GetLuts()[ins.lut] : 0);
+      gate_begin.push_back(ins.fanin_begin);
+      gate_count.push_back(ins.fanin_count);
+      gate_out.push_back(ins.out_net);
+      gate_level.push_back(l);
+      driver[ins.out_net] = g;
+      for (uint32_t k = 0; k < ins.fanin_count; k++) {
+        readers[fanin[ins.fanin_begin + k]].push_back(g);
+      }
+    }
+  }
+  removed.assign(gate_op.size(), 0);
+  queued.assign(gate_op.size(), 0);
+  stamp.assign(gate_op.size(), 0);
+  buckets.resize(offsets.size());
+  for (const uint32_t each_net : TargetNetlist.GetInputs()) {
+    const Pin::Link source = TargetNetlist.GetInputSource(each_net);
+    if (source.first != nullptr) {
+      input_source[each_net] = source;
+    }
+  }
+
+  // 2. settle every net once
+  for (uint32_t g = 0; g < gate_op.size(); g++) {
+    enqueue(g);
+  }
+  Update();
+  evaluations = 0;
+}
+
+// queue a gate for evaluation
+void IncrementalSim::enqueue(const uint32_t gate) {
+  if (queued[gate] != 0) {
+    return;
+  }
+  const uint32_t level = gate_level[gate];
+  if (level >= buckets.size()) {
+    buckets.resize(level + 1);
+  }
+  buckets[level].push_back(gate);
+  queued[gate] = 1;
+  dirty[gate_out[gate]] = 1;
+  first_level = (queued_num == 0 || level < first_level) ? level : first_level;
+  queued_num++;
+}
+
+// re-evaluate every queued gate
+uint64_t IncrementalSim::Update() {
+  const uint64_t start = evaluations;
+  // readers are always on higher levels -> one pass in level order
+  for (uint32_t l = first_level; queued_num != 0 && l < buckets.size(); l++) {
+    for (uint32_t i = 0; i < buckets[l].size(); i++) {
+      const uint32_t gate = buckets[l][i];
+      queued[gate] = 0;
+      queued_num--;
+      const uint32_t out = gate_out[gate];
+      dirty[out] = 0;
+      if (removed[gate] != 0) {
+        continue;
+      }
+      const uint32_t* const in = fanin.data() + gate_begin[gate];
+      const uint8_t* const states = nets.data();
+      const uint8_t state = EvaluateVariant<uint8_t>(gate_variant[gate],
+          [in, states](const uint32_t k) { return states[in[k]]; }, gate_count[gate], gate_table[gate]);
+      evaluations++;
+      if (state == nets[out]) {
+        continue;
+      }
+      nets[out] = state;
+      for (const uint32_t each_reader : readers[out]) {
+        enqueue(each_reader);
+      }
+    }
+    buckets[l].clear();
+  }
+  first_level = 0;
+  return evaluations - start;
+}
+
+// set an undriven net
+void IncrementalSim::SetInput(const uint32_t net, const bool new_state) {
+  check_net(net);
+  if (driver[net] != UINT32_MAX) {
+    throw std::invalid_argument("ERR: NET IS NOT A PRIMARY INPUT! \n");
+  }
+  if (nets[net] == static_cast<uint8_t>(new_state)) {
+    return;
+  }
+  nets[net] = new_state;
+  for (const uint32_t each_reader : readers[net]) {
+    enqueue(each_reader);
+  }
+}
+
+// set every compiled input pin whose Pin::state_changed flag is set
+void IncrementalSim::ApplyPinChanges() {
+  for (const auto& each_input : input_source) {
+    const Pin::Link& source = each_input.second;
+    if (driver[each_input.first] != UINT32_MAX || !source.first->IsPinStateChanged(source.second)) {
+      continue;
+    }
+    const bool state = source.first->GetPinState(source.second);
+    SetInput(each_input.first, state);
+    // consume the change; Set() again could make a sequential component capture
+    source.first->ClearPinStateChanged(source.second);
+  }
+}
+
+// return the state of a net
+bool IncrementalSim::GetState(const uint32_t net) const {
+  return this->nets.at(net) != 0;
+}
+
+// return true if the net waits for Update()
+bool IncrementalSim::IsDirty(const uint32_t net) const {
+  return this->dirty.at(net) != 0;
+}
+
+// return true if any gate waits for Update()
+bool IncrementalSim::IsDirty() const noexcept {
+  return this->queued_num != 0;
+}
+
+// edit: add an undriven net
+uint32_t IncrementalSim::AddNet() {
+  nets.push_back(0);
+  dirty.push_back(0);
+  driver.push_back(UINT32_MAX);
+  readers.emplace_back();
+  return nets.size() - 1;
+}
+
+// check & append one gate
+uint32_t IncrementalSim::push_gate(const GateKind op, const uint64_t table, const std::vector<uint32_t>& fanin_nets,
+    const uint32_t out_net) {
+  CheckGateInputs(op, fanin_nets.size());
+  if (IsSequentialKind(op)) {
+    throw std::invalid_argument("ERR: SEQUENTIAL ELEMENTS ARE NOT GATES! \n");
+  }
+  if (fanin_nets.size() > UINT16_MAX) {
+    throw std::invalid_argument("ERR: TOO MANY INPUTS FOR ONE GATE! \n");
+  }
+  check_net(out_net);
+  for (const uint32_t each_net : fanin_nets) {
+    check_net(each_net);
+  }
+  if (driver[out_net] != UINT32_MAX) {
+    throw std::invalid_argument("ERR: NET ALREADY HAS A DRIVER! \n");
+  }
+  // a loop closes if the gate reads its own output or a net downstream of it
+  for (const uint32_t each_net : fanin_nets) {
+    if (each_net == out_net) {
+      throw std::invalid_argument("ERR: EDIT WOULD CREATE A COMBINATIONAL LOOP! \n");
+    }
+    if (driver[each_net] == UINT32_MAX) {
+      continue;
+    }
+    for (const uint32_t each_reader : readers[out_net]) {
+      if (reaches(each_reader, driver[each_net])) {
+        throw std::invalid_argument("ERR: EDIT WOULD CREATE A COMBINATIONAL LOOP! \n");
+      }
+    }
+  }
+  const uint32_t gate = gate_op.size();
+  gate_op.push_back(op);
+  gate_variant.push_back(MakeVariant(op, fanin_nets.size()));
+  gate_table.push_back(table);
+  gate_begin.push_back(fanin.size());
+  gate_count.push_back(fanin_nets.size());
+  gate_out.push_back(out_net);
+  gate_level.push_back(0);
+  removed.push_back(0);
+  queued.push_back(0);
+  stamp.push_back(0);
+  fanin.insert(fanin.end(), fanin_nets.begin(), fanin_nets.end());
+  for (const uint32_t each_net : fanin_nets) {
+    readers[each_net].push_back(gate);
+  }
+  driver[out_net] = gate;
+  input_source.erase(out_net);
+  cones.clear();
+  // readers of a formerly undriven net move up as well
+  relevel(gate);
+  for (const uint32_t each_reader : readers[out_net]) {
+    relevel(each_reader);
+  }
+  enqueue(gate);
+  return gate;
+}
+
+// edit: add a gate
+uint32_t IncrementalSim::AddGate(const GateKind op, const std::vector<uint32_t>& fanin_nets, const uint32_t out_net) {
+  if (op == GateKind::LUT) {
+    throw std::invalid_argument("ERR: USE AddLut FOR LUT GATES! \n");
+  }
+  return push_gate(op, 0, fanin_nets, out_net);
+}
+
+// edit: add a LUT gate
+uint32_t IncrementalSim::AddLut(const uint64_t table, const std::vector<uint32_t>& fanin_nets, const uint32_t out_net) {
+  return push_gate(GateKind::LUT, table, fanin_nets, out_net);
+}
+
+// edit: connect an input pin of a gate to another net
+void IncrementalSim::ReplaceFanin(const uint32_t gate, const uint32_t pin_idx, const uint32_t net) {
+  check_gate(gate);
+  check_net(net);
+  if (pin_idx >= gate_count[gate]) {
+    throw std::out_of_range("ERR: PIN DOES NOT EXIST! \n");
+  }
+  uint32_t& slot = fanin[gate_begin[gate] + pin_idx];
+  if (slot == net) {
+    return;
+  }
+  if (driver[net] != UINT32_MAX && reaches(gate, driver[net])) {
+    throw std::invalid_argument("ERR: EDIT WOULD CREATE A COMBINATIONAL LOOP! \n");
+  }
+  remove_reader(slot, gate);
+  slot = net;
+  readers[net].push_back(gate);
+  cones.clear();
+  relevel(gate);
+  enqueue(gate);
+}
+
+// edit: change the kind of a gate
+void IncrementalSim::ChangeKind(const uint32_t gate, const GateKind op) {
+  check_gate(gate);
+  if (op == GateKind::LUT || IsSequentialKind(op)) {
+    throw std::invalid_argument("ERR: USE ChangeTable FOR LUT GATES! \n");
+  }
+  CheckGateInputs(op, gate_count[gate]);
+  gate_op[gate] = op;
+  gate_variant[gate] = MakeVariant(op, gate_count[gate]);
+  gate_table[gate] = 0;
+  enqueue(gate);
+}
+
+// edit: change a gate into a LUT with that truth table
+void IncrementalSim::ChangeTable(const uint32_t gate, const uint64_t table) {
+  check_gate(gate);
+  CheckGateInputs(GateKind::LUT, gate_count[gate]);
+  gate_op[gate] = GateKind::LUT;
+  gate_variant[gate] = MakeVariant(GateKind::LUT, gate_count[gate]);
+  gate_table[gate] = table;
+  enqueue(gate);
+}
+
+// edit: remove a gate
+void IncrementalSim::RemoveGate(const uint32_t gate) {
+  check_gate(gate);
+  for (uint32_t k = 0; k < gate_count[gate]; k++) {
+    remove_reader(fanin[gate_begin[gate] + k], gate);
+  }
+  removed[gate] = 1;
+  driver[gate_out[gate]] = UINT32_MAX;
+  dirty[gate_out[gate]] = 0;
+  cones.clear();
+  // readers lose one driven input
+  for (const uint32_t each_reader : readers[gate_out[gate]]) {
+    relevel(each_reader);
+  }
+}
+
+// edit: re-read the connection of an input pin of a compiled component
+void IncrementalSim::Rewire(const Component* const component, const uint32_t pin_idx) {
+  const uint32_t gate = pNetlist->GetGateIndex(component);
+  if (pin_idx >= gate_count[gate]) {
+    throw std::out_of_range("ERR: PIN DOES NOT EXIST! \n");
+  }
+  const Pin::Link link = component->GetPinConnection(pin_idx).at(0);
+  uint32_t net = UINT32_MAX;
+  if (link.first == nullptr) {
+    // dangling input -> private undriven net reading 0
+    net = AddNet();
+    input_source[net] = Pin::Link{const_cast<Component*>(component), pin_idx};
+  } else {
+    try {
+      // output pin of a compiled component
+      net = pNetlist->GetPinNet(link.first, link.second);
+    } catch (const std::exception&) {
+      // pin outside of the network -> shared undriven net
+      for (const auto& each_input : input_source) {
+        if (each_input.second == link && driver[each_input.first] == UINT32_MAX) {
+          net = each_input.first;
+          break;
+        }
+      }
+      if (net == UINT32_MAX) {
+        net = AddNet();
+        nets[net] = link.first->GetPinState(link.second);
+        input_source[net] = link;
+      }
+    }
+  }
+  ReplaceFanin(gate, pin_idx, net);
+}
+
+// return the level a gate needs from its fanin
+uint32_t IncrementalSim::compute_level(const uint32_t gate) const {
+  uint32_t level = 0;
+  for (uint32_t k = 0; k < gate_count[gate]; k++) {
+    const uint32_t source = driver[fanin[gate_begin[gate] + k]];
+    if (source != UINT32_MAX && gate_level[source] + 1 > level) {
+      level = gate_level[source] + 1;
+    }
+  }
+  return level;
+}
+
+// recompute levels downstream of a gate
+void IncrementalSim::relevel(const uint32_t gate) {
+  stack.assign(1, gate);
+  while (!stack.empty()) {
+    const uint32_t each_gate = stack.back();
+    stack.pop_back();
+    const uint32_t level = compute_level(each_gate);
+    if (level == gate_level[each_gate]) {
+      continue;
+    }
+    if (queued[each_gate] != 0) {
+      // move a queued gate to its new bucket
+      std::vector<uint32_t>& bucket = buckets[gate_level[each_gate]];
+      bucket.erase(std::find(bucket.begin(), bucket.end(), each_gate));
+      queued[each_gate] = 0;
+      queued_num--;
+      gate_level[each_gate] = level;
+      enqueue(each_gate);
+    }
+    gate_level[each_gate] = level;
+    if (level >= buckets.size()) {
+      buckets.resize(level + 1);
+    }
+    relevels++;
+    for (const uint32_t each_reader : readers[gate_out[each_gate]]) {
+      stack.push_back(each_reader);
+    }
+  }
+}
+
+// return true if gate 'to' is in the fanout of gate 'from'
+bool IncrementalSim::reaches(const uint32_t from, const uint32_t to) {
+  search++;
+  stack.assign(1, from);
+  while (!stack.empty()) {
+    const uint32_t gate = stack.back();
+    stack.pop_back();
+    if (gate == to) {
+      return true;
+    }
+    // a gate on a level above 'to' cannot lead back to it
+    if (stamp[gate] == search || gate_level[gate] > gate_level[to]) {
+      continue;
+    }
+    stamp[gate] = search;
+    for (const uint32_t each_reader : readers[gate_out[gate]]) {
+      stack.push_back(each_reader);
+    }
+  }
+  return false;
+}
+
+// drop one reader entry of a net
+void IncrementalSim::remove_reader(const uint32_t net, const uint32_t gate) {
+  std::vector<uint32_t>& list = readers[net];
+  const auto found = std::find(list.begin(), list.end(), gate);
+  if (found != list.end()) {
+    *found = list.back();
+    list.pop_back();
+  }
+}
+
+// return the gates reading a net directly or indirectly, in level order
+const std::vector<uint32_t>& IncrementalSim::GetFanoutCone(const uint32_t net) {
+  check_net(net);
+  const auto found = cones.find(net);
+  if (found != cones.end()) {
+    return found->second;
+  }
+  std::vector<uint32_t> cone;
+  search++;
+  stack.assign(readers[net].begin(), readers[net].end());
+  while (!stack.empty()) {
+    const uint32_t gate = stack.back();
+    stack.pop_back();
+    if (stamp[gate] == search) {
+      continue;
+    }
+    stamp[gate] = search;
+    cone.push_back(gate);
+    for (const uint32_t each_reader : readers[gate_out[gate]]) {
+      stack.push_back(each_reader);
+    }
+  }
+  std::sort(cone.begin(), cone.end(), [this](const uint32_t a, const uint32_t b) {
+    return (gate_level[a] != gate_level[b]) ? gate_level[a] < gate_level[b] : a < b;
+  });
+  return cones.emplace(net, std::move(cone)).first->second;
+}
+
+// return the number of nets
+uint32_t IncrementalSim::GetNetNum() const noexcept {
+  return this->nets.size();
+}
+
+// return the number of gate slots
+uint32_t IncrementalSim::GetGateNum() const noexcept {
+  return this->gate_op.size();
+}
+
+// return the number of levels
+uint32_t IncrementalSim::GetLevelNum() const noexcept {
+  uint32_t level_num = 0;
+  for (uint32_t g = 0; g < gate_op.size(); g++) {
+    if (removed[g] == 0 && gate_level[g] + 1 > level_num) {
+      level_num = gate_level[g] + 1;
+    }
+  }
+  return level_num;
+}
+
+// return the level of a gate
+uint32_t IncrementalSim::GetLevel(const uint32_t gate) const {
+  check_gate(gate);
+  return this->gate_level[gate];
+}
+
+// return the gate driving a net
+uint32_t IncrementalSim::GetNetDriver(const uint32_t net) const {
+  return this->driver.at(net);
+}
+
+// return true if the gate slot was removed
+bool IncrementalSim::IsRemoved(const uint32_t gate) const {
+  return this->removed.at(gate) != 0;
+}
+
+// return the number of gate evaluations
+uint64_t IncrementalSim::GetEvaluationNum() const noexcept {
+  return this->evaluations;
+}
+
+// return the number of level changes caused by edits
+uint64_t IncrementalSim::GetRelevelNum() const noexcept {
+  return this->relevels;
+}
+
+// store the net states back into the compiled components' pins
+void IncrementalSim::WriteBack() const {
+  const uint32_t compiled_num = pNetlist->GetGateNum();
+  for (uint32_t g = 0; g < compiled_num; g++) {
+    Component* const comp = pNetlist->GetGateSource(g);
+    if (comp == nullptr || removed[g] != 0) {
+      continue;
+    }
+    for (uint32_t k = 0; k < gate_count[g]; k++) {
+      comp->Set(k, nets[fanin[gate_begin[g] + k]] != 0);
+    }
+    comp->Set(gate_count[g], nets[gate_out[g]] != 0);
+  }
+}
+
+// return the edited circuit as a new levelized netlist
+Netlist IncrementalSim::ToNetlist() const {
+  Netlist result;
+  for (uint32_t n = 0; n < nets.size(); n++) {
+    result.AddNet();
+    if (n < pNetlist->GetNetNum() && !pNetlist->GetNetName(n).empty()) {
+      result.SetNetName(n, pNetlist->GetNetName(n));
+    }
+  }
+  std::vector<uint32_t> gate_fanin;
+  for (uint32_t g = 0; g < gate_op.size(); g++) {
+    if (removed[g] != 0) {
+      continue;
+    }
+    gate_fanin.assign(fanin.begin() + gate_begin[g], fanin.begin() + gate_begin[g] + gate_count[g]);
+    const uint32_t gate = (gate_op[g] == GateKind::LUT) ? result.AddLut(gate_table[g], gate_fanin, gate_out[g]) :
+        result.AddGate(gate_op[g], gate_fanin, gate_out[g]);
+    if (g < pNetlist->GetGateNum() && !pNetlist->GetGateName(g).empty()) {
+      result.SetGateName(gate, pNetlist->GetGateName(g));
+    }
+  }
+  for (const Register& each_reg : pNetlist->GetRegisters()) {
+    result.AddRegister(each_reg.kind, each_reg.d_net, each_reg.q_net, each_reg.ctrl_net, each_reg.init != 0);
+  }
+  for (const uint32_t each_net : pNetlist->GetOutputs()) {
+    result.AddOutput(each_net);
+  }
+  result.Levelize();
+  return result;
+}
+
+// throw if a net does not exist
+void IncrementalSim::check_net(const uint32_t net) const {
+  if (net >= nets.size()) {
+    throw std::out_of_range("ERR: NET DOES NOT EXIST! \n");
+  }
+}
+
+// throw if a gate does not exist or was removed
+void IncrementalSim::check_gate(const uint32_t gate) const {
+  if (gate >= gate_op.size() || removed[gate] != 0) {
+    throw std::out_of_range("ERR: GATE DOES NOT EXIST! \n");
+  }
+}
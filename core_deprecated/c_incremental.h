@@ -0,0 +1,185 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// include guard for this header
+#ifndef C_INCREMENTAL_H
+#define C_INCREMENTAL_H
+
+// includes for this header
+#include <vector>         // std::vector
+#include <cstdint>        // standard int types
+#include <unordered_map>  // std::unordered_map
+#include "c_netlist.h"    // class Netlist
+
+// namespace for entire project
+namespace Cim {
+
+// IncrementalSim Class
+// Editable simulation engine for many small changes in a row. It keeps its own
+// copy of the netlist's gates with per-gate levels, per-net readers and a
+// dirty flag per net. An input change or an edit only queues the gates it
+// touches; Update() then re-evaluates them level by level and follows a net
+// to its readers only if its value actually changed, so the work is bounded
+// by the affected fanout cone. Edits (rewiring a pin, changing a gate, adding
+// or removing gates) re-levelize only the gates downstream of the edit and
+// refuse to close a combinational loop. Gate indices start out as those of
+// the netlist; added gates are appended, removed ones leave a hole.
+class IncrementalSim {
+ public:
+  // constructor (netlist must be levelized and outlive the engine; settles every net)
+  explicit IncrementalSim(const Netlist& TargetNetlist);
+
+  // destructor
+  ~IncrementalSim() { /* DN */ }
+
+  // set an undriven net (primary input or register output), queues its readers
+  void SetInput(const uint32_t net, const bool new_state);
+
+  // set every compiled input pin whose Pin::state_changed flag is set
+  void ApplyPinChanges();
+
+  // re-evaluate every queued gate, return the number of gate evaluations
+  uint64_t Update();
+
+  // return the state of a net (stale while IsDirty(net), call Update())
+  bool GetState(const uint32_t net) const;
+
+  // return true if the net waits for Update() / if anything does
+  bool IsDirty(const uint32_t net) const;
+  bool IsDirty() const noexcept;
+
+  // edit: add an undriven net, return its index
+  uint32_t AddNet();
+
+  // edit: add a gate / LUT gate driving an undriven net, return its index
+  uint32_t AddGate(const GateKind op, const std::vector<uint32_t>& fanin_nets, const uint32_t out_net);
+  uint32_t AddLut(const uint64_t table, const std::vector<uint32_t>& fanin_nets, const uint32_t out_net);
+
+  // edit: connect input pin pin_idx of a gate to another net
+  void ReplaceFanin(const uint32_t gate, const uint32_t pin_idx, const uint32_t net);
+
+  // edit: change the function of a gate (same number of inputs)
+  void ChangeKind(const uint32_t gate, const GateKind op);
+  void ChangeTable(const uint32_t gate, const uint64_t table);
+
+  // edit: remove a gate, its output net keeps its state and becomes undriven
+  void RemoveGate(const uint32_t gate);
+
+  // edit: re-read the connection of an input pin of a compiled component
+  // (after changing it through Component::GetPinConnection)
+  void Rewire(const Component* const component, const uint32_t pin_idx);
+
+  // return the gates reading a net directly or indirectly, in level order
+  // (cached until the next structural edit)
+  const std::vector<uint32_t>& GetFanoutCone(const uint32_t net);
+
+  // return the number of nets / gate slots / levels
+  uint32_t GetNetNum() const noexcept;
+  uint32_t GetGateNum() const noexcept;
+  uint32_t GetLevelNum() const noexcept;
+
+  // return the level of a gate (gates reading only undriven nets are level 0)
+  uint32_t GetLevel(const uint32_t gate) const;
+
+  // return the gate driving a net (UINT32_MAX if undriven)
+  uint32_t GetNetDriver(const uint32_t net) const;
+
+  // return true if the gate slot was removed
+  bool IsRemoved(const uint32_t gate) const;
+
+  // return the number of gate evaluations / level changes caused by edits so far
+  uint64_t GetEvaluationNum() const noexcept;
+  uint64_t GetRelevelNum() const noexcept;
+
+  // store the net states back into the compiled components' pins
+  void WriteBack() const;
+
+  // return the edited circuit as a new levelized netlist (primary outputs are kept)
+  Netlist ToNetlist() const;
+
+ private:
+  // queue a gate for evaluation
+  void enqueue(const uint32_t gate);
+
+  // check & append one gate
+  uint32_t push_gate(const GateKind op, const uint64_t table, const std::vector<uint32_t>& fanin_nets,
+      const uint32_t out_net);
+
+  // return the level a gate needs from its fanin
+  uint32_t compute_level(const uint32_t gate) const;
+
+  // recompute levels downstream of a gate
+  void relevel(const uint32_t gate);
+
+  // return true if gate 'to' is in the fanout of gate 'from' (or is it)
+  bool reaches(const uint32_t from, const uint32_t to);
+
+  // drop one reader entry of a net
+  void remove_reader(const uint32_t net, const uint32_t gate);
+
+  // throw if a net does not exist
+  void check_net(const uint32_t net) const;
+
+  // throw if a gate does not exist or was removed
+  void check_gate(const uint32_t gate) const;
+
+ private:
+  const Netlist* pNetlist;                  // netlist the engine was built from
+
+  // Gates
+  std::vector<GateKind> gate_op;            // kind per gate
+  std::vector<uint8_t> gate_variant;        // kernel variant per gate
+  std::vector<uint64_t> gate_table;         // truth table per gate (LUT only)
+  std::vector<uint32_t> gate_begin;         // first fanin entry per gate
+  std::vector<uint16_t> gate_count;         // fanin count per gate
+  std::vector<uint32_t> gate_out;           // output net per gate
+  std::vector<uint32_t> gate_level;         // level per gate
+  std::vector<uint8_t> removed;             // removed gate slots
+  std::vector<uint32_t> fanin;              // fanin nets of all gates
+
+  // Nets
+  std::vector<uint8_t> nets;                // state per net
+  std::vector<uint8_t> dirty;               // net waits for its driver's evaluation
+  std::vector<uint32_t> driver;             // driving gate per net
+  std::vector<std::vector<uint32_t>> readers;  // reading gates per net (one entry per pin)
+  std::unordered_map<uint32_t, Pin::Link> input_source;  // undriven net -> component pin it reads
+
+  // Scheduling
+  std::vector<std::vector<uint32_t>> buckets;  // queued gates per level
+  std::vector<uint8_t> queued;              // gate is in a bucket
+  uint32_t queued_num;                      // gates in the buckets
+  uint32_t first_level;                     // lowest level holding queued gates
+
+  // Cones
+  std::unordered_map<uint32_t, std::vector<uint32_t>> cones;  // net -> cached fanout cone
+  std::vector<uint64_t> stamp;              // last search a gate was visited in
+  uint64_t search;                          // current search number
+  std::vector<uint32_t> stack;              // search stack
+
+  // Statistics
+  uint64_t evaluations;                     // gate evaluations
+  uint64_t relevels;                        // gate level changes from edits
+};
+
+}
+
+#endif  // C_INCREMENTAL_H
@@ -0,0 +1,155 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// include guard for this header
+#ifndef C_KERNELS_H
+#define C_KERNELS_H
+
+// includes for this header
+#include <cstdint>      // standard int types
+#include "c_structs.h"  // GateKind
+
+// force inlining of the kernels into the engines' loops
+#if defined(__GNUC__) || defined(__clang__)
+#define CIM_ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+#define CIM_ALWAYS_INLINE inline
+#endif
+
+// namespace for entire project
+namespace Cim {
+
+// Evaluation kernels shared by every engine. T is the value of one net: uint8_t
+// (one pattern, 0 / 1) or uint64_t (64 patterns, one per bit). Inputs are read
+// through an accessor in(k) so the same kernel serves pins, byte and word arrays.
+
+// value with every pattern set
+template <typename T> constexpr T AllOnes() noexcept;
+template <> constexpr uint8_t AllOnes<uint8_t>() noexcept { return 1; }
+template <> constexpr uint64_t AllOnes<uint64_t>() noexcept { return ~uint64_t{0}; }
+
+// combining operator and output inversion of each basic kind
+template <GateKind K> struct GateTraits;
+template <> struct GateTraits<GateKind::AND>  { static constexpr bool kInvert = false;
+  template <typename T> static CIM_ALWAYS_INLINE T Combine(T a, T b) { return a & b; } };
+template <> struct GateTraits<GateKind::NAND> { static constexpr bool kInvert = true;
+  template <typename T> static CIM_ALWAYS_INLINE T Combine(T a, T b) { return a & b; } };
+template <> struct GateTraits<GateKind::NOT>  { static constexpr bool kInvert = true;
+  template <typename T> static CIM_ALWAYS_INLINE T Combine(T a, T b) { return a & b; } };
+template <> struct GateTraits<GateKind::OR>   { static constexpr bool kInvert = false;
+  template <typename T> static CIM_ALWAYS_INLINE T Combine(T a, T b) { return a | b; } };
+template <> struct GateTraits<GateKind::NOR>  { static constexpr bool kInvert = true;
+  template <typename T> static CIM_ALWAYS_INLINE T Combine(T a, T b) { return a | b; } };
+// n-ary XOR is 1 for an odd number of 1's (parity), which chained ^ computes
+template <> struct GateTraits<GateKind::XOR>  { static constexpr bool kInvert = false;
+  template <typename T> static CIM_ALWAYS_INLINE T Combine(T a, T b) { return a ^ b; } };
+template <> struct GateTraits<GateKind::XNOR> { static constexpr bool kInvert = true;
+  template <typename T> static CIM_ALWAYS_INLINE T Combine(T a, T b) { return a ^ b; } };
+
+// fixed arity kernel: N is a constant, the loop is fully unrolled
+template <GateKind K, uint32_t N, typename T, typename Input>
+CIM_ALWAYS_INLINE T EvaluateFixed(const Input& in) {
+  T acc = in(0);
+  for (uint32_t k = 1; k < N; k++) {
+    acc = GateTraits<K>::Combine(acc, in(k));
+  }
+  return GateTraits<K>::kInvert ? static_cast<T>(acc ^ AllOnes<T>()) : acc;
+}
+
+// any arity kernel
+template <GateKind K, typename T, typename Input>
+CIM_ALWAYS_INLINE T EvaluateNary(const Input& in, const uint32_t count) {
+  T acc = in(0);
+  for (uint32_t k = 1; k < count; k++) {
+    acc = GateTraits<K>::Combine(acc, in(k));
+  }
+  return GateTraits<K>::kInvert ? static_cast<T>(acc ^ AllOnes<T>()) : acc;
+}
+
+// truth table kernel: bit (sum of in(k) << k) of table is the output
+template <typename T, typename Input>
+CIM_ALWAYS_INLINE T EvaluateLut(const Input& in, const uint32_t count, const uint64_t table) {
+  if constexpr (sizeof(T) == 1) {
+    // single pattern -> index the table directly
+    uint32_t index = 0;
+    for (uint32_t k = 0; k < count; k++) {
+      index |= static_cast<uint32_t>(in(k)) << k;
+    }
+    return static_cast<T>((table >> index) & 1);
+  } else {
+    // many patterns -> tree of multiplexers, one level per input
+    T level[1u << kMaxLutInputs];
+    const uint32_t size = 1u << count;
+    for (uint32_t m = 0; m < size; m++) {
+      level[m] = ((table >> m) & 1) ? AllOnes<T>() : T{0};
+    }
+    for (uint32_t k = 0, width = size; k < count; k++, width >>= 1) {
+      const T sel = in(k);
+      for (uint32_t m = 0; m < width / 2; m++) {
+        level[m] = (sel & level[2 * m + 1]) | (~sel & level[2 * m]);
+      }
+    }
+    return level[0];
+  }
+}
+
+// kernel variant of a gate: kind and arity class (1..4 fixed, 0 any)
+constexpr uint32_t kArityClasses = 5;
+constexpr uint8_t MakeVariant(const GateKind kind, const uint32_t count) noexcept {
+  return static_cast<uint8_t>(static_cast<uint32_t>(kind) * kArityClasses +
+      ((kind != GateKind::LUT && count <= 4) ? count : 0));
+}
+
+// evaluate a gate through a single jump over its precomputed variant
+template <typename T, typename Input>
+CIM_ALWAYS_INLINE T EvaluateVariant(const uint8_t variant, const Input& in, const uint32_t count,
+    const uint64_t table) {
+// fixed arity 2 / 3 / 4 and any arity variants of one kind
+#define CIM_KIND_CASES(KIND) \
+    case MakeVariant(GateKind::KIND, 2): return EvaluateFixed<GateKind::KIND, 2, T>(in); \
+    case MakeVariant(GateKind::KIND, 3): return EvaluateFixed<GateKind::KIND, 3, T>(in); \
+    case MakeVariant(GateKind::KIND, 4): return EvaluateFixed<GateKind::KIND, 4, T>(in); \
+    case MakeVariant(GateKind::KIND, 0): return EvaluateNary<GateKind::KIND, T>(in, count);
+  switch (variant) {
+    CIM_KIND_CASES(AND)
+    CIM_KIND_CASES(OR)
+    CIM_KIND_CASES(XOR)
+    CIM_KIND_CASES(NAND)
+    CIM_KIND_CASES(NOR)
+    CIM_KIND_CASES(XNOR)
+    case MakeVariant(GateKind::NOT, 1): return static_cast<T>(in(0) ^ AllOnes<T>());
+    case MakeVariant(GateKind::LUT, 0): return EvaluateLut<T>(in, count, table);
+    default: return T{0};
+  }
+#undef CIM_KIND_CASES
+}
+
+// evaluate a gate kind directly (no precomputed variant)
+template <typename T, typename Input>
+CIM_ALWAYS_INLINE T EvaluateKind(const GateKind kind, const Input& in, const uint32_t count,
+    const uint64_t table) {
+  return EvaluateVariant<T>(MakeVariant(kind, count), in, count, table);
+}
+
+}
+
+#endif  // C_KERNELS_H
@@ -0,0 +1,164 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// includes for this file
+#include "c_levelized.h"
+#include <chrono>         // std::chrono
+#include <stdexcept>
+#include <cassert>
+
+// using namespace for this project
+using namespace Cim;
+
+// constructor
+LevelizedSim::LevelizedSim(const Netlist& TargetNetlist) :
+  pNetlist{&TargetNetlist}, nets(TargetNetlist.GetNetNum(), 0), pProfiler{nullptr} {
+  if (!TargetNetlist.IsLevelized()) {
+    throw std::logic_error("ERR: NETLIST MUST BE LEVELIZED! \n");
+  }
+}
+
+// set a primary input net
+void LevelizedSim::SetInput(const uint32_t net, const bool new_state) {
+  if (pNetlist->GetNetDriver(net) != UINT32_MAX) {
+    throw std::invalid_argument("ERR: NET IS NOT A PRIMARY INPUT! \n");
+  }
+  nets[net] = new_state;
+}
+
+// set all primary inputs
+void LevelizedSim::SetInputs(const std::vector<bool>& input_vector) {
+  const ArrayView<uint32_t> inputs = pNetlist->GetInputs();
+  if (input_vector.size() != inputs.size()) {
+    throw std::invalid_argument("ERR: INPUT VECTOR SIZE MISMATCH! \n");
+  }
+  for (uint32_t i = 0; i < inputs.size(); i++) {
+    nets[inputs[i]] = input_vector[i];
+  }
+}
+
+// return the state of a net
+bool LevelizedSim::GetState(const uint32_t net) const {
+  return this->nets.at(net) != 0;
+}
+
+// return the state of every net
+const std::vector<uint8_t>& LevelizedSim::GetStates() const noexcept {
+  return this->nets;
+}
+
+// evaluate the whole circuit once
+void LevelizedSim::Evaluate() noexcept {
+#if CIM_PROFILE
+  if (pProfiler != nullptr) {
+    evaluate_profiled();
+    return;
+  }
+#endif
+  // program is in level order -> every fanin is final before it is read
+  const Instruction* ins = pNetlist->GetProgram().data();
+  const Instruction* const end = ins + pNetlist->GetProgram().size();
+  const uint32_t* const fanin = pNetlist->GetFanin().data();
+  const uint64_t* const luts = pNetlist->GetLuts().data();
+  uint8_t* const states = nets.data();
+  for (; ins != end; ++ins) {
+    states[ins->out_net] = EvaluateInstruction(*ins, fanin, luts, states);
+  }
+}
+
+// Evaluate() with per-gate and per-level counters
+void LevelizedSim::evaluate_profiled() noexcept {
+  using Clock = std::chrono::steady_clock;
+  const ArrayView<uint32_t> levels = pNetlist->GetLevelOffsets();
+  const Instruction* const program = pNetlist->GetProgram().data();
+  const uint32_t* const fanin = pNetlist->GetFanin().data();
+  const uint64_t* const luts = pNetlist->GetLuts().data();
+  uint8_t* const states = nets.data();
+  uint64_t total = 0;
+  for (uint32_t l = 0; l + 1 < levels.size(); l++) {
+    const Clock::time_point start = Clock::now();
+    for (uint32_t g = levels[l]; g < levels[l + 1]; g++) {
+      const Instruction& ins = program[g];
+      const uint8_t state = EvaluateInstruction(ins, fanin, luts, states);
+      pProfiler->CountEvaluation(g);
+      if (state != states[ins.out_net]) {
+        states[ins.out_net] = state;
+        pProfiler->CountToggle(g);
+      }
+    }
+    const uint64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+    pProfiler->AddLevel(l, levels[l + 1] - levels[l], elapsed);
+    total += elapsed;
+  }
+  pProfiler->AddVectors(1, total);
+}
+
+// attach a profiler of the same netlist
+void LevelizedSim::SetProfiler(Profiler* const profiler) {
+  if (profiler != nullptr && &profiler->GetNetlist() != pNetlist) {
+    throw std::invalid_argument("ERR: PROFILER BELONGS TO ANOTHER NETLIST! \n");
+  }
+  if (profiler != nullptr && !Profiler::IsEnabled()) {
+    throw std::logic_error("ERR: PROFILING IS COMPILED OUT! \n");
+  }
+  pProfiler = profiler;
+}
+
+// capture every net state
+Snapshot LevelizedSim::Save(const Snapshot* const base) const {
+  return Snapshot(*pNetlist, nets.data(), 0, base);
+}
+
+// load every net state of a snapshot of the same netlist
+void LevelizedSim::Restore(const Snapshot& snapshot) {
+  if (snapshot.GetNetlist() != pNetlist) {
+    throw std::invalid_argument("ERR: SNAPSHOT BELONGS TO ANOTHER NETLIST! \n");
+  }
+  snapshot.Unpack(nets.data());
+}
+
+// load primary inputs from the pins they were compiled from
+void LevelizedSim::ReadInputs() {
+  for (const uint32_t each_net : pNetlist->GetInputs()) {
+    const Pin::Link source = pNetlist->GetInputSource(each_net);
+    if (source.first != nullptr) {
+      nets[each_net] = source.first->GetPinState(source.second);
+    }
+  }
+}
+
+// store the net states back into the compiled components' pins
+void LevelizedSim::WriteBack() const {
+  const ArrayView<Instruction> program = pNetlist->GetProgram();
+  const ArrayView<uint32_t> fanin = pNetlist->GetFanin();
+  for (uint32_t g = 0; g < program.size(); g++) {
+    Component* const comp = pNetlist->GetGateSource(g);
+    if (comp == nullptr) {
+      continue;
+    }
+    const Instruction& ins = program[g];
+    for (uint32_t k = 0; k < ins.fanin_count; k++) {
+      comp->Set(k, nets[fanin[ins.fanin_begin + k]] != 0);
+    }
+    comp->Set(ins.fanin_count, nets[ins.out_net] != 0);
+  }
+}
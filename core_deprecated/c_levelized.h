@@ -0,0 +1,90 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// include guard for this header
+#ifndef C_LEVELIZED_H
+#define C_LEVELIZED_H
+
+// includes for this header
+#include <vector>         // std::vector
+#include <cstdint>        // standard int types
+#include "c_netlist.h"    // class Netlist
+#include "c_snapshot.h"   // class Snapshot
+#include "c_profile.h"    // class Profiler, CIM_PROFILE
+
+// namespace for entire project
+namespace Cim {
+
+// LevelizedSim Class
+// Compiled-code simulation engine: evaluates every gate of a levelized Netlist
+// exactly once per input vector, in one pass over the instruction stream.
+class LevelizedSim {
+ public:
+  // constructor (netlist must be levelized and outlive the engine)
+  explicit LevelizedSim(const Netlist& TargetNetlist);
+
+  // destructor
+  ~LevelizedSim() { /* DN */ }
+
+  // set a primary input net
+  void SetInput(const uint32_t net, const bool new_state);
+
+  // set all primary inputs, in Netlist::GetInputs() order
+  void SetInputs(const std::vector<bool>& input_vector);
+
+  // return the state of a net
+  bool GetState(const uint32_t net) const;
+
+  // return the state of every net
+  const std::vector<uint8_t>& GetStates() const noexcept;
+
+  // evaluate the whole circuit once
+  void Evaluate() noexcept;
+
+  // attach a profiler of the same netlist (nullptr detaches), see c_profile.h
+  void SetProfiler(Profiler* const profiler);
+
+  // capture every net state (pages equal to those of base are shared)
+  Snapshot Save(const Snapshot* const base = nullptr) const;
+
+  // load every net state of a snapshot of the same netlist
+  void Restore(const Snapshot& snapshot);
+
+  // load primary inputs from the pins they were compiled from
+  void ReadInputs();
+
+  // store the net states back into the compiled components' pins
+  void WriteBack() const;
+
+ private:
+  // Evaluate() with per-gate and per-level counters
+  void evaluate_profiled() noexcept;
+
+ private:
+  const Netlist* pNetlist;      // compiled circuit
+  std::vector<uint8_t> nets;    // one state byte per net
+  Profiler* pProfiler;          // activity counters (nullptr if not profiled)
+};
+
+}
+
+#endif  // C_LEVELIZED_H
@@ -0,0 +1,308 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// includes for this file
+#include "c_logic4.h"
+#include "c_kernels.h"    // CIM_ALWAYS_INLINE
+#include <algorithm>      // std::fill, std::copy
+#include <bitset>         // std::bitset
+#include <cassert>
+
+// using namespace for this project
+using namespace Cim;
+
+namespace {
+
+// LUT on one word: multiplexer tree over "can be 1" / "can be 0" masks,
+// an unknown select keeps both halves possible
+template <uint32_t W>
+CIM_ALWAYS_INLINE void evaluate_lut(const uint32_t* in, const uint32_t count, const uint64_t table,
+    const uint64_t* values, const uint64_t* unknowns, const uint32_t l, uint64_t& value, uint64_t& unknown) {
+  uint64_t can1[1u << kMaxLutInputs], can0[1u << kMaxLutInputs];
+  const uint32_t size = 1u << count;
+  for (uint32_t m = 0; m < size; m++) {
+    can1[m] = ((table >> m) & 1) ? ~uint64_t{0} : 0;
+    can0[m] = ~can1[m];
+  }
+  for (uint32_t k = 0, width = size; k < count; k++, width >>= 1) {
+    const uint64_t v = values[static_cast<size_t>(in[k]) * W + l];
+    const uint64_t u = unknowns[static_cast<size_t>(in[k]) * W + l];
+    const uint64_t is1 = v & ~u, is0 = ~(v | u);
+    for (uint32_t m = 0; m < width / 2; m++) {
+      can1[m] = (can1[2 * m + 1] & ~is0) | (can1[2 * m] & ~is1);
+      can0[m] = (can0[2 * m + 1] & ~is0) | (can0[2 * m] & ~is1);
+    }
+  }
+  value = can1[0] & ~can0[0];
+  unknown = can1[0] & can0[0];
+}
+
+// evaluate instructions on W-word planes, W is a constant so the lane loops vectorize
+template <uint32_t W>
+void evaluate_block(const Instruction* program, const uint32_t count, const uint32_t* fanin,
+    const uint64_t* luts, uint64_t* values, uint64_t* unknowns) {
+  for (uint32_t g = 0; g < count; g++) {
+    const Instruction& ins = program[g];
+    const uint32_t* in = fanin + ins.fanin_begin;
+    uint64_t* const dst_v = values + static_cast<size_t>(ins.out_net) * W;
+    uint64_t* const dst_u = unknowns + static_cast<size_t>(ins.out_net) * W;
+    if (ins.op == GateKind::LUT) {
+      for (uint32_t l = 0; l < W; l++) {
+        evaluate_lut<W>(in, ins.fanin_count, luts[ins.lut], values, unknowns, l, dst_v[l], dst_u[l]);
+      }
+      continue;
+    }
+    // AND / OR: a = combined "can be 1", b = combined "is 1"
+    // XOR: a = any input unknown, b = parity of the value planes
+    const uint32_t* const end = in + ins.fanin_count;
+    const bool is_xor = (ins.op == GateKind::XOR || ins.op == GateKind::XNOR);
+    uint64_t a[W], b[W];
+    const uint64_t* src_v = values + static_cast<size_t>(*in) * W;
+    const uint64_t* src_u = unknowns + static_cast<size_t>(*in) * W;
+    for (uint32_t l = 0; l < W; l++) {
+      a[l] = is_xor ? src_u[l] : (src_v[l] | src_u[l]);
+      b[l] = is_xor ? src_v[l] : (src_v[l] & ~src_u[l]);
+    }
+    for (++in; in != end; ++in) {
+      src_v = values + static_cast<size_t>(*in) * W;
+      src_u = unknowns + static_cast<size_t>(*in) * W;
+      switch (ins.op) {
+        case GateKind::AND:
+        case GateKind::NAND:
+          for (uint32_t l = 0; l < W; l++) {
+            a[l] &= src_v[l] | src_u[l];
+            b[l] &= src_v[l] & ~src_u[l];
+          }
+          break;
+        case GateKind::OR:
+        case GateKind::NOR:
+          for (uint32_t l = 0; l < W; l++) {
+            a[l] |= src_v[l] | src_u[l];
+            b[l] |= src_v[l] & ~src_u[l];
+          }
+          break;
+        case GateKind::XOR:
+        case GateKind::XNOR:
+          for (uint32_t l = 0; l < W; l++) {
+            a[l] |= src_u[l];
+            b[l] ^= src_v[l];
+          }
+          break;
+        default:
+          // NOT has a single input, sequential kinds never reach the program
+          break;
+      }
+    }
+    // known 1 / known 0 masks, inversion swaps them, the rest is X
+    const bool invert = (ins.op == GateKind::NOT || ins.op == GateKind::NAND ||
+        ins.op == GateKind::NOR || ins.op == GateKind::XNOR);
+    for (uint32_t l = 0; l < W; l++) {
+      const uint64_t one = is_xor ? (b[l] & ~a[l]) : b[l];
+      const uint64_t zero = is_xor ? ~(b[l] | a[l]) : ~a[l];
+      dst_v[l] = invert ? zero : one;
+      dst_u[l] = ~(one | zero);
+    }
+  }
+}
+
+}
+
+// constructor
+Logic4Sim::Logic4Sim(const Netlist& TargetNetlist, const uint32_t patterns) :
+  pNetlist{&TargetNetlist}, word_num{patterns / 64}, kernel{nullptr}, cycle_num{0},
+  // State
+  values(), unknowns(), next_values(), next_unknowns() {
+  if (!TargetNetlist.IsLevelized()) {
+    throw std::logic_error("ERR: NETLIST MUST BE LEVELIZED! \n");
+  }
+  switch (patterns) {
+    case 64:  kernel = &evaluate_block<1>; break;
+    case 256: kernel = &evaluate_block<4>; break;
+    case 512: kernel = &evaluate_block<8>; break;
+    default: throw std::invalid_argument("ERR: PATTERN NUMBER MUST BE 64, 256 OR 512! \n");
+  }
+  values.assign(static_cast<size_t>(TargetNetlist.GetNetNum()) * word_num, 0);
+  unknowns.assign(values.size(), 0);
+  next_values.assign(static_cast<size_t>(TargetNetlist.GetRegisters().size()) * word_num, 0);
+  next_unknowns.assign(next_values.size(), 0);
+  PowerUp();
+}
+
+// return the number of patterns
+uint32_t Logic4Sim::GetPatternNum() const noexcept {
+  return this->word_num * 64;
+}
+
+// return the number of 64-bit words per net and plane
+uint32_t Logic4Sim::GetWordNum() const noexcept {
+  return this->word_num;
+}
+
+// return the value plane of a net
+const uint64_t* Logic4Sim::GetValueWords(const uint32_t net) const {
+  if (net >= pNetlist->GetNetNum()) {
+    throw std::out_of_range("ERR: NET DOES NOT EXIST! \n");
+  }
+  return values.data() + static_cast<size_t>(net) * word_num;
+}
+
+// return the unknown plane of a net
+const uint64_t* Logic4Sim::GetUnknownWords(const uint32_t net) const {
+  if (net >= pNetlist->GetNetNum()) {
+    throw std::out_of_range("ERR: NET DOES NOT EXIST! \n");
+  }
+  return unknowns.data() + static_cast<size_t>(net) * word_num;
+}
+
+// throw unless net is a primary input
+void Logic4Sim::check_input(const uint32_t net) const {
+  if (pNetlist->GetNetDriver(net) != UINT32_MAX) {
+    throw std::invalid_argument("ERR: NET IS NOT A PRIMARY INPUT! \n");
+  }
+}
+
+// set all patterns of a primary input net from both planes
+void Logic4Sim::SetInputWords(const uint32_t net, const uint64_t* const new_values,
+    const uint64_t* const new_unknowns) {
+  check_input(net);
+  std::copy(new_values, new_values + word_num, values.begin() + static_cast<size_t>(net) * word_num);
+  std::copy(new_unknowns, new_unknowns + word_num, unknowns.begin() + static_cast<size_t>(net) * word_num);
+}
+
+// set one pattern of a primary input net
+void Logic4Sim::SetInput(const uint32_t net, const uint32_t pattern, const Logic new_state) {
+  check_input(net);
+  if (pattern >= GetPatternNum()) {
+    throw std::out_of_range("ERR: PATTERN DOES NOT EXIST! \n");
+  }
+  const size_t word = static_cast<size_t>(net) * word_num + pattern / 64;
+  const uint64_t bit = uint64_t{1} << (pattern % 64);
+  const uint32_t planes = static_cast<uint32_t>(new_state);
+  values[word] = (planes & 1) ? (values[word] | bit) : (values[word] & ~bit);
+  unknowns[word] = (planes & 2) ? (unknowns[word] | bit) : (unknowns[word] & ~bit);
+}
+
+// set every pattern of a primary input net
+void Logic4Sim::SetInput(const uint32_t net, const Logic new_state) {
+  check_input(net);
+  const uint32_t planes = static_cast<uint32_t>(new_state);
+  const auto first = static_cast<ptrdiff_t>(net) * word_num;
+  std::fill(values.begin() + first, values.begin() + first + word_num, (planes & 1) ? ~uint64_t{0} : 0);
+  std::fill(unknowns.begin() + first, unknowns.begin() + first + word_num, (planes & 2) ? ~uint64_t{0} : 0);
+}
+
+// return one pattern of a net
+Logic Logic4Sim::GetState(const uint32_t net, const uint32_t pattern) const {
+  if (pattern >= GetPatternNum()) {
+    throw std::out_of_range("ERR: PATTERN DOES NOT EXIST! \n");
+  }
+  const uint32_t value = (GetValueWords(net)[pattern / 64] >> (pattern % 64)) & 1;
+  const uint32_t unknown = (GetUnknownWords(net)[pattern / 64] >> (pattern % 64)) & 1;
+  return static_cast<Logic>(value | (unknown << 1));
+}
+
+// return one pattern of the state stored in a register
+Logic Logic4Sim::GetRegisterState(const uint32_t reg, const uint32_t pattern) const {
+  return GetState(pNetlist->GetRegisters().at(reg).q_net, pattern);
+}
+
+// return the number of patterns in which a net is X or Z
+uint32_t Logic4Sim::CountUnknown(const uint32_t net) const {
+  const uint64_t* const words = GetUnknownWords(net);
+  uint32_t count = 0;
+  for (uint32_t l = 0; l < word_num; l++) {
+    count += std::bitset<64>(words[l]).count();
+  }
+  return count;
+}
+
+// every net X, inputs compiled from dangling pins Z
+void Logic4Sim::PowerUp() noexcept {
+  std::fill(values.begin(), values.end(), 0);
+  std::fill(unknowns.begin(), unknowns.end(), ~uint64_t{0});
+  for (const uint32_t each_net : pNetlist->GetInputs()) {
+    // a dangling pin is its own source and has no connection
+    const Pin::Link source = pNetlist->GetInputSource(each_net);
+    if (source.first != nullptr && !source.first->IsPinConnected(source.second)) {
+      std::fill_n(values.begin() + static_cast<ptrdiff_t>(each_net) * word_num, word_num, ~uint64_t{0});
+    }
+  }
+  cycle_num = 0;
+}
+
+// load the initial state into every register
+void Logic4Sim::Reset() noexcept {
+  for (const Register& each_reg : pNetlist->GetRegisters()) {
+    const auto first = static_cast<ptrdiff_t>(each_reg.q_net) * word_num;
+    std::fill_n(values.begin() + first, word_num, each_reg.init ? ~uint64_t{0} : 0);
+    std::fill_n(unknowns.begin() + first, word_num, 0);
+  }
+  cycle_num = 0;
+}
+
+// compute phase only
+void Logic4Sim::Evaluate() noexcept {
+  // register outputs are sources -> one pass in level order settles everything
+  kernel(pNetlist->GetProgram().data(), pNetlist->GetProgram().size(), pNetlist->GetFanin().data(),
+      pNetlist->GetLuts().data(), values.data(), unknowns.data());
+}
+
+// one clock edge
+void Logic4Sim::Clock() noexcept {
+  Evaluate();
+  const ArrayView<Register> regs = pNetlist->GetRegisters();
+  // 1. compute: sample every input before any output changes
+  for (uint32_t r = 0; r < regs.size(); r++) {
+    const Register& reg = regs[r];
+    const size_t d = static_cast<size_t>(reg.d_net) * word_num, q = static_cast<size_t>(reg.q_net) * word_num;
+    const bool gated = reg.kind == GateKind::LATCH && reg.ctrl_net != UINT32_MAX;
+    const size_t e = gated ? static_cast<size_t>(reg.ctrl_net) * word_num : 0;
+    for (uint32_t l = 0; l < word_num; l++) {
+      // a floating D is stored as X
+      const uint64_t d_u = unknowns[d + l], d_v = values[d + l] & ~d_u;
+      if (!gated) {
+        next_values[static_cast<size_t>(r) * word_num + l] = d_v;
+        next_unknowns[static_cast<size_t>(r) * word_num + l] = d_u;
+        continue;
+      }
+      // open: D, closed: Q, unknown enable: Q only where D and Q agree
+      const uint64_t q_v = values[q + l], q_u = unknowns[q + l];
+      const uint64_t open = values[e + l] & ~unknowns[e + l], closed = ~(values[e + l] | unknowns[e + l]);
+      const uint64_t maybe = unknowns[e + l];
+      const uint64_t agree = ~(d_v ^ q_v) & ~d_u & ~q_u;
+      next_values[static_cast<size_t>(r) * word_num + l] = (open & d_v) | (closed & q_v) | (maybe & agree & q_v);
+      next_unknowns[static_cast<size_t>(r) * word_num + l] = (open & d_u) | (closed & q_u) | (maybe & ~agree);
+    }
+  }
+  // 2. commit
+  for (uint32_t r = 0; r < regs.size(); r++) {
+    const size_t q = static_cast<size_t>(regs[r].q_net) * word_num;
+    std::copy_n(next_values.begin() + static_cast<ptrdiff_t>(r) * word_num, word_num, values.begin() + q);
+    std::copy_n(next_unknowns.begin() + static_cast<ptrdiff_t>(r) * word_num, word_num, unknowns.begin() + q);
+  }
+  cycle_num++;
+}
+
+// return the number of clock edges since the last PowerUp() / Reset()
+uint64_t Logic4Sim::GetCycleNum() const noexcept {
+  return this->cycle_num;
+}
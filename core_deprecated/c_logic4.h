@@ -0,0 +1,139 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// include guard for this header
+#ifndef C_LOGIC4_H
+#define C_LOGIC4_H
+
+// includes for this header
+#include <vector>         // std::vector
+#include <cstdint>        // standard int types
+#include <stdexcept>      // std::invalid_argument
+#include "c_netlist.h"    // class Netlist
+
+// namespace for entire project
+namespace Cim {
+
+// four-valued logic state, bit 0 is the value plane, bit 1 the unknown plane
+enum class Logic : uint8_t {
+  ZERO = 0,   // driven 0
+  ONE,        // driven 1
+  X,          // unknown (uninitialized, conflicting or computed from an unknown)
+  Z           // not driven (floating), reads as X at gate inputs
+};
+
+// translate a logic state into '0', '1', 'X' or 'Z'
+constexpr char GetLogicChar(const Logic state) noexcept {
+  return "01XZ"[static_cast<uint32_t>(state)];
+}
+
+// translate '0', '1', 'X'/'x' or 'Z'/'z' into a logic state
+inline Logic ParseLogic(const char state) {
+  switch (state) {
+    case '0': return Logic::ZERO;
+    case '1': return Logic::ONE;
+    case 'X': case 'x': return Logic::X;
+    case 'Z': case 'z': return Logic::Z;
+  }
+  throw std::invalid_argument("ERR: UNKNOWN LOGIC STATE! \n");
+}
+
+// Logic4Sim Class
+// Four-valued (0 / 1 / X / Z) multi-pattern engine. Like BitParallelSim every net
+// holds 64, 256 or 512 patterns, but in two bit-planes: value and unknown
+// (0 = 00, 1 = 01, X = 10, Z = 11 as unknown:value). With no unknown bit set
+// the value plane equals the words of BitParallelSim for the same inputs.
+// Gates evaluate with a few bitwise operations per plane and only produce a
+// known output if it holds for every completion of their X / Z inputs.
+// Registers follow the two-phase clocking of CycleSim and power up as X, so
+// reset sequences can be checked: a register is known once reset reached it.
+class Logic4Sim {
+ public:
+  // constructor (patterns must be 64, 256 or 512, netlist must be levelized and outlive the engine)
+  explicit Logic4Sim(const Netlist& TargetNetlist, const uint32_t patterns = 64);
+
+  // destructor
+  ~Logic4Sim() { /* DN */ }
+
+  // return the number of patterns / 64-bit words per net and plane
+  uint32_t GetPatternNum() const noexcept;
+  uint32_t GetWordNum() const noexcept;
+
+  // return the value / unknown plane of a net (GetWordNum() words each)
+  const uint64_t* GetValueWords(const uint32_t net) const;
+  const uint64_t* GetUnknownWords(const uint32_t net) const;
+
+  // set all patterns of a primary input net from both planes
+  void SetInputWords(const uint32_t net, const uint64_t* const values, const uint64_t* const unknowns);
+
+  // set one / every pattern of a primary input net
+  void SetInput(const uint32_t net, const uint32_t pattern, const Logic new_state);
+  void SetInput(const uint32_t net, const Logic new_state);
+
+  // return one pattern of a net
+  Logic GetState(const uint32_t net, const uint32_t pattern) const;
+
+  // return one pattern of the state stored in a register
+  Logic GetRegisterState(const uint32_t reg, const uint32_t pattern) const;
+
+  // return the number of patterns in which a net is X or Z
+  uint32_t CountUnknown(const uint32_t net) const;
+
+  // every net X, inputs compiled from dangling pins Z, restart the cycle count
+  void PowerUp() noexcept;
+
+  // load the initial state into every register and restart the cycle count
+  void Reset() noexcept;
+
+  // compute phase only: settle the combinational logic for the current inputs & state
+  void Evaluate() noexcept;
+
+  // one clock edge: compute, then commit every register at once (see CycleSim::Clock())
+  void Clock() noexcept;
+
+  // return the number of clock edges since the last PowerUp() / Reset()
+  uint64_t GetCycleNum() const noexcept;
+
+ private:
+  // kernel signature: evaluate count instructions on word_num-wide planes
+  typedef void (*Kernel)(const Instruction* program, const uint32_t count, const uint32_t* fanin,
+      const uint64_t* luts, uint64_t* values, uint64_t* unknowns);
+
+  // throw unless net is a primary input
+  void check_input(const uint32_t net) const;
+
+ private:
+  const Netlist* pNetlist;            // compiled circuit
+  uint32_t word_num;                  // 64-bit words per net and plane
+  Kernel kernel;                      // evaluation loop for word_num
+  uint64_t cycle_num;                 // clock edges since power-up / reset
+
+  // State: net n owns words [n * word_num, (n + 1) * word_num) of each plane
+  std::vector<uint64_t> values;       // value plane
+  std::vector<uint64_t> unknowns;     // unknown plane
+  std::vector<uint64_t> next_values;  // sampled value per register word (compute -> commit)
+  std::vector<uint64_t> next_unknowns;// sampled unknown per register word
+};
+
+}
+
+#endif  // C_LOGIC4_H
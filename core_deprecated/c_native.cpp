@@ -0,0 +1,450 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// includes for this file
+#include "c_native.h"
+#include "c_cache.h"  // HashBytes()
+#include <stdexcept>
+#include <chrono>     // std::chrono
+#include <atomic>     // std::atomic
+#include <cctype>     // std::isspace
+#include <cerrno>     // errno
+#include <cstdio>     // std::snprintf
+#include <cstdlib>    // std::getenv
+#include <fstream>    // std::ofstream
+#include <filesystem> // std::filesystem
+
+// dlopen is available on Unix-like systems only
+#if defined(__unix__) || defined(__APPLE__)
+#define CIM_NATIVE_DLOPEN 1
+#include <dlfcn.h>    // dlopen, dlsym, dlclose
+#include <fcntl.h>    // O_WRONLY
+#include <spawn.h>    // posix_spawnp
+#include <sys/stat.h> // stat
+#include <sys/wait.h> // waitpid
+#include <unistd.h>   // getpid, geteuid
+
+// environment handed to the compiler
+extern char** environ;
+#else
+#define CIM_NATIVE_DLOPEN 0
+#endif
+
+// compiler of generated code by default (the build passes its own)
+#ifndef CIM_NATIVE_CXX
+#define CIM_NATIVE_CXX "c++"
+#endif
+
+// using namespace for this project
+using namespace Cim;
+
+namespace {
+
+// return the meaningful bits of an n-input truth table
+uint64_t table_mask(const uint32_t n) {
+  return (n == kMaxLutInputs) ? ~uint64_t{0} : ((uint64_t{1} << (1u << n)) - 1);
+}
+
+// return an expression of a truth table over the inputs in[0, n), split on the last input
+std::string lut_expr(uint64_t table, const uint32_t n, const std::vector<std::string>& in) {
+  table &= table_mask(n);
+  if (table == 0) {
+    return "Z";
+  }
+  if (table == table_mask(n)) {
+    return "O";
+  }
+  const uint32_t half = 1u << (n - 1);
+  const uint64_t low = table & table_mask(n - 1), high = (table >> half) & table_mask(n - 1);
+  if (low == high) {
+    return lut_expr(low, n - 1, in);
+  }
+  const std::string& x = in[n - 1];
+  const std::string h = lut_expr(high, n - 1, in), l = lut_expr(low, n - 1, in);
+  if (h == "O" && l == "Z") return x;
+  if (h == "Z" && l == "O") return "~" + x;
+  if (h == "O") return "(" + x + " | " + l + ")";
+  if (h == "Z") return "(~" + x + " & " + l + ")";
+  if (l == "Z") return "(" + x + " & " + h + ")";
+  if (l == "O") return "(~" + x + " | " + h + ")";
+  return "((" + x + " & " + h + ") | (~" + x + " & " + l + "))";
+}
+
+// return a 64-bit number as a C++ literal
+std::string hex_literal(const uint64_t value) {
+  char text[24];
+  std::snprintf(text, sizeof(text), "0x%016llxull", static_cast<unsigned long long>(value));
+  return text;
+}
+
+#if CIM_NATIVE_DLOPEN
+// return the per-user cache: $XDG_CACHE_HOME/cim_native, ~/.cache/cim_native or <temp>/cim_native-<uid>
+std::filesystem::path default_cache_dir() {
+  const char* const xdg = std::getenv("XDG_CACHE_HOME");
+  if (xdg != nullptr && xdg[0] == '/') {
+    return std::filesystem::path(xdg) / "cim_native";
+  }
+  const char* const home = std::getenv("HOME");
+  if (home != nullptr && home[0] == '/') {
+    return std::filesystem::path(home) / ".cache" / "cim_native";
+  }
+  return std::filesystem::temp_directory_path() / ("cim_native-" + std::to_string(geteuid()));
+}
+
+// create the cache directory (0700), then make sure no other user can plant objects in it
+void make_private_dir(const std::filesystem::path& dir) {
+  if (std::filesystem::create_directories(dir)) {
+    std::filesystem::permissions(dir, std::filesystem::perms::owner_all, std::filesystem::perm_options::replace);
+  }
+  struct stat info;
+  if (stat(dir.c_str(), &info) != 0 || !S_ISDIR(info.st_mode) || info.st_uid != geteuid() ||
+      (info.st_mode & (S_IWGRP | S_IWOTH)) != 0) {
+    throw std::runtime_error("ERR: NATIVE CACHE DIRECTORY MUST BE OWNED BY THE USER AND NOT WRITABLE BY OTHERS! \n");
+  }
+}
+
+// split a command line on white space (no shell: quotes & variables are not interpreted)
+void split_words(const std::string& text, std::vector<std::string>& words) {
+  size_t i = 0;
+  while (i < text.size()) {
+    if (std::isspace(static_cast<unsigned char>(text[i]))) {
+      i++;
+      continue;
+    }
+    const size_t begin = i;
+    while (i < text.size() && !std::isspace(static_cast<unsigned char>(text[i]))) i++;
+    words.emplace_back(text, begin, i - begin);
+  }
+}
+
+// run a program with stderr sent to log_path, return true if it exited with 0
+bool run(const std::vector<std::string>& args, const std::string& log_path) {
+  std::vector<char*> argv;
+  for (const std::string& each_arg : args) {
+    argv.push_back(const_cast<char*>(each_arg.c_str()));
+  }
+  argv.push_back(nullptr);
+  posix_spawn_file_actions_t actions;
+  if (posix_spawn_file_actions_init(&actions) != 0) {
+    return false;
+  }
+  pid_t child = 0;
+  const bool started =
+      posix_spawn_file_actions_addopen(&actions, 2, log_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600) == 0 &&
+      posix_spawnp(&child, argv[0], &actions, nullptr, argv.data(), environ) == 0;
+  posix_spawn_file_actions_destroy(&actions);
+  int status = 0;
+  while (started && waitpid(child, &status, 0) < 0) {
+    if (errno != EINTR) {
+      return false;
+    }
+  }
+  return started && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+#endif
+
+}
+
+// return a 64-bit hash of the evaluated structure of a netlist
+uint64_t Cim::HashNetlist(const Netlist& netlist) noexcept {
+  const ArrayView<Instruction> program = netlist.GetProgram();
+  const ArrayView<uint32_t> fanin = netlist.GetFanin();
+  const ArrayView<uint64_t> luts = netlist.GetLuts();
+  uint64_t hash = HashBytes(program.data(), program.size() * sizeof(Instruction), netlist.GetNetNum());
+  hash = HashBytes(fanin.data(), fanin.size() * sizeof(uint32_t), hash);
+  return HashBytes(luts.data(), luts.size() * sizeof(uint64_t), hash);
+}
+
+// return C++ source evaluating the netlist
+std::string Cim::GenerateNativeSource(const Netlist& netlist, const uint32_t word_num, const uint32_t chunk_size) {
+  if (!netlist.IsLevelized()) {
+    throw std::logic_error("ERR: NETLIST MUST BE LEVELIZED! \n");
+  }
+  if (word_num != 1 && word_num != 4 && word_num != 8) {
+    throw std::invalid_argument("ERR: PATTERN NUMBER MUST BE 64, 256 OR 512! \n");
+  }
+  if (chunk_size == 0) {
+    throw std::invalid_argument("ERR: CHUNK SIZE MUST NOT BE 0! \n");
+  }
+  const ArrayView<Instruction> program = netlist.GetProgram();
+  const ArrayView<uint32_t> fanin = netlist.GetFanin();
+  const ArrayView<uint64_t> luts = netlist.GetLuts();
+  std::string source;
+  source.reserve(64 + static_cast<size_t>(program.size()) * 40);
+
+  // 1. one net = one value of v_t: a word, or a vector of words the compiler maps to SIMD registers
+  source += "// generated by Cim::GenerateNativeSource, do not edit\n";
+  source += "// gates " + std::to_string(program.size()) + ", nets " + std::to_string(netlist.GetNetNum()) +
+      ", words per net " + std::to_string(word_num) + "\n";
+  source += "typedef unsigned long long w_t;\n";
+  if (word_num == 1) {
+    source += "typedef w_t v_t;\n";
+  } else {
+    source += "typedef w_t v_t __attribute__((vector_size(" + std::to_string(8 * word_num) + "), aligned(8)));\n";
+  }
+  source += "static const v_t Z = {};\nstatic const v_t O = ~Z;\n";
+
+  // 2. straight-line code, one statement per gate, cut into functions of chunk_size gates
+  std::vector<std::string> in;
+  uint32_t chunk_num = 0;
+  for (uint32_t begin = 0; begin < program.size(); begin += chunk_size, chunk_num++) {
+    source += "static __attribute__((noinline)) void c" + std::to_string(chunk_num) + "(v_t* __restrict v) {\n";
+    const uint32_t end = (program.size() - begin < chunk_size) ? program.size() : begin + chunk_size;
+    for (uint32_t g = begin; g < end; g++) {
+      const Instruction& ins = program[g];
+      in.clear();
+      for (uint32_t k = 0; k < ins.fanin_count; k++) {
+        in.push_back("v[" + std::to_string(fanin[ins.fanin_begin + k]) + "]");
+      }
+      std::string expr;
+      const char* join = " & ";
+      bool invert = false;
+      switch (ins.op) {
+        case GateKind::AND:  break;
+        case GateKind::NAND: invert = true; break;
+        case GateKind::OR:   join = " | "; break;
+        case GateKind::NOR:  join = " | "; invert = true; break;
+        case GateKind::XOR:  join = " ^ "; break;
+        case GateKind::XNOR: join = " ^ "; invert = true; break;
+        case GateKind::NOT:  invert = true; break;
+        case GateKind::LUT:  expr = lut_expr(luts[ins.lut], ins.fanin_count, in); break;
+        default: throw std::logic_error("ERR: UNKNOWN GATE KIND! \n");
+      }
+      if (ins.op != GateKind::LUT) {
+        for (uint32_t k = 0; k < in.size(); k++) {
+          expr += (k == 0) ? in[k] : join + in[k];
+        }
+        if (invert) {
+          expr = (in.size() == 1) ? "~" + expr : "~(" + expr + ")";
+        }
+      }
+      source += "  v[" + std::to_string(ins.out_net) + "] = " + expr + ";\n";
+    }
+    source += "}\n";
+  }
+
+  // 3. entry point & the identity of the netlist
+  source += "extern \"C\" void cim_evaluate(w_t* w) {\n  v_t* const v = (v_t*)w;\n";
+  for (uint32_t c = 0; c < chunk_num; c++) {
+    source += "  c" + std::to_string(c) + "(v);\n";
+  }
+  source += "}\n";
+  source += "extern \"C\" const w_t cim_netlist_hash = " + hex_literal(HashNetlist(netlist)) + ";\n";
+  source += "extern \"C\" const unsigned cim_word_num = " + std::to_string(word_num) + ";\n";
+  return source;
+}
+
+// constructor
+NativeSim::NativeSim(const Netlist& TargetNetlist, const uint32_t patterns, const NativeOptions& Options) :
+  pNetlist{&TargetNetlist}, word_num{patterns / 64}, handle{nullptr}, kernel{nullptr},
+  object_path(), cache_hit{false}, compile_seconds{0}, load_seconds{0}, words() {
+  if (!TargetNetlist.IsLevelized()) {
+    throw std::logic_error("ERR: NETLIST MUST BE LEVELIZED! \n");
+  }
+  if (patterns != 64 && patterns != 256 && patterns != 512) {
+    throw std::invalid_argument("ERR: PATTERN NUMBER MUST BE 64, 256 OR 512! \n");
+  }
+#if CIM_NATIVE_DLOPEN
+  // key = netlist + code version + width + how it is compiled
+  const uint64_t netlist_hash = HashNetlist(TargetNetlist);
+  const std::string compiler = Options.compiler.empty() ? std::string(CIM_NATIVE_CXX) : Options.compiler;
+  const std::string command = compiler + " " + Options.flags;
+  const uint64_t tag[3] = {kNativeCodeVersion, word_num, Options.chunk_size};
+  const uint64_t key = HashBytes(command.data(), command.size(), HashBytes(tag, sizeof(tag), netlist_hash));
+  const std::filesystem::path dir = Options.cache_dir.empty() ?
+      default_cache_dir() : std::filesystem::path(Options.cache_dir);
+  make_private_dir(dir);
+  char name[24];
+  std::snprintf(name, sizeof(name), "%016llx.so", static_cast<unsigned long long>(key));
+  object_path = (dir / name).string();
+
+  // hit: load the cached object, miss or damaged entry: build it
+  cache_hit = std::filesystem::exists(object_path) && load(netlist_hash);
+  if (!cache_hit) {
+    const auto start = std::chrono::steady_clock::now();
+    NativeOptions resolved = Options;
+    resolved.compiler = compiler;
+    compile(object_path, resolved);
+    compile_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (!load(netlist_hash)) {
+      throw std::runtime_error("ERR: CANNOT LOAD NATIVE OBJECT! \n");
+    }
+  }
+#else
+  (void)Options;
+  throw std::runtime_error("ERR: NATIVE BACKEND NEEDS DLOPEN! \n");
+#endif
+  words.assign(static_cast<size_t>(TargetNetlist.GetNetNum()) * word_num, 0);
+}
+
+// destructor
+NativeSim::~NativeSim() {
+#if CIM_NATIVE_DLOPEN
+  if (handle != nullptr) {
+    dlclose(handle);
+  }
+#endif
+}
+
+// generate & compile the object into path
+void NativeSim::compile(const std::string& path, const NativeOptions& options) const {
+#if CIM_NATIVE_DLOPEN
+  // private temporary names, renamed at the end -> concurrent runs never load a partial object
+  static std::atomic<uint64_t> temp_num{0};
+  const std::string stem = path.substr(0, path.size() - 3);
+  const std::string temp = stem + "." + std::to_string(getpid()) + "." + std::to_string(temp_num++);
+  {
+    std::ofstream file(temp + ".cpp", std::ios::binary | std::ios::trunc);
+    file << GenerateNativeSource(*pNetlist, word_num, options.chunk_size);
+    if (!file) {
+      throw std::runtime_error("ERR: CANNOT WRITE NATIVE SOURCE! \n");
+    }
+  }
+  // the compiler is started directly, paths never go through a shell
+  std::vector<std::string> args;
+  split_words(options.compiler, args);
+  split_words(options.flags, args);
+  if (args.empty()) {
+    throw std::invalid_argument("ERR: NATIVE COMPILER MUST BE GIVEN! \n");
+  }
+  for (const char* const each_arg : {"-shared", "-fPIC", "-o"}) {
+    args.emplace_back(each_arg);
+  }
+  args.push_back(temp + ".so");
+  args.push_back(temp + ".cpp");
+  if (!run(args, temp + ".log") || !std::filesystem::exists(temp + ".so")) {
+    // the source & compiler log stay for inspection
+    throw std::runtime_error("ERR: NATIVE COMPILATION FAILED! \n");
+  }
+  std::filesystem::rename(temp + ".so", path);
+  std::filesystem::rename(temp + ".cpp", stem + ".cpp");
+  std::filesystem::remove(temp + ".log");
+#else
+  (void)path;
+  (void)options;
+#endif
+}
+
+// load the object at object_path
+bool NativeSim::load(const uint64_t netlist_hash) {
+#if CIM_NATIVE_DLOPEN
+  const auto start = std::chrono::steady_clock::now();
+  void* const object = dlopen(object_path.c_str(), RTLD_NOW | RTLD_LOCAL);
+  if (object == nullptr) {
+    return false;
+  }
+  const uint64_t* const stored_hash = static_cast<const uint64_t*>(dlsym(object, "cim_netlist_hash"));
+  const unsigned* const stored_words = static_cast<const unsigned*>(dlsym(object, "cim_word_num"));
+  void* const entry = dlsym(object, "cim_evaluate");
+  if (stored_hash == nullptr || stored_words == nullptr || entry == nullptr ||
+      *stored_hash != netlist_hash || *stored_words != word_num) {
+    dlclose(object);
+    return false;
+  }
+  handle = object;
+  kernel = reinterpret_cast<Kernel>(entry);
+  load_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return true;
+#else
+  (void)netlist_hash;
+  return false;
+#endif
+}
+
+// return the number of patterns
+uint32_t NativeSim::GetPatternNum() const noexcept {
+  return this->word_num * 64;
+}
+
+// return the number of 64-bit words per net
+uint32_t NativeSim::GetWordNum() const noexcept {
+  return this->word_num;
+}
+
+// return the words of a net
+const uint64_t* NativeSim::GetWords(const uint32_t net) const {
+  if (net >= pNetlist->GetNetNum()) {
+    throw std::out_of_range("ERR: NET DOES NOT EXIST! \n");
+  }
+  return words.data() + static_cast<size_t>(net) * word_num;
+}
+
+// set all patterns of a primary input net
+void NativeSim::SetInputWords(const uint32_t net, const uint64_t* const new_words) {
+  if (pNetlist->GetNetDriver(net) != UINT32_MAX) {
+    throw std::invalid_argument("ERR: NET IS NOT A PRIMARY INPUT! \n");
+  }
+  for (uint32_t l = 0; l < word_num; l++) {
+    words[static_cast<size_t>(net) * word_num + l] = new_words[l];
+  }
+}
+
+// set one pattern of a net
+void NativeSim::SetInput(const uint32_t net, const uint32_t pattern, const bool new_state) {
+  if (pNetlist->GetNetDriver(net) != UINT32_MAX) {
+    throw std::invalid_argument("ERR: NET IS NOT A PRIMARY INPUT! \n");
+  }
+  if (pattern >= GetPatternNum()) {
+    throw std::out_of_range("ERR: PATTERN DOES NOT EXIST! \n");
+  }
+  uint64_t& word = words[static_cast<size_t>(net) * word_num + pattern / 64];
+  const uint64_t bit = uint64_t{1} << (pattern % 64);
+  word = new_state ? (word | bit) : (word & ~bit);
+}
+
+// return one pattern of a net
+bool NativeSim::GetState(const uint32_t net, const uint32_t pattern) const {
+  if (pattern >= GetPatternNum()) {
+    throw std::out_of_range("ERR: PATTERN DOES NOT EXIST! \n");
+  }
+  return (GetWords(net)[pattern / 64] >> (pattern % 64)) & 1;
+}
+
+// evaluate all patterns once
+void NativeSim::Evaluate() noexcept {
+  kernel(words.data());
+}
+
+// return true if the object came from the cache
+bool NativeSim::IsCacheHit() const noexcept {
+  return this->cache_hit;
+}
+
+// return the path of the loaded object
+const std::string& NativeSim::GetObjectPath() const noexcept {
+  return this->object_path;
+}
+
+// return the seconds spent generating & compiling
+double NativeSim::GetCompileSeconds() const noexcept {
+  return this->compile_seconds;
+}
+
+// return the seconds spent loading
+double NativeSim::GetLoadSeconds() const noexcept {
+  return this->load_seconds;
+}
+
+// return true if this platform can load generated code
+bool NativeSim::IsSupported() noexcept {
+  return CIM_NATIVE_DLOPEN != 0;
+}
@@ -0,0 +1,133 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// include guard for this header
+#ifndef C_NATIVE_H
+#define C_NATIVE_H
+
+// includes for this header
+#include <string>         // std::string
+#include <vector>         // std::vector
+#include <cstdint>        // standard int types
+#include "c_netlist.h"    // class Netlist
+
+// namespace for entire project
+namespace Cim {
+
+// version of the generated code (bump on any change to GenerateNativeSource)
+constexpr uint32_t kNativeCodeVersion = 1;
+
+// how generated code is built & where it is kept
+struct NativeOptions {
+  std::string compiler;                       // compiler command (empty: the one that built this library)
+  std::string flags = "-O2 -march=native";    // optimization flags, -shared -fPIC are added (both split on white
+                                              // space and run without a shell)
+  std::string cache_dir;                      // directory of compiled objects, owned by the user and not writable
+                                              // by others (empty: $XDG_CACHE_HOME/cim_native or ~/.cache/cim_native)
+  uint32_t chunk_size = 256;                  // gates per generated function (compile time grows faster than linear in it)
+};
+
+// return a 64-bit hash of the evaluated structure of a netlist (program, fanin, truth tables)
+uint64_t HashNetlist(const Netlist& netlist) noexcept;
+
+// return C++ source evaluating the netlist on word_num-word nets, exporting
+// extern "C" void cim_evaluate(uint64_t* words) with BitParallelSim's layout
+std::string GenerateNativeSource(const Netlist& netlist, const uint32_t word_num, const uint32_t chunk_size = 256);
+
+// NativeSim Class
+// Multi-pattern engine running the netlist as machine code: the levelized
+// program is emitted as straight-line C++ (one bitwise statement per gate,
+// GCC vector types for 256 / 512 patterns), compiled into a shared object with
+// the local compiler and loaded with dlopen. Nets keep BitParallelSim's
+// layout, so the compiler is free to keep values in registers between gates
+// while every net stays readable afterwards. Objects are cached on disk keyed
+// on the netlist hash, pattern width, compiler and flags; a hit skips code
+// generation and compilation. Registers are not evaluated (combinational only).
+// Needs dlopen (Unix-like systems); the constructor throws elsewhere.
+class NativeSim {
+ public:
+  // constructor (patterns must be 64, 256 or 512; compiles on a cache miss)
+  explicit NativeSim(const Netlist& TargetNetlist, const uint32_t patterns = 64,
+      const NativeOptions& Options = NativeOptions());
+
+  // not copyable (owns the loaded object)
+  NativeSim(const NativeSim&) = delete;
+  NativeSim& operator=(const NativeSim&) = delete;
+
+  // destructor (unloads the object, the cached file stays)
+  ~NativeSim();
+
+  // return the number of patterns / 64-bit words per net
+  uint32_t GetPatternNum() const noexcept;
+  uint32_t GetWordNum() const noexcept;
+
+  // return the words of a net (GetWordNum() of them)
+  const uint64_t* GetWords(const uint32_t net) const;
+
+  // set all patterns of a primary input net
+  void SetInputWords(const uint32_t net, const uint64_t* const words);
+
+  // set / return one pattern of a net
+  void SetInput(const uint32_t net, const uint32_t pattern, const bool new_state);
+  bool GetState(const uint32_t net, const uint32_t pattern) const;
+
+  // evaluate all patterns once
+  void Evaluate() noexcept;
+
+  // return true if the object came from the cache
+  bool IsCacheHit() const noexcept;
+
+  // return the path of the loaded object
+  const std::string& GetObjectPath() const noexcept;
+
+  // return the seconds spent generating & compiling (0 on a hit) and loading
+  double GetCompileSeconds() const noexcept;
+  double GetLoadSeconds() const noexcept;
+
+  // return true if this platform can load generated code
+  static bool IsSupported() noexcept;
+
+ private:
+  // generated entry point
+  typedef void (*Kernel)(uint64_t* words);
+
+  // generate & compile the object into path
+  void compile(const std::string& path, const NativeOptions& options) const;
+
+  // load the object at object_path, return false if it is missing or for another netlist
+  bool load(const uint64_t netlist_hash);
+
+ private:
+  const Netlist* pNetlist;      // compiled circuit
+  uint32_t word_num;            // 64-bit words per net
+  void* handle;                 // loaded shared object
+  Kernel kernel;                // evaluation function
+  std::string object_path;      // cached shared object
+  bool cache_hit;               // object was not compiled by this instance
+  double compile_seconds;       // generation + compilation time
+  double load_seconds;          // dlopen time
+  std::vector<uint64_t> words;  // net n owns words[n * word_num .. (n + 1) * word_num)
+};
+
+}
+
+#endif  // C_NATIVE_H
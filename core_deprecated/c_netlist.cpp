@@ -0,0 +1,810 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// includes for this file
+#include "c_netlist.h"
+#include <stdexcept>
+#include <cassert>
+#include <map>        // std::map
+#include <utility>    // std::pair
+
+// using namespace for this project
+using namespace Cim;
+
+// constructor (empty netlist)
+Netlist::Netlist() :
+  // IO
+  net_num{0}, inputs(), outputs(),
+  // Program
+  levelized{false}, program(), fanin(), luts(), level_offsets(),
+  // Connectivity
+  net_driver(), fanout_offsets(), fanout(), registers(),
+  // Names
+  names(), gate_name(), out_name(), pin_name(), net_name(), monitored(), gate_by_name(), net_by_name(),
+  // Sources
+  gate_source(), gate_index(), input_source(), register_source(), register_index(),
+  // Image
+  mapped{false}, image() {
+}
+
+// constructor (read a levelized netlist from an image)
+Netlist::Netlist(NetlistImage Image) : Netlist() {
+  const size_t gate_num = Image.program.size();
+  const size_t nets = Image.net_num;
+  // only the shapes are checked here, the contents are covered by the cache file checksum
+  if (Image.net_driver.size() != nets || Image.net_name.size() != nets ||
+      Image.fanout_offsets.size() != nets + 1 || Image.fanout.size() != Image.fanin.size() ||
+      Image.pin_name.size() != Image.fanin.size() || Image.gate_name.size() != gate_num ||
+      Image.out_name.size() != gate_num || Image.monitored.size() != gate_num ||
+      Image.registers.size() > nets ||
+      (gate_num != 0 && Image.level_offsets.size() < 2) ||
+      (!Image.level_offsets.empty() && Image.level_offsets[Image.level_offsets.size() - 1] != gate_num)) {
+    throw std::invalid_argument("ERR: MALFORMED NETLIST IMAGE! \n");
+  }
+  names = SymbolTable(Image.name_pool, Image.name_offsets, Image.name_slots);
+  if (Image.gate_by_name.size() > names.GetSize() || Image.net_by_name.size() > names.GetSize()) {
+    throw std::invalid_argument("ERR: MALFORMED NETLIST IMAGE! \n");
+  }
+  this->net_num = Image.net_num;
+  this->levelized = true;
+  this->mapped = true;
+  this->image = std::move(Image);
+}
+
+// copy a borrowed image into own storage
+void Netlist::detach() {
+  if (!mapped) {
+    return;
+  }
+  inputs.assign(image.inputs.begin(), image.inputs.end());
+  outputs.assign(image.outputs.begin(), image.outputs.end());
+  program.assign(image.program.begin(), image.program.end());
+  fanin.assign(image.fanin.begin(), image.fanin.end());
+  luts.assign(image.luts.begin(), image.luts.end());
+  level_offsets.assign(image.level_offsets.begin(), image.level_offsets.end());
+  net_driver.assign(image.net_driver.begin(), image.net_driver.end());
+  fanout_offsets.assign(image.fanout_offsets.begin(), image.fanout_offsets.end());
+  fanout.assign(image.fanout.begin(), image.fanout.end());
+  registers.assign(image.registers.begin(), image.registers.end());
+  SymbolTable own_names;
+  for (uint32_t id = 0; id < names.GetSize(); id++) {
+    own_names.Intern(names.GetString(id));
+  }
+  names = std::move(own_names);
+  gate_name.assign(image.gate_name.begin(), image.gate_name.end());
+  out_name.assign(image.out_name.begin(), image.out_name.end());
+  pin_name.assign(image.pin_name.begin(), image.pin_name.end());
+  net_name.assign(image.net_name.begin(), image.net_name.end());
+  monitored.assign(image.monitored.begin(), image.monitored.end());
+  gate_by_name.assign(image.gate_by_name.begin(), image.gate_by_name.end());
+  net_by_name.assign(image.net_by_name.begin(), image.net_by_name.end());
+  gate_source.assign(program.size(), nullptr);
+  register_source.assign(registers.size(), nullptr);
+  mapped = false;
+  image = NetlistImage();
+}
+
+// constructor (compile & levelize a connected network of gates)
+Netlist::Netlist(const std::vector<Component*>& Components) : Netlist() {
+  // Methodology:
+  //  - every gate output pin drives its own net
+  //  - an input pin linked to an output pin inside the network reads that net
+  //    (the link may be stored on either side of the connection)
+  //  - an input pin linked to a pin outside the network (e.g. the parent
+  //    device's input) reads a primary input net shared by all such pins
+  //  - an unconnected input pin reads its own primary input net
+  typedef std::pair<const Component*, uint32_t> PinKey;
+
+  // 1. one output net per gate / register
+  std::unordered_map<const Component*, uint32_t> out_net;
+  for (Component* each_comp : Components) {
+    if (each_comp == nullptr) {
+      throw std::invalid_argument("ERR: NULL COMPONENT IN NETWORK! \n");
+    }
+    if (each_comp->IsDevice()) {
+      throw std::invalid_argument("ERR: DEVICES MUST BE FLATTENED BEFORE COMPILATION! \n");
+    }
+    if (out_net.count(each_comp) != 0) {
+      throw std::invalid_argument("ERR: COMPONENT APPEARS TWICE IN NETWORK! \n");
+    }
+    out_net[each_comp] = AddNet();
+  }
+
+  // 2. collect the driver of every input pin
+  std::map<PinKey, uint32_t> pin_net;
+  auto bind = [&pin_net](const PinKey& key, const uint32_t net) {
+    auto found = pin_net.find(key);
+    if (found != pin_net.end() && found->second != net) {
+      throw std::logic_error("ERR: INPUT PIN HAS MULTIPLE DRIVERS! \n");
+    }
+    pin_net[key] = net;
+  };
+  for (Component* each_comp : Components) {
+    const uint32_t out_pin = each_comp->GetIONum().first;
+    // links stored on the output side
+    for (const Pin::Link& each_link : each_comp->GetPinConnection(out_pin)) {
+      if (each_link.first == nullptr || out_net.count(each_link.first) == 0) {
+        continue;
+      }
+      if (each_link.first->GetPinDirection(each_link.second) == Pin::Dir::Input) {
+        bind(PinKey{each_link.first, each_link.second}, out_net[each_comp]);
+      }
+    }
+  }
+  std::map<PinKey, uint32_t> external_net;
+  for (Component* each_comp : Components) {
+    const uint32_t in_num = each_comp->GetIONum().first;
+    for (uint32_t i = 0; i < in_num; i++) {
+      // links stored on the input side
+      for (const Pin::Link& each_link : each_comp->GetPinConnection(i)) {
+        if (each_link.first == nullptr) {
+          continue;
+        }
+        auto driver = out_net.find(each_link.first);
+        if (driver != out_net.end()) {
+          if (each_link.first->GetPinDirection(each_link.second) == Pin::Dir::Output) {
+            bind(PinKey{each_comp, i}, driver->second);
+          }
+          continue;
+        }
+        // pin outside of the network -> shared primary input
+        const PinKey ext_key{each_link.first, each_link.second};
+        auto found = external_net.find(ext_key);
+        if (found == external_net.end()) {
+          const uint32_t net = AddNet();
+          external_net[ext_key] = net;
+          input_source[net] = each_link;
+          SetNetName(net, each_link.first->GetFullName() + "." + each_link.first->GetPinName(each_link.second));
+          bind(PinKey{each_comp, i}, net);
+        } else {
+          bind(PinKey{each_comp, i}, found->second);
+        }
+      }
+      // dangling input -> private primary input
+      if (pin_net.count(PinKey{each_comp, i}) == 0) {
+        const uint32_t net = AddNet();
+        input_source[net] = Pin::Link{each_comp, i};
+        pin_net[PinKey{each_comp, i}] = net;
+        SetNetName(net, each_comp->GetFullName() + "." + each_comp->GetPinName(i));
+      }
+    }
+  }
+
+  // 3. lower every component into a gate or a register
+  std::vector<uint32_t> readers(net_num, 0);
+  std::vector<uint32_t> gate_fanin;
+  for (Component* each_comp : Components) {
+    const uint32_t in_num = each_comp->GetIONum().first;
+    gate_fanin.clear();
+    for (uint32_t i = 0; i < in_num; i++) {
+      const uint32_t net = pin_net.at(PinKey{each_comp, i});
+      gate_fanin.push_back(net);
+      readers[net]++;
+    }
+    if (IsSequentialKind(each_comp->GetKind())) {
+      // the state at compile time is the reset state
+      AddRegister(each_comp->GetKind(), gate_fanin.at(0), out_net[each_comp], gate_fanin.at(1),
+          each_comp->GetPinState(in_num), each_comp);
+      SetNetName(out_net[each_comp], each_comp->GetFullName());
+      continue;
+    }
+    const uint32_t gate = (each_comp->GetKind() == GateKind::LUT) ?
+        AddLut(each_comp->GetTruthTable(), gate_fanin, out_net[each_comp], each_comp) :
+        AddGate(each_comp->GetKind(), gate_fanin, out_net[each_comp], each_comp);
+    // names
+    SetGateName(gate, each_comp->GetName());
+    for (uint32_t i = 0; i <= in_num; i++) {
+      SetPinName(gate, i, each_comp->GetPinName(i));
+    }
+    SetNetName(out_net[each_comp], each_comp->GetFullName());
+    SetMonitored(gate, each_comp->IsMonitored());
+  }
+
+  // 4. monitored gates and gates without readers are primary outputs
+  for (Component* each_comp : Components) {
+    const uint32_t net = out_net[each_comp];
+    if (each_comp->IsMonitored() || readers[net] == 0) {
+      AddOutput(net);
+    }
+  }
+
+  Levelize();
+}
+
+// builder: create a new net and return its index
+uint32_t Netlist::AddNet() {
+  if (levelized) {
+    throw std::logic_error("ERR: NETLIST ALREADY LEVELIZED! \n");
+  }
+  net_name.push_back(SymbolTable::kNone);
+  return net_num++;
+}
+
+// builder: add a gate driving out_net from fanin_nets
+uint32_t Netlist::AddGate(const GateKind op, const std::vector<uint32_t>& fanin_nets, const uint32_t out_net,
+    Component* source) {
+  if (op == GateKind::LUT) {
+    throw std::invalid_argument("ERR: LUT GATES NEED A TRUTH TABLE, USE AddLut()! \n");
+  }
+  if (IsSequentialKind(op)) {
+    throw std::invalid_argument("ERR: SEQUENTIAL ELEMENTS ARE REGISTERS, USE AddRegister()! \n");
+  }
+  return push_gate(op, fanin_nets, out_net, source, UINT32_MAX);
+}
+
+// builder: add a LUT gate
+uint32_t Netlist::AddLut(const uint64_t table, const std::vector<uint32_t>& fanin_nets, const uint32_t out_net,
+    Component* source) {
+  const uint32_t gate = push_gate(GateKind::LUT, fanin_nets, out_net, source, luts.size());
+  // only the first 2^n bits of the table are meaningful
+  const uint32_t size = 1u << fanin_nets.size();
+  luts.push_back((size == 64) ? table : (table & ((uint64_t{1} << size) - 1)));
+  return gate;
+}
+
+// check & append one gate
+uint32_t Netlist::push_gate(const GateKind op, const std::vector<uint32_t>& fanin_nets, const uint32_t out_net,
+    Component* source, const uint32_t lut) {
+  if (levelized) {
+    throw std::logic_error("ERR: NETLIST ALREADY LEVELIZED! \n");
+  }
+  // 1. check the number of inputs
+  CheckGateInputs(op, fanin_nets.size());
+  if (fanin_nets.size() > UINT16_MAX) {
+    throw std::invalid_argument("ERR: TOO MANY INPUTS FOR ONE GATE! \n");
+  }
+  // 2. check net indices
+  if (out_net >= net_num) {
+    throw std::out_of_range("ERR: NET DOES NOT EXIST! \n");
+  }
+  for (const uint32_t each_net : fanin_nets) {
+    if (each_net >= net_num) {
+      throw std::out_of_range("ERR: NET DOES NOT EXIST! \n");
+    }
+  }
+  const uint32_t gate = program.size();
+  program.push_back(Instruction{op, MakeVariant(op, fanin_nets.size()), static_cast<uint16_t>(fanin_nets.size()),
+      static_cast<uint32_t>(fanin.size()), out_net, lut});
+  fanin.insert(fanin.end(), fanin_nets.begin(), fanin_nets.end());
+  gate_name.push_back(SymbolTable::kNone);
+  out_name.push_back(SymbolTable::kNone);
+  pin_name.insert(pin_name.end(), fanin_nets.size(), SymbolTable::kNone);
+  monitored.push_back(false);
+  gate_source.push_back(source);
+  if (source != nullptr) {
+    gate_index[source] = gate;
+  }
+  return gate;
+}
+
+// builder: add a register storing d_net into q_net
+uint32_t Netlist::AddRegister(const GateKind kind, const uint32_t d_net, const uint32_t q_net,
+    const uint32_t ctrl_net, const bool init, Component* source) {
+  if (levelized) {
+    throw std::logic_error("ERR: NETLIST ALREADY LEVELIZED! \n");
+  }
+  if (!IsSequentialKind(kind)) {
+    throw std::invalid_argument("ERR: REGISTER MUST BE A DFF OR A LATCH! \n");
+  }
+  if (d_net >= net_num || q_net >= net_num || (ctrl_net != UINT32_MAX && ctrl_net >= net_num)) {
+    throw std::out_of_range("ERR: NET DOES NOT EXIST! \n");
+  }
+  const uint32_t reg = registers.size();
+  registers.push_back(Register{kind, static_cast<uint8_t>(init), 0, d_net, q_net, ctrl_net});
+  register_source.push_back(source);
+  if (source != nullptr) {
+    register_index[source] = reg;
+  }
+  return reg;
+}
+
+// builder: mark a net as primary output
+void Netlist::AddOutput(const uint32_t net) {
+  detach();
+  if (net >= net_num) {
+    throw std::out_of_range("ERR: NET DOES NOT EXIST! \n");
+  }
+  outputs.push_back(net);
+}
+
+// name a gate
+void Netlist::SetGateName(const uint32_t gate, const std::string_view name) {
+  detach();
+  const uint32_t id = names.Intern(name);
+  this->gate_name.at(gate) = id;
+  if (gate_by_name.size() <= id) {
+    gate_by_name.resize(names.GetSize(), UINT32_MAX);
+  }
+  gate_by_name[id] = gate;
+}
+
+// name a pin of a gate
+void Netlist::SetPinName(const uint32_t gate, const uint32_t pin_idx, const std::string_view name) {
+  detach();
+  const Instruction& ins = program.at(gate);
+  if (pin_idx < ins.fanin_count) {
+    this->pin_name[ins.fanin_begin + pin_idx] = names.Intern(name);
+  } else if (pin_idx == ins.fanin_count) {
+    this->out_name[gate] = names.Intern(name);
+  } else {
+    throw std::out_of_range("ERR: PIN DOES NOT EXIST! \n");
+  }
+}
+
+// name a net
+void Netlist::SetNetName(const uint32_t net, const std::string_view name) {
+  detach();
+  const uint32_t id = names.Intern(name);
+  this->net_name.at(net) = id;
+  if (net_by_name.size() <= id) {
+    net_by_name.resize(names.GetSize(), UINT32_MAX);
+  }
+  net_by_name[id] = net;
+}
+
+// set whether the output of a gate is monitored
+void Netlist::SetMonitored(const uint32_t gate, const bool is_monitored) {
+  detach();
+  this->monitored.at(gate) = is_monitored;
+}
+
+// sort the gates topologically, build fanout and primary inputs
+void Netlist::Levelize() {
+  if (levelized) {
+    return;
+  }
+  const uint32_t gate_num = program.size();
+
+  // 1. find the driver of each net
+  net_driver.assign(net_num, UINT32_MAX);
+  for (uint32_t g = 0; g < gate_num; g++) {
+    uint32_t& driver = net_driver[program[g].out_net];
+    if (driver != UINT32_MAX) {
+      throw std::logic_error("ERR: NET HAS MULTIPLE DRIVERS! \n");
+    }
+    driver = g;
+  }
+  std::vector<uint8_t> held(net_num, 0);
+  for (const Register& each_reg : registers) {
+    if (net_driver[each_reg.q_net] != UINT32_MAX || held[each_reg.q_net] != 0) {
+      throw std::logic_error("ERR: NET HAS MULTIPLE DRIVERS! \n");
+    }
+    held[each_reg.q_net] = 1;
+  }
+
+  // 2. temporary fanout (net -> readers) in original gate order
+  std::vector<uint32_t> offsets(net_num + 1, 0);
+  for (const uint32_t each_net : fanin) {
+    offsets[each_net + 1]++;
+  }
+  for (uint32_t n = 0; n < net_num; n++) {
+    offsets[n + 1] += offsets[n];
+  }
+  std::vector<uint32_t> readers(fanin.size());
+  {
+    std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (uint32_t g = 0; g < gate_num; g++) {
+      const Instruction& ins = program[g];
+      for (uint32_t k = 0; k < ins.fanin_count; k++) {
+        readers[cursor[fanin[ins.fanin_begin + k]]++] = g;
+      }
+    }
+  }
+
+  // 3. Kahn's algorithm, level = 1 + deepest driven input
+  std::vector<uint32_t> pending(gate_num, 0);
+  std::vector<uint32_t> level(gate_num, 0);
+  std::vector<uint32_t> queue;
+  queue.reserve(gate_num);
+  for (uint32_t g = 0; g < gate_num; g++) {
+    const Instruction& ins = program[g];
+    for (uint32_t k = 0; k < ins.fanin_count; k++) {
+      if (net_driver[fanin[ins.fanin_begin + k]] != UINT32_MAX) {
+        pending[g]++;
+      }
+    }
+    if (pending[g] == 0) {
+      queue.push_back(g);
+    }
+  }
+  uint32_t max_level = 0;
+  for (uint32_t head = 0; head < queue.size(); head++) {
+    const uint32_t g = queue[head];
+    const uint32_t net = program[g].out_net;
+    for (uint32_t r = offsets[net]; r < offsets[net + 1]; r++) {
+      const uint32_t reader = readers[r];
+      if (level[reader] < level[g] + 1) {
+        level[reader] = level[g] + 1;
+      }
+      if (--pending[reader] == 0) {
+        queue.push_back(reader);
+      }
+    }
+    if (level[g] > max_level) {
+      max_level = level[g];
+    }
+  }
+  if (queue.size() != gate_num) {
+    throw std::logic_error("ERR: COMBINATIONAL LOOP DETECTED! \n");
+  }
+
+  // 4. stable counting sort of the gates by level
+  const uint32_t level_num = (gate_num == 0) ? 0 : max_level + 1;
+  level_offsets.assign(level_num + 1, 0);
+  for (uint32_t g = 0; g < gate_num; g++) {
+    level_offsets[level[g] + 1]++;
+  }
+  for (uint32_t l = 0; l < level_num; l++) {
+    level_offsets[l + 1] += level_offsets[l];
+  }
+  std::vector<uint32_t> new_index(gate_num);
+  {
+    std::vector<uint32_t> cursor(level_offsets.begin(), level_offsets.end() - 1);
+    for (uint32_t g = 0; g < gate_num; g++) {
+      new_index[g] = cursor[level[g]]++;
+    }
+  }
+
+  // 5. rebuild program & fanin in level order
+  std::vector<Instruction> old_program;
+  std::vector<uint32_t> old_fanin;
+  std::vector<Component*> old_source;
+  std::vector<uint32_t> old_gate_name, old_out_name, old_pin_name;
+  std::vector<uint8_t> old_monitored;
+  old_program.swap(program);
+  old_fanin.swap(fanin);
+  old_source.swap(gate_source);
+  old_gate_name.swap(gate_name);
+  old_out_name.swap(out_name);
+  old_pin_name.swap(pin_name);
+  old_monitored.swap(monitored);
+  std::vector<uint32_t> order(gate_num);
+  for (uint32_t g = 0; g < gate_num; g++) {
+    order[new_index[g]] = g;
+  }
+  program.reserve(gate_num);
+  fanin.reserve(old_fanin.size());
+  gate_source.reserve(gate_num);
+  gate_name.reserve(gate_num);
+  out_name.reserve(gate_num);
+  pin_name.reserve(old_pin_name.size());
+  monitored.reserve(gate_num);
+  for (const uint32_t g : order) {
+    const Instruction& ins = old_program[g];
+    program.push_back(Instruction{ins.op, ins.variant, ins.fanin_count, static_cast<uint32_t>(fanin.size()),
+        ins.out_net, ins.lut});
+    fanin.insert(fanin.end(), old_fanin.begin() + ins.fanin_begin,
+        old_fanin.begin() + ins.fanin_begin + ins.fanin_count);
+    pin_name.insert(pin_name.end(), old_pin_name.begin() + ins.fanin_begin,
+        old_pin_name.begin() + ins.fanin_begin + ins.fanin_count);
+    gate_source.push_back(old_source[g]);
+    gate_name.push_back(old_gate_name[g]);
+    out_name.push_back(old_out_name[g]);
+    monitored.push_back(old_monitored[g]);
+  }
+  for (auto& each_entry : gate_index) {
+    each_entry.second = new_index[each_entry.second];
+  }
+  for (uint32_t& each_gate : gate_by_name) {
+    if (each_gate != UINT32_MAX) {
+      each_gate = new_index[each_gate];
+    }
+  }
+  for (uint32_t& each_driver : net_driver) {
+    if (each_driver != UINT32_MAX) {
+      each_driver = new_index[each_driver];
+    }
+  }
+
+  // 6. final fanout in level order
+  fanout_offsets.swap(offsets);
+  fanout.resize(fanin.size());
+  {
+    std::vector<uint32_t> cursor(fanout_offsets.begin(), fanout_offsets.end() - 1);
+    for (uint32_t g = 0; g < gate_num; g++) {
+      const Instruction& ins = program[g];
+      for (uint32_t k = 0; k < ins.fanin_count; k++) {
+        fanout[cursor[fanin[ins.fanin_begin + k]]++] = g;
+      }
+    }
+  }
+
+  // 7. undriven nets are primary inputs
+  inputs.clear();
+  for (uint32_t n = 0; n < net_num; n++) {
+    if (net_driver[n] == UINT32_MAX && held[n] == 0) {
+      inputs.push_back(n);
+    }
+  }
+
+  levelized = true;
+}
+
+// return true once Levelize() succeeded
+bool Netlist::IsLevelized() const noexcept {
+  return this->levelized;
+}
+
+// return number of nets
+uint32_t Netlist::GetNetNum() const noexcept {
+  return this->net_num;
+}
+
+// return number of gates
+uint32_t Netlist::GetGateNum() const noexcept {
+  return GetProgram().size();
+}
+
+// return number of levels
+uint32_t Netlist::GetLevelNum() const noexcept {
+  const ArrayView<uint32_t> offsets = GetLevelOffsets();
+  return offsets.empty() ? 0 : offsets.size() - 1;
+}
+
+// return number of registers
+uint32_t Netlist::GetRegisterNum() const noexcept {
+  return GetRegisters().size();
+}
+
+// return the levelized instruction stream
+ArrayView<Instruction> Netlist::GetProgram() const noexcept {
+  return pick(image.program, program);
+}
+
+// return the flat fanin array
+ArrayView<uint32_t> Netlist::GetFanin() const noexcept {
+  return pick(image.fanin, fanin);
+}
+
+// return the truth tables
+ArrayView<uint64_t> Netlist::GetLuts() const noexcept {
+  return pick(image.luts, luts);
+}
+
+// return level boundaries
+ArrayView<uint32_t> Netlist::GetLevelOffsets() const noexcept {
+  return pick(image.level_offsets, level_offsets);
+}
+
+// return net -> reading gates offsets
+ArrayView<uint32_t> Netlist::GetFanoutOffsets() const noexcept {
+  return pick(image.fanout_offsets, fanout_offsets);
+}
+
+// return net -> reading gates
+ArrayView<uint32_t> Netlist::GetFanout() const noexcept {
+  return pick(image.fanout, fanout);
+}
+
+// return the state elements
+ArrayView<Register> Netlist::GetRegisters() const noexcept {
+  return pick(image.registers, registers);
+}
+
+// return the gate driving a net
+uint32_t Netlist::GetNetDriver(const uint32_t net) const {
+  return pick(image.net_driver, net_driver).at(net);
+}
+
+// return primary input nets
+ArrayView<uint32_t> Netlist::GetInputs() const noexcept {
+  return pick(image.inputs, inputs);
+}
+
+// return primary output nets
+ArrayView<uint32_t> Netlist::GetOutputs() const noexcept {
+  return pick(image.outputs, outputs);
+}
+
+// return the component a gate was compiled from
+Component* Netlist::GetGateSource(const uint32_t gate) const {
+  if (mapped) {
+    GetProgram().at(gate);
+    return nullptr;
+  }
+  return this->gate_source.at(gate);
+}
+
+// return the component a register was compiled from
+Component* Netlist::GetRegisterSource(const uint32_t reg) const {
+  if (mapped) {
+    GetRegisters().at(reg);
+    return nullptr;
+  }
+  return this->register_source.at(reg);
+}
+
+// return the pin a primary input net reads from
+Pin::Link Netlist::GetInputSource(const uint32_t net) const {
+  auto found = input_source.find(net);
+  if (found == input_source.end()) {
+    return Pin::Link{nullptr, UINT32_MAX};
+  }
+  return found->second;
+}
+
+// return the gate index of a compiled component
+uint32_t Netlist::GetGateIndex(const Component* const component) const {
+  auto found = gate_index.find(component);
+  if (found == gate_index.end()) {
+    throw std::invalid_argument("ERR: COMPONENT NOT IN NETLIST! \n");
+  }
+  return found->second;
+}
+
+// return the register index of a compiled component
+uint32_t Netlist::GetRegisterIndex(const Component* const component) const {
+  auto found = register_index.find(component);
+  if (found == register_index.end()) {
+    throw std::invalid_argument("ERR: COMPONENT NOT IN NETLIST! \n");
+  }
+  return found->second;
+}
+
+// return the net attached to a pin of a compiled component
+uint32_t Netlist::GetPinNet(const Component* const component, const uint32_t pin_idx) const {
+  if (register_index.count(component) != 0) {
+    const Register& reg = GetRegisters()[GetRegisterIndex(component)];
+    const uint32_t nets[3] = {reg.d_net, reg.ctrl_net, reg.q_net};
+    if (pin_idx >= 3) {
+      throw std::out_of_range("ERR: PIN DOES NOT EXIST! \n");
+    }
+    return nets[pin_idx];
+  }
+  const Instruction& ins = GetProgram()[GetGateIndex(component)];
+  if (pin_idx < ins.fanin_count) {
+    return GetFanin()[ins.fanin_begin + pin_idx];
+  }
+  if (pin_idx == ins.fanin_count) {
+    return ins.out_net;
+  }
+  throw std::out_of_range("ERR: PIN DOES NOT EXIST! \n");
+}
+
+// return the name of a gate
+std::string_view Netlist::GetGateName(const uint32_t gate) const {
+  const uint32_t id = pick(image.gate_name, gate_name).at(gate);
+  return (id == SymbolTable::kNone) ? std::string_view() : names.GetString(id);
+}
+
+// return the name of a pin of a gate
+std::string_view Netlist::GetPinName(const uint32_t gate, const uint32_t pin_idx) const {
+  const Instruction& ins = GetProgram().at(gate);
+  uint32_t id = SymbolTable::kNone;
+  if (pin_idx < ins.fanin_count) {
+    id = pick(image.pin_name, pin_name)[ins.fanin_begin + pin_idx];
+  } else if (pin_idx == ins.fanin_count) {
+    id = pick(image.out_name, out_name)[gate];
+  } else {
+    throw std::out_of_range("ERR: PIN DOES NOT EXIST! \n");
+  }
+  return (id == SymbolTable::kNone) ? std::string_view() : names.GetString(id);
+}
+
+// return the name of a net
+std::string_view Netlist::GetNetName(const uint32_t net) const {
+  const uint32_t id = pick(image.net_name, net_name).at(net);
+  return (id == SymbolTable::kNone) ? std::string_view() : names.GetString(id);
+}
+
+// return whether the output of a gate is monitored
+bool Netlist::IsMonitored(const uint32_t gate) const {
+  return pick(image.monitored, monitored).at(gate) != 0;
+}
+
+// return the interned name table
+const SymbolTable& Netlist::GetNames() const noexcept {
+  return this->names;
+}
+
+// return the bytes held by the hot arrays
+size_t Netlist::GetByteNum() const noexcept {
+  if (mapped) {
+    return image.program.size() * sizeof(Instruction) + image.luts.size() * sizeof(uint64_t) +
+        image.registers.size() * sizeof(Register) +
+        (image.fanin.size() + image.level_offsets.size() + image.net_driver.size() + image.fanout_offsets.size() +
+         image.fanout.size() + image.inputs.size() + image.outputs.size()) * sizeof(uint32_t);
+  }
+  return program.capacity() * sizeof(Instruction) + luts.capacity() * sizeof(uint64_t) +
+      registers.capacity() * sizeof(Register) +
+      (fanin.capacity() + level_offsets.capacity() + net_driver.capacity() +
+       fanout_offsets.capacity() + fanout.capacity() + inputs.capacity() + outputs.capacity()) * sizeof(uint32_t);
+}
+
+// return the bytes held by the name arrays
+size_t Netlist::GetNameByteNum() const noexcept {
+  if (mapped) {
+    return names.GetByteNum() + image.monitored.size() + (image.gate_name.size() + image.out_name.size() +
+        image.pin_name.size() + image.net_name.size() + image.gate_by_name.size() +
+        image.net_by_name.size()) * sizeof(uint32_t);
+  }
+  return names.GetByteNum() + monitored.capacity() +
+      (gate_name.capacity() + out_name.capacity() + pin_name.capacity() + net_name.capacity()) * sizeof(uint32_t);
+}
+
+// return the gate with that name
+uint32_t Netlist::FindGate(const std::string_view name) const noexcept {
+  const uint32_t id = names.Find(name);
+  const ArrayView<uint32_t> by_name = pick(image.gate_by_name, gate_by_name);
+  return (id < by_name.size()) ? by_name[id] : UINT32_MAX;
+}
+
+// return the net with that name
+uint32_t Netlist::FindNet(const std::string_view name) const noexcept {
+  const uint32_t id = names.Find(name);
+  const ArrayView<uint32_t> by_name = pick(image.net_by_name, net_by_name);
+  return (id < by_name.size()) ? by_name[id] : UINT32_MAX;
+}
+
+// return the pin of a gate with that name
+uint32_t Netlist::FindPin(const uint32_t gate, const std::string_view name) const {
+  const Instruction& ins = GetProgram().at(gate);
+  const uint32_t id = names.Find(name);
+  if (id == SymbolTable::kNone) {
+    return UINT32_MAX;
+  }
+  const ArrayView<uint32_t> in_names = pick(image.pin_name, pin_name);
+  for (uint32_t k = 0; k < ins.fanin_count; k++) {
+    if (in_names[ins.fanin_begin + k] == id) {
+      return k;
+    }
+  }
+  return (pick(image.out_name, out_name)[gate] == id) ? ins.fanin_count : UINT32_MAX;
+}
+
+// return the arrays of a levelized netlist
+NetlistImage Netlist::GetImage() const {
+  if (!levelized) {
+    throw std::logic_error("ERR: NETLIST MUST BE LEVELIZED! \n");
+  }
+  if (mapped) {
+    return image;
+  }
+  NetlistImage result;
+  result.net_num = net_num;
+  result.inputs = inputs;
+  result.outputs = outputs;
+  result.program = program;
+  result.fanin = fanin;
+  result.luts = luts;
+  result.level_offsets = level_offsets;
+  result.net_driver = net_driver;
+  result.fanout_offsets = fanout_offsets;
+  result.fanout = fanout;
+  result.name_pool = names.GetPool();
+  result.name_offsets = names.GetOffsets();
+  result.name_slots = names.GetSlots();
+  result.gate_name = gate_name;
+  result.out_name = out_name;
+  result.pin_name = pin_name;
+  result.net_name = net_name;
+  result.monitored = monitored;
+  result.gate_by_name = gate_by_name;
+  result.net_by_name = net_by_name;
+  result.registers = registers;
+  return result;
+}
+
+// return true if the arrays are read from a borrowed image
+bool Netlist::IsMapped() const noexcept {
+  return this->mapped;
+}
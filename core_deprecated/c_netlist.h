@@ -0,0 +1,287 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// include guard for this header
+#ifndef C_NETLIST_H
+#define C_NETLIST_H
+
+// includes for this header
+#include <string>         // std::string
+#include <vector>         // std::vector
+#include <cstdint>        // standard int types
+#include <string_view>    // std::string_view
+#include <unordered_map>  // std::unordered_map
+#include <memory>         // std::shared_ptr
+
+#include "c_component.h"  // class Component
+#include "c_structs.h"    // Pin
+#include "c_symbols.h"    // class SymbolTable
+#include "c_kernels.h"    // EvaluateVariant()
+#include "c_view.h"       // class ArrayView
+
+// namespace for entire project
+namespace Cim {
+
+// one lowered gate: out_net = op(fanin[fanin_begin .. fanin_begin + fanin_count))
+struct Instruction {
+  GateKind  op;           // logic function of the gate
+  uint8_t   variant;      // evaluation kernel, see MakeVariant()
+  uint16_t  fanin_count;  // number of input nets
+  uint32_t  fanin_begin;  // offset of the first input net in the fanin array
+  uint32_t  out_net;      // net driven by the gate
+  uint32_t  lut;          // index of the truth table (LUT gates only)
+};
+
+// one state element: q_net holds the value d_net had at the last clock edge
+struct Register {
+  GateKind  kind;         // DFF or LATCH
+  uint8_t   init;         // state after reset
+  uint16_t  reserved;     // padding, always 0
+  uint32_t  d_net;        // data input
+  uint32_t  q_net;        // stored state, a source of the combinational logic
+  uint32_t  ctrl_net;     // clock (DFF) / enable (LATCH) net, UINT32_MAX if none
+};
+
+// every array of a levelized netlist, stored outside of it (e.g. in a mapped file)
+struct NetlistImage {
+  uint32_t net_num = 0;                     // number of nets
+  ArrayView<uint32_t> inputs;               // primary input nets
+  ArrayView<uint32_t> outputs;              // primary output nets
+  ArrayView<Instruction> program;           // one instruction per gate, level order
+  ArrayView<uint32_t> fanin;                // input nets of all gates
+  ArrayView<uint64_t> luts;                 // truth tables of LUT gates
+  ArrayView<uint32_t> level_offsets;        // level boundaries in program
+  ArrayView<uint32_t> net_driver;           // net -> driving gate
+  ArrayView<uint32_t> fanout_offsets;       // net -> first reader in fanout
+  ArrayView<uint32_t> fanout;               // reading gates of all nets
+  ArrayView<char> name_pool;                // SymbolTable characters
+  ArrayView<uint32_t> name_offsets;         // SymbolTable offsets
+  ArrayView<SymbolTable::Slot> name_slots;  // SymbolTable hash slots
+  ArrayView<uint32_t> gate_name;            // gate -> name ID
+  ArrayView<uint32_t> out_name;             // gate -> output pin name ID
+  ArrayView<uint32_t> pin_name;             // input pin names, aligned with fanin
+  ArrayView<uint32_t> net_name;             // net -> name ID
+  ArrayView<uint8_t> monitored;             // gate -> monitored flag
+  ArrayView<uint32_t> gate_by_name;         // name ID -> gate
+  ArrayView<uint32_t> net_by_name;          // name ID -> net
+  ArrayView<Register> registers;            // state elements
+  std::shared_ptr<const void> owner;        // keeps the memory behind the views alive
+};
+
+// Netlist Class
+// Flat, levelized form of a gate network. Nets are dense indices, every gate is
+// one Instruction, and the program is stored in level order so that a single
+// forward pass over it evaluates the whole combinational circuit. Names are
+// optional, interned, and kept in separate (cold) arrays never touched while
+// evaluating. A levelized netlist can also read all of its arrays from an
+// image in borrowed memory (see c_cache.h); renaming it or adding outputs then
+// copies the image into its own storage first. Registers cut the network into
+// combinational logic: their outputs are sources of the program just like the
+// primary inputs, their inputs are read after it (see c_cycle.h).
+class Netlist {
+ public:
+  // constructor (empty netlist, filled through the builder interface)
+  Netlist();
+
+  // constructor (compile & levelize a connected network of gates)
+  explicit Netlist(const std::vector<Component*>& Components);
+
+  // constructor (read a levelized netlist from an image, without copying it)
+  explicit Netlist(NetlistImage Image);
+
+  // destructor
+  ~Netlist() { /* DN */ }
+
+  // builder: create a new net and return its index
+  uint32_t AddNet();
+
+  // builder: add a gate driving out_net from fanin_nets, returns the gate index
+  uint32_t AddGate(const GateKind op, const std::vector<uint32_t>& fanin_nets, const uint32_t out_net,
+      Component* source = nullptr);
+
+  // builder: add a LUT gate, bit (sum of input k << k) of table is its output
+  uint32_t AddLut(const uint64_t table, const std::vector<uint32_t>& fanin_nets, const uint32_t out_net,
+      Component* source = nullptr);
+
+  // builder: add a register (DFF or LATCH) storing d_net into q_net, returns the register index
+  uint32_t AddRegister(const GateKind kind, const uint32_t d_net, const uint32_t q_net,
+      const uint32_t ctrl_net = UINT32_MAX, const bool init = false, Component* source = nullptr);
+
+  // builder: mark a net as primary output
+  void AddOutput(const uint32_t net);
+
+  // name a gate / one of its pins (input pins first, output pin last) / a net
+  void SetGateName(const uint32_t gate, const std::string_view name);
+  void SetPinName(const uint32_t gate, const uint32_t pin_idx, const std::string_view name);
+  void SetNetName(const uint32_t net, const std::string_view name);
+
+  // set whether the output of a gate is monitored
+  void SetMonitored(const uint32_t gate, const bool is_monitored);
+
+  // sort the gates topologically, build fanout and primary inputs
+  void Levelize();
+
+  // return true once Levelize() succeeded
+  bool IsLevelized() const noexcept;
+
+  // return number of nets / gates / levels / registers
+  uint32_t GetNetNum() const noexcept;
+  uint32_t GetGateNum() const noexcept;
+  uint32_t GetLevelNum() const noexcept;
+  uint32_t GetRegisterNum() const noexcept;
+
+  // return the levelized instruction stream
+  ArrayView<Instruction> GetProgram() const noexcept;
+
+  // return the flat fanin array indexed by Instruction::fanin_begin
+  ArrayView<uint32_t> GetFanin() const noexcept;
+
+  // return the truth tables indexed by Instruction::lut
+  ArrayView<uint64_t> GetLuts() const noexcept;
+
+  // return level boundaries: gates of level l are [offset[l], offset[l + 1])
+  ArrayView<uint32_t> GetLevelOffsets() const noexcept;
+
+  // return net -> reading gates in CSR form: gates of net n are fanout[offset[n] .. offset[n + 1])
+  ArrayView<uint32_t> GetFanoutOffsets() const noexcept;
+  ArrayView<uint32_t> GetFanout() const noexcept;
+
+  // return the state elements
+  ArrayView<Register> GetRegisters() const noexcept;
+
+  // return the gate driving a net (UINT32_MAX for primary inputs and register outputs)
+  uint32_t GetNetDriver(const uint32_t net) const;
+
+  // return primary input / output nets
+  ArrayView<uint32_t> GetInputs() const noexcept;
+  ArrayView<uint32_t> GetOutputs() const noexcept;
+
+  // return the component a gate was compiled from (nullptr if built by hand)
+  Component* GetGateSource(const uint32_t gate) const;
+
+  // return the component a register was compiled from (nullptr if built by hand)
+  Component* GetRegisterSource(const uint32_t reg) const;
+
+  // return the pin a primary input net reads from (nullptr link if built by hand)
+  Pin::Link GetInputSource(const uint32_t net) const;
+
+  // return the name of a gate / pin / net (empty if unnamed)
+  std::string_view GetGateName(const uint32_t gate) const;
+  std::string_view GetPinName(const uint32_t gate, const uint32_t pin_idx) const;
+  std::string_view GetNetName(const uint32_t net) const;
+
+  // return whether the output of a gate is monitored
+  bool IsMonitored(const uint32_t gate) const;
+
+  // return the gate / net with that name, UINT32_MAX if none
+  uint32_t FindGate(const std::string_view name) const noexcept;
+  uint32_t FindNet(const std::string_view name) const noexcept;
+
+  // return the pin of a gate with that name, UINT32_MAX if none
+  uint32_t FindPin(const uint32_t gate, const std::string_view name) const;
+
+  // return the interned name table
+  const SymbolTable& GetNames() const noexcept;
+
+  // return the bytes held by the netlist (hot arrays / name arrays)
+  size_t GetByteNum() const noexcept;
+  size_t GetNameByteNum() const noexcept;
+
+  // return the arrays of a levelized netlist (views into this netlist)
+  NetlistImage GetImage() const;
+
+  // return true if the arrays are read from a borrowed image
+  bool IsMapped() const noexcept;
+
+  // return the gate / register index of a compiled component
+  uint32_t GetGateIndex(const Component* const component) const;
+  uint32_t GetRegisterIndex(const Component* const component) const;
+
+  // return the net attached to a pin of a compiled component
+  uint32_t GetPinNet(const Component* const component, const uint32_t pin_idx) const;
+
+ private:
+  // check & append one gate
+  uint32_t push_gate(const GateKind op, const std::vector<uint32_t>& fanin_nets, const uint32_t out_net,
+      Component* source, const uint32_t lut);
+
+  // copy a borrowed image into own storage
+  void detach();
+
+  // return the borrowed or the owned form of an array
+  template <typename T>
+  inline ArrayView<T> pick(const ArrayView<T>& borrowed, const std::vector<T>& owned) const noexcept {
+    return mapped ? borrowed : ArrayView<T>(owned);
+  }
+
+ private:
+  // IO
+  uint32_t net_num;                       // number of nets
+  std::vector<uint32_t> inputs;           // primary input nets
+  std::vector<uint32_t> outputs;          // primary output nets
+
+  // Program
+  bool levelized;                         // program is in level order
+  std::vector<Instruction> program;       // one instruction per gate
+  std::vector<uint32_t> fanin;            // input nets of all gates
+  std::vector<uint64_t> luts;             // truth tables of LUT gates
+  std::vector<uint32_t> level_offsets;    // level boundaries in program
+
+  // Connectivity
+  std::vector<uint32_t> net_driver;       // net -> driving gate
+  std::vector<uint32_t> fanout_offsets;   // net -> first reader in fanout
+  std::vector<uint32_t> fanout;           // reading gates of all nets
+  std::vector<Register> registers;        // state elements
+
+  // Names (cold)
+  SymbolTable names;                      // interned names
+  std::vector<uint32_t> gate_name;        // gate -> name ID
+  std::vector<uint32_t> out_name;         // gate -> output pin name ID
+  std::vector<uint32_t> pin_name;         // input pin names, aligned with fanin
+  std::vector<uint32_t> net_name;         // net -> name ID
+  std::vector<uint8_t> monitored;         // gate -> monitored flag
+  std::vector<uint32_t> gate_by_name;     // name ID -> gate
+  std::vector<uint32_t> net_by_name;      // name ID -> net
+
+  // Sources
+  std::vector<Component*> gate_source;                    // gate -> component
+  std::unordered_map<const Component*, uint32_t> gate_index;  // component -> gate
+  std::unordered_map<uint32_t, Pin::Link> input_source;   // primary input net -> pin
+  std::vector<Component*> register_source;                // register -> component
+  std::unordered_map<const Component*, uint32_t> register_index;  // component -> register
+
+  // Image
+  bool mapped;                            // arrays are read from image
+  NetlistImage image;                     // borrowed arrays
+};
+
+// evaluate one instruction on a byte-per-net state array
+CIM_ALWAYS_INLINE uint8_t EvaluateInstruction(const Instruction& ins, const uint32_t* const fanin,
+    const uint64_t* const luts, const uint8_t* const nets) noexcept {
+  const uint32_t* const in = fanin + ins.fanin_begin;
+  return EvaluateVariant<uint8_t>(ins.variant, [in, nets](const uint32_t k) { return nets[in[k]]; },
+      ins.fanin_count, (ins.op == GateKind::LUT) ? luts[ins.lut] : 0);
+}
+
+}
+
+#endif  // C_NETLIST_H
@@ -0,0 +1,549 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// includes for this file
+#include "c_optimize.h"
+#include <stdexcept>
+#include <algorithm>  // std::sort, std::equal, std::binary_search
+#include <chrono>     // std::chrono
+
+// using namespace for this project
+using namespace Cim;
+
+namespace {
+
+// literal of the constants: node 0, plain or inverted
+constexpr uint32_t kFalse = 0;
+constexpr uint32_t kTrue = 1;
+
+// return the meaningful bits of an n-input truth table
+uint64_t table_mask(const uint32_t n) {
+  return (n == kMaxLutInputs) ? ~uint64_t{0} : ((uint64_t{1} << (1u << n)) - 1);
+}
+
+// table of the n-1 input function with input k fixed to v
+uint64_t cofactor(const uint64_t table, const uint32_t n, const uint32_t k, const uint32_t v) {
+  uint64_t result = 0;
+  for (uint32_t r = 0; r < (1u << (n - 1)); r++) {
+    const uint32_t low = r & ((1u << k) - 1);
+    const uint32_t row = low | (v << k) | ((r >> k) << (k + 1));
+    result |= ((table >> row) & 1) << r;
+  }
+  return result;
+}
+
+// table of the same function with input k inverted
+uint64_t flip_input(const uint64_t table, const uint32_t n, const uint32_t k) {
+  uint64_t result = 0;
+  for (uint32_t r = 0; r < (1u << n); r++) {
+    result |= ((table >> (r ^ (1u << k))) & 1) << r;
+  }
+  return result;
+}
+
+// table of the n-1 input function where input k (> j) reads the same signal as input j
+uint64_t merge_inputs(const uint64_t table, const uint32_t n, const uint32_t j, const uint32_t k) {
+  uint64_t result = 0;
+  for (uint32_t r = 0; r < (1u << (n - 1)); r++) {
+    const uint32_t low = r & ((1u << k) - 1);
+    const uint32_t row = low | (((r >> j) & 1) << k) | ((r >> k) << (k + 1));
+    result |= ((table >> row) & 1) << r;
+  }
+  return result;
+}
+
+// table of the n-input parity function
+uint64_t parity_table(const uint32_t n) {
+  uint64_t result = 0;
+  for (uint32_t r = 0; r < (1u << n); r++) {
+    uint32_t ones = 0;
+    for (uint32_t k = 0; k < n; k++) {
+      ones += (r >> k) & 1;
+    }
+    result |= static_cast<uint64_t>(ones & 1) << r;
+  }
+  return result;
+}
+
+}
+
+// constructor
+NetlistOptimizer::NetlistOptimizer(const Netlist& Source) :
+  pSource{&Source}, tied(Source.GetNetNum(), -1),
+  // Graph
+  node_op(), node_table(), node_begin(), node_fanin(), scratch(), hashed_nodes(), net_lit(), hashing{true},
+  // Output
+  node_net(), net_map(), stats() {
+  if (!Source.IsLevelized()) {
+    throw std::logic_error("ERR: NETLIST MUST BE LEVELIZED! \n");
+  }
+}
+
+// treat a primary input net as a constant
+void NetlistOptimizer::TieNet(const uint32_t net, const bool value) {
+  const ArrayView<uint32_t> inputs = pSource->GetInputs();
+  if (!std::binary_search(inputs.begin(), inputs.end(), net)) {
+    throw std::invalid_argument("ERR: NET IS NOT A PRIMARY INPUT! \n");
+  }
+  tied[net] = value ? 1 : 0;
+}
+
+// create or find a node
+uint32_t NetlistOptimizer::make_node(const Op op, const uint64_t table, const bool hashed) {
+  // inputs of AND / OR / XOR commute -> one order for all
+  if (op != Op::Lut) {
+    std::sort(scratch.begin(), scratch.end());
+  }
+  uint64_t key = (static_cast<uint64_t>(op) + 1) * 0x9E3779B97F4A7C15ull ^ table;
+  for (const uint32_t each_lit : scratch) {
+    key = (key ^ each_lit) * 0xBF58476D1CE4E5B9ull;
+    key ^= key >> 31;
+  }
+  if (hashed) {
+    const auto range = hashed_nodes.equal_range(key);
+    for (auto it = range.first; it != range.second; ++it) {
+      const uint32_t node = it->second;
+      if (node_op[node] == op && node_table[node] == table &&
+          node_begin[node + 1] - node_begin[node] == scratch.size() &&
+          std::equal(scratch.begin(), scratch.end(), node_fanin.begin() + node_begin[node])) {
+        stats.merged_num++;
+        return node * 2;
+      }
+    }
+  }
+  const uint32_t node = node_op.size();
+  node_op.push_back(op);
+  node_table.push_back(table);
+  node_fanin.insert(node_fanin.end(), scratch.begin(), scratch.end());
+  node_begin.push_back(node_fanin.size());
+  if (hashed) {
+    hashed_nodes.emplace(key, node);
+  }
+  return node * 2;
+}
+
+// reduce an AND / OR of the literals in scratch
+uint32_t NetlistOptimizer::reduce_and(bool is_or, bool invert) {
+  // the constant that decides the output on its own: 0 for AND, 1 for OR
+  const uint32_t decisive = is_or ? kTrue : kFalse;
+  uint32_t kept = 0;
+  for (const uint32_t each_lit : scratch) {
+    if ((each_lit >> 1) == 0) {
+      if (each_lit == decisive) {
+        return decisive ^ invert;
+      }
+      continue;
+    }
+    scratch[kept++] = each_lit;
+  }
+  scratch.resize(kept);
+  std::sort(scratch.begin(), scratch.end());
+  scratch.erase(std::unique(scratch.begin(), scratch.end()), scratch.end());
+  for (uint32_t i = 0; i + 1 < scratch.size(); i++) {
+    // x and ~x are neighbours after sorting
+    if ((scratch[i] ^ 1) == scratch[i + 1]) {
+      return decisive ^ invert;
+    }
+  }
+  if (scratch.empty()) {
+    return (decisive ^ 1) ^ invert;
+  }
+  if (scratch.size() == 1) {
+    return scratch[0] ^ invert;
+  }
+  // De Morgan: all inputs inverted -> the dual gate of the plain inputs
+  bool all_inverted = true;
+  for (const uint32_t each_lit : scratch) {
+    all_inverted &= (each_lit & 1) != 0;
+  }
+  if (all_inverted) {
+    for (uint32_t& each_lit : scratch) {
+      each_lit ^= 1;
+    }
+    is_or = !is_or;
+    invert = !invert;
+  }
+  return make_node(is_or ? Op::Or : Op::And, 0, hashing) ^ invert;
+}
+
+// reduce an XOR of the literals in scratch
+uint32_t NetlistOptimizer::reduce_xor(bool invert) {
+  // inversions & constants move to the output
+  uint32_t kept = 0;
+  for (const uint32_t each_lit : scratch) {
+    invert ^= (each_lit & 1) != 0;
+    if ((each_lit >> 1) != 0) {
+      scratch[kept++] = each_lit & ~1u;
+    }
+  }
+  scratch.resize(kept);
+  std::sort(scratch.begin(), scratch.end());
+  // x ^ x = 0
+  kept = 0;
+  for (uint32_t i = 0; i < scratch.size(); i++) {
+    if (i + 1 < scratch.size() && scratch[i] == scratch[i + 1]) {
+      i++;
+      continue;
+    }
+    scratch[kept++] = scratch[i];
+  }
+  scratch.resize(kept);
+  if (scratch.empty()) {
+    return kFalse ^ invert;
+  }
+  if (scratch.size() == 1) {
+    return scratch[0] ^ invert;
+  }
+  return make_node(Op::Xor, 0, hashing) ^ invert;
+}
+
+// reduce a LUT reading the literals in scratch
+uint32_t NetlistOptimizer::reduce_lut(uint64_t table) {
+  uint32_t n = scratch.size();
+  table &= table_mask(n);
+  // 1. constants, inversions & repeated inputs fold into the table
+  for (uint32_t k = 0; k < n; ) {
+    const uint32_t lit = scratch[k];
+    if ((lit >> 1) == 0) {
+      table = cofactor(table, n, k, lit & 1);
+      scratch.erase(scratch.begin() + k);
+      n--;
+      continue;
+    }
+    if ((lit & 1) != 0) {
+      table = flip_input(table, n, k);
+      scratch[k] ^= 1;
+    }
+    uint32_t same = k;
+    for (uint32_t j = 0; j < k; j++) {
+      if (scratch[j] == scratch[k]) {
+        same = j;
+        break;
+      }
+    }
+    if (same != k) {
+      table = merge_inputs(table, n, same, k);
+      scratch.erase(scratch.begin() + k);
+      n--;
+      continue;
+    }
+    k++;
+  }
+  // 2. inputs the table ignores
+  for (uint32_t k = 0; k < n; ) {
+    const uint64_t low = cofactor(table, n, k, 0);
+    if (low == cofactor(table, n, k, 1)) {
+      table = low;
+      scratch.erase(scratch.begin() + k);
+      n--;
+      continue;
+    }
+    k++;
+  }
+  if (n == 0) {
+    return (table & 1) ? kTrue : kFalse;
+  }
+  if (n == 1) {
+    return scratch[0] ^ ((table & 1) ? 1u : 0u);
+  }
+  // 3. output inversion moves to the literal, AND / OR / XOR tables become those gates
+  const bool invert = (table & 1) != 0;
+  if (invert) {
+    table = ~table & table_mask(n);
+  }
+  const uint64_t top = uint64_t{1} << ((1u << n) - 1);
+  if (table == top) {
+    return make_node(Op::And, 0, hashing) ^ invert;
+  }
+  if (table == (table_mask(n) & ~uint64_t{1})) {
+    return make_node(Op::Or, 0, hashing) ^ invert;
+  }
+  if (table == parity_table(n)) {
+    return make_node(Op::Xor, 0, hashing) ^ invert;
+  }
+  return make_node(Op::Lut, table, hashing) ^ invert;
+}
+
+// return the net of a literal, emitting constants on demand
+uint32_t NetlistOptimizer::net_of(Netlist& target, const uint32_t lit) {
+  if (node_net[lit] == UINT32_MAX) {
+    if ((lit >> 1) != 0) {
+      throw std::logic_error("ERR: SIGNAL WAS NOT EMITTED! \n");
+    }
+    node_net[lit] = target.AddNet();
+    net_driver.resize(node_net[lit] + 1, UINT32_MAX);
+    net_driver[node_net[lit]] = target.AddLut(lit, {}, node_net[lit]);
+  }
+  return node_net[lit];
+}
+
+// build the optimized netlist into Target
+void NetlistOptimizer::Optimize(Netlist& Target, const OptimizeOptions& options) {
+  if (Target.GetNetNum() != 0 || Target.GetGateNum() != 0) {
+    throw std::invalid_argument("ERR: TARGET NETLIST MUST BE EMPTY! \n");
+  }
+  const auto start = std::chrono::steady_clock::now();
+  const Netlist& source = *pSource;
+  const ArrayView<Instruction> program = source.GetProgram();
+  const ArrayView<uint32_t> fanin = source.GetFanin();
+  const ArrayView<Register> registers = source.GetRegisters();
+  const ArrayView<uint32_t> inputs = source.GetInputs();
+  stats = OptimizeStats();
+  stats.gate_num_before = program.size();
+  stats.register_num_before = registers.size();
+  hashing = options.hash_structure;
+
+  // 1. constant node 0, then one leaf per primary input & register output
+  node_op.assign(1, Op::Const);
+  node_table.assign(1, 0);
+  node_begin.assign(2, 0);
+  node_fanin.clear();
+  hashed_nodes.clear();
+  net_lit.assign(source.GetNetNum(), UINT32_MAX);
+  for (const uint32_t each_net : inputs) {
+    int8_t value = tied[each_net];
+    if (value < 0 && options.tie_dangling_inputs) {
+      const Pin::Link pin = source.GetInputSource(each_net);
+      if (pin.first != nullptr && !pin.first->IsPinConnected(pin.second)) {
+        value = 0;
+      }
+    }
+    scratch.clear();
+    net_lit[each_net] = (value < 0) ? make_node(Op::Leaf, 0, false) : (value ? kTrue : kFalse);
+  }
+  std::vector<uint32_t> leaf_reg;
+  for (uint32_t r = 0; r < registers.size(); r++) {
+    scratch.clear();
+    net_lit[registers[r].q_net] = make_node(Op::Leaf, 0, false);
+    leaf_reg.resize(node_op.size(), UINT32_MAX);
+    leaf_reg[net_lit[registers[r].q_net] >> 1] = r;
+  }
+
+  // 2. every gate in level order becomes a literal
+  for (const Instruction& ins : program) {
+    scratch.clear();
+    for (uint32_t k = 0; k < ins.fanin_count; k++) {
+      scratch.push_back(net_lit[fanin[ins.fanin_begin + k]]);
+    }
+    const uint32_t node_num = node_op.size();
+    const uint32_t merged_num = stats.merged_num;
+    uint32_t lit = kFalse;
+    switch (ins.op) {
+      case GateKind::NOT:  lit = scratch[0] ^ 1; break;
+      case GateKind::AND:  lit = reduce_and(false, false); break;
+      case GateKind::NAND: lit = reduce_and(false, true); break;
+      case GateKind::OR:   lit = reduce_and(true, false); break;
+      case GateKind::NOR:  lit = reduce_and(true, true); break;
+      case GateKind::XOR:  lit = reduce_xor(false); break;
+      case GateKind::XNOR: lit = reduce_xor(true); break;
+      case GateKind::LUT:  lit = reduce_lut(source.GetLuts()[ins.lut]); break;
+      default: throw std::logic_error("ERR: UNKNOWN GATE KIND! \n");
+    }
+    if ((lit >> 1) == 0) {
+      stats.constant_num++;
+    } else if (node_op.size() == node_num && stats.merged_num == merged_num) {
+      stats.alias_num++;
+    }
+    net_lit[ins.out_net] = lit;
+  }
+  leaf_reg.resize(node_op.size(), UINT32_MAX);
+
+  // 3. liveness & the polarities needed (bit 0 plain, bit 1 inverted)
+  const uint32_t node_num = node_op.size();
+  std::vector<uint8_t> live(node_num, 0), need(node_num, 0);
+  std::vector<uint32_t> stack;
+  auto use = [&](const uint32_t lit) {
+    need[lit >> 1] |= 1u << (lit & 1);
+    if (live[lit >> 1] == 0) {
+      stack.push_back(lit >> 1);
+    }
+  };
+  for (const uint32_t each_net : source.GetOutputs()) {
+    use(net_lit[each_net]);
+  }
+  for (uint32_t g = 0; g < program.size(); g++) {
+    if (source.IsMonitored(g)) {
+      use(net_lit[program[g].out_net]);
+    }
+  }
+  if (!options.remove_dead) {
+    for (uint32_t n = 1; n < node_num; n++) {
+      stack.push_back(n);
+    }
+  }
+  while (!stack.empty()) {
+    const uint32_t node = stack.back();
+    stack.pop_back();
+    if (live[node] != 0) {
+      continue;
+    }
+    live[node] = 1;
+    if (leaf_reg[node] != UINT32_MAX) {
+      const Register& reg = registers[leaf_reg[node]];
+      use(net_lit[reg.d_net]);
+      if (reg.ctrl_net != UINT32_MAX) {
+        use(net_lit[reg.ctrl_net]);
+      }
+    }
+    for (uint32_t i = node_begin[node]; i < node_begin[node + 1]; i++) {
+      use(node_fanin[i]);
+    }
+  }
+  for (uint32_t n = 1; n < node_num; n++) {
+    if (node_op[n] != Op::Leaf && live[n] == 0) {
+      stats.dead_num++;
+    }
+  }
+
+  // 4. emit live signals in the polarity their readers need, primary inputs first
+  node_net.assign(2 * static_cast<size_t>(node_num), UINT32_MAX);
+  net_driver.clear();
+  // tied inputs keep a net nothing reads, so the input order stays that of the source
+  std::vector<uint32_t> input_net;
+  for (const uint32_t each_net : inputs) {
+    const uint32_t lit = net_lit[each_net];
+    input_net.push_back(Target.AddNet());
+    if ((lit >> 1) != 0) {
+      node_net[lit] = input_net.back();
+    }
+  }
+  std::vector<uint32_t> gate_fanin;
+  for (uint32_t n = 1; n < node_num; n++) {
+    if (live[n] == 0) {
+      continue;
+    }
+    // the polarity with readers comes first, the other one through an inverter
+    const bool is_leaf = (node_op[n] == Op::Leaf);
+    const uint32_t first = (is_leaf || (need[n] & 1) != 0 || need[n] == 0) ? 0 : 1;
+    uint32_t& net = node_net[2 * n + first];
+    if (is_leaf) {
+      // primary inputs already have their net, register outputs get theirs here
+      if (net == UINT32_MAX) {
+        net = Target.AddNet();
+      }
+    } else {
+      gate_fanin.clear();
+      for (uint32_t i = node_begin[n]; i < node_begin[n + 1]; i++) {
+        gate_fanin.push_back(net_of(Target, node_fanin[i]));
+      }
+      net = Target.AddNet();
+      uint32_t gate = 0;
+      switch (node_op[n]) {
+        case Op::And: gate = Target.AddGate(first ? GateKind::NAND : GateKind::AND, gate_fanin, net); break;
+        case Op::Or:  gate = Target.AddGate(first ? GateKind::NOR : GateKind::OR, gate_fanin, net); break;
+        case Op::Xor: gate = Target.AddGate(first ? GateKind::XNOR : GateKind::XOR, gate_fanin, net); break;
+        default:
+          gate = Target.AddLut(first ? (~node_table[n] & table_mask(gate_fanin.size())) : node_table[n],
+              gate_fanin, net);
+          break;
+      }
+      net_driver.resize(net + 1, UINT32_MAX);
+      net_driver[net] = gate;
+    }
+    if ((need[n] & (2 >> first)) != 0) {
+      const uint32_t other = Target.AddNet();
+      const uint32_t gate = Target.AddGate(GateKind::NOT, {net}, other);
+      node_net[2 * n + (first ^ 1)] = other;
+      net_driver.resize(other + 1, UINT32_MAX);
+      net_driver[other] = gate;
+      stats.inverter_num++;
+    }
+  }
+  for (uint32_t r = 0; r < registers.size(); r++) {
+    const Register& reg = registers[r];
+    const uint32_t q = net_lit[reg.q_net];
+    if (live[q >> 1] == 0) {
+      continue;
+    }
+    const uint32_t ctrl = (reg.ctrl_net == UINT32_MAX) ? UINT32_MAX : net_of(Target, net_lit[reg.ctrl_net]);
+    Target.AddRegister(reg.kind, net_of(Target, net_lit[reg.d_net]), node_net[q], ctrl, reg.init != 0);
+  }
+  for (const uint32_t each_net : source.GetOutputs()) {
+    Target.AddOutput(net_of(Target, net_lit[each_net]));
+  }
+
+  // 5. carry names over through the literal replacing each net, the lowest source index wins
+  net_map.assign(source.GetNetNum(), UINT32_MAX);
+  for (uint32_t n = 0; n < source.GetNetNum(); n++) {
+    if (net_lit[n] != UINT32_MAX) {
+      net_map[n] = node_net[net_lit[n]];
+    }
+  }
+  for (uint32_t i = 0; i < inputs.size(); i++) {
+    net_map[inputs[i]] = input_net[i];
+  }
+  for (uint32_t n = source.GetNetNum(); n-- > 0; ) {
+    const std::string_view name = source.GetNetName(n);
+    if (!name.empty() && net_map[n] != UINT32_MAX) {
+      Target.SetNetName(net_map[n], name);
+    }
+  }
+  for (uint32_t g = program.size(); g-- > 0; ) {
+    // monitored gates folded into a constant get the constant's gate
+    const uint32_t lit = net_lit[program[g].out_net];
+    const uint32_t net = (source.IsMonitored(g) && (lit >> 1) == 0) ? net_of(Target, lit) : node_net[lit];
+    if (net == UINT32_MAX) {
+      continue;
+    }
+    uint32_t driver = (net < net_driver.size()) ? net_driver[net] : UINT32_MAX;
+    if (driver == UINT32_MAX) {
+      if (!source.IsMonitored(g)) {
+        continue;
+      }
+      // monitored aliases of a primary input or register output get a buffer
+      driver = Target.AddLut(0x2, {net}, Target.AddNet());
+    }
+    const std::string_view name = source.GetGateName(g);
+    if (!name.empty()) {
+      Target.SetGateName(driver, name);
+    }
+    if (source.IsMonitored(g)) {
+      Target.SetMonitored(driver, true);
+    }
+  }
+
+  Target.Levelize();
+  stats.gate_num_after = Target.GetGateNum();
+  stats.register_num_after = Target.GetRegisterNum();
+  stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// return the net of the optimized netlist carrying a source net
+uint32_t NetlistOptimizer::MapNet(const uint32_t net) const {
+  return this->net_map.at(net);
+}
+
+// return the statistics of the last run
+const OptimizeStats& NetlistOptimizer::GetStats() const noexcept {
+  return this->stats;
+}
+
+// return an optimized copy of a levelized netlist
+Netlist Cim::OptimizeNetlist(const Netlist& Source, const OptimizeOptions& options, OptimizeStats* stats) {
+  Netlist target;
+  NetlistOptimizer optimizer(Source);
+  optimizer.Optimize(target, options);
+  if (stats != nullptr) {
+    *stats = optimizer.GetStats();
+  }
+  return target;
+}
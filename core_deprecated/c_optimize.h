@@ -0,0 +1,140 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// include guard for this header
+#ifndef C_OPTIMIZE_H
+#define C_OPTIMIZE_H
+
+// includes for this header
+#include <vector>         // std::vector
+#include <cstdint>        // standard int types
+#include <unordered_map>  // std::unordered_multimap
+#include "c_netlist.h"    // class Netlist
+
+// namespace for entire project
+namespace Cim {
+
+// passes of the optimizer that can be turned off
+struct OptimizeOptions {
+  bool tie_dangling_inputs = false;   // unconnected component input pins read 0 (see Gate::Initialize)
+  bool hash_structure = true;         // merge gates with the same function of the same signals
+  bool remove_dead = true;            // drop logic with no path to an output or a live register
+};
+
+// what the optimizer did
+struct OptimizeStats {
+  uint32_t gate_num_before = 0;       // gates of the source netlist
+  uint32_t gate_num_after = 0;        // gates of the optimized netlist
+  uint32_t register_num_before = 0;   // registers of the source netlist
+  uint32_t register_num_after = 0;    // registers of the optimized netlist
+  uint32_t constant_num = 0;          // gates folded into a constant
+  uint32_t alias_num = 0;             // gates reduced to an existing signal (buffers, double inversions, x & x)
+  uint32_t merged_num = 0;            // gates identical to an earlier gate
+  uint32_t dead_num = 0;              // remaining gates without a path to an output
+  uint32_t inverter_num = 0;          // NOT gates added for inverted signals that had no driver
+  double seconds = 0;                 // wall time
+};
+
+// NetlistOptimizer Class
+// Rewrites a levelized netlist into an equivalent, smaller one before it is
+// simulated. Gates are visited in level order and each one is reduced to a
+// literal, a signal with an inversion flag: NOT gates and double inversions
+// cost nothing, constants (tied nets, dangling inputs, 0-input LUTs) fold
+// forward, duplicate and complementary inputs are resolved, LUT gates drop
+// the inputs their table ignores, and every remaining gate is looked up in a
+// structural hash table (commutative inputs sorted, AIG-style) so identical
+// logic exists once. Liveness is then traced back from the primary outputs
+// and monitored gates through the registers, and only live signals are
+// emitted, each in the polarity its readers need (NAND instead of AND + NOT).
+// Primary inputs (tied ones included) and outputs keep their order and names,
+// a monitored gate reduced to an input or register output keeps a buffer LUT;
+// the result has no component sources.
+class NetlistOptimizer {
+ public:
+  // constructor (source must be levelized and outlive the optimizer)
+  explicit NetlistOptimizer(const Netlist& Source);
+
+  // destructor
+  ~NetlistOptimizer() { /* DN */ }
+
+  // treat a primary input net as a constant (it stays an input of the result, read by nothing)
+  void TieNet(const uint32_t net, const bool value);
+
+  // build the optimized netlist into Target, which must be empty
+  void Optimize(Netlist& Target, const OptimizeOptions& options = OptimizeOptions());
+
+  // return the net of the optimized netlist carrying a source net (UINT32_MAX if gone)
+  uint32_t MapNet(const uint32_t net) const;
+
+  // return the statistics of the last run
+  const OptimizeStats& GetStats() const noexcept;
+
+ private:
+  // node kinds of the intermediate graph
+  enum class Op : uint8_t {
+    Const,    // node 0 only, value 0
+    Leaf,     // primary input or register output
+    And,
+    Or,
+    Xor,
+    Lut
+  };
+
+  // create or find a node, return its positive literal
+  uint32_t make_node(const Op op, const uint64_t table, const bool hashed);
+
+  // reduce one gate of the source to a literal
+  uint32_t reduce_and(bool is_or, bool invert);
+  uint32_t reduce_xor(bool invert);
+  uint32_t reduce_lut(uint64_t table);
+
+  // return the net of a literal, emitting constants on demand
+  uint32_t net_of(Netlist& target, const uint32_t lit);
+
+ private:
+  const Netlist* pSource;                   // netlist being optimized
+  std::vector<int8_t> tied;                 // source net -> tied value, -1 if not tied
+
+  // Graph
+  std::vector<Op> node_op;                  // node -> kind
+  std::vector<uint64_t> node_table;         // node -> truth table (LUT only)
+  std::vector<uint32_t> node_begin;         // node -> first fanin literal, fanin of n is [begin[n], begin[n + 1])
+  std::vector<uint32_t> node_fanin;         // fanin literals of all nodes
+  std::vector<uint32_t> scratch;            // fanin literals of the node being built
+  std::unordered_multimap<uint64_t, uint32_t> hashed_nodes;  // structural hash -> node
+  std::vector<uint32_t> net_lit;            // source net -> literal
+  bool hashing;                             // structural hashing enabled
+
+  // Output
+  std::vector<uint32_t> node_net;           // literal -> net in the target, UINT32_MAX if none
+  std::vector<uint32_t> net_map;            // source net -> target net
+  std::vector<uint32_t> net_driver;         // target net -> its gate, UINT32_MAX if none
+  OptimizeStats stats;                      // statistics of the last run
+};
+
+// return an optimized copy of a levelized netlist
+Netlist OptimizeNetlist(const Netlist& Source, const OptimizeOptions& options = OptimizeOptions(),
+    OptimizeStats* stats = nullptr);
+
+}
+
+#endif  // C_OPTIMIZE_H
@@ -0,0 +1,181 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// includes for this file
+#include "c_parallel.h"
+#include <stdexcept>
+#include <cassert>
+
+// using namespace for this project
+using namespace Cim;
+
+// constructor
+ParallelSim::ParallelSim(const Netlist& TargetNetlist, const uint32_t thread_num, const uint32_t grain) :
+  pNetlist{&TargetNetlist}, pool(thread_num), barrier(pool.GetThreadNum()), ranges(pool.GetThreadNum()),
+  segments(), chunk_offsets(), program(), fanin(), local(), storage(), states{nullptr} {
+  if (!TargetNetlist.IsLevelized()) {
+    throw std::logic_error("ERR: NETLIST MUST BE LEVELIZED! \n");
+  }
+  // chunks cover whole cache lines of outputs
+  const uint32_t chunk_size = (grain < kCacheLine) ? kCacheLine : (grain + kCacheLine - 1) / kCacheLine * kCacheLine;
+  const ArrayView<uint32_t> levels = TargetNetlist.GetLevelOffsets();
+
+  // 1. cut levels into chunks, merge narrow ones into serial segments
+  chunk_offsets.push_back(0);
+  for (uint32_t l = 0; l + 1 < levels.size(); l++) {
+    const uint32_t lo = levels[l], hi = levels[l + 1];
+    const bool wide = pool.GetThreadNum() > 1 && hi - lo >= 2 * chunk_size;
+    if (!wide && !segments.empty() && segments.back().serial) {
+      // extend the previous serial segment
+      chunk_offsets.back() = hi;
+      continue;
+    }
+    Segment segment{!wide, static_cast<uint32_t>(chunk_offsets.size() - 1), 0};
+    for (uint32_t g = lo + (wide ? chunk_size : hi - lo); g < hi; g += chunk_size) {
+      chunk_offsets.push_back(g);
+    }
+    chunk_offsets.push_back(hi);
+    segment.chunk_end = chunk_offsets.size() - 1;
+    segments.push_back(segment);
+  }
+
+  // 2. renumber nets: sources first (inputs, register outputs), then every chunk starting on a fresh line
+  const uint32_t net_num = TargetNetlist.GetNetNum();
+  local.assign(net_num, UINT32_MAX);
+  uint32_t next = 0;
+  for (const uint32_t each_net : TargetNetlist.GetInputs()) {
+    local[each_net] = next++;
+  }
+  for (const Register& each_reg : TargetNetlist.GetRegisters()) {
+    local[each_reg.q_net] = next++;
+  }
+  const ArrayView<Instruction> source = TargetNetlist.GetProgram();
+  for (uint32_t c = 0; c + 1 < chunk_offsets.size(); c++) {
+    next = (next + kCacheLine - 1) / kCacheLine * kCacheLine;
+    for (uint32_t g = chunk_offsets[c]; g < chunk_offsets[c + 1]; g++) {
+      local[source[g].out_net] = next++;
+    }
+  }
+
+  // 3. copy the program in local numbering
+  program.assign(source.begin(), source.end());
+  for (Instruction& ins : program) {
+    ins.out_net = local[ins.out_net];
+  }
+  fanin.reserve(TargetNetlist.GetFanin().size());
+  for (const uint32_t each_net : TargetNetlist.GetFanin()) {
+    fanin.push_back(local[each_net]);
+  }
+
+  // 4. cache-line aligned state array
+  storage.assign(next + 2 * kCacheLine, 0);
+  const uintptr_t base = reinterpret_cast<uintptr_t>(storage.data());
+  states = storage.data() + ((kCacheLine - base % kCacheLine) % kCacheLine);
+}
+
+// evaluate the gates of one chunk
+void ParallelSim::run_chunk(const uint32_t chunk) noexcept {
+  const uint64_t* const luts = pNetlist->GetLuts().data();
+  const Instruction* ins = program.data() + chunk_offsets[chunk];
+  const Instruction* const end = program.data() + chunk_offsets[chunk + 1];
+  for (; ins != end; ++ins) {
+    states[ins->out_net] = EvaluateInstruction(*ins, fanin.data(), luts, states);
+  }
+}
+
+// evaluate the whole circuit once
+void ParallelSim::Evaluate() {
+  const uint32_t thread_num = pool.GetThreadNum();
+  if (thread_num == 1) {
+    for (uint32_t c = 0; c + 1 < chunk_offsets.size(); c++) {
+      run_chunk(c);
+    }
+    return;
+  }
+  pool.Run([&](const uint32_t self) {
+    for (const Segment& each_segment : segments) {
+      if (each_segment.serial) {
+        if (self == 0) {
+          for (uint32_t c = each_segment.chunk_begin; c < each_segment.chunk_end; c++) {
+            run_chunk(c);
+          }
+        }
+        barrier.Wait();
+        continue;
+      }
+      // own share first, then steal from the others
+      const uint64_t chunk_num = each_segment.chunk_end - each_segment.chunk_begin;
+      ranges[self].Reset(each_segment.chunk_begin + chunk_num * self / thread_num,
+          each_segment.chunk_begin + chunk_num * (self + 1) / thread_num);
+      uint32_t chunk = 0;
+      for (uint32_t victim = self, tried = 0; tried < thread_num; ) {
+        const bool found = (victim == self) ? ranges[victim].PopFront(chunk) : ranges[victim].PopBack(chunk);
+        if (found) {
+          run_chunk(chunk);
+        } else {
+          victim = (victim + 1) % thread_num;
+          tried++;
+        }
+      }
+      barrier.Wait();
+    }
+  });
+}
+
+// set a primary input net (or the output of a register)
+void ParallelSim::SetInput(const uint32_t net, const bool new_state) {
+  if (pNetlist->GetNetDriver(net) != UINT32_MAX) {
+    throw std::invalid_argument("ERR: NET IS NOT A PRIMARY INPUT! \n");
+  }
+  states[local[net]] = new_state;
+}
+
+// set all primary inputs
+void ParallelSim::SetInputs(const std::vector<bool>& input_vector) {
+  const ArrayView<uint32_t> inputs = pNetlist->GetInputs();
+  if (input_vector.size() != inputs.size()) {
+    throw std::invalid_argument("ERR: INPUT VECTOR SIZE MISMATCH! \n");
+  }
+  for (uint32_t i = 0; i < inputs.size(); i++) {
+    states[local[inputs[i]]] = input_vector[i];
+  }
+}
+
+// return the state of a net
+bool ParallelSim::GetState(const uint32_t net) const {
+  return states[local.at(net)] != 0;
+}
+
+// return the number of threads
+uint32_t ParallelSim::GetThreadNum() const noexcept {
+  return this->pool.GetThreadNum();
+}
+
+// return the number of chunks
+uint32_t ParallelSim::GetChunkNum() const noexcept {
+  return this->chunk_offsets.size() - 1;
+}
+
+// return the number of barriers per evaluation
+uint32_t ParallelSim::GetBarrierNum() const noexcept {
+  return (pool.GetThreadNum() == 1) ? 0 : this->segments.size();
+}
@@ -0,0 +1,102 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// include guard for this header
+#ifndef C_PARALLEL_H
+#define C_PARALLEL_H
+
+// includes for this header
+#include <vector>         // std::vector
+#include <cstdint>        // standard int types
+#include "c_netlist.h"    // class Netlist
+#include "c_threads.h"    // class ThreadPool
+
+// namespace for entire project
+namespace Cim {
+
+// ParallelSim Class
+// Multi-threaded levelized engine. Gates of one level are independent, so each
+// level is cut into chunks that the threads share with work stealing, with one
+// barrier per level. Consecutive narrow levels are merged into a serial segment
+// run by one thread behind a single barrier. Nets are renumbered so that the
+// outputs of every chunk fill cache lines of their own: two threads never write
+// into the same line of the state array. Register outputs are sources like the
+// primary inputs, set through SetInput() (combinational evaluation only).
+class ParallelSim {
+ public:
+  // constructor (thread_num 0 -> hardware threads, grain = gates per chunk)
+  explicit ParallelSim(const Netlist& TargetNetlist, const uint32_t thread_num = 0, const uint32_t grain = 1024);
+
+  // destructor
+  ~ParallelSim() { /* DN */ }
+
+  // set a primary input net (or the output of a register, which is a source like an input)
+  void SetInput(const uint32_t net, const bool new_state);
+
+  // set all primary inputs, in Netlist::GetInputs() order
+  void SetInputs(const std::vector<bool>& input_vector);
+
+  // return the state of a net
+  bool GetState(const uint32_t net) const;
+
+  // evaluate the whole circuit once
+  void Evaluate();
+
+  // return the number of threads / chunks / barriers per evaluation
+  uint32_t GetThreadNum() const noexcept;
+  uint32_t GetChunkNum() const noexcept;
+  uint32_t GetBarrierNum() const noexcept;
+
+ private:
+  // levels (or merged narrow levels) separated by barriers
+  struct Segment {
+    bool      serial;       // run by thread 0 only
+    uint32_t  chunk_begin;  // first chunk
+    uint32_t  chunk_end;    // one past the last chunk
+  };
+
+  // evaluate the gates of one chunk
+  void run_chunk(const uint32_t chunk) noexcept;
+
+ private:
+  const Netlist* pNetlist;                // compiled circuit
+  ThreadPool pool;                        // worker threads
+  SpinBarrier barrier;                    // level barrier
+  std::vector<StealRange> ranges;         // chunks left per thread in the current level
+
+  // Schedule
+  std::vector<Segment> segments;          // in evaluation order
+  std::vector<uint32_t> chunk_offsets;    // chunk -> first gate in program
+
+  // Renumbered program
+  std::vector<Instruction> program;       // out_net in local numbering
+  std::vector<uint32_t> fanin;            // local numbering
+  std::vector<uint32_t> local;            // netlist net -> local net
+
+  // State
+  std::vector<uint8_t> storage;           // backing store of states
+  uint8_t* states;                        // cache-line aligned into storage
+};
+
+}
+
+#endif  // C_PARALLEL_H
@@ -0,0 +1,251 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// includes for this file
+#include "c_profile.h"
+#include <algorithm>      // std::partial_sort, std::sort
+#include <map>            // std::map
+#include <numeric>        // std::accumulate
+#include <string_view>    // std::string_view
+#include <stdexcept>
+
+// using namespace for this project
+using namespace Cim;
+
+// helpers private to this file
+namespace {
+
+// separator between hierarchy levels in Component::GetFullName()
+constexpr std::string_view kHierSep = "::";
+
+// write a string as a JSON string literal
+void write_json_string(std::ostream& out, const std::string_view text) {
+  static const char* const hex = "0123456789abcdef";
+  out << '"';
+  for (const char c : text) {
+    if (c == '"' || c == '\\') {
+      out << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      out << "\\u00" << hex[(c >> 4) & 0xF] << hex[c & 0xF];
+    } else {
+      out << c;
+    }
+  }
+  out << '"';
+}
+
+}
+
+// constructor
+Profiler::Profiler(const Netlist& TargetNetlist) :
+  pNetlist{&TargetNetlist},
+  // Per gate
+  evaluations(TargetNetlist.GetGateNum(), 0), toggles(TargetNetlist.GetGateNum(), 0),
+  // Per level
+  level_evaluations(TargetNetlist.GetLevelNum(), 0), level_nanoseconds(TargetNetlist.GetLevelNum(), 0),
+  // Per run
+  vector_num{0}, total_nanoseconds{0} {
+  if (!TargetNetlist.IsLevelized()) {
+    throw std::logic_error("ERR: NETLIST MUST BE LEVELIZED! \n");
+  }
+}
+
+// clear every counter
+void Profiler::Reset() noexcept {
+  std::fill(evaluations.begin(), evaluations.end(), 0);
+  std::fill(toggles.begin(), toggles.end(), 0);
+  std::fill(level_evaluations.begin(), level_evaluations.end(), 0);
+  std::fill(level_nanoseconds.begin(), level_nanoseconds.end(), 0);
+  vector_num = 0;
+  total_nanoseconds = 0;
+}
+
+// return the profiled netlist
+const Netlist& Profiler::GetNetlist() const noexcept {
+  return *this->pNetlist;
+}
+
+// return the number of simulated input vectors
+uint64_t Profiler::GetVectorNum() const noexcept {
+  return this->vector_num;
+}
+
+// return the time spent on the simulated input vectors
+double Profiler::GetSeconds() const noexcept {
+  return this->total_nanoseconds * 1e-9;
+}
+
+// return the evaluations of one gate
+uint64_t Profiler::GetEvaluations(const uint32_t gate) const {
+  return this->evaluations.at(gate);
+}
+
+// return the output toggles of one gate
+uint64_t Profiler::GetToggles(const uint32_t gate) const {
+  return this->toggles.at(gate);
+}
+
+// return toggles per input vector of one gate
+double Profiler::GetActivity(const uint32_t gate) const {
+  return (vector_num == 0) ? 0.0 : static_cast<double>(toggles.at(gate)) / vector_num;
+}
+
+// return the evaluations summed over every gate
+uint64_t Profiler::GetTotalEvaluations() const noexcept {
+  return std::accumulate(evaluations.begin(), evaluations.end(), uint64_t{0});
+}
+
+// return the toggles summed over every gate
+uint64_t Profiler::GetTotalToggles() const noexcept {
+  return std::accumulate(toggles.begin(), toggles.end(), uint64_t{0});
+}
+
+// return gate evaluations per second
+double Profiler::GetEvaluationRate() const noexcept {
+  return (total_nanoseconds == 0) ? 0.0 : GetTotalEvaluations() / GetSeconds();
+}
+
+// return the evaluations of one level
+uint64_t Profiler::GetLevelEvaluations(const uint32_t level) const {
+  return this->level_evaluations.at(level);
+}
+
+// return the time spent in one level
+double Profiler::GetLevelSeconds(const uint32_t level) const {
+  return this->level_nanoseconds.at(level) * 1e-9;
+}
+
+// return the hierarchical name of a gate
+std::string Profiler::GetGateFullName(const uint32_t gate) const {
+  const Component* const comp = pNetlist->GetGateSource(gate);
+  if (comp != nullptr) {
+    return comp->GetFullName();
+  }
+  const std::string_view name = pNetlist->GetGateName(gate);
+  return name.empty() ? "g" + std::to_string(gate) : std::string(name);
+}
+
+// return up to count gates, most evaluated first
+std::vector<uint32_t> Profiler::GetHottest(const uint32_t count) const {
+  std::vector<uint32_t> order(evaluations.size());
+  std::iota(order.begin(), order.end(), 0);
+  const auto hotter = [&](const uint32_t a, const uint32_t b) {
+    if (evaluations[a] != evaluations[b]) {
+      return evaluations[a] > evaluations[b];
+    }
+    return (toggles[a] != toggles[b]) ? toggles[a] > toggles[b] : a < b;
+  };
+  const uint32_t kept = std::min<uint32_t>(count, order.size());
+  std::partial_sort(order.begin(), order.begin() + kept, order.end(), hotter);
+  order.resize(kept);
+  return order;
+}
+
+// return the number of gates per activity bin
+std::vector<uint64_t> Profiler::GetActivityHistogram(const uint32_t bins) const {
+  if (bins == 0) {
+    throw std::invalid_argument("ERR: HISTOGRAM NEEDS AT LEAST ONE BIN! \n");
+  }
+  std::vector<uint64_t> histogram(bins, 0);
+  for (uint32_t g = 0; g < toggles.size(); g++) {
+    const double bin = GetActivity(g) * bins;
+    histogram[(bin >= bins) ? bins - 1 : static_cast<uint32_t>(bin)]++;
+  }
+  return histogram;
+}
+
+// return the activity of every hierarchy prefix
+std::vector<PrefixActivity> Profiler::GetHierarchy() const {
+  // 1. add every gate to each proper prefix of its full name
+  std::map<std::string, PrefixActivity> prefixes;
+  for (uint32_t g = 0; g < evaluations.size(); g++) {
+    const std::string name = GetGateFullName(g);
+    for (size_t end = name.find(kHierSep); end != std::string::npos; end = name.find(kHierSep, end + kHierSep.size())) {
+      PrefixActivity& entry = prefixes[name.substr(0, end)];
+      entry.gates++;
+      entry.evaluations += evaluations[g];
+      entry.toggles += toggles[g];
+    }
+  }
+  // 2. most evaluated first
+  std::vector<PrefixActivity> result;
+  result.reserve(prefixes.size());
+  for (auto& [prefix, entry] : prefixes) {
+    entry.prefix = prefix;
+    result.push_back(std::move(entry));
+  }
+  std::stable_sort(result.begin(), result.end(), [](const PrefixActivity& a, const PrefixActivity& b) {
+    return a.evaluations > b.evaluations;
+  });
+  return result;
+}
+
+// write the whole report as one JSON object
+void Profiler::WriteJson(std::ostream& out, const uint32_t top_n, const uint32_t bins) const {
+  // 1. summary
+  out << "{\n  \"gates\": " << evaluations.size() << ",\n  \"levels\": " << level_evaluations.size()
+      << ",\n  \"vectors\": " << vector_num << ",\n  \"seconds\": " << GetSeconds()
+      << ",\n  \"evaluations\": " << GetTotalEvaluations() << ",\n  \"toggles\": " << GetTotalToggles()
+      << ",\n  \"evaluations_per_second\": " << GetEvaluationRate();
+
+  // 2. per level
+  out << ",\n  \"per_level\": [";
+  for (uint32_t l = 0; l < level_evaluations.size(); l++) {
+    out << (l == 0 ? "\n" : ",\n") << "    {\"level\": " << l << ", \"evaluations\": " << level_evaluations[l]
+        << ", \"seconds\": " << GetLevelSeconds(l) << "}";
+  }
+  out << "\n  ]";
+
+  // 3. hottest gates
+  out << ",\n  \"hottest\": [";
+  const std::vector<uint32_t> hottest = GetHottest(top_n);
+  for (uint32_t i = 0; i < hottest.size(); i++) {
+    const uint32_t g = hottest[i];
+    out << (i == 0 ? "\n" : ",\n") << "    {\"gate\": " << g << ", \"name\": ";
+    write_json_string(out, GetGateFullName(g));
+    out << ", \"kind\": ";
+    write_json_string(out, GetGateKindName(pNetlist->GetProgram()[g].op));
+    out << ", \"evaluations\": " << evaluations[g] << ", \"toggles\": " << toggles[g]
+        << ", \"activity\": " << GetActivity(g) << "}";
+  }
+  out << "\n  ]";
+
+  // 4. activity factor histogram
+  const std::vector<uint64_t> histogram = GetActivityHistogram(bins);
+  out << ",\n  \"activity_histogram\": {\"bin_width\": " << 1.0 / bins << ", \"counts\": [";
+  for (uint32_t b = 0; b < bins; b++) {
+    out << (b == 0 ? "" : ", ") << histogram[b];
+  }
+  out << "]}";
+
+  // 5. hierarchy
+  out << ",\n  \"hierarchy\": [";
+  const std::vector<PrefixActivity> hierarchy = GetHierarchy();
+  for (uint32_t i = 0; i < hierarchy.size(); i++) {
+    const PrefixActivity& entry = hierarchy[i];
+    out << (i == 0 ? "\n" : ",\n") << "    {\"prefix\": ";
+    write_json_string(out, entry.prefix);
+    out << ", \"gates\": " << entry.gates << ", \"evaluations\": " << entry.evaluations
+        << ", \"toggles\": " << entry.toggles << "}";
+  }
+  out << "\n  ]\n}\n";
+}
@@ -0,0 +1,140 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// include guard for this header
+#ifndef C_PROFILE_H
+#define C_PROFILE_H
+
+// includes for this header
+#include <ostream>        // std::ostream
+#include <string>         // std::string
+#include <vector>         // std::vector
+#include <cstdint>        // standard int types
+#include "c_netlist.h"    // class Netlist
+
+// profiling hooks in the engines, 0 compiles them out (see CMake option CIM_PROFILE)
+#ifndef CIM_PROFILE
+#define CIM_PROFILE 1
+#endif
+
+// namespace for entire project
+namespace Cim {
+
+// activity of one hierarchy prefix of GetFullName() ("top::alu" covers "top::alu::*")
+struct PrefixActivity {
+  std::string prefix;       // hierarchy prefix, without the trailing "::"
+  uint32_t    gates;        // gates below the prefix
+  uint64_t    evaluations;  // evaluations of those gates
+  uint64_t    toggles;      // output toggles of those gates
+};
+
+// Profiler Class
+// Collects simulation activity of one Netlist: evaluations and output toggles
+// per gate, evaluations and time per level, and the number of input vectors.
+// Engines feed it through SetProfiler(); when built with CIM_PROFILE=0 the
+// hooks are compiled out and only the report side remains.
+// toggles / vectors is the activity factor used for dynamic power estimation.
+class Profiler {
+ public:
+  // constructor (netlist must be levelized and outlive the profiler)
+  explicit Profiler(const Netlist& TargetNetlist);
+
+  // destructor
+  ~Profiler() { /* DN */ }
+
+  // return true if the engines were built with the profiling hooks
+  static constexpr bool IsEnabled() noexcept { return CIM_PROFILE != 0; }
+
+  // clear every counter
+  void Reset() noexcept;
+
+  // hooks, called by the engines
+  inline void CountEvaluation(const uint32_t gate) noexcept { evaluations[gate]++; }
+  inline void CountToggle(const uint32_t gate) noexcept { toggles[gate]++; }
+  inline void AddLevel(const uint32_t level, const uint64_t evals, const uint64_t nanoseconds) noexcept {
+    level_evaluations[level] += evals;
+    level_nanoseconds[level] += nanoseconds;
+  }
+  inline void AddVectors(const uint64_t vectors, const uint64_t nanoseconds) noexcept {
+    vector_num += vectors;
+    total_nanoseconds += nanoseconds;
+  }
+
+  // return the profiled netlist
+  const Netlist& GetNetlist() const noexcept;
+
+  // return the number of simulated input vectors / the time spent on them
+  uint64_t GetVectorNum() const noexcept;
+  double GetSeconds() const noexcept;
+
+  // return the counters of one gate
+  uint64_t GetEvaluations(const uint32_t gate) const;
+  uint64_t GetToggles(const uint32_t gate) const;
+
+  // return toggles per input vector of one gate (can exceed 1 with glitches)
+  double GetActivity(const uint32_t gate) const;
+
+  // return the counters summed over every gate
+  uint64_t GetTotalEvaluations() const noexcept;
+  uint64_t GetTotalToggles() const noexcept;
+
+  // return gate evaluations per second
+  double GetEvaluationRate() const noexcept;
+
+  // return the counters of one level (filled by levelized engines only)
+  uint64_t GetLevelEvaluations(const uint32_t level) const;
+  double GetLevelSeconds(const uint32_t level) const;
+
+  // return the hierarchical name of a gate (component full name if compiled from one)
+  std::string GetGateFullName(const uint32_t gate) const;
+
+  // return up to count gates, most evaluated first (ties: most toggles first)
+  std::vector<uint32_t> GetHottest(const uint32_t count) const;
+
+  // return the number of gates per activity bin, [k / bins, (k + 1) / bins), last bin open
+  std::vector<uint64_t> GetActivityHistogram(const uint32_t bins) const;
+
+  // return the activity of every hierarchy prefix, most evaluated first
+  std::vector<PrefixActivity> GetHierarchy() const;
+
+  // write the whole report as one JSON object
+  void WriteJson(std::ostream& out, const uint32_t top_n = 20, const uint32_t bins = 10) const;
+
+ private:
+  const Netlist* pNetlist;                    // profiled circuit
+
+  // Per gate
+  std::vector<uint64_t> evaluations;          // evaluations per gate
+  std::vector<uint64_t> toggles;              // output changes per gate
+
+  // Per level
+  std::vector<uint64_t> level_evaluations;    // evaluations per level
+  std::vector<uint64_t> level_nanoseconds;    // time per level
+
+  // Per run
+  uint64_t vector_num;                        // simulated input vectors
+  uint64_t total_nanoseconds;                 // time spent on them
+};
+
+}
+
+#endif  // C_PROFILE_H
@@ -0,0 +1,94 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// includes for this file
+#include "c_sequential.h"
+#include <stdexcept>
+
+// using namespace for this project
+using namespace Cim;
+
+// constructor
+Sequential::Sequential(const Component* const ParentDevice, const std::string& Name, const GateKind Kind,
+    const std::string& ControlPinName, bool isMonitored, bool InitState, std::pmr::memory_resource* const Resource) :
+  Gate(ParentDevice, Name, Kind, {"D", ControlPinName}, isMonitored, Resource),
+  // State
+  init{InitState} {
+  Gate::Set(kOutput, init);
+}
+
+// initialize the stored state to the initial state
+void Sequential::Initialize() {
+  Gate::Set(kOutput, init);
+}
+
+// Set a pin to new state, may update the stored state
+void Sequential::Set(const uint32_t pin_idx, const bool new_state) {
+  const bool old_control = GetPinState(kControl);
+  Gate::Set(pin_idx, new_state);
+  if (pin_idx != kOutput && is_open(old_control, GetPinState(kControl))) {
+    Gate::Set(kOutput, GetPinState(kData));
+  }
+}
+
+// Set a pin to new state, may update the stored state
+void Sequential::Set(const std::string& pin_name, const bool new_state) {
+  Set(GetPinIndex(pin_name), new_state);
+}
+
+// store the state of D regardless of the control pin
+void Sequential::Capture() {
+  Gate::Set(kOutput, GetPinState(kData));
+}
+
+// return the stored state
+bool Sequential::GetState() const {
+  return GetPinState(kOutput);
+}
+
+// return the state after Initialize()
+bool Sequential::GetInitState() const noexcept {
+  return this->init;
+}
+
+// constructor
+FlipFlop::FlipFlop(const Component* const ParentDevice, const std::string& Name, bool isMonitored,
+    bool InitState, std::pmr::memory_resource* const Resource) :
+  Sequential(ParentDevice, Name, GateKind::DFF, "CLK", isMonitored, InitState, Resource) {
+}
+
+// rising edge of CLK
+bool FlipFlop::is_open(const bool old_control, const bool new_control) const noexcept {
+  return !old_control && new_control;
+}
+
+// constructor
+Latch::Latch(const Component* const ParentDevice, const std::string& Name, bool isMonitored,
+    bool InitState, std::pmr::memory_resource* const Resource) :
+  Sequential(ParentDevice, Name, GateKind::LATCH, "EN", isMonitored, InitState, Resource) {
+}
+
+// EN is high
+bool Latch::is_open(const bool old_control, const bool new_control) const noexcept {
+  (void)old_control;
+  return new_control;
+}
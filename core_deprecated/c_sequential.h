@@ -0,0 +1,108 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// include guard for this header
+#ifndef C_SEQUENTIAL_H
+#define C_SEQUENTIAL_H
+
+// includes for this header
+#include "c_gate.h"     // class Gate
+#include "c_structs.h"  // GateKind
+
+// namespace for entire project
+namespace Cim {
+
+// Sequential Class (Derived class from Gate)
+// A state element with pins D (0), a control pin (1) and out (2). The output
+// pin holds the stored state; it only changes when the control pin lets D
+// through, never as a function of the current inputs alone.
+class Sequential : public Gate {
+ public:
+  // index of the data / control / output pin
+  static constexpr uint32_t kData = 0;
+  static constexpr uint32_t kControl = 1;
+  static constexpr uint32_t kOutput = 2;
+
+  // destructor
+  ~Sequential() { /* DN */ }
+
+  // initialize the stored state to the initial state
+  virtual void Initialize() override;
+
+  // Set a pin to new state, may update the stored state
+  virtual void Set(const uint32_t pin_idx, const bool new_state) override;
+  virtual void Set(const std::string& pin_name, const bool new_state) override;
+
+  // store the state of D regardless of the control pin
+  void Capture();
+
+  // return the stored state
+  bool GetState() const;
+
+  // return the state after Initialize()
+  bool GetInitState() const noexcept;
+
+ protected:
+  // constructor
+  Sequential(const Component* const ParentDevice, const std::string& Name, const GateKind Kind,
+      const std::string& ControlPinName, bool isMonitored, bool InitState, std::pmr::memory_resource* const Resource);
+
+  // return true if a change of the control pin from old_state lets D through
+  virtual bool is_open(const bool old_control, const bool new_control) const noexcept = 0;
+
+ private:
+  bool init;  // state after Initialize()
+};
+
+// FlipFlop Class: stores D on the rising edge of CLK
+class FlipFlop : public Sequential {
+ public:
+  // constructor (pins D, CLK -> out)
+  FlipFlop(const Component* const ParentDevice, const std::string& Name, bool isMonitored = false,
+      bool InitState = false, std::pmr::memory_resource* const Resource = std::pmr::get_default_resource());
+
+  // destructor
+  ~FlipFlop() { /* DN */ }
+
+ protected:
+  // rising edge of CLK
+  virtual bool is_open(const bool old_control, const bool new_control) const noexcept override;
+};
+
+// Latch Class: follows D while EN is high, holds it while EN is low
+class Latch : public Sequential {
+ public:
+  // constructor (pins D, EN -> out)
+  Latch(const Component* const ParentDevice, const std::string& Name, bool isMonitored = false,
+      bool InitState = false, std::pmr::memory_resource* const Resource = std::pmr::get_default_resource());
+
+  // destructor
+  ~Latch() { /* DN */ }
+
+ protected:
+  // EN is high
+  virtual bool is_open(const bool old_control, const bool new_control) const noexcept override;
+};
+
+}
+
+#endif  // C_SEQUENTIAL_H
@@ -0,0 +1,174 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// includes for this file
+#include "c_snapshot.h"
+#include <algorithm>      // std::min
+#include <array>          // std::array
+#include <cstring>        // std::memcpy, std::memcmp
+#include <stdexcept>
+#include <cassert>
+
+// using namespace for this project
+using namespace Cim;
+
+namespace {
+
+// words per page
+constexpr uint32_t kPageWords = kSnapshotPageNets / 64;
+
+// byte b -> 8 state bytes (bit k of b is byte k), in memory order of the running machine
+const std::array<uint64_t, 256>& unpack_table() {
+  static const std::array<uint64_t, 256> table = [] {
+    std::array<uint64_t, 256> result{};
+    for (uint32_t b = 0; b < 256; b++) {
+      uint8_t bytes[8];
+      for (uint32_t k = 0; k < 8; k++) {
+        bytes[k] = (b >> k) & 1;
+      }
+      std::memcpy(&result[b], bytes, 8);
+    }
+    return result;
+  }();
+  return table;
+}
+
+// 8 state bytes (0 / 1, loaded in memory order) -> 8 bits, byte k -> bit k
+inline uint64_t pack_bytes(uint64_t bytes) noexcept {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  bytes = __builtin_bswap64(bytes);
+#endif
+  return ((bytes & 0x0101010101010101ULL) * 0x0102040810204080ULL) >> 56;
+}
+
+}
+
+// constructor (empty)
+Snapshot::Snapshot() noexcept :
+  pNetlist{nullptr}, net_num{0}, cycle{0}, pages() {
+}
+
+// constructor (pack one state byte per net)
+Snapshot::Snapshot(const Netlist& TargetNetlist, const uint8_t* const states, const uint64_t cycle,
+    const Snapshot* const base) :
+  pNetlist{&TargetNetlist}, net_num{TargetNetlist.GetNetNum()}, cycle{cycle}, pages() {
+  if (base != nullptr && (base->pNetlist != pNetlist || base->net_num != net_num)) {
+    throw std::invalid_argument("ERR: SNAPSHOT BELONGS TO ANOTHER NETLIST! \n");
+  }
+  pages.reserve((net_num + kSnapshotPageNets - 1) / kSnapshotPageNets);
+  Page page;
+  for (uint32_t first = 0, p = 0; first < net_num; first += kSnapshotPageNets, p++) {
+    // 1. pack: 8 states per byte, 64 per word
+    const uint32_t last = std::min(first + kSnapshotPageNets, net_num);
+    for (uint32_t w = 0; w < kPageWords; w++) {
+      uint64_t word = 0;
+      const uint32_t lo = first + 64 * w, hi = std::min(lo + 64, last);
+      if (hi == lo + 64) {
+        // 8 states at a time: spread bytes of 0 / 1 meet in the top byte of the product
+        for (uint32_t k = 0; k < 8; k++) {
+          uint64_t bytes;
+          std::memcpy(&bytes, states + lo + 8 * k, 8);
+          word |= pack_bytes(bytes) << (8 * k);
+        }
+      } else {
+        for (uint32_t n = lo; n < hi; n++) {
+          word |= uint64_t{states[n] != 0} << (n - lo);
+        }
+      }
+      page.words[w] = word;
+    }
+    // 2. share the page of the base if nothing changed
+    if (base != nullptr && std::memcmp(base->pages[p]->words, page.words, sizeof(Page)) == 0) {
+      pages.push_back(base->pages[p]);
+    } else {
+      pages.push_back(std::make_shared<Page>(page));
+    }
+  }
+}
+
+// unpack into one state byte per net
+void Snapshot::Unpack(uint8_t* const states) const noexcept {
+  const std::array<uint64_t, 256>& table = unpack_table();
+  const uint32_t full = net_num / 8;
+  for (uint32_t b = 0; b < full; b++) {
+    const uint32_t n = 8 * b;
+    const uint64_t word = pages[n / kSnapshotPageNets]->words[(n % kSnapshotPageNets) / 64];
+    std::memcpy(states + n, &table[(word >> (n % 64)) & 0xFF], 8);
+  }
+  for (uint32_t n = 8 * full; n < net_num; n++) {
+    states[n] = GetState(n);
+  }
+}
+
+// return the netlist the states belong to
+const Netlist* Snapshot::GetNetlist() const noexcept {
+  return this->pNetlist;
+}
+
+// return the number of nets
+uint32_t Snapshot::GetNetNum() const noexcept {
+  return this->net_num;
+}
+
+// return the cycle count at capture
+uint64_t Snapshot::GetCycle() const noexcept {
+  return this->cycle;
+}
+
+// return the state of one net
+bool Snapshot::GetState(const uint32_t net) const {
+  if (net >= net_num) {
+    throw std::out_of_range("ERR: NET DOES NOT EXIST! \n");
+  }
+  return (pages[net / kSnapshotPageNets]->words[(net % kSnapshotPageNets) / 64] >> (net % 64)) & 1;
+}
+
+// change the state of one net
+void Snapshot::SetState(const uint32_t net, const bool new_state) {
+  if (GetState(net) == new_state) {
+    return;
+  }
+  std::shared_ptr<Page>& page = pages[net / kSnapshotPageNets];
+  if (page.use_count() > 1) {
+    page = std::make_shared<Page>(*page);
+  }
+  page->words[(net % kSnapshotPageNets) / 64] ^= uint64_t{1} << (net % 64);
+}
+
+// return the number of pages
+uint32_t Snapshot::GetPageNum() const noexcept {
+  return this->pages.size();
+}
+
+// return the number of pages also referenced by another snapshot
+uint32_t Snapshot::GetSharedPageNum() const noexcept {
+  uint32_t shared = 0;
+  for (const std::shared_ptr<Page>& each_page : pages) {
+    shared += (each_page.use_count() > 1);
+  }
+  return shared;
+}
+
+// return the bytes of state owned by this snapshot alone
+size_t Snapshot::GetUniqueByteNum() const noexcept {
+  return static_cast<size_t>(GetPageNum() - GetSharedPageNum()) * sizeof(Page);
+}
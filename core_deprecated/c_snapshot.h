@@ -0,0 +1,95 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// include guard for this header
+#ifndef C_SNAPSHOT_H
+#define C_SNAPSHOT_H
+
+// includes for this header
+#include <memory>         // std::shared_ptr
+#include <vector>         // std::vector
+#include <cstdint>        // standard int types
+#include "c_netlist.h"    // class Netlist
+
+// namespace for entire project
+namespace Cim {
+
+// nets per snapshot page (bits), the unit of sharing between snapshots
+constexpr uint32_t kSnapshotPageNets = 4096;
+
+// Snapshot Class
+// Bit-packed copy of every net state of an engine (register outputs included,
+// so it also holds the sequential state) plus the cycle count. The bits are
+// split into fixed pages held by shared pointers: copies of a snapshot share
+// all pages and a page is only duplicated when one copy changes it
+// (copy-on-write). Snapshots captured against a base share every page that
+// did not change, so thousands of branches of one reset state stay cheap.
+// Engines create them with Save() and load them with Restore().
+class Snapshot {
+ public:
+  // constructor (empty, belongs to no netlist)
+  Snapshot() noexcept;
+
+  // constructor (pack one state byte per net, share the pages equal to those of base)
+  Snapshot(const Netlist& TargetNetlist, const uint8_t* const states, const uint64_t cycle,
+      const Snapshot* const base = nullptr);
+
+  // destructor
+  ~Snapshot() { /* DN */ }
+
+  // unpack into one state byte per net
+  void Unpack(uint8_t* const states) const noexcept;
+
+  // return the netlist the states belong to (nullptr if empty)
+  const Netlist* GetNetlist() const noexcept;
+
+  // return the number of nets / the cycle count at capture
+  uint32_t GetNetNum() const noexcept;
+  uint64_t GetCycle() const noexcept;
+
+  // return / change the state of one net (a shared page is copied first)
+  bool GetState(const uint32_t net) const;
+  void SetState(const uint32_t net, const bool new_state);
+
+  // return the number of pages / of pages also referenced by another snapshot
+  uint32_t GetPageNum() const noexcept;
+  uint32_t GetSharedPageNum() const noexcept;
+
+  // return the bytes of state owned by this snapshot alone
+  size_t GetUniqueByteNum() const noexcept;
+
+ private:
+  // one page of packed states
+  struct Page {
+    uint64_t words[kSnapshotPageNets / 64];
+  };
+
+ private:
+  const Netlist* pNetlist;                        // owner of the states
+  uint32_t net_num;                               // number of packed states
+  uint64_t cycle;                                 // cycle count at capture
+  std::vector<std::shared_ptr<Page>> pages;       // packed states, net n is bit n % 64 of word n / 64
+};
+
+}
+
+#endif  // C_SNAPSHOT_H
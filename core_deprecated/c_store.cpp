@@ -0,0 +1,410 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// includes for this file
+#include "c_store.h"
+#include <iostream>   // std::cout
+#include <stdexcept>
+#include <cassert>
+
+// using namespace for this project
+using namespace Cim;
+
+// constructor (all nets false & unchanged)
+PackedStates::PackedStates(const uint32_t size) :
+  size{size}, state((size + 63) / 64, 0), changed((size + 63) / 64, 0) {
+}
+
+// return number of nets
+uint32_t PackedStates::GetSize() const noexcept {
+  return this->size;
+}
+
+// load every state from a byte-per-net array
+void PackedStates::Assign(const uint8_t* const bytes, const uint32_t size) {
+  if (size != this->size) {
+    throw std::invalid_argument("ERR: STATE SIZE MISMATCH! \n");
+  }
+  for (uint32_t w = 0; w < state.size(); w++) {
+    uint64_t word = 0;
+    const uint32_t end = (w * 64 + 64 < size) ? 64 : size - w * 64;
+    for (uint32_t b = 0; b < end; b++) {
+      word |= static_cast<uint64_t>(bytes[w * 64 + b] & 1) << b;
+    }
+    changed[w] = state[w] ^ word;
+    state[w] = word;
+  }
+}
+
+// export every state to a byte-per-net array
+void PackedStates::Export(uint8_t* const bytes) const noexcept {
+  for (uint32_t i = 0; i < size; i++) {
+    bytes[i] = Get(i);
+  }
+}
+
+// return the packed state words
+const std::vector<uint64_t>& PackedStates::GetWords() const noexcept {
+  return this->state;
+}
+
+// constructor
+GateView::GateView(NetlistStore* const Store, const uint32_t GateIndex) :
+  pStore{Store}, gate{GateIndex}, links() {
+}
+
+// initialize components to initial state
+void GateView::Initialize() {
+  // states live in the store, nothing to set up per view
+}
+
+// return the net of a pin
+uint32_t GateView::net(const uint32_t pin_idx) const {
+  const Netlist& netlist = pStore->GetNetlist();
+  const Instruction& ins = netlist.GetProgram()[gate];
+  if (pin_idx < ins.fanin_count) {
+    return netlist.GetFanin()[ins.fanin_begin + pin_idx];
+  }
+  if (pin_idx == ins.fanin_count) {
+    return ins.out_net;
+  }
+  throw std::out_of_range("ERR: PIN DOES NOT EXIST! \n");
+}
+
+// search for a pin by name
+uint32_t GateView::search(const std::string& pin_name) const noexcept {
+  return pStore->GetNetlist().FindPin(gate, pin_name);
+}
+
+// Set a pin to new state and update the state_changed flag
+void GateView::Set(const uint32_t pin_idx, const bool new_state) {
+  pStore->SetNetState(net(pin_idx), new_state);
+}
+
+// Set a pin to new state and update the state_changed flag
+void GateView::Set(const std::string& pin_name, const bool new_state) {
+  const uint32_t pin_idx = search(pin_name);
+  if (pin_idx == UINT32_MAX) {
+    throw std::invalid_argument("ERR: PIN DOES NOT EXIST! \n");
+  }
+  Set(pin_idx, new_state);
+}
+
+// return true if component is monitored
+bool GateView::IsMonitored() const noexcept {
+  return pStore->GetNetlist().IsMonitored(gate);
+}
+
+// return true if component is a device
+bool GateView::IsDevice() const noexcept {
+  return false;
+}
+
+// return the pointer to parent device
+const Component* const GateView::GetParentDevice() const noexcept {
+  return nullptr;
+}
+
+// return local index
+uint32_t GateView::GetLocalIndex() const noexcept {
+  return this->gate;
+}
+
+// set local index (views are indexed by their gate, ignored)
+void GateView::SetLocalIndex(const uint32_t new_idx) noexcept {
+  (void)new_idx;
+}
+
+// get inpins and outpins number
+std::pair<uint32_t, uint32_t> GateView::GetIONum() const noexcept {
+  return std::make_pair<uint32_t, uint32_t>(uint32_t{pStore->GetNetlist().GetProgram()[gate].fanin_count}, 1);
+}
+
+// return component name
+std::string GateView::GetName() const noexcept {
+  return std::string(pStore->GetNetlist().GetGateName(gate));
+}
+
+// return component full name (the store is flat)
+std::string GateView::GetFullName() const noexcept {
+  return GetName();
+}
+
+// return component type
+std::string GateView::GetType() const noexcept {
+  return GetGateKindName(pStore->GetNetlist().GetProgram()[gate].op);
+}
+
+// return component kind
+GateKind GateView::GetKind() const {
+  return pStore->GetNetlist().GetProgram()[gate].op;
+}
+
+// return the truth table of a LUT component
+uint64_t GateView::GetTruthTable() const {
+  const Instruction& ins = pStore->GetNetlist().GetProgram()[gate];
+  return (ins.op == GateKind::LUT) ? pStore->GetNetlist().GetLuts()[ins.lut] : 0;
+}
+
+// return nesting level
+uint32_t GateView::GetNestingLvl() const noexcept {
+  return 0;
+}
+
+// return pin state
+bool GateView::GetPinState(const uint32_t pin_idx) const {
+  return pStore->GetNetState(net(pin_idx));
+}
+
+// return if state changed after the last evaluation
+bool GateView::IsPinStateChanged(const uint32_t pin_idx) const {
+  return pStore->IsNetStateChanged(net(pin_idx));
+}
+
+// mark a pin change as consumed, without touching any state
+void GateView::ClearPinStateChanged(const uint32_t pin_idx) {
+  pStore->ClearNetStateChanged(net(pin_idx));
+}
+
+// return pin name
+std::string GateView::GetPinName(const uint32_t pin_idx) const {
+  net(pin_idx);
+  return std::string(pStore->GetNetlist().GetPinName(gate, pin_idx));
+}
+
+// return a non-owning view of the input pins
+PinRange GateView::GetInPins() const noexcept {
+  return PinRange(this, 0, GetIONum().first);
+}
+
+// return a non-owning view of the output pins
+PinRange GateView::GetOutPins() const noexcept {
+  return PinRange(this, GetIONum().first, GetIONum().first + 1);
+}
+
+// return the states of 64 input pins starting at pin (64 * word)
+uint64_t GateView::GetInPinStates(const uint32_t word) const noexcept {
+  const Netlist& netlist = pStore->GetNetlist();
+  const Instruction& ins = netlist.GetProgram()[gate];
+  const uint32_t* const fanin = netlist.GetFanin().data() + ins.fanin_begin;
+  const PackedStates& states = pStore->GetStates();
+  uint64_t bits = 0;
+  for (uint32_t i = word * 64, b = 0; i < ins.fanin_count && b < 64; i++, b++) {
+    bits |= static_cast<uint64_t>(states.Get(fanin[i])) << b;
+  }
+  return bits;
+}
+
+// return the pin's direction
+Pin::Dir GateView::GetPinDirection(const uint32_t pin_idx) const {
+  net(pin_idx);
+  return (pin_idx < GetIONum().first) ? Pin::Dir::Input : Pin::Dir::Output;
+}
+
+// return the pin's direction
+Pin::Dir GateView::GetPinDirection(const std::string& pin_name) const {
+  return GetPinDirection(GetPinIndex(pin_name));
+}
+
+// return pin index
+uint32_t GateView::GetPinIndex(const std::string& pin_name) const {
+  const uint32_t pin_idx = search(pin_name);
+  if (pin_idx == UINT32_MAX) {
+    throw std::invalid_argument("ERR: PIN DOES NOT EXIST! \n");
+  }
+  return pin_idx;
+}
+
+// resolve a pin name once
+PinHandle GateView::ResolvePin(const std::string& pin_name) {
+  return PinHandle{this, GetPinIndex(pin_name)};
+}
+
+// views are rewired through the Netlist
+std::pmr::vector<Pin::Link>& GateView::GetPinConnection(const uint32_t pin_idx) {
+  net(pin_idx);
+  throw std::logic_error("ERR: VIEWS ARE REWIRED THROUGH THE NETLIST! \n");
+}
+
+// views are rewired through the Netlist
+std::pmr::vector<Pin::Link>& GateView::GetPinConnection(const std::string& pin_name) {
+  return GetPinConnection(GetPinIndex(pin_name));
+}
+
+// return a snapshot of the connection of that pin
+const std::pmr::vector<Pin::Link>& GateView::GetPinConnection(const uint32_t pin_idx) const {
+  const Netlist& netlist = pStore->GetNetlist();
+  const uint32_t pin_net = net(pin_idx);
+  links.clear();
+  if (GetPinDirection(pin_idx) == Pin::Dir::Input) {
+    // driver of the net
+    const uint32_t driver = netlist.GetNetDriver(pin_net);
+    if (driver != UINT32_MAX) {
+      links.push_back(Pin::Link{pStore->GetComponent(driver), netlist.GetProgram()[driver].fanin_count});
+    }
+  } else {
+    // readers of the net
+    const ArrayView<uint32_t> offsets = netlist.GetFanoutOffsets();
+    for (uint32_t r = offsets[pin_net]; r < offsets[pin_net + 1]; r++) {
+      const uint32_t reader = netlist.GetFanout()[r];
+      const Instruction& ins = netlist.GetProgram()[reader];
+      for (uint32_t k = 0; k < ins.fanin_count; k++) {
+        if (netlist.GetFanin()[ins.fanin_begin + k] == pin_net) {
+          links.push_back(Pin::Link{pStore->GetComponent(reader), k});
+        }
+      }
+    }
+  }
+  // same convention as Pin: an unconnected pin holds one empty link
+  if (links.empty()) {
+    links.push_back(Pin::Link{nullptr, UINT32_MAX});
+  }
+  return links;
+}
+
+// return whether a pin exist
+bool GateView::DoesPinExist(const std::string& pin_name) const {
+  return search(pin_name) != UINT32_MAX;
+}
+
+// check if pin is connected
+bool GateView::IsPinConnected(const uint32_t pin_idx) const {
+  const Netlist& netlist = pStore->GetNetlist();
+  const uint32_t pin_net = net(pin_idx);
+  if (GetPinDirection(pin_idx) == Pin::Dir::Input) {
+    return netlist.GetNetDriver(pin_net) != UINT32_MAX;
+  }
+  return netlist.GetFanoutOffsets()[pin_net + 1] != netlist.GetFanoutOffsets()[pin_net];
+}
+
+// check if pin is connected
+bool GateView::IsPinConnected(const std::string& pin_name) const {
+  return IsPinConnected(GetPinIndex(pin_name));
+}
+
+// print input pins' states
+void GateView::PrintInPinStates() const noexcept {
+  std::cout << "[ " << GetFullName() << " ] \n";
+  const uint32_t in_num = GetIONum().first;
+  for (uint32_t i = 0; i < in_num; i++) {
+    std::cout << "> " << GetPinName(i) << ": " << (GetPinState(i) ? "T \n" : "F \n");
+  }
+  std::cout << '\n';
+}
+
+// print output pins' states
+void GateView::PrintOutPinStates() const noexcept {
+  const uint32_t out_pin = GetIONum().first;
+  std::cout << "[ " << GetFullName() << " ] \n";
+  std::cout << "> " << GetPinName(out_pin) << ": " << (GetPinState(out_pin) ? "T \n" : "F \n");
+  std::cout << '\n';
+}
+
+// constructor (takes over a levelized netlist)
+NetlistStore::NetlistStore(Netlist&& TargetNetlist) :
+  netlist{std::move(TargetNetlist)}, states(netlist.GetNetNum()), views() {
+  if (!netlist.IsLevelized()) {
+    throw std::logic_error("ERR: NETLIST MUST BE LEVELIZED! \n");
+  }
+  views.reserve(netlist.GetGateNum());
+  for (uint32_t g = 0; g < netlist.GetGateNum(); g++) {
+    views.emplace_back(this, g);
+  }
+}
+
+// constructor (compile a connected network of gates)
+NetlistStore::NetlistStore(const std::vector<Component*>& Components) :
+  NetlistStore(Netlist(Components)) {
+}
+
+// return the netlist
+const Netlist& NetlistStore::GetNetlist() const noexcept {
+  return this->netlist;
+}
+
+// return the component view of a gate
+Component* NetlistStore::GetComponent(const uint32_t gate) {
+  return &this->views.at(gate);
+}
+
+// return the view of the gate with that name
+Component* NetlistStore::FindComponent(const std::string& gate_name) {
+  const uint32_t gate = netlist.FindGate(gate_name);
+  return (gate == UINT32_MAX) ? nullptr : &views[gate];
+}
+
+// resolve a gate & pin name pair once
+PinHandle NetlistStore::ResolvePin(const std::string& gate_name, const std::string& pin_name) {
+  Component* const comp = FindComponent(gate_name);
+  if (comp == nullptr) {
+    throw std::invalid_argument("ERR: COMPONENT DOES NOT EXIST! \n");
+  }
+  return comp->ResolvePin(pin_name);
+}
+
+// return the state of a net
+bool NetlistStore::GetNetState(const uint32_t net) const {
+  if (net >= states.GetSize()) {
+    throw std::out_of_range("ERR: NET DOES NOT EXIST! \n");
+  }
+  return states.Get(net);
+}
+
+// set the state of a net
+void NetlistStore::SetNetState(const uint32_t net, const bool new_state) {
+  if (net >= states.GetSize()) {
+    throw std::out_of_range("ERR: NET DOES NOT EXIST! \n");
+  }
+  states.Set(net, new_state);
+}
+
+// return if the state of a net changed on its last update
+bool NetlistStore::IsNetStateChanged(const uint32_t net) const {
+  if (net >= states.GetSize()) {
+    throw std::out_of_range("ERR: NET DOES NOT EXIST! \n");
+  }
+  return states.IsChanged(net);
+}
+
+// mark the last update of a net as consumed
+void NetlistStore::ClearNetStateChanged(const uint32_t net) {
+  if (net >= states.GetSize()) {
+    throw std::out_of_range("ERR: NET DOES NOT EXIST! \n");
+  }
+  states.ClearChanged(net);
+}
+
+// load every net state from a byte-per-net engine
+void NetlistStore::SetStates(const std::vector<uint8_t>& nets) {
+  states.Assign(nets.data(), nets.size());
+}
+
+// return the packed states
+const PackedStates& NetlistStore::GetStates() const noexcept {
+  return this->states;
+}
+
+// return the bytes held by the store
+size_t NetlistStore::GetByteNum() const noexcept {
+  return netlist.GetByteNum() + netlist.GetNameByteNum() + states.GetWords().capacity() * 2 * sizeof(uint64_t) +
+      views.capacity() * sizeof(GateView);
+}
@@ -0,0 +1,268 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// include guard for this header
+#ifndef C_STORE_H
+#define C_STORE_H
+
+// includes for this header
+#include <string>         // std::string
+#include <vector>         // std::vector
+#include <utility>        // std::pair
+#include <cstdint>        // standard int types
+
+#include "c_component.h"  // class Component
+#include "c_netlist.h"    // class Netlist
+
+// namespace for entire project
+namespace Cim {
+
+// PackedStates Class
+// One state bit and one state_changed bit per net, 64 nets per word.
+class PackedStates {
+ public:
+  // constructor (all nets false & unchanged)
+  explicit PackedStates(const uint32_t size = 0);
+
+  // destructor
+  ~PackedStates() { /* DN */ }
+
+  // return number of nets
+  uint32_t GetSize() const noexcept;
+
+  // return the state of a net
+  inline bool Get(const uint32_t idx) const noexcept {
+    return (state[idx >> 6] >> (idx & 63)) & 1;
+  }
+
+  // set a net to new state and update its state_changed bit
+  inline void Set(const uint32_t idx, const bool new_state) noexcept {
+    const uint64_t bit = uint64_t{1} << (idx & 63);
+    const uint64_t old_word = state[idx >> 6];
+    const uint64_t new_word = new_state ? (old_word | bit) : (old_word & ~bit);
+    changed[idx >> 6] = (changed[idx >> 6] & ~bit) | (old_word ^ new_word);
+    state[idx >> 6] = new_word;
+  }
+
+  // return if the state changed on the last Set()
+  inline bool IsChanged(const uint32_t idx) const noexcept {
+    return (changed[idx >> 6] >> (idx & 63)) & 1;
+  }
+
+  // clear the state_changed bit of a net
+  inline void ClearChanged(const uint32_t idx) noexcept {
+    changed[idx >> 6] &= ~(uint64_t{1} << (idx & 63));
+  }
+
+  // load / export every state from / to a byte-per-net array
+  void Assign(const uint8_t* const bytes, const uint32_t size);
+  void Export(uint8_t* const bytes) const noexcept;
+
+  // return the packed state words
+  const std::vector<uint64_t>& GetWords() const noexcept;
+
+ private:
+  uint32_t size;                  // number of nets
+  std::vector<uint64_t> state;    // state bits
+  std::vector<uint64_t> changed;  // state_changed bits
+};
+
+class NetlistStore;
+
+// GateView Class (Derived class from Component Interface)
+// Non-owning view of one gate of a NetlistStore. It holds the store pointer, the
+// gate index and a scratch vector for GetPinConnection(), every other call is
+// answered from the store's arrays. The const GetPinConnection() rewrites that
+// scratch vector, so the returned reference is only valid until the next call
+// and one view must not be read from two threads at once.
+class GateView : public Component {
+ public:
+  // constructor
+  GateView(NetlistStore* const Store, const uint32_t GateIndex);
+
+  // destructor
+  ~GateView() { /* DN */ }
+
+  // initialize components to initial state
+  virtual void Initialize() override;
+
+  // Set a pin to new state and update the state_changed flag
+  virtual void Set(const uint32_t pin_idx, const bool new_state) override;
+  virtual void Set(const std::string& pin_name, const bool new_state) override;
+
+  // return true if component is monitored
+  virtual bool IsMonitored() const noexcept override;
+
+  // return true if component is a device
+  virtual bool IsDevice() const noexcept override;
+
+  // return the pointer to parent device
+  virtual const Component* const GetParentDevice() const noexcept override;
+
+  // return local index
+  virtual uint32_t GetLocalIndex() const noexcept override;
+
+  // set local index (views are indexed by their gate, ignored)
+  virtual void SetLocalIndex(const uint32_t new_idx) noexcept override;
+
+  // get inpins and outpins number
+  virtual std::pair<uint32_t, uint32_t> GetIONum() const noexcept override;
+
+  // return component name
+  virtual std::string GetName() const noexcept override;
+
+  // return component full name
+  virtual std::string GetFullName() const noexcept override;
+
+  // return component type
+  virtual std::string GetType() const noexcept override;
+
+  // return component kind
+  virtual GateKind GetKind() const override;
+
+  // return the truth table of a LUT component (0 for other kinds)
+  virtual uint64_t GetTruthTable() const override;
+
+  // return nesting level
+  virtual uint32_t GetNestingLvl() const noexcept override;
+
+  // return pin state
+  virtual bool GetPinState(const uint32_t pin_idx) const override;
+
+  // return if state changed after the last evaluation
+  virtual bool IsPinStateChanged(const uint32_t pin_idx) const override;
+
+  // mark a pin change as consumed, without touching any state
+  virtual void ClearPinStateChanged(const uint32_t pin_idx) override;
+
+  // return pin name
+  virtual std::string GetPinName(const uint32_t pin_idx) const override;
+
+  // return a non-owning view of the input pins
+  virtual PinRange GetInPins() const noexcept override;
+
+  // return a non-owning view of the output pins
+  virtual PinRange GetOutPins() const noexcept override;
+
+  // return the states of 64 input pins starting at pin (64 * word), one bit per pin
+  virtual uint64_t GetInPinStates(const uint32_t word = 0) const noexcept override;
+
+  // return the pin's direction
+  virtual Pin::Dir GetPinDirection(const uint32_t pin_idx) const override;
+  virtual Pin::Dir GetPinDirection(const std::string& pin_name) const override;
+
+  // return pin index
+  virtual uint32_t GetPinIndex(const std::string& pin_name) const override;
+
+  // resolve a pin name once, the handle replaces the name in later calls
+  virtual PinHandle ResolvePin(const std::string& pin_name) override;
+
+  // views are rewired through the Netlist: the modifiable connection throws
+  virtual std::pmr::vector<Pin::Link>& GetPinConnection(const uint32_t pin_idx) override;
+  virtual std::pmr::vector<Pin::Link>& GetPinConnection(const std::string& pin_name) override;
+
+  // return a snapshot of the connection of that pin (overwritten by the next call)
+  virtual const std::pmr::vector<Pin::Link>& GetPinConnection(const uint32_t pin_idx) const override;
+
+  // return whether a pin exist
+  virtual bool DoesPinExist(const std::string& pin_name) const override;
+
+  // check if pin is connected
+  virtual bool IsPinConnected(const uint32_t pin_idx) const override;
+  virtual bool IsPinConnected(const std::string& pin_name) const override;
+
+  // print input pins' states
+  virtual void PrintInPinStates() const noexcept override;
+
+  // print output pins' states
+  virtual void PrintOutPinStates() const noexcept override;
+
+ private:
+  // return the net of a pin (throws if the pin does not exist)
+  uint32_t net(const uint32_t pin_idx) const;
+
+  // search for a pin by name, UINT32_MAX if not found
+  uint32_t search(const std::string& pin_name) const noexcept;
+
+ private:
+  NetlistStore* pStore;               // owning store
+  uint32_t gate;                      // gate index in the netlist
+  mutable std::pmr::vector<Pin::Link> links;  // GetPinConnection() snapshot
+};
+
+// NetlistStore Class
+// Struct-of-arrays netlist storage: the levelized Netlist (opcodes, CSR fanin &
+// fanout, cold name table) plus bit-packed net states. Components handed out
+// by the store are GateViews on top of these arrays.
+class NetlistStore {
+ public:
+  // constructor (takes over a levelized netlist)
+  explicit NetlistStore(Netlist&& TargetNetlist);
+
+  // constructor (compile a connected network of gates)
+  explicit NetlistStore(const std::vector<Component*>& Components);
+
+  // views point into the store -> neither copyable nor movable
+  NetlistStore(const NetlistStore&) = delete;
+  NetlistStore& operator=(const NetlistStore&) = delete;
+
+  // destructor
+  ~NetlistStore() { /* DN */ }
+
+  // return the netlist
+  const Netlist& GetNetlist() const noexcept;
+
+  // return the component view of a gate
+  Component* GetComponent(const uint32_t gate);
+
+  // return the view of the gate with that name, nullptr if none
+  Component* FindComponent(const std::string& gate_name);
+
+  // resolve a gate & pin name pair once
+  PinHandle ResolvePin(const std::string& gate_name, const std::string& pin_name);
+
+  // return / set the state of a net
+  bool GetNetState(const uint32_t net) const;
+  void SetNetState(const uint32_t net, const bool new_state);
+
+  // return if the state of a net changed on its last update / mark that update as consumed
+  bool IsNetStateChanged(const uint32_t net) const;
+  void ClearNetStateChanged(const uint32_t net);
+
+  // load every net state from a byte-per-net engine (e.g. LevelizedSim::GetStates())
+  void SetStates(const std::vector<uint8_t>& nets);
+
+  // return the packed states
+  const PackedStates& GetStates() const noexcept;
+
+  // return the bytes held by the store
+  size_t GetByteNum() const noexcept;
+
+ private:
+  Netlist netlist;                // structure & names
+  PackedStates states;            // net states
+  std::vector<GateView> views;    // one view per gate
+};
+
+}
+
+#endif  // C_STORE_H
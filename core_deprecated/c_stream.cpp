@@ -0,0 +1,671 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// includes for this file
+#include "c_stream.h"
+#include "c_bitsim.h"     // class BitParallelSim
+#include "c_cycle.h"      // class CycleSim
+#include <algorithm>      // std::min, std::fill
+#include <chrono>         // std::chrono
+#include <condition_variable>   // std::condition_variable
+#include <cstring>        // std::memcpy, std::memcmp, std::memchr
+#include <deque>          // std::deque
+#include <exception>      // std::exception_ptr
+#include <fstream>        // std::ifstream
+#include <mutex>          // std::mutex
+#include <stdexcept>
+#include <thread>         // std::thread
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>        // open
+#include <sys/mman.h>     // mmap, munmap, madvise
+#include <sys/stat.h>     // fstat
+#include <unistd.h>       // close
+#define CIM_HAS_MMAP 1
+#endif
+
+// using namespace for this project
+using namespace Cim;
+
+// helpers private to this file
+namespace {
+
+// file layout: VectorHeader, then groups of 64 vectors of width words each
+constexpr char kMagic[8] = {'C', 'I', 'M', 'V', 'E', 'C', 'T', 'S'};
+constexpr uint32_t kByteOrder = 0x01020304;
+
+struct VectorHeader {
+  char magic[8];          // kMagic
+  uint32_t version;       // kVectorFileVersion
+  uint32_t byte_order;    // kByteOrder as written by the producer
+  uint32_t width;         // columns per vector
+  uint32_t reserved;      // 0
+  uint64_t vector_num;    // vectors in the file (the last group is padded with zeros)
+};
+static_assert(sizeof(VectorHeader) == 32, "vector file header must stay 32 bytes");
+
+// return the header of a file of vector_num vectors
+VectorHeader make_header(const uint32_t width, const uint64_t vector_num) noexcept {
+  VectorHeader header;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVectorFileVersion;
+  header.byte_order = kByteOrder;
+  header.width = width;
+  header.reserved = 0;
+  header.vector_num = vector_num;
+  return header;
+}
+
+// consumed pages are released in steps of this many bytes (a multiple of any page size)
+constexpr uint64_t kReleaseBytes = uint64_t{1} << 26;
+
+// map (or read) a whole file, the returned owner releases it
+std::shared_ptr<const void> load_file(const std::string& path, uint64_t& size) {
+#if defined(CIM_HAS_MMAP)
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("ERR: CANNOT OPEN VECTOR FILE! \n");
+  }
+  struct stat info;
+  if (::fstat(fd, &info) != 0) {
+    ::close(fd);
+    throw std::runtime_error("ERR: CANNOT OPEN VECTOR FILE! \n");
+  }
+  size = static_cast<uint64_t>(info.st_size);
+  if (size == 0) {
+    ::close(fd);
+    return std::shared_ptr<const void>(nullptr, [](const void*) {});
+  }
+  void* const base = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (base == MAP_FAILED) {
+    throw std::runtime_error("ERR: CANNOT MAP VECTOR FILE! \n");
+  }
+  // read ahead aggressively, the file is consumed front to back once
+  ::madvise(base, size, MADV_SEQUENTIAL);
+  const size_t length = size;
+  return std::shared_ptr<const void>(base, [length](const void* p) { ::munmap(const_cast<void*>(p), length); });
+#else
+  // no mmap -> one read of the whole file
+  std::ifstream in(path, std::ios::binary | std::ios::ate);
+  if (!in) {
+    throw std::runtime_error("ERR: CANNOT OPEN VECTOR FILE! \n");
+  }
+  size = static_cast<uint64_t>(in.tellg());
+  auto buffer = std::make_shared<std::vector<uint64_t>>((size + 7) / 8);
+  in.seekg(0);
+  in.read(reinterpret_cast<char*>(buffer->data()), static_cast<std::streamsize>(size));
+  if (!in) {
+    throw std::runtime_error("ERR: CANNOT READ VECTOR FILE! \n");
+  }
+  return std::shared_ptr<const void>(buffer, buffer->data());
+#endif
+}
+
+// return true for characters a text vector may contain between its bits
+inline bool is_blank(const char c) noexcept {
+  return c == ' ' || c == '\t' || c == '\r' || c == '_';
+}
+
+// return the number of bits on a text line, throw on anything else
+uint32_t count_bits(const char* begin, const char* const end) {
+  uint32_t bits = 0;
+  for (; begin < end; begin++) {
+    if (*begin == '0' || *begin == '1') {
+      bits++;
+    } else if (!is_blank(*begin)) {
+      throw std::invalid_argument("ERR: INVALID CHARACTER IN VECTOR FILE! \n");
+    }
+  }
+  return bits;
+}
+
+// seconds since start
+inline double seconds_since(const std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// hand-over of slot indices from one pipeline stage to the next
+class SlotQueue {
+ public:
+  // give a slot to the next stage
+  void Push(const uint32_t slot) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      slots.push_back(slot);
+    }
+    ready.notify_one();
+  }
+
+  // take the oldest slot, false once closed and drained or aborted
+  bool Pop(uint32_t& slot) {
+    std::unique_lock<std::mutex> lock(mutex);
+    ready.wait(lock, [this] { return !slots.empty() || closed || aborted; });
+    if (aborted || slots.empty()) {
+      return false;
+    }
+    slot = slots.front();
+    slots.pop_front();
+    return true;
+  }
+
+  // no more slots will come (Abort: drop the waiting ones too)
+  void Close() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      closed = true;
+    }
+    ready.notify_all();
+  }
+  void Abort() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      aborted = true;
+    }
+    ready.notify_all();
+  }
+
+ private:
+  std::mutex mutex;                   // guards the fields below
+  std::condition_variable ready;      // a slot was pushed / closed / aborted
+  std::deque<uint32_t> slots;         // slots waiting for the next stage
+  bool closed = false;                // producer finished
+  bool aborted = false;               // a stage failed
+};
+
+// simulate a block on the bit-parallel engine, 512 vectors per pass
+void simulate_parallel(BitParallelSim& sim, const ArrayView<uint32_t> inputs, const std::vector<uint32_t>& results,
+    const uint64_t* const in, uint64_t* const out, const uint32_t word_num, const uint32_t vector_num) {
+  const uint32_t step = sim.GetWordNum();
+  const uint32_t used = (vector_num + 63) / 64;
+  for (uint32_t w = 0; w < used; w += step) {
+    for (uint32_t c = 0; c < inputs.size(); c++) {
+      sim.SetInputWords(inputs[c], in + static_cast<size_t>(c) * word_num + w);
+    }
+    sim.Evaluate();
+    for (uint32_t r = 0; r < results.size(); r++) {
+      std::memcpy(out + static_cast<size_t>(r) * word_num + w, sim.GetWords(results[r]), step * sizeof(uint64_t));
+    }
+  }
+}
+
+// simulate a block on the cycle engine, one clock edge per vector
+void simulate_cycles(CycleSim& sim, const ArrayView<uint32_t> inputs, const std::vector<uint32_t>& results,
+    const uint64_t* const in, uint64_t* const out, const uint32_t word_num, const uint32_t vector_num) {
+  std::fill(out, out + static_cast<size_t>(results.size()) * word_num, 0);
+  for (uint32_t v = 0; v < vector_num; v++) {
+    for (uint32_t c = 0; c < inputs.size(); c++) {
+      sim.SetInput(inputs[c], (in[static_cast<size_t>(c) * word_num + v / 64] >> (v % 64)) & 1);
+    }
+    sim.Clock();
+    for (uint32_t r = 0; r < results.size(); r++) {
+      out[static_cast<size_t>(r) * word_num + v / 64] |= uint64_t{sim.GetState(results[r])} << (v % 64);
+    }
+  }
+}
+
+}
+
+// constructor
+VectorReader::VectorReader(const std::string& path, const VectorFormat format) :
+  mapping(), data{nullptr}, size{0}, pos{0}, released{0}, format{format}, width{0}, vector_num{0}, total{0} {
+  mapping = load_file(path, size);
+  data = static_cast<const char*>(mapping.get());
+  // 1. pick the format
+  const bool has_magic = size >= sizeof(VectorHeader) && std::memcmp(data, kMagic, sizeof(kMagic)) == 0;
+  if (this->format == VectorFormat::Auto) {
+    this->format = has_magic ? VectorFormat::Binary : VectorFormat::Text;
+  }
+  // 2. binary: check the header and the size
+  if (this->format == VectorFormat::Binary) {
+    if (!has_magic) {
+      throw std::runtime_error("ERR: NOT A BINARY VECTOR FILE! \n");
+    }
+    VectorHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.version != kVectorFileVersion || header.byte_order != kByteOrder) {
+      throw std::runtime_error("ERR: INCOMPATIBLE VECTOR FILE! \n");
+    }
+    width = header.width;
+    total = header.vector_num;
+    if ((size - sizeof(VectorHeader)) / sizeof(uint64_t) / std::max<uint32_t>(width, 1) < (total + 63) / 64) {
+      throw std::runtime_error("ERR: VECTOR FILE TOO SHORT! \n");
+    }
+    pos = sizeof(VectorHeader);
+    return;
+  }
+  // 3. text: the width is the number of bits of the first vector
+  for (uint64_t p = 0; p < size && width == 0; ) {
+    const char* const line = data + p;
+    const char* end = static_cast<const char*>(std::memchr(line, '\n', size - p));
+    end = (end == nullptr) ? data + size : end;
+    p = (end - data) + 1;
+    if (*line != '#') {
+      width = count_bits(line, end);
+    }
+  }
+}
+
+// return the format of the file
+VectorFormat VectorReader::GetFormat() const noexcept {
+  return this->format;
+}
+
+// return the number of columns per vector
+uint32_t VectorReader::GetWidth() const noexcept {
+  return this->width;
+}
+
+// return the number of vectors read so far
+uint64_t VectorReader::GetVectorNum() const noexcept {
+  return this->vector_num;
+}
+
+// return the size of the file
+uint64_t VectorReader::GetByteNum() const noexcept {
+  return this->size;
+}
+
+// read at most 64 * word_num vectors
+uint32_t VectorReader::ReadBlock(uint64_t* const words, const uint32_t word_num) {
+  const uint32_t count = (format == VectorFormat::Binary) ? read_binary(words, word_num) : read_text(words, word_num);
+  vector_num += count;
+  release();
+  return count;
+}
+
+// read one block of text vectors
+uint32_t VectorReader::read_text(uint64_t* const words, const uint32_t word_num) {
+  std::fill(words, words + static_cast<size_t>(width) * word_num, 0);
+  const uint32_t capacity = 64 * word_num;
+  uint32_t count = 0;
+  while (count < capacity && pos < size) {
+    // 1. next line
+    const char* const line = data + pos;
+    const char* end = static_cast<const char*>(std::memchr(line, '\n', size - pos));
+    end = (end == nullptr) ? data + size : end;
+    pos = (end - data) + 1;
+    if (*line == '#') {
+      continue;
+    }
+    // 2. bit c of the line goes to column c
+    uint64_t* const word = words + count / 64;
+    const uint32_t shift = count % 64;
+    if (end - line == width && width != 0) {
+      // fast path: nothing but bits, no branch per character
+      uint32_t bad = 0;
+      for (uint32_t c = 0; c < width; c++) {
+        const uint32_t value = static_cast<uint8_t>(line[c] - '0');
+        bad |= value;
+        word[static_cast<size_t>(c) * word_num] |= uint64_t{value & 1} << shift;
+      }
+      if (bad <= 1) {
+        count++;
+        continue;
+      }
+      // undo the line and let the checks below report it
+      for (uint32_t c = 0; c < width; c++) {
+        word[static_cast<size_t>(c) * word_num] &= ~(uint64_t{1} << shift);
+      }
+    }
+    const uint64_t bit = uint64_t{1} << shift;
+    uint32_t column = 0;
+    for (const char* p = line; p < end; p++) {
+      if (*p == '0' || *p == '1') {
+        if (column == width) {
+          throw std::invalid_argument("ERR: VECTOR WIDTH MISMATCH! \n");
+        }
+        if (*p == '1') {
+          word[static_cast<size_t>(column) * word_num] |= bit;
+        }
+        column++;
+      } else if (!is_blank(*p)) {
+        throw std::invalid_argument("ERR: INVALID CHARACTER IN VECTOR FILE! \n");
+      }
+    }
+    // 3. blank lines hold no vector
+    if (column == 0) {
+      continue;
+    }
+    if (column != width) {
+      throw std::invalid_argument("ERR: VECTOR WIDTH MISMATCH! \n");
+    }
+    count++;
+  }
+  pos = std::min(pos, size);
+  return count;
+}
+
+// read one block of binary vectors
+uint32_t VectorReader::read_binary(uint64_t* const words, const uint32_t word_num) {
+  const uint64_t left = total - vector_num;
+  const uint32_t count = static_cast<uint32_t>(std::min<uint64_t>(left, 64 * uint64_t{word_num}));
+  // one group of 64 vectors per word of every column
+  for (uint32_t w = 0; w < (count + 63) / 64; w++) {
+    for (uint32_t c = 0; c < width; c++) {
+      std::memcpy(words + static_cast<size_t>(c) * word_num + w, data + pos, sizeof(uint64_t));
+      pos += sizeof(uint64_t);
+    }
+  }
+  return count;
+}
+
+// hand the pages before the read position back to the kernel
+void VectorReader::release() {
+#if defined(CIM_HAS_MMAP)
+  const uint64_t end = pos & ~(kReleaseBytes - 1);
+  if (end > released) {
+    ::madvise(const_cast<char*>(data) + released, end - released, MADV_DONTNEED);
+    released = end;
+  }
+#endif
+}
+
+// constructor
+VectorWriter::VectorWriter(const std::string& path, const uint32_t Width, const VectorFormat Format) :
+  file{nullptr}, byte_num{0}, width{Width}, format{Format}, vector_num{0}, pending_num{0},
+  pending(Width, 0), columns(Width, 0), line() {
+  if (format == VectorFormat::Auto) {
+    throw std::invalid_argument("ERR: OUTPUT FORMAT MUST BE TEXT OR BINARY! \n");
+  }
+  file = std::fopen(path.c_str(), "wb");
+  if (file == nullptr) {
+    throw std::runtime_error("ERR: CANNOT CREATE VECTOR FILE! \n");
+  }
+  // the header is rewritten with the vector count by Close()
+  if (format == VectorFormat::Binary) {
+    const VectorHeader header = make_header(width, 0);
+    if (std::fwrite(&header, sizeof(header), 1, file) != 1) {
+      std::fclose(file);
+      throw std::runtime_error("ERR: CANNOT WRITE VECTOR FILE! \n");
+    }
+    byte_num = sizeof(header);
+  }
+}
+
+// destructor
+VectorWriter::~VectorWriter() {
+  try {
+    Close();
+  } catch (...) {
+    // write errors can only be reported by an explicit Close()
+  }
+}
+
+// append vector_num vectors of a column-major block
+void VectorWriter::WriteBlock(const uint64_t* const words, const uint32_t word_num, const uint32_t vector_num) {
+  if (vector_num > 64 * uint64_t{word_num}) {
+    throw std::invalid_argument("ERR: BLOCK HOLDS FEWER VECTORS! \n");
+  }
+  for (uint32_t w = 0; 64 * w < vector_num; w++) {
+    for (uint32_t c = 0; c < width; c++) {
+      columns[c] = words[static_cast<size_t>(c) * word_num + w];
+    }
+    append(columns.data(), std::min(64u, vector_num - 64 * w));
+  }
+}
+
+// append one vector
+void VectorWriter::Write(const std::vector<bool>& vector) {
+  if (vector.size() != width) {
+    throw std::invalid_argument("ERR: VECTOR WIDTH MISMATCH! \n");
+  }
+  for (uint32_t c = 0; c < width; c++) {
+    columns[c] = vector[c];
+  }
+  append(columns.data(), 1);
+}
+
+// append up to 64 vectors given as one word per column
+void VectorWriter::append(const uint64_t* const group, const uint32_t count) {
+  if (file == nullptr) {
+    throw std::logic_error("ERR: VECTOR FILE IS CLOSED! \n");
+  }
+  const uint64_t mask = (count == 64) ? ~uint64_t{0} : (uint64_t{1} << count) - 1;
+  const uint32_t shift = pending_num;
+  // 1. the first vectors fill up the pending group
+  for (uint32_t c = 0; c < width; c++) {
+    pending[c] |= (group[c] & mask) << shift;
+  }
+  vector_num += count;
+  if (shift + count < 64) {
+    pending_num = shift + count;
+    return;
+  }
+  flush(64);
+  // 2. the others start the next one
+  pending_num = shift + count - 64;
+  if (pending_num != 0) {
+    for (uint32_t c = 0; c < width; c++) {
+      pending[c] = (group[c] & mask) >> (64 - shift);
+    }
+  }
+}
+
+// write the group of pending vectors
+void VectorWriter::flush(const uint32_t count) {
+  size_t written = 0, expected = 0;
+  if (format == VectorFormat::Binary) {
+    // the whole group, unused vectors are zero
+    expected = width;
+    written = std::fwrite(pending.data(), sizeof(uint64_t), width, file);
+    byte_num += sizeof(uint64_t) * written;
+  } else {
+    // one line per vector
+    line.resize(static_cast<size_t>(count) * (width + 1));
+    char* p = line.data();
+    for (uint32_t v = 0; v < count; v++) {
+      for (uint32_t c = 0; c < width; c++) {
+        *p++ = static_cast<char>('0' + ((pending[c] >> v) & 1));
+      }
+      *p++ = '\n';
+    }
+    expected = line.size();
+    written = std::fwrite(line.data(), 1, line.size(), file);
+    byte_num += written;
+  }
+  std::fill(pending.begin(), pending.end(), 0);
+  if (written != expected) {
+    throw std::runtime_error("ERR: CANNOT WRITE VECTOR FILE! \n");
+  }
+}
+
+// write the pending vectors and the header, then close the file
+void VectorWriter::Close() {
+  if (file == nullptr) {
+    return;
+  }
+  std::FILE* const closing = file;
+  bool ok = true;
+  try {
+    if (pending_num != 0) {
+      flush(pending_num);
+      pending_num = 0;
+    }
+  } catch (const std::runtime_error&) {
+    ok = false;
+  }
+  if (ok && format == VectorFormat::Binary) {
+    const VectorHeader header = make_header(width, vector_num);
+    ok = std::fseek(closing, 0, SEEK_SET) == 0 && std::fwrite(&header, sizeof(header), 1, closing) == 1;
+  }
+  file = nullptr;
+  ok &= (std::fclose(closing) == 0);
+  if (!ok) {
+    throw std::runtime_error("ERR: CANNOT WRITE VECTOR FILE! \n");
+  }
+}
+
+// return the number of vectors written
+uint64_t VectorWriter::GetVectorNum() const noexcept {
+  return this->vector_num;
+}
+
+// return the bytes written so far
+uint64_t VectorWriter::GetByteNum() const noexcept {
+  return this->byte_num;
+}
+
+// constructor
+StreamDriver::StreamDriver(const Netlist& TargetNetlist, const uint32_t block_vectors, const uint32_t ring_slots) :
+  pNetlist{&TargetNetlist}, word_num{block_vectors / 64}, slot_num{ring_slots}, result_nets() {
+  if (!TargetNetlist.IsLevelized()) {
+    throw std::logic_error("ERR: NETLIST MUST BE LEVELIZED! \n");
+  }
+  if (block_vectors == 0 || block_vectors % 512 != 0) {
+    throw std::invalid_argument("ERR: BLOCK SIZE MUST BE A MULTIPLE OF 512! \n");
+  }
+  if (ring_slots == 0) {
+    throw std::invalid_argument("ERR: STREAM NEEDS AT LEAST 1 SLOT PER RING! \n");
+  }
+  // primary outputs, then outputs of monitored gates
+  for (const uint32_t each_net : TargetNetlist.GetOutputs()) {
+    result_nets.push_back(each_net);
+  }
+  for (uint32_t g = 0; g < TargetNetlist.GetGateNum(); g++) {
+    if (TargetNetlist.IsMonitored(g)) {
+      result_nets.push_back(TargetNetlist.GetProgram()[g].out_net);
+    }
+  }
+}
+
+// return the nets written per vector
+const std::vector<uint32_t>& StreamDriver::GetResultNets() const noexcept {
+  return this->result_nets;
+}
+
+// stream every vector of in_path through the circuit into out_path
+StreamStats StreamDriver::Run(const std::string& in_path, const std::string& out_path,
+    const VectorFormat in_format, const VectorFormat out_format) {
+  const auto start = std::chrono::steady_clock::now();
+  const ArrayView<uint32_t> inputs = pNetlist->GetInputs();
+  VectorReader reader(in_path, in_format);
+  if (reader.GetWidth() != inputs.size()) {
+    throw std::invalid_argument("ERR: VECTOR WIDTH DOES NOT MATCH THE PRIMARY INPUTS! \n");
+  }
+  VectorWriter writer(out_path, result_nets.size(), out_format);
+
+  // 1. engines & slots (a block of one column is word_num words)
+  const bool sequential = pNetlist->GetRegisterNum() != 0;
+  std::unique_ptr<BitParallelSim> parallel_sim;
+  std::unique_ptr<CycleSim> cycle_sim;
+  if (sequential) {
+    cycle_sim = std::make_unique<CycleSim>(*pNetlist);
+    cycle_sim->Reset();
+  } else {
+    parallel_sim = std::make_unique<BitParallelSim>(*pNetlist, 512);
+  }
+  const size_t in_words = static_cast<size_t>(inputs.size()) * word_num;
+  const size_t out_words = static_cast<size_t>(result_nets.size()) * word_num;
+  std::vector<uint64_t> in_blocks(in_words * slot_num), out_blocks(out_words * slot_num);
+  std::vector<uint32_t> in_counts(slot_num), out_counts(slot_num);
+  SlotQueue in_free, in_full, out_free, out_full;
+  for (uint32_t s = 0; s < slot_num; s++) {
+    in_free.Push(s);
+    out_free.Push(s);
+  }
+
+  // 2. the first failing stage stops all of them
+  std::mutex error_mutex;
+  std::exception_ptr error;
+  const auto fail = [&]() {
+    {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+    in_free.Abort();
+    in_full.Abort();
+    out_free.Abort();
+    out_full.Abort();
+  };
+  StreamStats stats{0, 0, reader.GetByteNum(), 0, 0, 0, 0, 0};
+
+  // 3. reader: file -> free input slots -> simulation
+  std::thread read_stage([&]() {
+    try {
+      uint32_t slot = 0;
+      while (in_free.Pop(slot)) {
+        const auto begin = std::chrono::steady_clock::now();
+        const uint32_t count = reader.ReadBlock(in_blocks.data() + slot * in_words, word_num);
+        stats.read_seconds += seconds_since(begin);
+        if (count == 0) {
+          break;
+        }
+        in_counts[slot] = count;
+        in_full.Push(slot);
+      }
+      in_full.Close();
+    } catch (...) {
+      fail();
+    }
+  });
+
+  // 4. writer: simulation -> file -> free output slots
+  std::thread write_stage([&]() {
+    try {
+      uint32_t slot = 0;
+      while (out_full.Pop(slot)) {
+        const auto begin = std::chrono::steady_clock::now();
+        writer.WriteBlock(out_blocks.data() + slot * out_words, word_num, out_counts[slot]);
+        stats.write_seconds += seconds_since(begin);
+        out_free.Push(slot);
+      }
+    } catch (...) {
+      fail();
+    }
+  });
+
+  // 5. simulation on this thread: input slot -> output slot
+  try {
+    uint32_t in_slot = 0, out_slot = 0;
+    while (in_full.Pop(in_slot) && out_free.Pop(out_slot)) {
+      const auto begin = std::chrono::steady_clock::now();
+      const uint64_t* const in = in_blocks.data() + in_slot * in_words;
+      uint64_t* const out = out_blocks.data() + out_slot * out_words;
+      if (sequential) {
+        simulate_cycles(*cycle_sim, inputs, result_nets, in, out, word_num, in_counts[in_slot]);
+      } else {
+        simulate_parallel(*parallel_sim, inputs, result_nets, in, out, word_num, in_counts[in_slot]);
+      }
+      stats.simulate_seconds += seconds_since(begin);
+      out_counts[out_slot] = in_counts[in_slot];
+      stats.vectors += in_counts[in_slot];
+      stats.blocks++;
+      in_free.Push(in_slot);
+      out_full.Push(out_slot);
+    }
+    out_full.Close();
+  } catch (...) {
+    fail();
+  }
+  read_stage.join();
+  write_stage.join();
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  writer.Close();
+  stats.bytes_out = writer.GetByteNum();
+  stats.seconds = seconds_since(start);
+  return stats;
+}
@@ -0,0 +1,188 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// include guard for this header
+#ifndef C_STREAM_H
+#define C_STREAM_H
+
+// includes for this header
+#include <string>         // std::string
+#include <vector>         // std::vector
+#include <memory>         // std::shared_ptr
+#include <cstdio>         // std::FILE
+#include <cstdint>        // standard int types
+#include "c_netlist.h"    // class Netlist
+
+// namespace for entire project
+namespace Cim {
+
+// version of the binary vector file layout
+constexpr uint32_t kVectorFileVersion = 1;
+
+// layout of a vector file
+enum class VectorFormat : uint8_t {
+  Auto = 0,   // reading only: Binary if the file starts with the binary magic, Text otherwise
+  Text,       // one vector per line, one '0' / '1' per column (blanks ignored, '#' starts a comment line)
+  Binary      // 32-byte header, then groups of 64 vectors: one word per column, bit v is vector v of the group
+};
+
+// VectorReader Class
+// Reads a vector file through a memory mapping, block by block, so files far
+// larger than memory can be streamed: pages already consumed are handed back
+// to the kernel as the reader moves on. Blocks are column major, the layout the
+// bit-parallel engine takes: column c of a block of word_num words holds
+// vector v in bit v % 64 of word [c * word_num + v / 64].
+class VectorReader {
+ public:
+  // constructor (maps the file, reads the header or the width of the first text vector)
+  explicit VectorReader(const std::string& path, const VectorFormat format = VectorFormat::Auto);
+
+  // destructor
+  ~VectorReader() { /* DN */ }
+
+  // return the format of the file / the number of columns per vector
+  VectorFormat GetFormat() const noexcept;
+  uint32_t GetWidth() const noexcept;
+
+  // return the number of vectors read so far / the size of the file
+  uint64_t GetVectorNum() const noexcept;
+  uint64_t GetByteNum() const noexcept;
+
+  // read at most 64 * word_num vectors into GetWidth() * word_num words, returns the count (0 at the end)
+  uint32_t ReadBlock(uint64_t* const words, const uint32_t word_num);
+
+ private:
+  // read one block of each format
+  uint32_t read_text(uint64_t* const words, const uint32_t word_num);
+  uint32_t read_binary(uint64_t* const words, const uint32_t word_num);
+
+  // hand the pages before the read position back to the kernel
+  void release();
+
+ private:
+  std::shared_ptr<const void> mapping;  // owner of the mapped (or read) file
+  const char* data;                     // first byte of the file
+  uint64_t size;                        // bytes in the file
+  uint64_t pos;                         // read position
+  uint64_t released;                    // pages before this offset were released
+  VectorFormat format;                  // layout of the file
+  uint32_t width;                       // columns per vector
+  uint64_t vector_num;                  // vectors read so far
+  uint64_t total;                       // vectors in the file (Binary only)
+};
+
+// VectorWriter Class
+// Writes vectors in either format from column-major blocks (see VectorReader)
+// or one at a time. Vectors are gathered into groups of 64 and written through
+// the buffered file; Close() writes the last group and the vector count.
+class VectorWriter {
+ public:
+  // constructor (creates or truncates the file)
+  VectorWriter(const std::string& path, const uint32_t Width, const VectorFormat Format = VectorFormat::Text);
+
+  // not copyable, owns the file
+  VectorWriter(const VectorWriter&) = delete;
+  VectorWriter& operator=(const VectorWriter&) = delete;
+
+  // destructor (closes the file, errors are lost: call Close() to see them)
+  ~VectorWriter();
+
+  // append vector_num vectors of a column-major block of word_num words per column
+  void WriteBlock(const uint64_t* const words, const uint32_t word_num, const uint32_t vector_num);
+
+  // append one vector
+  void Write(const std::vector<bool>& vector);
+
+  // write the pending vectors and the header, then close the file
+  void Close();
+
+  // return the number of vectors written / the bytes written so far
+  uint64_t GetVectorNum() const noexcept;
+  uint64_t GetByteNum() const noexcept;
+
+ private:
+  // append up to 64 vectors given as one word per column
+  void append(const uint64_t* const columns, const uint32_t count);
+
+  // write the group of 64 pending vectors (count of them are valid)
+  void flush(const uint32_t count);
+
+ private:
+  std::FILE* file;                    // output file (nullptr once closed)
+  uint64_t byte_num;                  // bytes written
+  uint32_t width;                     // columns per vector
+  VectorFormat format;                // Text or Binary
+  uint64_t vector_num;                // vectors appended
+  uint32_t pending_num;               // vectors in pending
+  std::vector<uint64_t> pending;      // one word per column, bit v is pending vector v
+  std::vector<uint64_t> columns;      // scratch group for WriteBlock / Write
+  std::string line;                   // scratch text of one group
+};
+
+// statistics of one streamed run
+struct StreamStats {
+  uint64_t  vectors;            // vectors simulated
+  uint64_t  blocks;             // blocks passed through the pipeline
+  uint64_t  bytes_in;           // size of the input file
+  uint64_t  bytes_out;          // size of the output file
+  double    seconds;            // wall time of the run
+  double    read_seconds;       // busy time of the reader stage
+  double    simulate_seconds;   // busy time of the simulation stage
+  double    write_seconds;      // busy time of the writer stage
+};
+
+// StreamDriver Class
+// Batch driver for vector files of any size: a reader thread parses blocks of
+// input vectors from the mapped file, the calling thread simulates them and a
+// writer thread streams the results, the three stages handing blocks over
+// through bounded rings of reusable slots (so memory use is fixed and a slow
+// stage stalls the others instead of buffering). The results of a vector are
+// the primary outputs, then the outputs of monitored gates.
+// Combinational netlists run on BitParallelSim, 512 vectors per pass;
+// netlists with registers run on CycleSim with one clock edge per vector
+// (starting from Reset(), results are read after the edge as Clock() leaves them).
+class StreamDriver {
+ public:
+  // constructor (block_vectors must be a multiple of 512, netlist must be levelized and outlive the driver)
+  explicit StreamDriver(const Netlist& TargetNetlist, const uint32_t block_vectors = 8192,
+      const uint32_t ring_slots = 4);
+
+  // destructor
+  ~StreamDriver() { /* DN */ }
+
+  // return the nets written per vector, in column order
+  const std::vector<uint32_t>& GetResultNets() const noexcept;
+
+  // stream every vector of in_path through the circuit into out_path
+  StreamStats Run(const std::string& in_path, const std::string& out_path,
+      const VectorFormat in_format = VectorFormat::Auto, const VectorFormat out_format = VectorFormat::Text);
+
+ private:
+  const Netlist* pNetlist;            // compiled circuit
+  uint32_t word_num;                  // words per column of a block
+  uint32_t slot_num;                  // blocks per ring
+  std::vector<uint32_t> result_nets;  // primary outputs, then monitored gate outputs
+};
+
+}
+
+#endif  // C_STREAM_H
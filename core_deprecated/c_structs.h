@@ -26,10 +26,15 @@
 
 // includes for this header
 #include <string>   // std::string
+#include <string_view>  // std::string_view, std::hash
 #include <cstdint>  // standard int types
 #include <utility>  // std::pair
 #include <vector>   // std::vector
+#include <memory_resource>  // std::pmr::memory_resource
 #include <cassert>  // assert()
+#include <stdexcept> // std::invalid_argument
+
+#include "c_symbols.h"  // InternSymbol()
 
 // namespace for entire project
 namespace Cim {
@@ -38,6 +43,86 @@ namespace Cim {
 class Component;
 class Gate;
 
+// define the kinds of gate
+enum class GateKind : uint8_t {
+  AND = 0,
+  OR,
+  XOR,
+  NOT,
+  NAND,
+  NOR,
+  XNOR,
+  LUT,        // arbitrary function of 0 to 6 inputs given by a truth table
+  DFF,        // edge-triggered flip-flop (D, CLK), never lowered to an instruction
+  LATCH       // level-sensitive latch (D, EN), never lowered to an instruction
+};
+
+// number of combinational gate kinds
+constexpr uint32_t kGateKindNum = static_cast<uint32_t>(GateKind::LUT) + 1;
+
+// return true for the kinds that hold state (flip-flops & latches)
+constexpr bool IsSequentialKind(const GateKind kind) noexcept {
+  return kind == GateKind::DFF || kind == GateKind::LATCH;
+}
+
+// maximum number of inputs of a LUT gate (truth table fits 64 bits)
+constexpr uint32_t kMaxLutInputs = 6;
+
+// translate a gate type string ("AND", "NOT", ...) into a gate kind
+inline GateKind ParseGateKind(const std::string& type) {
+  if (type == "AND")  return GateKind::AND;
+  if (type == "OR")   return GateKind::OR;
+  if (type == "XOR")  return GateKind::XOR;
+  if (type == "NOT")  return GateKind::NOT;
+  if (type == "NAND") return GateKind::NAND;
+  if (type == "NOR")  return GateKind::NOR;
+  if (type == "XNOR") return GateKind::XNOR;
+  if (type == "LUT")  return GateKind::LUT;
+  if (type == "DFF")  return GateKind::DFF;
+  if (type == "LATCH") return GateKind::LATCH;
+  throw std::invalid_argument("ERR: UNKNOWN GATE TYPE! \n");
+}
+
+// translate a gate kind back into its gate type string
+inline std::string GetGateKindName(const GateKind kind) {
+  switch (kind) {
+    case GateKind::AND:  return "AND";
+    case GateKind::OR:   return "OR";
+    case GateKind::XOR:  return "XOR";
+    case GateKind::NOT:  return "NOT";
+    case GateKind::NAND: return "NAND";
+    case GateKind::NOR:  return "NOR";
+    case GateKind::XNOR: return "XNOR";
+    case GateKind::LUT:  return "LUT";
+    case GateKind::DFF:  return "DFF";
+    case GateKind::LATCH: return "LATCH";
+  }
+  throw std::invalid_argument("ERR: UNKNOWN GATE KIND! \n");
+}
+
+// check the number of inputs of a gate kind
+inline void CheckGateInputs(const GateKind kind, const size_t input_size) {
+  if (kind == GateKind::NOT) {
+    if (input_size != 1) {
+      throw std::invalid_argument("ERR: NOT GATE MUST ONLY HAVE 1 INPUT! \n");
+    }
+  } else if (kind == GateKind::LUT) {
+    // a LUT without inputs is a constant
+    if (input_size > kMaxLutInputs) {
+      throw std::invalid_argument("ERR: LUT GATE MUST HAVE AT MOST 6 INPUTS! \n");
+    }
+  } else if (IsSequentialKind(kind)) {
+    // data & clock / enable
+    if (input_size != 2) {
+      throw std::invalid_argument("ERR: SEQUENTIAL ELEMENTS MUST HAVE 2 INPUTS! \n");
+    }
+  } else {
+    if (input_size < 2) {
+      throw std::invalid_argument("ERR: AT LEAST 2 INPUTS FOR THIS LOGIC GATES! \n");
+    }
+  }
+}
+
 // define data structures
 struct Pin {
   // define two directions of the pin
@@ -49,7 +134,8 @@ struct Pin {
   // link is the connection of one pin to any other pin
   typedef std::pair<Component*, uint32_t> Link;
 
-  std::string   name;           // name of the pin
+  std::pmr::string name;        // name of the pin
+  uint32_t      symbol;         // interned ID of name
   uint32_t      index;          // local index of pin in device
   bool          state;          // the CURRENT state of pin
   bool          state_changed;  // has the pin state changed
@@ -57,22 +143,79 @@ struct Pin {
 
   // Pin -> which component's which pin index?
   // take into consideration for multiple input connect to one output and vice versa
-  std::vector<Link> connections;
+  std::pmr::vector<Link> connections;
   
-  // constructor of Pin struct
-  inline Pin(const std::string& pin_name, const uint32_t pin_idx, Dir pin_dir) :
-    name{pin_name},
+  // constructor of Pin struct (name & connections are allocated from resource)
+  inline Pin(const std::string& pin_name, const uint32_t pin_idx, Dir pin_dir,
+      std::pmr::memory_resource* const resource = std::pmr::get_default_resource()) :
+    name{pin_name.data(), pin_name.size(), resource},
+    symbol{InternSymbol(pin_name)},
     index{pin_idx}, 
     state{false},
     state_changed{false},
     direction{pin_dir},
-    connections(1) {
+    connections(1, resource) {
     // default initialize the size of connections is one
     assert(connections.size() == 1 && "ERR: SIZE RESERVED FAILED! \n");
     connections.at(0) = std::make_pair<Component*, uint32_t>(nullptr, UINT32_MAX);
   }
 };
 
+// PinIndex Class
+// Hash index of the pins of one component: name -> local pin index. Slots hold
+// pin index + 1 (0 marks an empty slot) and a hit is confirmed against the
+// pin's own name, so lookups touch neither the shared symbol table nor its lock.
+class PinIndex {
+ public:
+  // constructor (empty index, slots allocated from resource)
+  explicit PinIndex(std::pmr::memory_resource* const resource = std::pmr::get_default_resource()) :
+    slots(resource) { /* DN */ }
+
+  // rebuild the index for the given pins (at most half of the slots are used)
+  inline void Build(const std::pmr::vector<Pin>& pins) {
+    size_t size = 4;
+    while (size < 2 * pins.size()) {
+      size *= 2;
+    }
+    slots.assign(size, 0);
+    for (uint32_t i = 0; i < pins.size(); i++) {
+      size_t slot = hash_of(pins[i].name) & (size - 1);
+      while (slots[slot] != 0) {
+        slot = (slot + 1) & (size - 1);
+      }
+      slots[slot] = i + 1;
+    }
+  }
+
+  // return the index of the pin called name, UINT32_MAX if there is none
+  inline uint32_t Find(const std::pmr::vector<Pin>& pins, const std::string_view name) const noexcept {
+    if (slots.empty()) {
+      return UINT32_MAX;
+    }
+    for (size_t slot = hash_of(name) & (slots.size() - 1); slots[slot] != 0; slot = (slot + 1) & (slots.size() - 1)) {
+      if (pins[slots[slot] - 1].name == name) {
+        return slots[slot] - 1;
+      }
+    }
+    return UINT32_MAX;
+  }
+
+ private:
+  // return the hash of a name
+  static size_t hash_of(const std::string_view name) noexcept {
+    return std::hash<std::string_view>{}(name);
+  }
+
+ private:
+  std::pmr::vector<uint32_t> slots;   // pin index + 1 per slot, 0 if empty (power of 2)
+};
+
+// resolved reference to one pin of a component, reused instead of the pin name
+struct PinHandle {
+  Component*    component;      // owning component
+  uint32_t      index;          // local index of pin in component
+};
+
 }
 
 #endif  // C_STRUCTS_H
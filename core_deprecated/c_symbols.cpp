@@ -0,0 +1,241 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// includes for this file
+#include "c_symbols.h"
+#include <stdexcept>
+#include <functional>   // std::hash
+#include <mutex>        // std::unique_lock
+#include <shared_mutex> // std::shared_mutex, std::shared_lock
+#include <array>        // std::array
+#include <string>       // std::string
+
+// using namespace for this project
+using namespace Cim;
+
+// constructor (empty table)
+SymbolTable::SymbolTable() :
+  pool(), offsets(1, 0), slots(16, Slot{kNone, 0}),
+  // Borrowed arrays
+  mapped{false}, pool_view(), offsets_view(), slots_view() {
+}
+
+// constructor (borrow the arrays of a table)
+SymbolTable::SymbolTable(const ArrayView<char> Pool, const ArrayView<uint32_t> Offsets,
+    const ArrayView<Slot> Slots) :
+  pool(), offsets(), slots(),
+  // Borrowed arrays
+  mapped{true}, pool_view{Pool}, offsets_view{Offsets}, slots_view{Slots} {
+  const size_t slot_num = Slots.size();
+  if (Offsets.empty() || slot_num == 0 || (slot_num & (slot_num - 1)) != 0 ||
+      Offsets[Offsets.size() - 1] != Pool.size() || (Offsets.size() - 1) * 2 > slot_num) {
+    throw std::invalid_argument("ERR: MALFORMED SYMBOL TABLE! \n");
+  }
+}
+
+// copy borrowed arrays into own storage
+void SymbolTable::detach() {
+  if (!mapped) {
+    return;
+  }
+  pool.assign(pool_view.begin(), pool_view.end());
+  offsets.assign(offsets_view.begin(), offsets_view.end());
+  slots.assign(slots_view.begin(), slots_view.end());
+  mapped = false;
+  pool_view = ArrayView<char>();
+  offsets_view = ArrayView<uint32_t>();
+  slots_view = ArrayView<Slot>();
+}
+
+// return the 32-bit hash of a name
+uint32_t SymbolTable::hash_of(const std::string_view name) noexcept {
+  const size_t hash = std::hash<std::string_view>{}(name);
+  return static_cast<uint32_t>(hash ^ (static_cast<uint64_t>(hash) >> 32));
+}
+
+// return the slot holding name, or the empty slot it would go into
+uint32_t SymbolTable::probe(const std::string_view name, const uint32_t hash) const noexcept {
+  const ArrayView<Slot> all_slots = GetSlots();
+  const uint32_t* const all_offsets = GetOffsets().data();
+  const char* const all_chars = GetPool().data();
+  const size_t mask = all_slots.size() - 1;
+  size_t slot = hash & mask;
+  for (;;) {
+    const Slot& each_slot = all_slots[slot];
+    if (each_slot.id == kNone) {
+      return slot;
+    }
+    // compare characters only when the hashes agree
+    if (each_slot.hash == hash) {
+      const uint32_t begin = all_offsets[each_slot.id];
+      if (std::string_view(all_chars + begin, all_offsets[each_slot.id + 1] - begin) == name) {
+        return slot;
+      }
+    }
+    slot = (slot + 1) & mask;
+  }
+}
+
+// double the slot array and re-insert every ID
+void SymbolTable::grow() {
+  std::vector<Slot> old_slots(slots.size() * 2, Slot{kNone, 0});
+  old_slots.swap(slots);
+  const size_t mask = slots.size() - 1;
+  for (const Slot& each_slot : old_slots) {
+    if (each_slot.id == kNone) {
+      continue;
+    }
+    size_t slot = each_slot.hash & mask;
+    while (slots[slot].id != kNone) {
+      slot = (slot + 1) & mask;
+    }
+    slots[slot] = each_slot;
+  }
+}
+
+// return the ID of a name, interning it on first use
+uint32_t SymbolTable::Intern(const std::string_view name) {
+  const uint32_t hash = hash_of(name);
+  uint32_t slot = probe(name, hash);
+  if (GetSlots()[slot].id != kNone) {
+    return GetSlots()[slot].id;
+  }
+  detach();
+  if (pool.size() + name.size() >= UINT32_MAX) {
+    throw std::length_error("ERR: SYMBOL TABLE FULL! \n");
+  }
+  const uint32_t id = GetSize();
+  pool.insert(pool.end(), name.begin(), name.end());
+  offsets.push_back(pool.size());
+  slots[slot] = Slot{id, hash};
+  // keep the load factor below 1/2
+  if ((id + 1) * 2 > slots.size()) {
+    grow();
+  }
+  return id;
+}
+
+// return the ID of a name, kNone if it was never interned
+uint32_t SymbolTable::Find(const std::string_view name) const noexcept {
+  return GetSlots()[probe(name, hash_of(name))].id;
+}
+
+// return the name of an ID
+std::string_view SymbolTable::GetString(const uint32_t id) const {
+  if (id >= GetSize()) {
+    throw std::out_of_range("ERR: SYMBOL DOES NOT EXIST! \n");
+  }
+  const uint32_t* const all_offsets = GetOffsets().data();
+  return std::string_view(GetPool().data() + all_offsets[id], all_offsets[id + 1] - all_offsets[id]);
+}
+
+// return the number of interned names
+uint32_t SymbolTable::GetSize() const noexcept {
+  return GetOffsets().size() - 1;
+}
+
+// return the bytes held by the table
+size_t SymbolTable::GetByteNum() const noexcept {
+  if (mapped) {
+    return pool_view.size() + offsets_view.size() * sizeof(uint32_t) + slots_view.size() * sizeof(Slot);
+  }
+  return pool.capacity() + offsets.capacity() * sizeof(uint32_t) + slots.capacity() * sizeof(Slot);
+}
+
+// return the characters of all names
+ArrayView<char> SymbolTable::GetPool() const noexcept {
+  return mapped ? pool_view : ArrayView<char>(pool);
+}
+
+// return ID -> begin offsets (one extra end offset)
+ArrayView<uint32_t> SymbolTable::GetOffsets() const noexcept {
+  return mapped ? offsets_view : ArrayView<uint32_t>(offsets);
+}
+
+// return the hash slots
+ArrayView<SymbolTable::Slot> SymbolTable::GetSlots() const noexcept {
+  return mapped ? slots_view : ArrayView<Slot>(slots);
+}
+
+namespace {
+
+// process-wide table and its lock
+SymbolTable& global_table() {
+  static SymbolTable table;
+  return table;
+}
+
+std::shared_mutex& global_mutex() {
+  static std::shared_mutex mutex;
+  return mutex;
+}
+
+// IDs of recently seen names, private to each thread: interned IDs never
+// change, so hits need no lock (direct mapped, a collision replaces the entry)
+struct CachedSymbol {
+  std::string name;                 // interned name
+  uint32_t id = SymbolTable::kNone; // its ID, kNone while the entry is empty
+};
+
+CachedSymbol& cached_symbol(const std::string_view name) {
+  thread_local std::array<CachedSymbol, 256> cache;
+  return cache[std::hash<std::string_view>{}(name) & (cache.size() - 1)];
+}
+
+}
+
+// return the ID of a name, interning it on first use
+uint32_t Cim::InternSymbol(const std::string_view name) {
+  CachedSymbol& cached = cached_symbol(name);
+  if (cached.id != SymbolTable::kNone && cached.name == name) {
+    return cached.id;
+  }
+  uint32_t id = SymbolTable::kNone;
+  {
+    // most names are already interned -> shared lock first
+    std::shared_lock<std::shared_mutex> lock(global_mutex());
+    id = global_table().Find(name);
+  }
+  if (id == SymbolTable::kNone) {
+    std::unique_lock<std::shared_mutex> lock(global_mutex());
+    id = global_table().Intern(name);
+  }
+  cached.name.assign(name.data(), name.size());
+  cached.id = id;
+  return id;
+}
+
+// return the ID of a name, SymbolTable::kNone if it was never interned
+uint32_t Cim::FindSymbol(const std::string_view name) {
+  CachedSymbol& cached = cached_symbol(name);
+  if (cached.id != SymbolTable::kNone && cached.name == name) {
+    return cached.id;
+  }
+  std::shared_lock<std::shared_mutex> lock(global_mutex());
+  return global_table().Find(name);
+}
+
+// return the name of an ID
+std::string Cim::GetSymbolName(const uint32_t id) {
+  std::shared_lock<std::shared_mutex> lock(global_mutex());
+  return std::string(global_table().GetString(id));
+}
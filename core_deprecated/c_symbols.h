@@ -0,0 +1,121 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// include guard for this header
+#ifndef C_SYMBOLS_H
+#define C_SYMBOLS_H
+
+// includes for this header
+#include <string>       // std::string
+#include <string_view>  // std::string_view
+#include <vector>       // std::vector
+#include <cstdint>      // standard int types
+#include "c_view.h"     // class ArrayView
+
+// namespace for entire project
+namespace Cim {
+
+// SymbolTable Class
+// Interns names to dense integer IDs. All characters live back to back in one
+// pool and lookups go through an open-addressing hash of the IDs, so a table of
+// a million names costs a handful of allocations instead of a million strings.
+// The three arrays may also be borrowed from a mapped file; such a table copies
+// them into its own storage on the first Intern() of a new name.
+class SymbolTable {
+ public:
+  // ID returned for names that are not interned
+  static constexpr uint32_t kNone = UINT32_MAX;
+
+  // one hash slot: ID and the hash of its name, so that probing rarely touches the pool
+  struct Slot {
+    uint32_t id;
+    uint32_t hash;
+  };
+
+  // constructor (empty table)
+  SymbolTable();
+
+  // constructor (borrow the arrays of a table, which must outlive this one)
+  SymbolTable(const ArrayView<char> Pool, const ArrayView<uint32_t> Offsets, const ArrayView<Slot> Slots);
+
+  // destructor
+  ~SymbolTable() { /* DN */ }
+
+  // return the ID of a name, interning it on first use
+  uint32_t Intern(const std::string_view name);
+
+  // return the ID of a name, kNone if it was never interned
+  uint32_t Find(const std::string_view name) const noexcept;
+
+  // return the name of an ID
+  std::string_view GetString(const uint32_t id) const;
+
+  // return the number of interned names
+  uint32_t GetSize() const noexcept;
+
+  // return the bytes held by the table
+  size_t GetByteNum() const noexcept;
+
+  // return the raw arrays: characters, ID -> begin offsets, hash slots
+  ArrayView<char> GetPool() const noexcept;
+  ArrayView<uint32_t> GetOffsets() const noexcept;
+  ArrayView<Slot> GetSlots() const noexcept;
+
+ private:
+  // return the 32-bit hash of a name
+  static uint32_t hash_of(const std::string_view name) noexcept;
+
+  // return the slot holding name, or the empty slot it would go into
+  uint32_t probe(const std::string_view name, const uint32_t hash) const noexcept;
+
+  // double the slot array and re-insert every ID
+  void grow();
+
+  // copy borrowed arrays into own storage
+  void detach();
+
+ private:
+  std::vector<char> pool;         // characters of all names
+  std::vector<uint32_t> offsets;  // ID -> begin in pool (one extra end offset)
+  std::vector<Slot> slots;        // hash slots holding IDs (power of 2)
+
+  // Borrowed arrays
+  bool mapped;                    // arrays below are in use instead of the vectors
+  ArrayView<char> pool_view;
+  ArrayView<uint32_t> offsets_view;
+  ArrayView<Slot> slots_view;
+};
+
+// process-wide symbol table shared by all components (thread-safe; repeated names are
+// answered from a per-thread cache without taking the lock)
+// return the ID of a name, interning it on first use
+uint32_t InternSymbol(const std::string_view name);
+
+// return the ID of a name, SymbolTable::kNone if it was never interned
+uint32_t FindSymbol(const std::string_view name);
+
+// return the name of an ID
+std::string GetSymbolName(const uint32_t id);
+
+}
+
+#endif  // C_SYMBOLS_H
@@ -0,0 +1,158 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// includes for this file
+#include "c_threads.h"
+
+// using namespace for this project
+using namespace Cim;
+
+// constructor
+SpinBarrier::SpinBarrier(const uint32_t ThreadNum) : thread_num{ThreadNum}, arrived{0}, phase{0} {
+}
+
+// block until every thread arrived
+void SpinBarrier::Wait() noexcept {
+  const uint32_t my_phase = phase.load(std::memory_order_acquire);
+  if (arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == thread_num) {
+    // last one in -> release everybody
+    arrived.store(0, std::memory_order_relaxed);
+    phase.fetch_add(1, std::memory_order_acq_rel);
+    return;
+  }
+  while (phase.load(std::memory_order_acquire) == my_phase) {
+    std::this_thread::yield();
+  }
+}
+
+// constructor (empty range)
+StealRange::StealRange() noexcept : range{0} {
+}
+
+// replace the range
+void StealRange::Reset(const uint32_t begin, const uint32_t end) noexcept {
+  range.store(static_cast<uint64_t>(end) << 32 | begin, std::memory_order_release);
+}
+
+// take the first task
+bool StealRange::PopFront(uint32_t& task) noexcept {
+  uint64_t cur = range.load(std::memory_order_acquire);
+  while (true) {
+    const uint32_t begin = static_cast<uint32_t>(cur);
+    const uint32_t end = static_cast<uint32_t>(cur >> 32);
+    if (begin >= end) {
+      return false;
+    }
+    if (range.compare_exchange_weak(cur, static_cast<uint64_t>(end) << 32 | (begin + 1),
+        std::memory_order_acq_rel)) {
+      task = begin;
+      return true;
+    }
+  }
+}
+
+// take the last task
+bool StealRange::PopBack(uint32_t& task) noexcept {
+  uint64_t cur = range.load(std::memory_order_acquire);
+  while (true) {
+    const uint32_t begin = static_cast<uint32_t>(cur);
+    const uint32_t end = static_cast<uint32_t>(cur >> 32);
+    if (begin >= end) {
+      return false;
+    }
+    if (range.compare_exchange_weak(cur, static_cast<uint64_t>(end - 1) << 32 | begin,
+        std::memory_order_acq_rel)) {
+      task = end - 1;
+      return true;
+    }
+  }
+}
+
+// constructor
+ThreadPool::ThreadPool(uint32_t ThreadNum) :
+  thread_num{0}, workers(), mutex(), wake(), done(), pJob{nullptr}, generation{0}, running{0}, stop{false} {
+  if (ThreadNum == 0) {
+    ThreadNum = std::thread::hardware_concurrency();
+  }
+  thread_num = (ThreadNum == 0) ? 1 : ThreadNum;
+  workers.reserve(thread_num - 1);
+  for (uint32_t t = 1; t < thread_num; t++) {
+    workers.emplace_back(&ThreadPool::work, this, t);
+  }
+}
+
+// destructor
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stop = true;
+  }
+  wake.notify_all();
+  for (std::thread& each_worker : workers) {
+    each_worker.join();
+  }
+}
+
+// return the number of threads
+uint32_t ThreadPool::GetThreadNum() const noexcept {
+  return this->thread_num;
+}
+
+// run job(thread index) on every thread and wait for all of them
+void ThreadPool::Run(const std::function<void(const uint32_t)>& job) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    pJob = &job;
+    running = thread_num - 1;
+    generation++;
+  }
+  wake.notify_all();
+  // the caller is thread 0
+  job(0);
+  std::unique_lock<std::mutex> lock(mutex);
+  done.wait(lock, [this] { return running == 0; });
+  pJob = nullptr;
+}
+
+// main loop of worker threads
+void ThreadPool::work(const uint32_t self) {
+  uint64_t seen = 0;
+  while (true) {
+    const std::function<void(const uint32_t)>* job = nullptr;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      wake.wait(lock, [this, seen] { return stop || generation != seen; });
+      if (stop) {
+        return;
+      }
+      seen = generation;
+      job = pJob;
+    }
+    (*job)(self);
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (--running == 0) {
+        done.notify_one();
+      }
+    }
+  }
+}
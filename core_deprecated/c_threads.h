@@ -0,0 +1,148 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// include guard for this header
+#ifndef C_THREADS_H
+#define C_THREADS_H
+
+// includes for this header
+#include <atomic>               // std::atomic
+#include <condition_variable>   // std::condition_variable
+#include <cstdint>              // standard int types
+#include <functional>           // std::function
+#include <memory>               // std::unique_ptr
+#include <mutex>                // std::mutex
+#include <thread>               // std::thread
+#include <vector>               // std::vector
+
+// namespace for entire project
+namespace Cim {
+
+// size of a cache line, used to keep per-thread data apart
+constexpr size_t kCacheLine = 64;
+
+// SpinBarrier Class
+// Sense-reversing barrier for a fixed number of threads. Waiting threads spin
+// (yielding) since the simulation phases between barriers are short.
+class SpinBarrier {
+ public:
+  // constructor
+  explicit SpinBarrier(const uint32_t ThreadNum);
+
+  // block until every thread arrived
+  void Wait() noexcept;
+
+ private:
+  const uint32_t thread_num;                          // threads to wait for
+  alignas(kCacheLine) std::atomic<uint32_t> arrived;  // threads arrived in this phase
+  alignas(kCacheLine) std::atomic<uint32_t> phase;    // incremented when the last thread arrives
+};
+
+// StealRange Class
+// Range of task indices owned by one thread. The owner pops from the front,
+// idle threads steal from the back; both ends live in one atomic word.
+class alignas(kCacheLine) StealRange {
+ public:
+  // constructor (empty range)
+  StealRange() noexcept;
+
+  // replace the range (only while no other thread pops from it)
+  void Reset(const uint32_t begin, const uint32_t end) noexcept;
+
+  // take the first / last task, false if empty
+  bool PopFront(uint32_t& task) noexcept;
+  bool PopBack(uint32_t& task) noexcept;
+
+ private:
+  std::atomic<uint64_t> range;  // begin in the low, end in the high 32 bits
+};
+
+// ThreadPool Class
+// Persistent worker threads. Run() executes one job on every thread (the caller
+// is thread 0) and returns when all of them finished; ParallelFor() spreads an
+// index range over the threads with work stealing.
+class ThreadPool {
+ public:
+  // constructor (0 -> one thread per hardware thread)
+  explicit ThreadPool(uint32_t ThreadNum = 0);
+
+  // not copyable, workers refer to the pool
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // destructor (joins the workers)
+  ~ThreadPool();
+
+  // return the number of threads, caller included
+  uint32_t GetThreadNum() const noexcept;
+
+  // run job(thread index) on every thread and wait for all of them
+  void Run(const std::function<void(const uint32_t)>& job);
+
+  // call fn(begin, end) on chunks of at most grain indices of [begin, end)
+  template <typename Function>
+  void ParallelFor(const uint32_t begin, const uint32_t end, const uint32_t grain, Function&& fn) {
+    if (end <= begin) {
+      return;
+    }
+    const uint32_t step = (grain == 0) ? 1 : grain;
+    const uint32_t chunk_num = (end - begin + step - 1) / step;
+    // each thread starts with a contiguous share of the chunks
+    std::unique_ptr<StealRange[]> ranges(new StealRange[thread_num]);
+    for (uint32_t t = 0; t < thread_num; t++) {
+      ranges[t].Reset(static_cast<uint64_t>(chunk_num) * t / thread_num,
+          static_cast<uint64_t>(chunk_num) * (t + 1) / thread_num);
+    }
+    Run([&](const uint32_t self) {
+      uint32_t chunk = 0;
+      for (uint32_t victim = self, tried = 0; tried < thread_num; ) {
+        const bool found = (victim == self) ? ranges[victim].PopFront(chunk) : ranges[victim].PopBack(chunk);
+        if (!found) {
+          victim = (victim + 1) % thread_num;
+          tried++;
+          continue;
+        }
+        const uint32_t first = begin + chunk * step;
+        fn(first, (end - first < step) ? end : first + step);
+      }
+    });
+  }
+
+ private:
+  // main loop of worker threads
+  void work(const uint32_t self);
+
+ private:
+  uint32_t thread_num;                                  // threads, caller included
+  std::vector<std::thread> workers;                     // threads 1 .. thread_num - 1
+  std::mutex mutex;                                     // guards the fields below
+  std::condition_variable wake;                         // new job or stop
+  std::condition_variable done;                         // last worker finished
+  const std::function<void(const uint32_t)>* pJob;      // current job
+  uint64_t generation;                                  // number of jobs started
+  uint32_t running;                                     // workers still in the job
+  bool stop;                                            // shut down workers
+};
+
+}
+
+#endif  // C_THREADS_H
@@ -0,0 +1,73 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// include guard for this header
+#ifndef C_VIEW_H
+#define C_VIEW_H
+
+// includes for this header
+#include <vector>       // std::vector
+#include <cstddef>      // size_t
+#include <stdexcept>    // std::out_of_range
+
+// namespace for entire project
+namespace Cim {
+
+// ArrayView Class
+// Non-owning, read-only view of contiguous elements. Arrays are handed out as
+// views so that they can live either in a std::vector or in a mapped file.
+template <typename T>
+class ArrayView {
+ public:
+  // constructor (empty view)
+  constexpr ArrayView() noexcept : ptr{nullptr}, len{0} {}
+
+  // constructor (view of size elements starting at data)
+  constexpr ArrayView(const T* const data, const size_t size) noexcept : ptr{data}, len{size} {}
+
+  // constructor (view of a whole vector)
+  ArrayView(const std::vector<T>& elements) noexcept : ptr{elements.data()}, len{elements.size()} {}
+
+  // element access
+  inline const T* data() const noexcept { return ptr; }
+  inline size_t size() const noexcept { return len; }
+  inline bool empty() const noexcept { return len == 0; }
+  inline const T& operator[](const size_t i) const noexcept { return ptr[i]; }
+  inline const T& at(const size_t i) const {
+    if (i >= len) {
+      throw std::out_of_range("ERR: INDEX OUT OF RANGE! \n");
+    }
+    return ptr[i];
+  }
+
+  // range access
+  inline const T* begin() const noexcept { return ptr; }
+  inline const T* end() const noexcept { return ptr + len; }
+
+ private:
+  const T* ptr;   // first element
+  size_t len;     // number of elements
+};
+
+}
+
+#endif  // C_VIEW_H
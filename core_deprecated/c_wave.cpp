@@ -0,0 +1,403 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// includes for this file
+#include "c_wave.h"
+#include <stdexcept>
+#include <cstring>
+#include <fstream>
+
+// using namespace for this project
+using namespace Cim;
+
+// helpers private to this file
+namespace {
+
+// first bytes of a binary change log
+constexpr char kLogMagic[8] = {'C', 'I', 'M', 'W', 'A', 'V', 'E', '1'};
+
+// return the VCD identifier of a signal (printable characters '!' .. '~')
+std::string vcd_id(uint32_t signal) {
+  std::string id;
+  do {
+    id.push_back(static_cast<char>('!' + signal % 94));
+    signal /= 94;
+  } while (signal != 0);
+  return id;
+}
+
+// append an unsigned LEB128 number
+void put_varint(std::string& out, uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+// append a little-endian 32-bit number
+void put_u32(std::string& out, const uint32_t value) {
+  for (uint32_t k = 0; k < 4; k++) {
+    out.push_back(static_cast<char>((value >> (8 * k)) & 0xff));
+  }
+}
+
+// open an output file, nullptr for an empty path
+std::FILE* open_output(const std::string& path) {
+  if (path.empty()) {
+    return nullptr;
+  }
+  std::FILE* const file = std::fopen(path.c_str(), "wb");
+  if (file == nullptr) {
+    throw std::runtime_error("ERR: CANNOT CREATE WAVEFORM FILE! \n");
+  }
+  return file;
+}
+
+}
+
+// constructor
+WaveformRecorder::WaveformRecorder(const Netlist& TargetNetlist, const std::string& vcd_path,
+    const std::string& log_path, const uint32_t buffer_changes, const uint32_t buffer_num) :
+  pNetlist{&TargetNetlist},
+  // Signals
+  signals(), last(), started{false}, closed{false}, last_time{0},
+  // Buffers
+  buffer_changes{buffer_changes}, current(), full(), spare(), in_flight{0}, mutex(), work_ready(), work_done(),
+  stop{false}, writer(),
+  // Output
+  vcd{nullptr}, log{nullptr}, ids(), text(), written_time{0}, any_written{false}, failed{false},
+  // Statistics
+  change_num{0}, stall_num{0} {
+  if (!TargetNetlist.IsLevelized()) {
+    throw std::logic_error("ERR: NETLIST MUST BE LEVELIZED! \n");
+  }
+  if (buffer_changes == 0 || buffer_num < 2) {
+    throw std::invalid_argument("ERR: WAVEFORM RECORDER NEEDS AT LEAST 2 NON-EMPTY BUFFERS! \n");
+  }
+  // outputs of monitored gates
+  for (uint32_t g = 0; g < TargetNetlist.GetGateNum(); g++) {
+    if (TargetNetlist.IsMonitored(g)) {
+      Watch(TargetNetlist.GetProgram()[g].out_net);
+    }
+  }
+  // buffers
+  current.reserve(buffer_changes);
+  spare.resize(buffer_num - 1);
+  for (std::vector<WaveChange>& each_buffer : spare) {
+    each_buffer.reserve(buffer_changes);
+  }
+  // files
+  vcd = open_output(vcd_path);
+  try {
+    log = open_output(log_path);
+  } catch (...) {
+    if (vcd != nullptr) std::fclose(vcd);
+    throw;
+  }
+}
+
+// destructor
+WaveformRecorder::~WaveformRecorder() {
+  try {
+    Close();
+  } catch (...) {
+    // write errors can only be reported by an explicit Close()
+  }
+}
+
+// watch one more net
+uint32_t WaveformRecorder::Watch(const uint32_t net) {
+  if (started) {
+    throw std::logic_error("ERR: SIGNALS MUST BE WATCHED BEFORE THE FIRST SAMPLE! \n");
+  }
+  if (net >= pNetlist->GetNetNum()) {
+    throw std::out_of_range("ERR: NET DOES NOT EXIST! \n");
+  }
+  signals.push_back(net);
+  last.push_back(2);
+  return signals.size() - 1;
+}
+
+// return the number of watched nets
+uint32_t WaveformRecorder::GetSignalNum() const noexcept {
+  return this->signals.size();
+}
+
+// return the net of a signal
+uint32_t WaveformRecorder::GetSignalNet(const uint32_t signal) const {
+  return this->signals.at(signal);
+}
+
+// record the watched nets of a byte-per-net state array
+void WaveformRecorder::Sample(const uint64_t time, const std::vector<uint8_t>& nets) {
+  if (nets.size() < pNetlist->GetNetNum()) {
+    throw std::invalid_argument("ERR: STATE ARRAY TOO SHORT! \n");
+  }
+  const uint8_t* const states = nets.data();
+  Sample(time, [states](const uint32_t net) { return states[net] != 0; });
+}
+
+// check the sample time, start the writer on the first sample
+void WaveformRecorder::begin_sample(const uint64_t time) {
+  if (closed) {
+    throw std::logic_error("ERR: WAVEFORM RECORDER IS CLOSED! \n");
+  }
+  if (started) {
+    if (time < last_time) {
+      throw std::invalid_argument("ERR: SAMPLE TIME MUST NOT DECREASE! \n");
+    }
+    last_time = time;
+    return;
+  }
+  started = true;
+  last_time = time;
+  write_headers();
+  writer = std::thread(&WaveformRecorder::write_loop, this);
+}
+
+// hand the current buffer to the writer, take a free one
+void WaveformRecorder::submit() {
+  std::unique_lock<std::mutex> lock(mutex);
+  full.push_back(std::move(current));
+  work_ready.notify_one();
+  if (spare.empty()) {
+    stall_num++;
+    work_done.wait(lock, [this] { return !spare.empty(); });
+  }
+  current = std::move(spare.back());
+  spare.pop_back();
+  current.clear();
+}
+
+// hand all recorded changes to the writer and wait until they are written
+void WaveformRecorder::Flush() {
+  if (!started || closed) {
+    return;
+  }
+  if (!current.empty()) {
+    submit();
+  }
+  std::unique_lock<std::mutex> lock(mutex);
+  work_done.wait(lock, [this] { return full.empty() && in_flight == 0; });
+  // the writer is idle until the next submit
+  if (vcd != nullptr) std::fflush(vcd);
+  if (log != nullptr) std::fflush(log);
+  if (failed) {
+    throw std::runtime_error("ERR: CANNOT WRITE WAVEFORM FILE! \n");
+  }
+}
+
+// write the remaining changes, stop the writer and close the files
+void WaveformRecorder::Close() {
+  if (closed) {
+    return;
+  }
+  closed = true;
+  if (started) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!current.empty()) {
+        full.push_back(std::move(current));
+      }
+      stop = true;
+    }
+    work_ready.notify_one();
+    writer.join();
+  }
+  bool ok = !failed;
+  if (vcd != nullptr) ok &= (std::fclose(vcd) == 0);
+  if (log != nullptr) ok &= (std::fclose(log) == 0);
+  vcd = nullptr;
+  log = nullptr;
+  if (!ok) {
+    throw std::runtime_error("ERR: CANNOT WRITE WAVEFORM FILE! \n");
+  }
+}
+
+// return the number of recorded changes
+uint64_t WaveformRecorder::GetChangeNum() const noexcept {
+  return this->change_num;
+}
+
+// return how often the simulation waited for a free buffer
+uint64_t WaveformRecorder::GetStallNum() const noexcept {
+  return this->stall_num;
+}
+
+// writer thread: format & write buffers until closed
+void WaveformRecorder::write_loop() {
+  std::unique_lock<std::mutex> lock(mutex);
+  for (;;) {
+    work_ready.wait(lock, [this] { return !full.empty() || stop; });
+    if (full.empty()) {
+      return;
+    }
+    std::vector<WaveChange> buffer = std::move(full.front());
+    full.pop_front();
+    in_flight++;
+    lock.unlock();
+    write_changes(buffer);
+    buffer.clear();
+    lock.lock();
+    spare.push_back(std::move(buffer));
+    in_flight--;
+    work_done.notify_all();
+  }
+}
+
+// write the file headers
+void WaveformRecorder::write_headers() {
+  ids.resize(signals.size());
+  for (uint32_t s = 0; s < signals.size(); s++) {
+    ids[s] = vcd_id(s);
+  }
+  // signal name: gate name, else net name, else the net index
+  std::vector<std::string> names(signals.size());
+  for (uint32_t s = 0; s < signals.size(); s++) {
+    const uint32_t driver = pNetlist->GetNetDriver(signals[s]);
+    std::string_view name = (driver != UINT32_MAX) ? pNetlist->GetGateName(driver) : std::string_view();
+    if (name.empty()) {
+      name = pNetlist->GetNetName(signals[s]);
+    }
+    names[s] = name.empty() ? ("n" + std::to_string(signals[s])) : std::string(name);
+    for (char& c : names[s]) {
+      if (c == ' ' || c == '\t' || c == '\n' || c == '\r') c = '_';
+    }
+  }
+
+  if (vcd != nullptr) {
+    text = "$version circuit-sim $end\n$timescale 1ns $end\n$scope module netlist $end\n";
+    for (uint32_t s = 0; s < signals.size(); s++) {
+      text += "$var wire 1 " + ids[s] + " " + names[s] + " $end\n";
+    }
+    text += "$upscope $end\n$enddefinitions $end\n";
+    failed |= (std::fwrite(text.data(), 1, text.size(), vcd) != text.size());
+  }
+  if (log != nullptr) {
+    text.assign(kLogMagic, sizeof(kLogMagic));
+    put_u32(text, signals.size());
+    for (uint32_t s = 0; s < signals.size(); s++) {
+      put_u32(text, signals[s]);
+      put_u32(text, names[s].size());
+      text += names[s];
+    }
+    failed |= (std::fwrite(text.data(), 1, text.size(), log) != text.size());
+  }
+}
+
+// write one buffer of changes
+void WaveformRecorder::write_changes(const std::vector<WaveChange>& changes) {
+  if (vcd != nullptr) {
+    text.clear();
+    uint64_t time = written_time;
+    bool any = any_written;
+    for (const WaveChange& each_change : changes) {
+      if (!any || each_change.time != time) {
+        text += '#';
+        text += std::to_string(each_change.time);
+        text += '\n';
+        time = each_change.time;
+        any = true;
+      }
+      text += static_cast<char>('0' + each_change.value);
+      text += ids[each_change.signal];
+      text += '\n';
+    }
+    failed |= (std::fwrite(text.data(), 1, text.size(), vcd) != text.size());
+  }
+  if (log != nullptr) {
+    // time advance: (delta << 1) | 1, change: (signal << 2) | (value << 1)
+    text.clear();
+    uint64_t time = written_time;
+    bool any = any_written;
+    for (const WaveChange& each_change : changes) {
+      if (!any || each_change.time != time) {
+        put_varint(text, ((each_change.time - time) << 1) | 1);
+        time = each_change.time;
+        any = true;
+      }
+      put_varint(text, (uint64_t{each_change.signal} << 2) | (uint64_t{each_change.value} << 1));
+    }
+    failed |= (std::fwrite(text.data(), 1, text.size(), log) != text.size());
+  }
+  if (!changes.empty()) {
+    written_time = changes.back().time;
+    any_written = true;
+  }
+}
+
+// read a binary change log
+std::vector<WaveChange> Cim::ReadChangeLog(const std::string& path, std::vector<uint32_t>* const nets) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    throw std::runtime_error("ERR: CANNOT OPEN WAVEFORM FILE! \n");
+  }
+  const std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  size_t pos = 0;
+  auto damaged = []() { return std::runtime_error("ERR: WAVEFORM FILE DAMAGED! \n"); };
+  auto get_u32 = [&]() {
+    if (pos + 4 > data.size()) throw damaged();
+    uint32_t value = 0;
+    for (uint32_t k = 0; k < 4; k++) value |= uint32_t{static_cast<uint8_t>(data[pos++])} << (8 * k);
+    return value;
+  };
+  auto get_varint = [&]() {
+    uint64_t value = 0;
+    for (uint32_t shift = 0; ; shift += 7) {
+      if (pos >= data.size() || shift > 63) throw damaged();
+      const uint8_t byte = static_cast<uint8_t>(data[pos++]);
+      value |= uint64_t{byte & 0x7fu} << shift;
+      if ((byte & 0x80) == 0) return value;
+    }
+  };
+
+  // header
+  if (data.size() < sizeof(kLogMagic) || std::memcmp(data.data(), kLogMagic, sizeof(kLogMagic)) != 0) {
+    throw std::runtime_error("ERR: NOT A WAVEFORM FILE! \n");
+  }
+  pos = sizeof(kLogMagic);
+  const uint32_t signal_num = get_u32();
+  if (nets != nullptr) nets->clear();
+  for (uint32_t s = 0; s < signal_num; s++) {
+    const uint32_t net = get_u32();
+    const uint32_t name_size = get_u32();
+    if (pos + name_size > data.size()) throw damaged();
+    pos += name_size;
+    if (nets != nullptr) nets->push_back(net);
+  }
+
+  // changes
+  std::vector<WaveChange> changes;
+  uint64_t time = 0;
+  while (pos < data.size()) {
+    const uint64_t code = get_varint();
+    if (code & 1) {
+      time += code >> 1;
+      continue;
+    }
+    const uint64_t signal = code >> 2;
+    if (signal >= signal_num) throw damaged();
+    changes.push_back(WaveChange{time, static_cast<uint32_t>(signal), static_cast<uint32_t>((code >> 1) & 1)});
+  }
+  return changes;
+}
@@ -0,0 +1,172 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2023 Wanxuan Li
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+// include guard for this header
+#ifndef C_WAVE_H
+#define C_WAVE_H
+
+// includes for this header
+#include <string>               // std::string
+#include <vector>               // std::vector
+#include <deque>                // std::deque
+#include <cstdio>               // std::FILE
+#include <cstdint>              // standard int types
+#include <thread>               // std::thread
+#include <mutex>                // std::mutex
+#include <condition_variable>   // std::condition_variable
+#include "c_netlist.h"          // class Netlist
+
+// namespace for entire project
+namespace Cim {
+
+// one recorded value change
+struct WaveChange {
+  uint64_t time;      // time of the change
+  uint32_t signal;    // index of the signal in the recorder
+  uint32_t value;     // new value (0 / 1)
+};
+
+// WaveformRecorder Class
+// Records value changes of watched nets (by default the outputs of monitored
+// gates) and writes them as a VCD file and/or a compact binary change log.
+// The simulation thread only compares states and appends changes to its own
+// buffer; full buffers are handed to a background thread that formats and
+// writes them, so tracing does not wait for file I/O unless every buffer is in
+// flight. Each recorder belongs to one simulation thread; simulations running
+// on other threads use their own recorders.
+class WaveformRecorder {
+ public:
+  // constructor (an empty path disables that output)
+  WaveformRecorder(const Netlist& TargetNetlist, const std::string& vcd_path, const std::string& log_path = "",
+      const uint32_t buffer_changes = 1u << 16, const uint32_t buffer_num = 4);
+
+  // destructor (closes the outputs)
+  ~WaveformRecorder();
+
+  // no copy
+  WaveformRecorder(const WaveformRecorder&) = delete;
+  WaveformRecorder& operator=(const WaveformRecorder&) = delete;
+
+  // watch one more net (before the first sample), returns its signal index
+  uint32_t Watch(const uint32_t net);
+
+  // return the number of watched nets / the net of a signal
+  uint32_t GetSignalNum() const noexcept;
+  uint32_t GetSignalNet(const uint32_t signal) const;
+
+  // record the watched nets of a byte-per-net state array at a time (non-decreasing)
+  void Sample(const uint64_t time, const std::vector<uint8_t>& nets);
+
+  // record the watched nets at a time, get_state(net) returns the state of a net
+  template <typename GetState>
+  void Sample(const uint64_t time, GetState get_state);
+
+  // hand all recorded changes to the writer and wait until they are written
+  void Flush();
+
+  // write the remaining changes, stop the writer and close the files
+  void Close();
+
+  // return the number of recorded changes
+  uint64_t GetChangeNum() const noexcept;
+
+  // return how often the simulation waited for a free buffer
+  uint64_t GetStallNum() const noexcept;
+
+ private:
+  // check the sample time, start the writer on the first sample
+  void begin_sample(const uint64_t time);
+
+  // append one change to the current buffer
+  inline void record(const uint64_t time, const uint32_t signal, const uint8_t value) {
+    current.push_back(WaveChange{time, signal, value});
+    if (current.size() == buffer_changes) {
+      submit();
+    }
+  }
+
+  // hand the current buffer to the writer, take a free one
+  void submit();
+
+  // writer thread: format & write buffers until closed
+  void write_loop();
+
+  // write the file headers / one buffer of changes
+  void write_headers();
+  void write_changes(const std::vector<WaveChange>& changes);
+
+ private:
+  const Netlist* pNetlist;                    // recorded circuit
+
+  // Signals
+  std::vector<uint32_t> signals;              // signal -> net
+  std::vector<uint8_t> last;                  // signal -> last recorded value (2 = none yet)
+  bool started;                               // first sample taken
+  bool closed;                                // Close() called
+  uint64_t last_time;                         // time of the last sample
+
+  // Buffers
+  uint32_t buffer_changes;                    // changes per buffer
+  std::vector<WaveChange> current;            // buffer being filled
+  std::deque<std::vector<WaveChange>> full;   // buffers waiting for the writer
+  std::vector<std::vector<WaveChange>> spare; // empty buffers
+  uint32_t in_flight;                         // buffers held by the writer
+  std::mutex mutex;                           // guards full, spare, in_flight, stop
+  std::condition_variable work_ready;         // writer: a buffer is waiting / stop
+  std::condition_variable work_done;          // simulation: a buffer was written
+  bool stop;                                  // writer should exit once drained
+  std::thread writer;                         // background writer
+
+  // Output (writer thread only)
+  std::FILE* vcd;                             // VCD file
+  std::FILE* log;                             // binary change log
+  std::vector<std::string> ids;               // signal -> VCD identifier
+  std::string text;                           // formatting buffer
+  uint64_t written_time;                      // last time stamp written
+  bool any_written;                           // a time stamp was written
+  bool failed;                                // a write failed
+
+  // Statistics
+  uint64_t change_num;                        // recorded changes
+  uint64_t stall_num;                         // waits for a free buffer
+};
+
+// record the watched nets at a time
+template <typename GetState>
+void WaveformRecorder::Sample(const uint64_t time, GetState get_state) {
+  begin_sample(time);
+  for (uint32_t s = 0; s < signals.size(); s++) {
+    const uint8_t value = get_state(signals[s]) ? 1 : 0;
+    if (value != last[s]) {
+      last[s] = value;
+      change_num++;
+      record(time, s, value);
+    }
+  }
+}
+
+// read a binary change log, optionally returning the net of every signal
+std::vector<WaveChange> ReadChangeLog(const std::string& path, std::vector<uint32_t>* const nets = nullptr);
+
+}
+
+#endif  // C_WAVE_H
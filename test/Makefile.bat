@@ -1,5 +1,5 @@
 @echo off
 echo Compilation started...
-echo g++ -g -std=c++17 -I../core t_main.cpp ../core/c_gate.cpp -o t_main.exe
-g++ -g -std=c++17 -I../core t_main.cpp ../core/c_gate.cpp -o t_main.exe
+echo g++ -g -std=c++17 -pthread -I../core_deprecated t_main.cpp ../core_deprecated/c_gate.cpp ../core_deprecated/c_symbols.cpp ../core_deprecated/c_netlist.cpp ../core_deprecated/c_levelized.cpp ../core_deprecated/c_event.cpp ../core_deprecated/c_bitsim.cpp ../core_deprecated/c_store.cpp ../core_deprecated/c_arena.cpp ../core_deprecated/c_threads.cpp ../core_deprecated/c_parallel.cpp ../core_deprecated/c_import.cpp ../core_deprecated/c_cache.cpp ../core_deprecated/c_wave.cpp ../core_deprecated/c_sequential.cpp ../core_deprecated/c_cycle.cpp ../core_deprecated/c_fault.cpp ../core_deprecated/c_optimize.cpp ../core_deprecated/c_native.cpp ../core_deprecated/c_incremental.cpp ../core_deprecated/c_profile.cpp ../core_deprecated/c_logic4.cpp ../core_deprecated/c_snapshot.cpp ../core_deprecated/c_device.cpp ../core_deprecated/c_stream.cpp ../core_deprecated/c_exhaustive.cpp ../core_deprecated/c_bdd.cpp -o t_main.exe
+g++ -g -std=c++17 -pthread -I../core_deprecated t_main.cpp ../core_deprecated/c_gate.cpp ../core_deprecated/c_symbols.cpp ../core_deprecated/c_netlist.cpp ../core_deprecated/c_levelized.cpp ../core_deprecated/c_event.cpp ../core_deprecated/c_bitsim.cpp ../core_deprecated/c_store.cpp ../core_deprecated/c_arena.cpp ../core_deprecated/c_threads.cpp ../core_deprecated/c_parallel.cpp ../core_deprecated/c_import.cpp ../core_deprecated/c_cache.cpp ../core_deprecated/c_wave.cpp ../core_deprecated/c_sequential.cpp ../core_deprecated/c_cycle.cpp ../core_deprecated/c_fault.cpp ../core_deprecated/c_optimize.cpp ../core_deprecated/c_native.cpp ../core_deprecated/c_incremental.cpp ../core_deprecated/c_profile.cpp ../core_deprecated/c_logic4.cpp ../core_deprecated/c_snapshot.cpp ../core_deprecated/c_device.cpp ../core_deprecated/c_stream.cpp ../core_deprecated/c_exhaustive.cpp ../core_deprecated/c_bdd.cpp -o t_main.exe
 echo Compilation ended...
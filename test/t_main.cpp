@@ -20,8 +20,1997 @@
 //  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
 //  DEALINGS IN THE SOFTWARE.
 
+// the tests are asserts, keep them in optimized builds
+#undef NDEBUG
+
 #include "c_gate.h"
+#include "c_netlist.h"
+#include "c_levelized.h"
+#include "c_event.h"
+#include "c_bitsim.h"
+#include "c_store.h"
+#include "c_arena.h"
+#include "c_parallel.h"
+#include "c_import.h"
+#include "c_cache.h"
+#include "c_wave.h"
+#include "c_sequential.h"
+#include "c_cycle.h"
+#include "c_fault.h"
+#include "c_optimize.h"
+#include "c_native.h"
+#include "c_incremental.h"
+#include "c_profile.h"
+#include "c_logic4.h"
+#include "c_snapshot.h"
+#include "c_device.h"
+#include "c_stream.h"
+#include "c_exhaustive.h"
+#include "c_bdd.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <random>
+#include <algorithm>
+#include <numeric>
+#include <bitset>
+#include <cassert>
+#include <thread>
+
+// connect an output pin to an input pin (link stored on both sides)
+static void Connect(Cim::Component& from, const uint32_t out_pin, Cim::Component& to, const uint32_t in_pin) {
+  from.GetPinConnection(out_pin).push_back(Cim::Pin::Link{&to, in_pin});
+  to.GetPinConnection(in_pin).at(0) = Cim::Pin::Link{&from, out_pin};
+}
+
+// full adder: sum = a ^ b ^ cin, cout = (a & b) | (cin & (a ^ b))
+struct FullAdder {
+  Cim::Gate x1{nullptr, "x1", "XOR", {"A", "B"}};
+  Cim::Gate x2{nullptr, "x2", "XOR", {"IN1", "CIN"}, true};
+  Cim::Gate a1{nullptr, "a1", "AND", {"A", "B"}};
+  Cim::Gate a2{nullptr, "a2", "AND", {"IN1", "CIN"}};
+  Cim::Gate o1{nullptr, "o1", "OR", {"IN1", "IN2"}, true};
+
+  FullAdder() {
+    Connect(x1, 2, x2, 0);
+    Connect(x1, 2, a2, 0);
+    Connect(a1, 2, o1, 0);
+    Connect(a2, 2, o1, 1);
+  }
+
+  // gates are listed out of order on purpose
+  std::vector<Cim::Component*> Gates() {
+    return {&o1, &a2, &x2, &a1, &x1};
+  }
+
+  // drive the primary input pins
+  void Drive(const bool a, const bool b, const bool cin) {
+    x1.Set("A", a); x1.Set("B", b);
+    a1.Set("A", a); a1.Set("B", b);
+    x2.Set("CIN", cin); a2.Set("CIN", cin);
+  }
+};
+
+static void TestLevelized() {
+  FullAdder fa;
+  Cim::Netlist netlist(fa.Gates());
+  assert(netlist.GetGateNum() == 5);
+  assert(netlist.GetLevelNum() == 3);
+  assert(netlist.GetOutputs().size() == 2);
+
+  Cim::LevelizedSim sim(netlist);
+  for (uint32_t v = 0; v < 8; v++) {
+    const bool a = v & 1, b = v & 2, cin = v & 4;
+    fa.Drive(a, b, cin);
+    sim.ReadInputs();
+    sim.Evaluate();
+    sim.WriteBack();
+    assert(fa.x2.GetPinState(2) == ((a + b + cin) % 2 == 1));
+    assert(fa.o1.GetPinState(2) == (a + b + cin >= 2));
+  }
+}
+
+static void TestEvent() {
+  FullAdder fa;
+  Cim::Netlist netlist(fa.Gates());
+  Cim::EventSim sim(netlist);
+  sim.SetDelay(Cim::GateKind::XOR, 3);
+  // gray code -> one input toggles per step
+  const uint32_t gray[8] = {0, 1, 3, 2, 6, 7, 5, 4};
+  for (const uint32_t v : gray) {
+    const bool a = v & 1, b = v & 2, cin = v & 4;
+    fa.Drive(a, b, cin);
+    sim.ApplyPinChanges();
+    sim.Run();
+    assert(sim.IsStable());
+    sim.WriteBack();
+    assert(fa.x2.GetPinState(2) == ((a + b + cin) % 2 == 1));
+    assert(fa.o1.GetPinState(2) == (a + b + cin >= 2));
+  }
+  // never more work than re-evaluating every gate per step
+  assert(sim.GetEvaluationNum() <= 8 * netlist.GetGateNum());
+  // registers have no propagation delay
+  uint32_t refused = 0;
+  try {
+    sim.SetDelay(Cim::GateKind::LATCH, 5);
+  } catch (const std::invalid_argument&) {
+    refused++;
+  }
+  try {
+    sim.GetDelay(Cim::GateKind::DFF);
+  } catch (const std::invalid_argument&) {
+    refused++;
+  }
+  assert(refused == 2 && sim.GetDelay(Cim::GateKind::XOR) == 3 && sim.GetDelay(Cim::GateKind::LUT) == 1);
+  // events after the horizon stay pending
+  Cim::Netlist inv;
+  const uint32_t a = inv.AddNet(), y = inv.AddNet();
+  inv.AddGate(Cim::GateKind::NOT, {a}, y);
+  inv.AddOutput(y);
+  inv.Levelize();
+  Cim::EventSim slow(inv);
+  slow.SetDelay(Cim::GateKind::NOT, 5);
+  assert(slow.GetState(y));
+  slow.SetInput(a, true);
+  slow.Run(2);
+  assert(slow.GetTime() == 3 && !slow.IsStable() && slow.GetState(a) && slow.GetState(y));
+  slow.Run();
+  assert(slow.GetTime() == 6 && slow.IsStable() && !slow.GetState(y));
+}
+
+static void TestBitParallel() {
+  FullAdder fa;
+  Cim::Netlist netlist(fa.Gates());
+  Cim::LevelizedSim ref(netlist);
+  const Cim::ArrayView<uint32_t> inputs = netlist.GetInputs();
+  for (const uint32_t patterns : {64u, 256u, 512u}) {
+    for (const auto isa : {Cim::BitParallelSim::Isa::Scalar, Cim::BitParallelSim::Isa::AVX2,
+        Cim::BitParallelSim::Isa::AVX512}) {
+      Cim::BitParallelSim sim(netlist, patterns, isa);
+      sim.Randomize(patterns);
+      sim.Evaluate();
+      // every pattern must match the scalar engine
+      for (uint32_t p = 0; p < patterns; p++) {
+        for (const uint32_t each_net : inputs) {
+          ref.SetInput(each_net, sim.GetState(each_net, p));
+        }
+        ref.Evaluate();
+        for (const uint32_t each_net : netlist.GetOutputs()) {
+          assert(sim.GetState(each_net, p) == ref.GetState(each_net));
+        }
+      }
+    }
+  }
+}
+
+static void TestStore() {
+  FullAdder fa;
+  Cim::NetlistStore store(fa.Gates());
+  const Cim::Netlist& netlist = store.GetNetlist();
+  Cim::LevelizedSim sim(netlist);
+  Cim::Component* const x2 = store.FindComponent("x2");
+  Cim::Component* const o1 = store.FindComponent("o1");
+  assert(x2 != nullptr && o1 != nullptr && store.FindComponent("none") == nullptr);
+  assert(x2->GetType() == "XOR" && x2->GetPinName(1) == "CIN" && x2->IsMonitored());
+  assert(o1->IsPinConnected(0) && !o1->IsPinConnected(2));
+  for (uint32_t v = 0; v < 8; v++) {
+    const bool a = v & 1, b = v & 2, cin = v & 4;
+    sim.SetInput(netlist.GetPinNet(&fa.x1, 0), a);
+    sim.SetInput(netlist.GetPinNet(&fa.x1, 1), b);
+    sim.SetInput(netlist.GetPinNet(&fa.a1, 0), a);
+    sim.SetInput(netlist.GetPinNet(&fa.a1, 1), b);
+    sim.SetInput(netlist.GetPinNet(&fa.x2, 1), cin);
+    sim.SetInput(netlist.GetPinNet(&fa.a2, 1), cin);
+    sim.Evaluate();
+    store.SetStates(sim.GetStates());
+    assert(x2->GetPinState(2) == ((a + b + cin) % 2 == 1));
+    assert(o1->GetPinState(2) == (a + b + cin >= 2));
+  }
+  // views are wired to each other, read only
+  const Cim::Component* const o1_view = o1;
+  assert(o1_view->GetPinConnection(0).at(0).first == store.FindComponent("a1"));
+  bool refused = false;
+  try {
+    o1->GetPinConnection(0).at(0) = Cim::Pin::Link{nullptr, UINT32_MAX};
+  } catch (const std::logic_error&) {
+    refused = true;
+  }
+  assert(refused && o1_view->GetPinConnection(0).at(0).first == store.FindComponent("a1"));
+}
+
+static void TestHandles() {
+  Cim::Gate g(nullptr, "g", "NAND", {"A", "B", "C"});
+  const Cim::PinHandle b = g.ResolvePin("B");
+  assert(b.component == &g && b.index == 1);
+  Cim::Set(b, true);
+  assert(g.GetPinState(1) && Cim::GetPinState(b));
+  assert(g.GetPinIndex("C") == 2 && !g.DoesPinExist("never_interned_name"));
+
+  // wide gate: every pin found through the per-component index
+  std::vector<std::string> wide_names;
+  for (uint32_t i = 0; i < 40; i++) {
+    wide_names.push_back("IN" + std::to_string(i));
+  }
+  Cim::Gate wide(nullptr, "wide", "AND", wide_names);
+  for (uint32_t i = 0; i < 40; i++) {
+    assert(wide.GetPinIndex(wide_names[i]) == i);
+  }
+  assert(wide.GetPinIndex("out") == 40 && !wide.DoesPinExist("IN40"));
+
+  // symbols interned from several threads agree on the IDs
+  std::vector<uint32_t> ids(4 * 64);
+  std::vector<std::thread> workers;
+  for (uint32_t t = 0; t < 4; t++) {
+    workers.emplace_back([&ids, t]() {
+      for (uint32_t k = 0; k < 64; k++) {
+        ids[t * 64 + k] = Cim::InternSymbol("handle_symbol_" + std::to_string(k));
+      }
+    });
+  }
+  for (std::thread& each_worker : workers) each_worker.join();
+  for (uint32_t k = 0; k < 4 * 64; k++) {
+    assert(ids[k] == ids[k % 64] && Cim::FindSymbol("handle_symbol_" + std::to_string(k % 64)) == ids[k]);
+  }
+
+  FullAdder fa;
+  Cim::NetlistStore store(fa.Gates());
+  const Cim::Netlist& netlist = store.GetNetlist();
+  assert(netlist.FindGate("o1") == netlist.GetGateIndex(&fa.o1));
+  assert(netlist.FindNet("x2.CIN") == netlist.GetPinNet(&fa.x2, 1));
+  const Cim::PinHandle cin = store.ResolvePin("a2", "CIN");
+  Cim::Set(cin, true);
+  assert(store.GetNetState(netlist.GetPinNet(&fa.a2, 1)));
+}
+
+static void TestPinViews() {
+  Cim::Gate g(nullptr, "g", "OR", {"A", "B", "C"});
+  g.Set("A", true);
+  g.Set("C", true);
+  uint32_t count = 0;
+  for (const Cim::PinRef pin : g.GetInPins()) {
+    assert(pin.GetDirection() == Cim::Pin::Dir::Input && pin.index == count);
+    count++;
+  }
+  assert(count == 3 && g.GetInPins()[1].GetName() == "B");
+  assert(g.GetOutPins().size() == 1 && g.GetOutPins()[0].GetName() == "out");
+  assert(g.GetInPinStates() == 0x5);
+
+  FullAdder fa;
+  Cim::NetlistStore store(fa.Gates());
+  Cim::Component* const a2 = store.FindComponent("a2");
+  a2->Set("CIN", true);
+  assert(a2->GetInPinStates() == 0x2 && a2->GetInPins()[1].IsStateChanged());
+}
+
+static void TestKinds() {
+  // every basic kind at fixed (2..4) and any (5) arity against a direct count
+  const char* const types[] = {"AND", "OR", "XOR", "NAND", "NOR", "XNOR"};
+  for (const char* const type : types) {
+    for (uint32_t n = 2; n <= 5; n++) {
+      std::vector<std::string> pins;
+      for (uint32_t k = 0; k < n; k++) {
+        pins.push_back("I" + std::to_string(k));
+      }
+      Cim::Gate g(nullptr, "g", type, pins);
+      const Cim::GateKind kind = g.GetKind();
+      for (uint32_t v = 0; v < (1u << n); v++) {
+        uint32_t ones = 0;
+        for (uint32_t k = 0; k < n; k++) {
+          g.Set(k, (v >> k) & 1);
+          ones += (v >> k) & 1;
+        }
+        bool expect = false;
+        switch (kind) {
+          case Cim::GateKind::AND:  expect = ones == n; break;
+          case Cim::GateKind::OR:   expect = ones != 0; break;
+          case Cim::GateKind::XOR:  expect = ones % 2 == 1; break;
+          case Cim::GateKind::NAND: expect = ones != n; break;
+          case Cim::GateKind::NOR:  expect = ones == 0; break;
+          case Cim::GateKind::XNOR: expect = ones % 2 == 0; break;
+          default: assert(false);
+        }
+        assert(g.Evaluate() == expect);
+      }
+    }
+  }
+
+  // LUT3 majority feeding a NOT, checked by all engines
+  Cim::Gate maj(nullptr, "maj", 0xE8, {"A", "B", "C"});
+  Cim::Gate inv(nullptr, "inv", "NOT", {"IN"}, true);
+  Connect(maj, 3, inv, 0);
+  assert(maj.GetType() == "LUT" && maj.GetTruthTable() == 0xE8);
+  Cim::Netlist netlist({&maj, &inv});
+  Cim::LevelizedSim sim(netlist);
+  Cim::BitParallelSim bits(netlist, 256);
+  for (uint32_t v = 0; v < 8; v++) {
+    for (uint32_t k = 0; k < 3; k++) {
+      maj.Set(k, (v >> k) & 1);
+      bits.SetInput(netlist.GetPinNet(&maj, k), v, (v >> k) & 1);
+    }
+    sim.ReadInputs();
+    sim.Evaluate();
+    const bool majority = (v == 3 || v >= 5);
+    assert(maj.Evaluate() == majority);
+    assert(sim.GetState(netlist.GetPinNet(&inv, 1)) == !majority);
+  }
+  bits.Evaluate();
+  for (uint32_t v = 0; v < 8; v++) {
+    assert(bits.GetState(netlist.GetPinNet(&inv, 1), v) == !(v == 3 || v >= 5));
+  }
+}
+
+static void TestArena() {
+  Cim::Arena arena(4096);
+  Cim::Gate* const n1 = arena.Create<Cim::Gate>(nullptr, "n1", "NAND", std::vector<std::string>{"A", "B"},
+      false, &arena);
+  Cim::Gate* const n2 = arena.Create<Cim::Gate>(nullptr, "n2_with_a_name_longer_than_sso", "NOT",
+      std::vector<std::string>{"IN"}, true, &arena);
+  Connect(*n1, 2, *n2, 0);
+  assert(arena.GetUsedByteNum() > 2 * sizeof(Cim::Gate) && arena.GetReservedByteNum() >= 4096);
+  assert(n2->GetName() == "n2_with_a_name_longer_than_sso" && n2->GetPinName(0) == "IN");
+
+  Cim::Netlist netlist({n1, n2});
+  Cim::LevelizedSim sim(netlist);
+  n1->Set("A", true);
+  n1->Set("B", true);
+  sim.ReadInputs();
+  sim.Evaluate();
+  assert(sim.GetState(netlist.GetPinNet(n2, 1)));
+  arena.Release();
+  assert(arena.GetUsedByteNum() == 0 && arena.GetReservedByteNum() == 0);
+}
+
+// random DAG: every gate reads earlier nets only, window keeps the levels wide
+static void RandomNetlist(Cim::Netlist& netlist, const uint32_t input_num, const uint32_t gate_num,
+    uint32_t seed) {
+  auto next = [&seed]() { seed = seed * 1664525u + 1013904223u; return seed >> 8; };
+  std::vector<uint32_t> nets;
+  for (uint32_t i = 0; i < input_num; i++) {
+    nets.push_back(netlist.AddNet());
+  }
+  for (uint32_t g = 0; g < gate_num; g++) {
+    const Cim::GateKind kind = static_cast<Cim::GateKind>(next() % 8);
+    const uint32_t arity = (kind == Cim::GateKind::NOT) ? 1 : 2 + next() % 4;
+    const uint32_t window = (nets.size() < 4 * input_num) ? nets.size() : 4 * input_num;
+    std::vector<uint32_t> fanin;
+    for (uint32_t k = 0; k < arity; k++) {
+      fanin.push_back(nets[nets.size() - 1 - next() % window]);
+    }
+    const uint32_t out = netlist.AddNet();
+    if (kind == Cim::GateKind::LUT) {
+      netlist.AddLut((uint64_t{next()} << 32) | next(), fanin, out);
+    } else {
+      netlist.AddGate(kind, fanin, out);
+    }
+    nets.push_back(out);
+  }
+  for (uint32_t i = 0; i < input_num; i++) {
+    netlist.AddOutput(nets[nets.size() - 1 - i]);
+  }
+  netlist.Levelize();
+}
+
+static void TestParallel() {
+  Cim::Netlist netlist;
+  RandomNetlist(netlist, 256, 20000, 7);
+  Cim::LevelizedSim ref(netlist);
+  Cim::ParallelSim sim(netlist, 4, 64);
+  assert(sim.GetThreadNum() == 4 && sim.GetChunkNum() > sim.GetBarrierNum());
+  for (uint32_t v = 0; v < 4; v++) {
+    std::vector<bool> input_vector;
+    for (uint32_t i = 0; i < netlist.GetInputs().size(); i++) {
+      input_vector.push_back(((i * 2654435761u) >> (v + 3)) & 1);
+    }
+    ref.SetInputs(input_vector);
+    sim.SetInputs(input_vector);
+    ref.Evaluate();
+    sim.Evaluate();
+    for (uint32_t n = 0; n < netlist.GetNetNum(); n++) {
+      assert(sim.GetState(n) == ref.GetState(n));
+    }
+  }
+
+  // register outputs are sources next to the primary inputs
+  Cim::Netlist seq;
+  const uint32_t d = seq.AddNet(), q = seq.AddNet(), y = seq.AddNet();
+  seq.AddGate(Cim::GateKind::AND, {d, q}, y);
+  seq.AddRegister(Cim::GateKind::DFF, y, q);
+  seq.AddOutput(y);
+  seq.Levelize();
+  Cim::ParallelSim seq_sim(seq, 2, 64);
+  seq_sim.SetInput(d, true);
+  seq_sim.Evaluate();
+  assert(!seq_sim.GetState(q) && !seq_sim.GetState(y));
+  seq_sim.SetInput(q, true);
+  seq_sim.Evaluate();
+  assert(seq_sim.GetState(y));
+
+  // work-stealing loop covers every index exactly once
+  Cim::ThreadPool pool(3);
+  std::vector<std::atomic<uint32_t>> hits(1000);
+  pool.ParallelFor(0, 1000, 7, [&hits](const uint32_t begin, const uint32_t end) {
+    for (uint32_t i = begin; i < end; i++) {
+      hits[i]++;
+    }
+  });
+  for (const auto& each_hit : hits) {
+    assert(each_hit == 1);
+  }
+}
+
+// check an imported full adder against its truth table
+static void CheckImportedAdder(const Cim::Netlist& netlist) {
+  Cim::LevelizedSim sim(netlist);
+  for (uint32_t v = 0; v < 8; v++) {
+    const bool a = v & 1, b = v & 2, cin = v & 4;
+    sim.SetInput(netlist.FindNet("a"), a);
+    sim.SetInput(netlist.FindNet("b"), b);
+    sim.SetInput(netlist.FindNet("cin"), cin);
+    sim.Evaluate();
+    assert(sim.GetState(netlist.FindNet("sum")) == (a ^ b ^ cin));
+    assert(sim.GetState(netlist.FindNet("cout")) == ((a & b) | (cin & (a ^ b))));
+  }
+}
+
+static void TestImport() {
+  // ISCAS bench, outputs declared and used before they are driven
+  std::istringstream bench(
+      "# full adder\n"
+      "INPUT(a)\nINPUT(b)\nINPUT(cin)\nOUTPUT(sum)\nOUTPUT(cout)\n"
+      "sum = XOR(p, cin)\n"
+      "cout = OR(g, t)\r\n"
+      "t = and(p, cin)\n"
+      "p = XOR(a, b)\n"
+      "g = AND(a, b)  # generate\n");
+  Cim::Netlist from_bench;
+  Cim::NetlistImporter bench_importer(from_bench);
+  bench_importer.ImportStream(bench, Cim::NetlistFormat::Bench);
+  assert(from_bench.GetGateNum() == 5);
+  assert(from_bench.GetInputs().size() == 3);
+  assert(from_bench.GetOutputs().size() == 2);
+  assert(from_bench.FindGate("cout") != UINT32_MAX);
+  assert(bench_importer.GetStats().gate_num == 5);
+  assert(bench_importer.GetStats().byte_num == bench.str().size());
+  assert(bench_importer.GetStats().peak_byte_num > 0);
+  CheckImportedAdder(from_bench);
+
+  // BLIF covers, with a continued line and an off-set cover
+  std::istringstream blif(
+      ".model fa\n.inputs a b \\\n cin\n.outputs sum cout\n"
+      ".names a b cin sum\n100 1\n010 1\n001 1\n111 1\n"
+      ".names a b cin cout\n00- 0\n0-0 0\n-00 0\n"
+      ".end\n");
+  Cim::Netlist from_blif;
+  Cim::NetlistImporter(from_blif).ImportStream(blif, Cim::NetlistFormat::Blif);
+  assert(from_blif.GetGateNum() == 2);
+  CheckImportedAdder(from_blif);
+
+  // structural Verilog with comments, named and unnamed primitives
+  std::istringstream verilog(
+      "module fa(a, b, cin, sum, cout);\n"
+      "  input a, b, cin; output sum, cout; /* ports */\n"
+      "  wire p, g, t;\n"
+      "  xor x1 (p, a, b), x2 (sum, p, cin);\n"
+      "  and (g, a, b); // generate\n"
+      "  and a2 (t, p, cin);\n"
+      "  or o1 (cout, g, t);\n"
+      "endmodule\n");
+  Cim::Netlist from_verilog;
+  Cim::NetlistImporter(from_verilog).ImportStream(verilog, Cim::NetlistFormat::Verilog);
+  assert(from_verilog.GetGateNum() == 5);
+  assert(from_verilog.FindGate("x2") != UINT32_MAX);
+  CheckImportedAdder(from_verilog);
+
+  // wide BLIF cover is decomposed, constants become input-less LUTs
+  std::istringstream wide(
+      ".model wide\n.inputs i0 i1 i2 i3 i4 i5 i6\n.outputs y one\n"
+      ".names i0 i1 i2 i3 i4 i5 i6 y\n1111110 1\n.names one\n1\n.end\n");
+  Cim::Netlist from_wide;
+  Cim::NetlistImporter(from_wide).ImportStream(wide, Cim::NetlistFormat::Blif);
+  Cim::LevelizedSim wide_sim(from_wide);
+  for (uint32_t v = 0; v < 128; v++) {
+    for (uint32_t k = 0; k < 7; k++) {
+      wide_sim.SetInput(from_wide.FindNet("i" + std::to_string(k)), (v >> k) & 1);
+    }
+    wide_sim.Evaluate();
+    assert(wide_sim.GetState(from_wide.FindNet("y")) == (v == 0x3f));
+    assert(wide_sim.GetState(from_wide.FindNet("one")));
+  }
+
+  // malformed flip-flops and unknown extensions are rejected
+  std::istringstream dff("INPUT(d)\nINPUT(e)\nq = DFF(d, e)\n");
+  Cim::Netlist from_dff;
+  bool thrown = false;
+  try {
+    Cim::NetlistImporter(from_dff).ImportStream(dff, Cim::NetlistFormat::Bench);
+  } catch (const std::invalid_argument&) {
+    thrown = true;
+  }
+  assert(thrown);
+
+  // undriven nets, driven inputs, double drivers & unsupported registers report their line
+  const std::pair<Cim::NetlistFormat, const char*> broken[] = {
+    {Cim::NetlistFormat::Bench, "INPUT(a)\nOUTPUT(y)\ny = AND(a, b)\n"},
+    {Cim::NetlistFormat::Bench, "INPUT(a)\nINPUT(b)\nOUTPUT(b)\nb = NOT(a)\n"},
+    {Cim::NetlistFormat::Bench, "INPUT(a)\nOUTPUT(y)\n\ny = NOT(a)\ny = BUFF(a)\n"},
+    {Cim::NetlistFormat::Bench, "INPUT(d)\nINPUT(e)\nOUTPUT(q)\nq = LATCH(d, e)\n"},
+    {Cim::NetlistFormat::Blif, ".model m\n.inputs a\n.outputs y\n.names a b y\n11 1\n.end\n"},
+    {Cim::NetlistFormat::Blif, ".model m\n.inputs d c\n.outputs q\n.latch d q fe c 0\n.end\n"},
+    {Cim::NetlistFormat::Blif, ".model m\n.inputs d c\n.outputs q\n.latch d q as c 0\n.end\n"},
+    {Cim::NetlistFormat::Verilog, "module m(a, y);\ninput a;\noutput y;\nwire q;\ndff d1 (q, a);\nendmodule\n"},
+    {Cim::NetlistFormat::Verilog, "module m(a, y);\ninput a;\noutput y;\nnot n1 (a, y);\nendmodule\n"}
+  };
+  const char* const broken_line[] = {"AT LINE 3!", "AT LINE 4!", "AT LINE 5!", "AT LINE 4!", "AT LINE 4!",
+                                     "AT LINE 4!", "AT LINE 4!", "AT LINE 5!", "AT LINE 4!"};
+  for (size_t c = 0; c < sizeof(broken) / sizeof(broken[0]); c++) {
+    std::istringstream in(broken[c].second);
+    Cim::Netlist target;
+    std::string what;
+    try {
+      Cim::NetlistImporter(target).ImportStream(in, broken[c].first);
+    } catch (const std::invalid_argument& e) {
+      what = e.what();
+    }
+    assert(what.find(broken_line[c]) != std::string::npos);
+  }
+  assert(Cim::GetNetlistFormat("c17.bench") == Cim::NetlistFormat::Bench);
+  assert(Cim::GetNetlistFormat("top.v") == Cim::NetlistFormat::Verilog);
+}
+
+static void TestCache() {
+  const std::filesystem::path dir = std::filesystem::temp_directory_path() / "cim_test_cache";
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir);
+
+  // round trip through a mapped file
+  FullAdder fa;
+  Cim::Netlist netlist(fa.Gates());
+  const std::string path = (dir / "fa.cnl").string();
+  Cim::SaveNetlist(netlist, path, 42);
+  uint64_t source_hash = 0;
+  Cim::Netlist mapped = Cim::MapNetlist(path, true, &source_hash);
+  assert(mapped.IsMapped() && source_hash == 42);
+  assert(mapped.GetGateNum() == netlist.GetGateNum() && mapped.GetLevelNum() == netlist.GetLevelNum());
+  assert(mapped.GetNetName(0) == netlist.GetNetName(0));
+  assert(mapped.FindGate("o1") == netlist.FindGate("o1"));
+  assert(mapped.FindPin(mapped.FindGate("x2"), "CIN") == 1);
+  assert(mapped.IsMonitored(mapped.FindGate("x2")));
+  assert(mapped.GetGateSource(0) == nullptr);
+  Cim::LevelizedSim sim(netlist), mapped_sim(mapped);
+  for (uint32_t v = 0; v < 8; v++) {
+    std::vector<bool> input_vector;
+    for (uint32_t i = 0; i < netlist.GetInputs().size(); i++) {
+      input_vector.push_back((v >> (i % 3)) & 1);
+    }
+    sim.SetInputs(input_vector);
+    mapped_sim.SetInputs(input_vector);
+    sim.Evaluate();
+    mapped_sim.Evaluate();
+    assert(sim.GetStates() == mapped_sim.GetStates());
+  }
+
+  // renaming copies the mapped arrays first
+  mapped.SetNetName(0, "renamed");
+  assert(!mapped.IsMapped() && mapped.FindNet("renamed") == 0);
+  assert(mapped.FindGate("o1") == netlist.FindGate("o1"));
+
+  // damaged files are rejected
+  {
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(-1, std::ios::end);
+    file.put('\x7f');
+  }
+  bool thrown = false;
+  try {
+    Cim::MapNetlist(path);
+  } catch (const std::runtime_error&) {
+    thrown = true;
+  }
+  assert(thrown);
+
+  // cache keyed on the source contents
+  const std::string source = (dir / "fa.bench").string();
+  std::ofstream(source) << "INPUT(a)\nINPUT(b)\nINPUT(cin)\nOUTPUT(sum)\nOUTPUT(cout)\n"
+      "p = XOR(a, b)\nsum = XOR(p, cin)\ng = AND(a, b)\nt = AND(p, cin)\ncout = OR(g, t)\n";
+  Cim::NetlistCache cache((dir / "entries").string());
+  const Cim::Netlist first = cache.Load(source);
+  const Cim::Netlist second = cache.Load(source);
+  assert(cache.GetMissNum() == 1 && cache.GetHitNum() == 1);
+  assert(!first.IsMapped() && second.IsMapped());
+  CheckImportedAdder(second);
+  std::ofstream(source, std::ios::app) << "extra = NOT(cout)\n";
+  assert(cache.Load(source).GetGateNum() == 6);
+  assert(cache.GetMissNum() == 2);
+  std::filesystem::remove_all(dir);
+}
+
+static void TestWave() {
+  const std::filesystem::path dir = std::filesystem::temp_directory_path();
+  const std::string vcd_path = (dir / "cim_test.vcd").string();
+  const std::string log_path = (dir / "cim_test.wave").string();
+  FullAdder fa;
+  Cim::Netlist netlist(fa.Gates());
+  Cim::LevelizedSim sim(netlist);
+
+  // tiny buffers force many hand-offs to the writer thread
+  std::vector<Cim::WaveChange> expected;
+  {
+    Cim::WaveformRecorder recorder(netlist, vcd_path, log_path, 2, 2);
+    assert(recorder.GetSignalNum() == 2);
+    std::vector<uint8_t> last(2, 2);
+    for (uint32_t t = 0; t < 64; t++) {
+      const uint32_t v = (t * 5) % 8;
+      std::vector<bool> input_vector;
+      for (uint32_t i = 0; i < netlist.GetInputs().size(); i++) {
+        input_vector.push_back((v >> (i % 3)) & 1);
+      }
+      sim.SetInputs(input_vector);
+      sim.Evaluate();
+      recorder.Sample(t * 10, sim.GetStates());
+      for (uint32_t s = 0; s < 2; s++) {
+        const uint8_t value = sim.GetState(recorder.GetSignalNet(s));
+        if (value != last[s]) {
+          expected.push_back(Cim::WaveChange{t * 10, s, value});
+          last[s] = value;
+        }
+      }
+      if (t == 31) {
+        recorder.Flush();
+      }
+    }
+    assert(recorder.GetChangeNum() == expected.size());
+    recorder.Close();
+  }
+
+  // binary change log holds exactly the changes
+  std::vector<uint32_t> nets;
+  const std::vector<Cim::WaveChange> changes = Cim::ReadChangeLog(log_path, &nets);
+  std::vector<uint32_t> monitored_nets;
+  for (uint32_t g = 0; g < netlist.GetGateNum(); g++) {
+    if (netlist.IsMonitored(g)) {
+      monitored_nets.push_back(netlist.GetProgram()[g].out_net);
+    }
+  }
+  assert(nets == monitored_nets);
+  assert(changes.size() == expected.size());
+  for (uint32_t i = 0; i < changes.size(); i++) {
+    assert(changes[i].time == expected[i].time && changes[i].signal == expected[i].signal);
+    assert(changes[i].value == expected[i].value);
+  }
+
+  // VCD declares both monitored gates and one value line per change
+  std::ifstream vcd(vcd_path);
+  const std::string text((std::istreambuf_iterator<char>(vcd)), std::istreambuf_iterator<char>());
+  assert(text.find("$var wire 1 ! ") != std::string::npos);
+  assert(text.find(" x2 $end") != std::string::npos && text.find(" o1 $end") != std::string::npos);
+  assert(text.find("$enddefinitions $end\n#0\n") != std::string::npos);
+  uint32_t value_lines = 0;
+  for (size_t pos = text.find("$enddefinitions"); (pos = text.find('\n', pos)) != std::string::npos; pos++) {
+    value_lines += (pos + 1 < text.size() && (text[pos + 1] == '0' || text[pos + 1] == '1'));
+  }
+  assert(value_lines == expected.size());
+  std::filesystem::remove(vcd_path);
+  std::filesystem::remove(log_path);
+}
+
+static void TestSequential() {
+  // components: edge-triggered flip-flop & transparent latch
+  Cim::FlipFlop ff(nullptr, "ff");
+  ff.Set("D", true);
+  assert(!ff.GetState());
+  ff.Set("CLK", true);
+  assert(ff.GetState() && ff.IsPinStateChanged(2));
+  ff.Set("D", false);
+  ff.Set("CLK", true);
+  assert(ff.GetState());
+  ff.Set("CLK", false);
+  ff.Set("CLK", true);
+  assert(!ff.GetState());
+  Cim::Latch latch(nullptr, "latch", false, true);
+  latch.Set("D", false);
+  assert(latch.GetState());
+  latch.Set("EN", true);
+  assert(!latch.GetState());
+  latch.Set("D", true);
+  assert(latch.GetState());
+  latch.Set("EN", false);
+  latch.Set("D", false);
+  assert(latch.GetState() && latch.GetKind() == Cim::GateKind::LATCH);
+  bool thrown = false;
+  try {
+    Cim::Gate(nullptr, "g", "DFF", {"D", "CLK"});
+  } catch (const std::invalid_argument&) {
+    thrown = true;
+  }
+  assert(thrown);
+
+  // 3-stage shift register from components: two-phase update moves data one stage per edge
+  Cim::FlipFlop s0(nullptr, "s0"), s1(nullptr, "s1"), s2(nullptr, "s2", true);
+  Connect(s0, 2, s1, 0);
+  Connect(s1, 2, s2, 0);
+  Cim::Netlist shift({&s0, &s1, &s2});
+  assert(shift.GetRegisterNum() == 3 && shift.GetGateNum() == 0);
+  assert(shift.GetPinNet(&s1, 0) == shift.GetPinNet(&s0, 2));
+  Cim::CycleSim shift_sim(shift);
+  const uint32_t d = shift.GetPinNet(&s0, 0);
+  const uint32_t pattern = 0x5a;
+  for (uint32_t t = 0; t < 8; t++) {
+    shift_sim.SetInput(d, (pattern >> t) & 1);
+    shift_sim.Clock();
+    if (t >= 2) {
+      assert(shift_sim.GetState(shift.GetPinNet(&s2, 2)) == (((pattern >> (t - 2)) & 1) != 0));
+    }
+  }
+  shift_sim.WriteBack();
+  assert(s2.GetState() == shift_sim.GetRegisterState(shift.GetRegisterIndex(&s2)));
+  thrown = false;
+  try {
+    shift_sim.SetInput(shift.GetPinNet(&s1, 2), true);
+  } catch (const std::invalid_argument&) {
+    thrown = true;
+  }
+  assert(thrown);
+
+  // 4-bit counter with a latch holding the carry-out
+  Cim::Netlist counter;
+  std::vector<uint32_t> q, next;
+  for (uint32_t b = 0; b < 4; b++) {
+    q.push_back(counter.AddNet());
+    next.push_back(counter.AddNet());
+  }
+  const uint32_t enable = counter.AddNet();
+  uint32_t carry = enable;
+  for (uint32_t b = 0; b < 4; b++) {
+    counter.AddGate(Cim::GateKind::XOR, {q[b], carry}, next[b]);
+    const uint32_t carry_out = counter.AddNet();
+    counter.AddGate(Cim::GateKind::AND, {q[b], carry}, carry_out);
+    counter.AddRegister(Cim::GateKind::DFF, next[b], q[b], UINT32_MAX, b == 0);
+    carry = carry_out;
+  }
+  const uint32_t wrapped = counter.AddNet();
+  counter.AddRegister(Cim::GateKind::LATCH, carry, wrapped, carry);
+  counter.Levelize();
+  assert(counter.GetInputs().size() == 1 && counter.GetInputs()[0] == enable);
+  Cim::CycleSim counter_sim(counter);
+  counter_sim.SetInput(enable, true);
+  for (uint32_t t = 1; t <= 20; t++) {
+    counter_sim.Clock();
+    uint32_t value = 0;
+    for (uint32_t b = 0; b < 4; b++) {
+      value |= static_cast<uint32_t>(counter_sim.GetState(q[b])) << b;
+    }
+    assert(value == (1 + t) % 16);
+    assert(counter_sim.GetState(wrapped) == (t >= 15));
+  }
+  counter_sim.SetInput(enable, false);
+  counter_sim.Run(5);
+  assert(counter_sim.GetRegisterState(0) && !counter_sim.GetRegisterState(1));
+  assert(counter_sim.GetCycleNum() == 25);
+  counter_sim.Reset();
+  assert(counter_sim.GetRegisterState(0) && counter_sim.GetCycleNum() == 0);
+
+  // imported flip-flops, through a mapped cache file
+  std::istringstream toggle("INPUT(en)\nOUTPUT(q)\nq = DFF(t)\nt = XOR(q, en)\n");
+  Cim::Netlist from_bench;
+  Cim::NetlistImporter(from_bench).ImportStream(toggle, Cim::NetlistFormat::Bench);
+  const std::string path = (std::filesystem::temp_directory_path() / "cim_test_toggle.cnl").string();
+  Cim::SaveNetlist(from_bench, path);
+  const Cim::Netlist mapped = Cim::MapNetlist(path);
+  assert(mapped.GetRegisterNum() == 1 && mapped.GetInputs().size() == 1);
+  Cim::CycleSim toggle_sim(mapped);
+  toggle_sim.SetInput(mapped.FindNet("en"), true);
+  for (uint32_t t = 1; t <= 4; t++) {
+    toggle_sim.Clock();
+    assert(toggle_sim.GetState(mapped.FindNet("q")) == (t % 2 == 1));
+  }
+  std::filesystem::remove(path);
+  std::istringstream blif(".model l\n.inputs d g\n.outputs q\n.latch d q al g 1\n.end\n");
+  Cim::Netlist from_blif;
+  Cim::NetlistImporter(from_blif).ImportStream(blif, Cim::NetlistFormat::Blif);
+  Cim::CycleSim blif_sim(from_blif);
+  assert(blif_sim.GetState(from_blif.FindNet("q")));
+  blif_sim.SetInput(from_blif.FindNet("g"), true);
+  blif_sim.Clock();
+  assert(blif_sim.GetState(from_blif.FindNet("q")));
+  blif_sim.SetInput(from_blif.FindNet("g"), false);
+  blif_sim.Clock();
+  assert(!blif_sim.GetState(from_blif.FindNet("q")));
+}
+
+// reference: serial simulation of one fault on one input vector (inputs already in nets)
+static std::vector<uint8_t> SerialFaulty(const Cim::Netlist& netlist, const Cim::Fault& fault,
+    std::vector<uint8_t> nets) {
+  const auto program = netlist.GetProgram();
+  const auto fanin = netlist.GetFanin();
+  for (uint32_t g = 0; g < program.size(); g++) {
+    const Cim::Instruction& ins = program[g];
+    const bool site = (g == fault.gate);
+    if (site && fault.pin == ins.fanin_count) {
+      nets[ins.out_net] = fault.stuck_at;
+      continue;
+    }
+    nets[ins.out_net] = Cim::EvaluateVariant<uint8_t>(ins.variant, [&](const uint32_t k) {
+      return (site && k == fault.pin) ? fault.stuck_at : nets[fanin[ins.fanin_begin + k]];
+    }, ins.fanin_count, (ins.op == Cim::GateKind::LUT) ? netlist.GetLuts()[ins.lut] : 0);
+  }
+  return nets;
+}
+
+static void TestFault() {
+  // fault list & detection agree with serial fault simulation
+  Cim::Netlist netlist;
+  RandomNetlist(netlist, 12, 300, 99);
+  Cim::FaultSim fault_sim(netlist);
+  uint32_t pin_num = 0;
+  for (const Cim::Instruction& ins : netlist.GetProgram()) {
+    pin_num += ins.fanin_count + 1;
+  }
+  assert(fault_sim.GetFaultNum() == 2 * pin_num && fault_sim.GetControlNum() == 12);
+  std::mt19937_64 rng(5);
+  std::vector<std::vector<uint64_t>> batches(2, std::vector<uint64_t>(12));
+  for (auto& each_batch : batches) {
+    for (uint64_t& each_word : each_batch) each_word = rng();
+  }
+  fault_sim.Simulate(batches[0]);
+  fault_sim.Simulate(batches[1], 40);
+  assert(fault_sim.GetPatternNum() == 104);
+  Cim::LevelizedSim sim(netlist);
+  std::vector<uint64_t> first(fault_sim.GetFaultNum(), UINT64_MAX);
+  for (uint32_t p = 0; p < 104; p++) {
+    for (uint32_t i = 0; i < 12; i++) {
+      sim.SetInput(netlist.GetInputs()[i], (batches[p / 64][i] >> (p % 64)) & 1);
+    }
+    sim.Evaluate();
+    for (uint32_t f = 0; f < fault_sim.GetFaultNum(); f++) {
+      if (first[f] != UINT64_MAX) continue;
+      const std::vector<uint8_t> nets = SerialFaulty(netlist, fault_sim.GetFaults()[f], sim.GetStates());
+      for (const uint32_t each_net : netlist.GetOutputs()) {
+        if (nets[each_net] != sim.GetStates()[each_net]) {
+          first[f] = p;
+          break;
+        }
+      }
+    }
+  }
+  uint32_t detected = 0;
+  for (uint32_t f = 0; f < fault_sim.GetFaultNum(); f++) {
+    assert(fault_sim.GetDetectingPattern(f) == first[f]);
+    detected += (first[f] != UINT64_MAX);
+  }
+  assert(fault_sim.GetDetectedNum() == detected && detected > 0);
+  assert(fault_sim.GetEventNum() < uint64_t{fault_sim.GetFaultNum()} * netlist.GetGateNum());
+
+  // redundant logic: y = a | (a & b), the AND output stuck-at-0 is untestable
+  Cim::Netlist redundant;
+  const uint32_t a = redundant.AddNet(), b = redundant.AddNet(), t = redundant.AddNet(), y = redundant.AddNet();
+  redundant.AddGate(Cim::GateKind::AND, {a, b}, t);
+  redundant.SetGateName(redundant.AddGate(Cim::GateKind::OR, {a, t}, y), "y");
+  redundant.AddOutput(y);
+  redundant.Levelize();
+  Cim::FaultSim redundant_sim(redundant);
+  redundant_sim.Simulate({0xa, 0xc}, 4);
+  const uint32_t and_gate = redundant.GetNetDriver(t);
+  for (uint32_t f = 0; f < redundant_sim.GetFaultNum(); f++) {
+    const Cim::Fault& fault = redundant_sim.GetFaults()[f];
+    if (fault.gate == and_gate && fault.pin == 2 && fault.stuck_at == 0) {
+      assert(!redundant_sim.IsDetected(f));
+    }
+    if (fault.gate == redundant.FindGate("y") && fault.pin == 2) {
+      assert(redundant_sim.IsDetected(f));
+      assert(redundant_sim.GetFaultName(f) == (fault.stuck_at ? "y.out/SA1" : "y.out/SA0"));
+    }
+  }
+  assert(redundant_sim.GetCoverage() < 1.0);
+  redundant_sim.Reset();
+  assert(redundant_sim.GetDetectedNum() == 0);
+  assert(redundant_sim.SimulateRandom(256, 1) > 0 && redundant_sim.GetPatternNum() == 256);
+
+  // registers are scanned: controlled like inputs, observed at their data input
+  std::istringstream toggle("INPUT(en)\nOUTPUT(q)\nq = DFF(t)\nt = XOR(q, en)\n");
+  Cim::Netlist from_bench;
+  Cim::NetlistImporter(from_bench).ImportStream(toggle, Cim::NetlistFormat::Bench);
+  Cim::FaultSim scan_sim(from_bench);
+  assert(scan_sim.GetControlNum() == 2);
+  scan_sim.Simulate({0xa, 0xc}, 4);
+  assert(scan_sim.GetCoverage() == 1.0);
+}
+
+static void TestOptimize() {
+  // random logic with two tied inputs stays equivalent on every input vector
+  Cim::Netlist netlist;
+  RandomNetlist(netlist, 10, 400, 3);
+  const Cim::ArrayView<uint32_t> inputs = netlist.GetInputs();
+  Cim::NetlistOptimizer optimizer(netlist);
+  optimizer.TieNet(inputs[2], true);
+  optimizer.TieNet(inputs[7], false);
+  Cim::Netlist optimized;
+  optimizer.Optimize(optimized);
+  const Cim::OptimizeStats& stats = optimizer.GetStats();
+  assert(stats.gate_num_before == 400 && stats.gate_num_after == optimized.GetGateNum());
+  assert(stats.gate_num_after < stats.gate_num_before && stats.constant_num > 0);
+  assert(optimized.GetInputs().size() == 10 && optimized.GetOutputs().size() == 10);
+  for (uint32_t i = 0; i < 10; i++) {
+    assert(optimizer.MapNet(inputs[i]) == optimized.GetInputs()[i]);
+  }
+  Cim::LevelizedSim sim(netlist), opt_sim(optimized);
+  for (uint32_t v = 0; v < 256; v++) {
+    for (uint32_t i = 0, k = 0; i < 10; i++) {
+      const bool value = (i == 2) || (i != 7 && ((v >> k) & 1));
+      sim.SetInput(inputs[i], value);
+      // tied inputs read nothing, drive them the other way
+      opt_sim.SetInput(optimized.GetInputs()[i], (i == 2 || i == 7) ? !value : value);
+      k += (i != 2 && i != 7) ? 1 : 0;
+    }
+    sim.Evaluate();
+    opt_sim.Evaluate();
+    for (uint32_t o = 0; o < 10; o++) {
+      assert(sim.GetState(netlist.GetOutputs()[o]) == opt_sim.GetState(optimized.GetOutputs()[o]));
+    }
+  }
+
+  // double inversion, identical gates & dead logic
+  Cim::Netlist small;
+  const uint32_t a = small.AddNet(), b = small.AddNet();
+  const uint32_t n1 = small.AddNet(), n2 = small.AddNet(), t1 = small.AddNet(), t2 = small.AddNet();
+  const uint32_t y = small.AddNet(), dead = small.AddNet();
+  small.AddGate(Cim::GateKind::NOT, {a}, n1);
+  small.AddGate(Cim::GateKind::NOT, {n1}, n2);
+  small.AddGate(Cim::GateKind::AND, {a, b}, t1);
+  small.AddGate(Cim::GateKind::AND, {b, n2}, t2);
+  small.SetGateName(small.AddGate(Cim::GateKind::OR, {t1, t2}, y), "y");
+  small.AddGate(Cim::GateKind::NOR, {a, b}, dead);
+  small.SetNetName(y, "y");
+  small.AddOutput(y);
+  small.Levelize();
+  Cim::OptimizeStats small_stats;
+  const Cim::Netlist small_opt = Cim::OptimizeNetlist(small, Cim::OptimizeOptions(), &small_stats);
+  assert(small_opt.GetGateNum() == 1 && small_opt.GetProgram()[0].op == Cim::GateKind::AND);
+  assert(small_stats.merged_num == 1 && small_stats.alias_num == 3 && small_stats.dead_num == 1);
+  assert(small_opt.FindNet("y") == small_opt.GetOutputs()[0]);
+  Cim::Netlist inverter;
+  const uint32_t x = inverter.AddNet(), not_x = inverter.AddNet();
+  inverter.AddGate(Cim::GateKind::NOT, {x}, not_x);
+  inverter.AddOutput(not_x);
+  inverter.Levelize();
+  const Cim::Netlist inverter_opt = Cim::OptimizeNetlist(inverter);
+  assert(inverter_opt.GetInputs().size() == 1 && inverter_opt.GetGateNum() == 1);
+  Cim::OptimizeOptions keep;
+  keep.hash_structure = false;
+  keep.remove_dead = false;
+  assert(Cim::OptimizeNetlist(small, keep).GetGateNum() == 4);
+
+  // monitored gates stay live and keep their flag, also when folded into a constant or an input
+  Cim::Netlist watched;
+  const uint32_t p = watched.AddNet(), q = watched.AddNet(), w = watched.AddNet(), z = watched.AddNet();
+  const uint32_t o = watched.AddNet(), qq = watched.AddNet();
+  watched.SetMonitored(watched.AddGate(Cim::GateKind::NAND, {p, q}, w), true);
+  watched.SetMonitored(watched.AddGate(Cim::GateKind::XOR, {p, p}, z), true);
+  const uint32_t alias = watched.AddGate(Cim::GateKind::AND, {q, q}, qq);
+  watched.SetMonitored(alias, true);
+  watched.SetGateName(alias, "alias");
+  watched.AddGate(Cim::GateKind::OR, {p, q}, o);
+  watched.AddOutput(o);
+  watched.Levelize();
+  const Cim::Netlist watched_opt = Cim::OptimizeNetlist(watched);
+  uint32_t monitored_num = 0;
+  for (uint32_t g = 0; g < watched_opt.GetGateNum(); g++) {
+    monitored_num += watched_opt.IsMonitored(g) ? 1 : 0;
+  }
+  assert(watched_opt.GetGateNum() == 4 && monitored_num == 3);
+  const uint32_t buffer = watched_opt.FindGate("alias");
+  assert(buffer != UINT32_MAX && watched_opt.IsMonitored(buffer));
+  Cim::LevelizedSim watched_sim(watched_opt);
+  for (const bool value : {true, false}) {
+    watched_sim.SetInput(watched_opt.GetInputs()[1], value);
+    watched_sim.Evaluate();
+    assert(watched_sim.GetState(watched_opt.GetProgram()[buffer].out_net) == value);
+  }
+
+  // dangling component inputs read 0, inputs driven from outside stay
+  Cim::Gate ext(nullptr, "ext", "NOT", {"IN"});
+  Cim::Gate g1(nullptr, "g1", "AND", {"A", "B"});
+  Cim::Gate g2(nullptr, "g2", "OR", {"IN1", "IN2"}, true);
+  Connect(ext, 1, g1, 0);
+  Connect(ext, 1, g2, 1);
+  Connect(g1, 2, g2, 0);
+  const Cim::Netlist network(std::vector<Cim::Component*>{&g1, &g2});
+  assert(Cim::OptimizeNetlist(network).GetGateNum() == 2);
+  Cim::OptimizeOptions tie;
+  tie.tie_dangling_inputs = true;
+  const Cim::Netlist tied = Cim::OptimizeNetlist(network, tie);
+  // the monitored g2 reduces to its other input and keeps a buffer
+  assert(tied.GetGateNum() == 1 && tied.GetInputs().size() == 2);
+  assert(tied.FindGate("g2") == 0 && tied.IsMonitored(0));
+  const Cim::Pin::Link first_pin = network.GetInputSource(network.GetInputs()[0]);
+  assert(tied.GetOutputs()[0] == tied.GetInputs()[first_pin.first->IsPinConnected(first_pin.second) ? 0 : 1]);
+
+  // registers without a path to an output are removed
+  std::istringstream bench("INPUT(en)\nOUTPUT(q)\nq = DFF(t)\nt = XOR(q, en)\nd = NOT(en)\nu = DFF(d)\n");
+  Cim::Netlist sequential;
+  Cim::NetlistImporter(sequential).ImportStream(bench, Cim::NetlistFormat::Bench);
+  const Cim::Netlist seq_opt = Cim::OptimizeNetlist(sequential);
+  assert(seq_opt.GetRegisterNum() == 1 && seq_opt.GetGateNum() == 1);
+  Cim::CycleSim cycle(sequential), opt_cycle(seq_opt);
+  for (uint32_t c = 0; c < 8; c++) {
+    cycle.SetInput(sequential.GetInputs()[0], c % 3 != 0);
+    opt_cycle.SetInput(seq_opt.GetInputs()[0], c % 3 != 0);
+    cycle.Clock();
+    opt_cycle.Clock();
+    assert(cycle.GetState(sequential.GetOutputs()[0]) == opt_cycle.GetState(seq_opt.GetOutputs()[0]));
+  }
+}
+
+static void TestNative() {
+  // generated code: one statement per gate, LUTs as bitwise expressions
+  Cim::Netlist small;
+  const uint32_t a = small.AddNet(), b = small.AddNet(), c = small.AddNet(), y = small.AddNet(), z = small.AddNet();
+  small.AddGate(Cim::GateKind::NAND, {a, b}, y);
+  small.AddLut(0xCA, {a, b, c}, z);
+  small.AddOutput(y);
+  small.AddOutput(z);
+  small.Levelize();
+  const std::string source = Cim::GenerateNativeSource(small, 1);
+  assert(source.find("v[3] = ~(v[0] & v[1]);") != std::string::npos);
+  assert(source.find("v[4] = ((v[2] & v[1]) | (~v[2] & v[0]));") != std::string::npos);
+  assert(Cim::HashNetlist(small) != 0 && source.find("cim_evaluate") != std::string::npos);
+  if (!Cim::NativeSim::IsSupported()) {
+    return;
+  }
+
+  // compiled kernel agrees with the interpreted engine, the second load is a cache hit
+  const std::filesystem::path dir = std::filesystem::temp_directory_path() / "cim_test_native";
+  std::filesystem::remove_all(dir);
+  Cim::Netlist netlist;
+  RandomNetlist(netlist, 64, 3000, 11);
+  Cim::NativeOptions options;
+  options.cache_dir = dir.string();
+  options.flags = "-O1";
+  options.chunk_size = 500;
+  Cim::NativeSim native(netlist, 256, options);
+  assert(!native.IsCacheHit() && native.GetCompileSeconds() > 0);
+  assert(std::filesystem::exists(native.GetObjectPath()));
+  Cim::BitParallelSim reference(netlist, 256);
+  reference.Randomize(3);
+  for (const uint32_t each_net : netlist.GetInputs()) {
+    native.SetInputWords(each_net, reference.GetWords(each_net));
+  }
+  reference.Evaluate();
+  native.Evaluate();
+  for (uint32_t n = 0; n < netlist.GetNetNum(); n++) {
+    assert(std::equal(reference.GetWords(n), reference.GetWords(n) + 4, native.GetWords(n)));
+  }
+  Cim::NativeSim cached(netlist, 256, options);
+  assert(cached.IsCacheHit() && cached.GetCompileSeconds() == 0);
+  cached.SetInput(netlist.GetInputs()[0], 255, true);
+  cached.Evaluate();
+  assert(cached.GetState(netlist.GetInputs()[0], 255));
+
+  // objects are never loaded from a directory others can write to
+  std::filesystem::permissions(dir, std::filesystem::perms::all);
+  bool thrown = false;
+  try {
+    Cim::NativeSim shared(netlist, 256, options);
+  } catch (const std::runtime_error&) {
+    thrown = true;
+  }
+  assert(thrown);
+  std::filesystem::remove_all(dir);
+}
+
+static void TestIncremental() {
+  // single input toggles re-evaluate a fraction of the circuit and match a full pass
+  Cim::Netlist netlist;
+  RandomNetlist(netlist, 64, 3000, 21);
+  Cim::IncrementalSim inc(netlist);
+  Cim::LevelizedSim full(netlist);
+  full.Evaluate();
+  std::mt19937_64 rng(4);
+  for (uint32_t step = 0; step < 200; step++) {
+    const uint32_t net = netlist.GetInputs()[rng() % 64];
+    const bool state = !inc.GetState(net);
+    inc.SetInput(net, state);
+    full.SetInput(net, state);
+    assert(inc.IsDirty() || inc.GetFanoutCone(net).empty());
+    inc.Update();
+    full.Evaluate();
+    assert(!inc.IsDirty());
+    for (uint32_t n = 0; n < netlist.GetNetNum(); n++) {
+      assert(inc.GetState(n) == full.GetState(n));
+    }
+  }
+  assert(inc.GetEvaluationNum() < 200 * uint64_t{netlist.GetGateNum()} / 2);
+
+  // random rewiring keeps the levels consistent and the states exact
+  uint32_t loops = 0;
+  for (uint32_t edit = 0; edit < 300; edit++) {
+    const uint32_t gate = rng() % inc.GetGateNum();
+    const uint32_t net = rng() % inc.GetNetNum();
+    try {
+      inc.ReplaceFanin(gate, 0, net);
+    } catch (const std::invalid_argument&) {
+      loops++;
+    }
+    if (edit % 10 == 0) {
+      try {
+        inc.ChangeKind(gate, Cim::GateKind::XNOR);
+      } catch (const std::invalid_argument&) {
+        // single input gate
+      }
+    }
+  }
+  inc.Update();
+  assert(loops > 0 && inc.GetRelevelNum() > 0);
+  const Cim::Netlist edited = inc.ToNetlist();
+  Cim::LevelizedSim check(edited);
+  for (const uint32_t each_net : edited.GetInputs()) {
+    check.SetInput(each_net, inc.GetState(each_net));
+  }
+  check.Evaluate();
+  for (uint32_t n = 0; n < edited.GetNetNum(); n++) {
+    assert(check.GetState(n) == inc.GetState(n));
+  }
+  assert(edited.GetLevelNum() == inc.GetLevelNum());
+
+  // adding & removing gates, loops are refused
+  Cim::Netlist chain;
+  const uint32_t a = chain.AddNet(), b = chain.AddNet(), c = chain.AddNet();
+  chain.AddGate(Cim::GateKind::NOT, {a}, b);
+  chain.AddGate(Cim::GateKind::NOT, {b}, c);
+  chain.AddOutput(c);
+  chain.Levelize();
+  Cim::IncrementalSim edit_sim(chain);
+  bool refused = false;
+  try {
+    edit_sim.ReplaceFanin(chain.GetNetDriver(b), 0, c);
+  } catch (const std::invalid_argument&) {
+    refused = true;
+  }
+  assert(refused && !edit_sim.GetState(c));
+  const uint32_t d = edit_sim.AddNet();
+  const uint32_t nand = edit_sim.AddGate(Cim::GateKind::NAND, {c, a}, d);
+  edit_sim.Update();
+  assert(edit_sim.GetState(d) && edit_sim.GetLevel(nand) == 2 && edit_sim.GetLevelNum() == 3);
+  edit_sim.SetInput(a, true);
+  edit_sim.Update();
+  assert(edit_sim.GetState(c) && !edit_sim.GetState(d));
+  edit_sim.RemoveGate(chain.GetNetDriver(b));
+  assert(edit_sim.GetLevel(nand) == 1 && edit_sim.GetNetDriver(b) == UINT32_MAX);
+  edit_sim.SetInput(b, true);
+  edit_sim.Update();
+  assert(!edit_sim.GetState(c) && edit_sim.GetState(d));
+
+  // components: pin changes & rewiring through GetPinConnection
+  FullAdder fa;
+  Cim::Netlist fa_netlist(fa.Gates());
+  Cim::IncrementalSim fa_sim(fa_netlist);
+  fa.Drive(true, true, false);
+  fa_sim.ApplyPinChanges();
+  assert(!fa.x1.IsPinStateChanged(0) && !fa.a1.IsPinStateChanged(1));
+  fa_sim.Update();
+  fa_sim.WriteBack();
+  assert(!fa.x2.GetPinState(2) && fa.o1.GetPinState(2));
+
+  // consuming a change leaves a latch alone (Set() again would let D through while EN is high)
+  Cim::Latch latch(nullptr, "l");
+  latch.Set(Cim::Sequential::kControl, true);
+  latch.Set(Cim::Sequential::kData, true);
+  Cim::Gate& latch_gate = latch;
+  latch_gate.Gate::Set(Cim::Sequential::kData, false);
+  latch.ClearPinStateChanged(Cim::Sequential::kControl);
+  assert(!latch.IsPinStateChanged(Cim::Sequential::kControl) && latch.GetState());
+  fa.o1.GetPinConnection(0).at(0) = Cim::Pin::Link{nullptr, UINT32_MAX};
+  fa_sim.Rewire(&fa.o1, 0);
+  fa_sim.Update();
+  fa_sim.WriteBack();
+  assert(!fa.o1.GetPinState(2));
+  fa.o1.GetPinConnection(0).at(0) = Cim::Pin::Link{&fa.x1, 2};
+  fa_sim.Rewire(&fa.o1, 0);
+  fa.Drive(true, false, false);
+  fa_sim.ApplyPinChanges();
+  fa_sim.Update();
+  fa_sim.WriteBack();
+  assert(fa.o1.GetPinState(2) && fa.x2.GetPinState(2));
+}
+
+static void TestProfile() {
+  if (!Cim::Profiler::IsEnabled()) {
+    return;
+  }
+  // levelized: one evaluation per gate and vector, toggles match a plain engine
+  Cim::Netlist netlist;
+  RandomNetlist(netlist, 32, 2000, 9);
+  for (uint32_t g = 0; g < netlist.GetGateNum(); g++) {
+    netlist.SetGateName(g, "core" + std::to_string(g % 2) + "::blk" + std::to_string(g % 3) + "::g" + std::to_string(g));
+  }
+  Cim::Profiler profiler(netlist);
+  Cim::LevelizedSim sim(netlist), plain(netlist);
+  sim.SetProfiler(&profiler);
+  std::vector<uint64_t> toggles(netlist.GetGateNum(), 0);
+  std::mt19937_64 rng(12);
+  for (uint32_t v = 0; v < 100; v++) {
+    std::vector<bool> inputs;
+    for (uint32_t i = 0; i < netlist.GetInputs().size(); i++) {
+      inputs.push_back(rng() & 1);
+    }
+    const std::vector<uint8_t> before = plain.GetStates();
+    sim.SetInputs(inputs);
+    plain.SetInputs(inputs);
+    sim.Evaluate();
+    plain.Evaluate();
+    assert(sim.GetStates() == plain.GetStates());
+    for (uint32_t g = 0; g < netlist.GetGateNum(); g++) {
+      const uint32_t out = netlist.GetProgram()[g].out_net;
+      toggles[g] += before[out] != plain.GetStates()[out];
+    }
+  }
+  assert(profiler.GetVectorNum() == 100);
+  assert(profiler.GetTotalEvaluations() == 100 * uint64_t{netlist.GetGateNum()});
+  uint64_t level_sum = 0;
+  for (uint32_t l = 0; l < netlist.GetLevelNum(); l++) {
+    level_sum += profiler.GetLevelEvaluations(l);
+  }
+  assert(level_sum == profiler.GetTotalEvaluations());
+  for (uint32_t g = 0; g < netlist.GetGateNum(); g++) {
+    assert(profiler.GetEvaluations(g) == 100 && profiler.GetToggles(g) == toggles[g]);
+    assert(profiler.GetActivity(g) == toggles[g] / 100.0);
+  }
+
+  // report: hottest gates, histogram covers every gate, hierarchy prefixes
+  const std::vector<uint32_t> hottest = profiler.GetHottest(5);
+  assert(hottest.size() == 5);
+  for (uint32_t i = 1; i < hottest.size(); i++) {
+    assert(profiler.GetToggles(hottest[i - 1]) >= profiler.GetToggles(hottest[i]));
+  }
+  const std::vector<uint64_t> histogram = profiler.GetActivityHistogram(10);
+  assert(std::accumulate(histogram.begin(), histogram.end(), uint64_t{0}) == netlist.GetGateNum());
+  const std::vector<Cim::PrefixActivity> hierarchy = profiler.GetHierarchy();
+  assert(hierarchy.size() == 2 + 6);
+  for (const Cim::PrefixActivity& each : hierarchy) {
+    const uint64_t expected = (each.prefix.find("::") == std::string::npos) ? 1000 : 2000 / 6 + 1;
+    assert(each.gates >= expected - 1 && each.gates <= expected);
+    assert(each.evaluations == 100 * uint64_t{each.gates});
+  }
+  std::ostringstream json;
+  profiler.WriteJson(json, 3);
+  assert(json.str().find("\"evaluations_per_second\"") != std::string::npos);
+  assert(json.str().find("\"prefix\": \"core1::blk2\"") != std::string::npos);
+  assert(json.str().find("\"activity_histogram\"") != std::string::npos);
+
+  // event driven: counts only the activated gates, toggles include glitches
+  FullAdder fa;
+  Cim::Netlist fa_netlist(fa.Gates());
+  Cim::Profiler fa_profiler(fa_netlist);
+  Cim::EventSim event(fa_netlist);
+  event.SetDelay(Cim::GateKind::XOR, 3);
+  const uint64_t settled = event.GetEvaluationNum();
+  event.SetProfiler(&fa_profiler);
+  for (uint32_t v = 0; v < 8; v++) {
+    fa.Drive(v & 1, v & 2, v & 4);
+    event.ApplyPinChanges();
+    event.Run();
+  }
+  assert(fa_profiler.GetVectorNum() == 8);
+  assert(fa_profiler.GetTotalEvaluations() == event.GetEvaluationNum() - settled);
+  assert(fa_profiler.GetHierarchy().empty());
+  assert(fa_profiler.GetGateFullName(fa_netlist.GetGateIndex(&fa.x2)) == "x2");
+
+  // a profiler of another netlist is refused
+  bool refused = false;
+  try {
+    event.SetProfiler(&profiler);
+  } catch (const std::invalid_argument&) {
+    refused = true;
+  }
+  assert(refused);
+}
+
+static void TestLogic4() {
+  // without X / Z the value plane matches the two-valued bit-parallel engine
+  Cim::Netlist netlist;
+  RandomNetlist(netlist, 32, 2000, 17);
+  Cim::BitParallelSim two(netlist, 256);
+  Cim::Logic4Sim four(netlist, 256);
+  two.Randomize(5);
+  two.Evaluate();
+  const std::vector<uint64_t> known(four.GetWordNum(), 0);
+  for (const uint32_t each_net : netlist.GetInputs()) {
+    four.SetInputWords(each_net, two.GetWords(each_net), known.data());
+  }
+  four.Evaluate();
+  for (uint32_t n = 0; n < netlist.GetNetNum(); n++) {
+    assert(four.CountUnknown(n) == 0);
+    assert(std::equal(two.GetWords(n), two.GetWords(n) + 4, four.GetValueWords(n)));
+  }
+
+  // with X / Z inputs every gate is exact: known iff all completions of its unknown inputs agree
+  std::mt19937_64 rng(8);
+  for (const uint32_t each_net : netlist.GetInputs()) {
+    for (uint32_t p = 0; p < four.GetPatternNum(); p++) {
+      four.SetInput(each_net, p, static_cast<Cim::Logic>(rng() % 4));
+    }
+  }
+  four.Evaluate();
+  const auto program = netlist.GetProgram();
+  for (uint32_t g = 0; g < program.size(); g += 7) {
+    const Cim::Instruction& ins = program[g];
+    for (uint32_t p = 0; p < four.GetPatternNum(); p += 13) {
+      std::vector<Cim::Logic> in;
+      uint32_t unknown_mask = 0;
+      for (uint32_t k = 0; k < ins.fanin_count; k++) {
+        in.push_back(four.GetState(netlist.GetFanin()[ins.fanin_begin + k], p));
+        unknown_mask |= (in.back() >= Cim::Logic::X) << k;
+      }
+      bool seen[2] = {false, false};
+      for (uint32_t fill = 0; fill < (1u << ins.fanin_count); fill++) {
+        if ((fill & ~unknown_mask) != 0) {
+          continue;
+        }
+        const uint8_t out = Cim::EvaluateKind<uint8_t>(ins.op, [&](const uint32_t k) -> uint8_t {
+          return ((unknown_mask >> k) & 1) ? ((fill >> k) & 1) : (in[k] == Cim::Logic::ONE);
+        }, ins.fanin_count, (ins.op == Cim::GateKind::LUT) ? netlist.GetLuts()[ins.lut] : 0);
+        seen[out] = true;
+      }
+      const Cim::Logic expected = (seen[0] && seen[1]) ? Cim::Logic::X : (seen[1] ? Cim::Logic::ONE : Cim::Logic::ZERO);
+      assert(four.GetState(ins.out_net, p) == expected);
+    }
+  }
+
+  // dangling pins float: Z until driven, a controlling 0 masks the other input
+  FullAdder fa;
+  Cim::Netlist fa_netlist(fa.Gates());
+  Cim::Logic4Sim fa_sim(fa_netlist);
+  const uint32_t a = fa_netlist.GetPinNet(&fa.a1, 0);
+  assert(fa_sim.GetState(a, 0) == Cim::Logic::Z && Cim::GetLogicChar(fa_sim.GetState(a, 0)) == 'Z');
+  fa_sim.Evaluate();
+  assert(fa_sim.CountUnknown(fa_netlist.GetPinNet(&fa.o1, 2)) == 64);
+  fa_sim.SetInput(a, Cim::ParseLogic('0'));
+  fa_sim.Evaluate();
+  assert(fa_sim.GetState(fa_netlist.GetPinNet(&fa.a1, 2), 0) == Cim::Logic::ZERO);
+  assert(fa_sim.GetState(fa_netlist.GetPinNet(&fa.x1, 2), 0) == Cim::Logic::X);
+
+  // reset: a toggling flip-flop stays X until a synchronous reset reaches it
+  Cim::Netlist seq;
+  const uint32_t rst = seq.AddNet(), q = seq.AddNet(), d = seq.AddNet(), en = seq.AddNet(), lq = seq.AddNet();
+  seq.AddGate(Cim::GateKind::NOR, {rst, q}, d);
+  seq.AddRegister(Cim::GateKind::DFF, d, q);
+  seq.AddRegister(Cim::GateKind::LATCH, q, lq, en);
+  seq.AddOutput(d);
+  seq.AddOutput(lq);
+  seq.Levelize();
+  Cim::Logic4Sim seq_sim(seq);
+  seq_sim.SetInput(rst, Cim::Logic::ZERO);
+  seq_sim.SetInput(en, Cim::Logic::ONE);
+  seq_sim.Clock();
+  seq_sim.Clock();
+  assert(seq_sim.GetRegisterState(0, 0) == Cim::Logic::X && seq_sim.GetRegisterState(1, 0) == Cim::Logic::X);
+  seq_sim.SetInput(rst, Cim::Logic::ONE);
+  seq_sim.Clock();
+  assert(seq_sim.GetRegisterState(0, 0) == Cim::Logic::ZERO && seq_sim.GetRegisterState(1, 0) == Cim::Logic::X);
+  seq_sim.SetInput(rst, Cim::Logic::ZERO);
+  seq_sim.Clock();
+  assert(seq_sim.GetRegisterState(0, 0) == Cim::Logic::ONE && seq_sim.GetRegisterState(1, 0) == Cim::Logic::ZERO);
+  // unknown enable: the latch only stays known where D agrees with it
+  seq_sim.SetInput(en, Cim::Logic::X);
+  seq_sim.Clock();
+  assert(seq_sim.GetRegisterState(0, 0) == Cim::Logic::ZERO && seq_sim.GetRegisterState(1, 0) == Cim::Logic::X);
+  seq_sim.Reset();
+  assert(seq_sim.GetRegisterState(0, 0) == Cim::Logic::ZERO && seq_sim.GetCycleNum() == 0);
+  seq_sim.PowerUp();
+  assert(seq_sim.GetRegisterState(0, 0) == Cim::Logic::X && seq_sim.GetState(rst, 0) == Cim::Logic::X);
+}
+
+static void TestSnapshot() {
+  // shift register over several pages: save, run on, restore
+  Cim::Netlist netlist;
+  const uint32_t stage_num = 3 * Cim::kSnapshotPageNets;
+  const uint32_t in = netlist.AddNet();
+  uint32_t prev = in;
+  for (uint32_t i = 0; i < stage_num; i++) {
+    const uint32_t q = netlist.AddNet();
+    netlist.AddRegister(Cim::GateKind::DFF, prev, q);
+    prev = q;
+  }
+  const uint32_t out = netlist.AddNet();
+  netlist.AddGate(Cim::GateKind::NOT, {prev}, out);
+  netlist.AddOutput(out);
+  netlist.Levelize();
+  Cim::CycleSim sim(netlist);
+  sim.SetInput(in, true);
+  sim.Run(5);
+  const Cim::Snapshot base = sim.Save();
+  assert(base.GetPageNum() == 4 && base.GetCycle() == 5 && base.GetSharedPageNum() == 0);
+  const std::vector<uint8_t> saved = sim.GetStates();
+  sim.SetInput(in, false);
+  sim.Run(100);
+  assert(sim.GetStates() != saved);
+  sim.Restore(base);
+  assert(sim.GetStates() == saved && sim.GetCycleNum() == 5);
+  for (uint32_t n = 0; n < netlist.GetNetNum(); n++) {
+    assert(base.GetState(n) == (saved[n] != 0));
+  }
+
+  // branches captured against the base share the pages that did not change
+  sim.SetInput(in, false);
+  sim.Clock();
+  const Cim::Snapshot branch = sim.Save(&base);
+  assert(branch.GetSharedPageNum() == 3 && base.GetSharedPageNum() == 3);
+  assert(branch.GetUniqueByteNum() == base.GetUniqueByteNum());
+
+  // copies share everything until one of them changes a page
+  Cim::Snapshot fork = branch;
+  assert(fork.GetSharedPageNum() == 4);
+  fork.SetState(stage_num, true);
+  assert(fork.GetState(stage_num) && !branch.GetState(stage_num));
+  assert(fork.GetSharedPageNum() == 3 && branch.GetState(1) == fork.GetState(1));
+  sim.Restore(fork);
+  assert(sim.GetState(stage_num) && sim.GetCycleNum() == 6);
+
+  // a levelized engine restores only into its own netlist
+  FullAdder fa;
+  Cim::Netlist fa_netlist(fa.Gates());
+  Cim::LevelizedSim fa_sim(fa_netlist);
+  fa.Drive(true, true, true);
+  fa_sim.ReadInputs();
+  fa_sim.Evaluate();
+  const Cim::Snapshot full = fa_sim.Save();
+  fa.Drive(false, false, false);
+  fa_sim.ReadInputs();
+  fa_sim.Evaluate();
+  fa_sim.Restore(full);
+  fa_sim.WriteBack();
+  assert(fa.x2.GetPinState(2) && fa.o1.GetPinState(2));
+  bool refused = false;
+  try {
+    fa_sim.Restore(base);
+  } catch (const std::invalid_argument&) {
+    refused = true;
+  }
+  assert(refused);
+}
+
+static void TestDevice() {
+  // full adder -> 4-bit ripple adder -> 8-bit adder, each definition stored once
+  Cim::DeviceDef fa("fa", {"a", "b", "cin"}, {"sum", "cout"});
+  const uint32_t x1 = fa.AddGate("x1", Cim::GateKind::XOR, {0, 1});
+  const uint32_t x2 = fa.AddGate("x2", Cim::GateKind::XOR, {x1, 2});
+  const uint32_t a1 = fa.AddGate("a1", Cim::GateKind::AND, {x1, 2});
+  const uint32_t a2 = fa.AddGate("a2", Cim::GateKind::AND, {0, 1});
+  fa.SetOutput(0, x2);
+  fa.SetOutput(1, fa.AddGate("o1", Cim::GateKind::OR, {a1, a2}));
+  Cim::DeviceDef add4("add4", {"a0", "a1", "a2", "a3", "b0", "b1", "b2", "b3", "cin"},
+      {"s0", "s1", "s2", "s3", "cout"});
+  uint32_t carry = 8;
+  for (uint32_t i = 0; i < 4; i++) {
+    const std::vector<uint32_t> outs = add4.AddInstance("fa" + std::to_string(i), fa, {i, 4 + i, carry});
+    add4.SetOutput(i, outs[0]);
+    carry = outs[1];
+  }
+  add4.SetOutput(4, carry);
+  std::vector<std::string> in_names, out_names;
+  for (uint32_t i = 0; i < 8; i++) {
+    in_names.push_back("a" + std::to_string(i));
+  }
+  for (uint32_t i = 0; i < 8; i++) {
+    in_names.push_back("b" + std::to_string(i));
+    out_names.push_back("s" + std::to_string(i));
+  }
+  in_names.push_back("cin");
+  out_names.push_back("cout");
+  Cim::DeviceDef add8("add8", in_names, out_names);
+  carry = 16;
+  for (uint32_t half = 0; half < 2; half++) {
+    std::vector<uint32_t> ins;
+    for (uint32_t i = 0; i < 4; i++) {
+      ins.push_back(4 * half + i);
+    }
+    for (uint32_t i = 0; i < 4; i++) {
+      ins.push_back(8 + 4 * half + i);
+    }
+    ins.push_back(carry);
+    const std::vector<uint32_t> outs = add8.AddInstance("u" + std::to_string(half), add4, ins);
+    for (uint32_t i = 0; i < 4; i++) {
+      add8.SetOutput(4 * half + i, outs[i]);
+    }
+    carry = outs[4];
+  }
+  add8.SetOutput(8, carry);
+  assert(add8.GetFlatGateNum() == 40 && fa.GetStateSize() == 8 && add4.GetStateSize() == 17 + 4 * 8);
+  assert(add8.GetStateSize() == 27 + 2 * add4.GetStateSize());
+
+  // interpreted instance: pins in, hierarchy evaluated, pins out
+  Cim::Device chip(nullptr, "chip", add8);
+  assert(chip.IsDevice() && chip.GetType() == "add8" && chip.GetIONum() == std::make_pair(17u, 9u));
+  assert(chip.GetPinIndex("cout") == 25 && chip.GetInPins().size() == 17 && chip.GetOutPins().size() == 9);
+  bool thrown = false;
+  try {
+    chip.GetKind();
+  } catch (const std::logic_error&) {
+    thrown = true;
+  }
+  assert(thrown);
+  std::vector<uint64_t> state_of_net;
+  const Cim::Netlist flat = chip.Flatten(&state_of_net);
+  assert(flat.GetGateNum() == 40 && flat.GetInputs().size() == 17 && flat.GetOutputs().size() == 9);
+  assert(flat.GetNetName(16) == "cin" && state_of_net.size() == flat.GetNetNum());
+  Cim::LevelizedSim sim(flat);
+  std::mt19937 rng(7);
+  for (uint32_t round = 0; round < 200; round++) {
+    const uint32_t a = rng() & 0xFF, b = rng() & 0xFF, cin = rng() & 1;
+    for (uint32_t i = 0; i < 8; i++) {
+      chip.Set(i, (a >> i) & 1);
+      chip.Set(8 + i, (b >> i) & 1);
+      sim.SetInput(i, (a >> i) & 1);
+      sim.SetInput(8 + i, (b >> i) & 1);
+    }
+    chip.Set(16, cin);
+    sim.SetInput(16, cin);
+    chip.Evaluate();
+    sim.Evaluate();
+    uint32_t sum = 0;
+    for (uint32_t k = 0; k < 9; k++) {
+      sum |= uint32_t{chip.GetPinState(17 + k)} << k;
+      assert(sim.GetState(flat.GetOutputs()[k]) == chip.GetPinState(17 + k));
+    }
+    assert(sum == a + b + cin);
+    for (uint32_t n = 0; n < flat.GetNetNum(); n++) {
+      assert(sim.GetState(n) == chip.GetState(state_of_net[n]));
+    }
+  }
+
+  // full names are built from the definitions on demand
+  assert(chip.GetStateName(0) == "chip::a0" && chip.GetStateName(17) == "chip::u0::s0");
+  assert(chip.GetStateName(27 + 49 + 17 + 2 * 8 + 3) == "chip::u1::fa2::x1");
+  assert(chip.GetStateName(27 + 49 + 17 + 2 * 8) == "chip::u1::fa2::a");
+  Cim::Gate probe(&chip, "probe", "AND", {"IN1", "IN2"});
+  assert(probe.GetFullName() == "chip::probe" && probe.GetNestingLvl() == 1);
+  assert(chip.GetByteNum() < 4096 && fa.GetByteNum() < 1024);
+
+  // instantiated definitions are frozen, and stay combinational
+  bool refused = false;
+  try {
+    fa.AddGate("late", Cim::GateKind::NOT, {0});
+  } catch (const std::logic_error&) {
+    refused = true;
+  }
+  assert(refused);
+  refused = false;
+  Cim::DeviceDef reg("reg", {"d", "clk"}, {"q"});
+  try {
+    reg.AddGate("ff", Cim::GateKind::DFF, {0, 1});
+  } catch (const std::invalid_argument&) {
+    refused = true;
+  }
+  assert(refused);
+
+  // a netlist compiles gates only, devices are flattened first
+  refused = false;
+  try {
+    Cim::Netlist compiled(std::vector<Cim::Component*>{&chip});
+  } catch (const std::invalid_argument&) {
+    refused = true;
+  }
+  assert(refused);
+}
+
+static void TestStream() {
+  const std::filesystem::path dir = std::filesystem::temp_directory_path();
+  const std::string text_in = (dir / "cim_test_in.vec").string();
+  const std::string text_out = (dir / "cim_test_out.vec").string();
+  const std::string bin_in = (dir / "cim_test_in.bvec").string();
+  const std::string bin_out = (dir / "cim_test_out.bvec").string();
+  Cim::Netlist netlist;
+  RandomNetlist(netlist, 12, 300, 5);
+  const uint32_t input_num = netlist.GetInputs().size();
+
+  // text input with comments, blanks and separators; a partial last group
+  const uint32_t vector_num = 1500;
+  std::vector<std::vector<bool>> vectors(vector_num, std::vector<bool>(input_num));
+  std::mt19937 rng(3);
+  {
+    std::ofstream out(text_in);
+    out << "# random vectors\n\n";
+    for (std::vector<bool>& each_vector : vectors) {
+      for (uint32_t c = 0; c < input_num; c++) {
+        each_vector[c] = rng() & 1;
+        out << (each_vector[c] ? '1' : '0') << ((c == 5) ? "_" : "");
+      }
+      out << "\r\n";
+    }
+  }
+  Cim::StreamDriver driver(netlist, 512, 2);
+  const std::vector<uint32_t>& results = driver.GetResultNets();
+  assert(results.size() == netlist.GetOutputs().size());
+  Cim::StreamStats stats = driver.Run(text_in, text_out);
+  assert(stats.vectors == vector_num && stats.blocks == 3);
+
+  // every result line matches the scalar engine
+  Cim::LevelizedSim ref(netlist);
+  std::ifstream in(text_out);
+  std::string line;
+  for (uint32_t v = 0; v < vector_num; v++) {
+    ref.SetInputs(vectors[v]);
+    ref.Evaluate();
+    assert(std::getline(in, line) && line.size() == results.size());
+    for (uint32_t r = 0; r < results.size(); r++) {
+      assert((line[r] == '1') == ref.GetState(results[r]));
+    }
+  }
+  assert(!std::getline(in, line));
+  in.close();
+
+  // binary in -> binary out holds the same results
+  {
+    Cim::VectorWriter writer(bin_in, input_num, Cim::VectorFormat::Binary);
+    for (const std::vector<bool>& each_vector : vectors) {
+      writer.Write(each_vector);
+    }
+    writer.Close();
+    assert(writer.GetVectorNum() == vector_num && writer.GetByteNum() == 32 + 24 * input_num * 8);
+  }
+  stats = driver.Run(bin_in, bin_out, Cim::VectorFormat::Auto, Cim::VectorFormat::Binary);
+  assert(stats.vectors == vector_num);
+  Cim::VectorReader binary(bin_out);
+  Cim::VectorReader text(text_out);
+  assert(binary.GetFormat() == Cim::VectorFormat::Binary && text.GetFormat() == Cim::VectorFormat::Text);
+  assert(binary.GetWidth() == results.size() && text.GetWidth() == results.size());
+  std::vector<uint64_t> a(results.size() * 8), b(results.size() * 8);
+  for (;;) {
+    const uint32_t count = binary.ReadBlock(a.data(), 8);
+    assert(text.ReadBlock(b.data(), 8) == count);
+    if (count == 0) {
+      break;
+    }
+    for (uint32_t r = 0; r < results.size(); r++) {
+      for (uint32_t v = 0; v < count; v++) {
+        assert(((a[r * 8 + v / 64] ^ b[r * 8 + v / 64]) >> (v % 64) & 1) == 0);
+      }
+    }
+  }
+  assert(binary.GetVectorNum() == vector_num);
+
+  // registers: one clock edge per vector, in file order
+  Cim::Netlist counter;
+  const uint32_t en = counter.AddNet(), q = counter.AddNet(), d = counter.AddNet();
+  counter.AddGate(Cim::GateKind::XOR, {en, q}, d);
+  counter.AddRegister(Cim::GateKind::DFF, d, q);
+  counter.AddOutput(q);
+  counter.Levelize();
+  {
+    std::ofstream out(text_in);
+    for (uint32_t v = 0; v < 100; v++) {
+      out << (vectors[v][0] ? "1\n" : "0\n");
+    }
+  }
+  Cim::StreamDriver(counter, 512, 1).Run(text_in, text_out);
+  Cim::CycleSim cycle(counter);
+  in.open(text_out);
+  for (uint32_t v = 0; v < 100; v++) {
+    cycle.SetInput(en, vectors[v][0]);
+    cycle.Clock();
+    assert(std::getline(in, line) && line == (cycle.GetState(q) ? "1" : "0"));
+  }
+  in.close();
+
+  // a file of another width is refused before anything is written
+  bool refused = false;
+  try {
+    driver.Run(text_in, text_out);
+  } catch (const std::invalid_argument&) {
+    refused = true;
+  }
+  assert(refused);
+  refused = false;
+  try {
+    Cim::StreamDriver(netlist, 1000);
+  } catch (const std::invalid_argument&) {
+    refused = true;
+  }
+  assert(refused);
+  for (const std::string& each_path : {text_in, text_out, bin_in, bin_out}) {
+    std::filesystem::remove(each_path);
+  }
+}
+
+static void TestExhaustive() {
+  // full adder: 3 inputs, a table shorter than one word
+  Cim::Netlist fa;
+  const uint32_t a = fa.AddNet(), b = fa.AddNet(), cin = fa.AddNet();
+  const uint32_t x1 = fa.AddNet(), sum = fa.AddNet(), a1 = fa.AddNet(), a2 = fa.AddNet(), cout = fa.AddNet();
+  fa.AddGate(Cim::GateKind::XOR, {a, b}, x1);
+  fa.AddGate(Cim::GateKind::XOR, {x1, cin}, sum);
+  fa.AddGate(Cim::GateKind::AND, {a, b}, a1);
+  fa.AddGate(Cim::GateKind::AND, {x1, cin}, a2);
+  fa.AddGate(Cim::GateKind::OR, {a1, a2}, cout);
+  fa.AddOutput(sum);
+  fa.AddOutput(cout);
+  fa.Levelize();
+  Cim::ExhaustiveSim fa_sim(fa, 2);
+  assert(fa_sim.GetInputNum() == 3 && fa_sim.GetCombinationNum() == 8 && fa_sim.GetTableWordNum() == 1);
+  assert(fa_sim.ComputeTruthTables() == std::vector<uint64_t>({0x96, 0xE8}));
+  assert(fa_sim.ComputeSignatures()[1].ones == 4);
+
+  // 12 inputs: several chunks, every combination checked against the scalar engine
+  Cim::Netlist netlist;
+  RandomNetlist(netlist, 12, 400, 9);
+  Cim::ExhaustiveSim sim(netlist, 4);
+  const std::vector<uint64_t> tables = sim.ComputeTruthTables();
+  const uint64_t table_words = sim.GetTableWordNum();
+  assert(table_words == 64 && tables.size() == table_words * sim.GetOutputNum());
+  Cim::LevelizedSim ref(netlist);
+  const Cim::ArrayView<uint32_t> inputs = netlist.GetInputs();
+  for (uint32_t m = 0; m < 4096; m++) {
+    for (uint32_t k = 0; k < 12; k++) {
+      ref.SetInput(inputs[k], (m >> k) & 1);
+    }
+    ref.Evaluate();
+    for (uint32_t o = 0; o < sim.GetOutputNum(); o++) {
+      assert(((tables[o * table_words + m / 64] >> (m % 64)) & 1) == ref.GetState(netlist.GetOutputs()[o]));
+    }
+  }
+
+  // signatures: ones match the tables, hashes do not depend on the thread count
+  const std::vector<Cim::OutputSignature> signatures = sim.ComputeSignatures();
+  const std::vector<Cim::OutputSignature> serial = Cim::ExhaustiveSim(netlist, 1).ComputeSignatures();
+  for (uint32_t o = 0; o < sim.GetOutputNum(); o++) {
+    uint64_t ones = 0;
+    for (uint64_t w = 0; w < table_words; w++) {
+      ones += std::bitset<64>(tables[o * table_words + w]).count();
+    }
+    assert(signatures[o].ones == ones && serial[o].ones == ones && serial[o].hash == signatures[o].hash);
+  }
+
+  // equivalence: an optimized copy agrees everywhere
+  Cim::Netlist optimized;
+  Cim::NetlistOptimizer(netlist).Optimize(optimized);
+  Cim::EquivalenceResult result = sim.CheckEquivalence(optimized);
+  assert(result.equivalent && result.checked == 4096);
+
+  // 20 inputs: AND of all of them vs. 0 differ on the last combination only, output 1 from the start
+  Cim::Netlist wide_a, wide_b;
+  std::vector<uint32_t> ins_a, ins_b;
+  for (uint32_t k = 0; k < 20; k++) {
+    ins_a.push_back(wide_a.AddNet());
+    ins_b.push_back(wide_b.AddNet());
+  }
+  const uint32_t all_a = wide_a.AddNet(), all_b = wide_b.AddNet();
+  wide_a.AddGate(Cim::GateKind::AND, ins_a, all_a);
+  const uint32_t not_b = wide_b.AddNet();
+  wide_b.AddGate(Cim::GateKind::NOT, {ins_b[0]}, not_b);
+  wide_b.AddGate(Cim::GateKind::AND, {ins_b[0], not_b}, all_b);
+  const uint32_t x_a = wide_a.AddNet(), x_b = wide_b.AddNet();
+  wide_a.AddGate(Cim::GateKind::XOR, {ins_a[3], ins_a[17]}, x_a);
+  wide_b.AddGate(Cim::GateKind::OR, {ins_b[3], ins_b[17]}, x_b);
+  wide_a.AddOutput(all_a);
+  wide_a.AddOutput(x_a);
+  wide_b.AddOutput(all_b);
+  wide_b.AddOutput(x_b);
+  wide_a.Levelize();
+  wide_b.Levelize();
+  Cim::ExhaustiveSim wide(wide_a, 4);
+  result = wide.CheckEquivalence(wide_b);
+  assert(!result.equivalent && result.input == ((1u << 3) | (1u << 17)) && result.output == 1);
+  // with the second output fixed only the last combination differs
+  Cim::Netlist wide_c;
+  std::vector<uint32_t> ins_c;
+  for (uint32_t k = 0; k < 20; k++) {
+    ins_c.push_back(wide_c.AddNet());
+  }
+  const uint32_t not_c = wide_c.AddNet(), all_c = wide_c.AddNet(), x_c = wide_c.AddNet();
+  wide_c.AddGate(Cim::GateKind::NOT, {ins_c[0]}, not_c);
+  wide_c.AddGate(Cim::GateKind::AND, {ins_c[0], not_c}, all_c);
+  wide_c.AddGate(Cim::GateKind::XOR, {ins_c[3], ins_c[17]}, x_c);
+  wide_c.AddOutput(all_c);
+  wide_c.AddOutput(x_c);
+  wide_c.Levelize();
+  result = wide.CheckEquivalence(wide_c);
+  assert(!result.equivalent && result.input == (1u << 20) - 1 && result.output == 0);
+
+  // interfaces must match
+  bool refused = false;
+  try {
+    sim.CheckEquivalence(wide_a);
+  } catch (const std::invalid_argument&) {
+    refused = true;
+  }
+  assert(refused);
+}
+
+static void TestBdd() {
+  // 12 inputs (random gates incl. LUTs): every output BDD matches the exhaustive truth table
+  Cim::Netlist netlist;
+  RandomNetlist(netlist, 12, 400, 9);
+  Cim::BddManager manager(12);
+  Cim::BddSim sim(netlist, manager);
+  const std::vector<uint32_t>& var_of_source = sim.GetVarOfSource();
+  assert(var_of_source.size() == 12 && manager.GetVarNum() == 12);
+  Cim::ExhaustiveSim exhaustive(netlist, 2);
+  const std::vector<uint64_t> tables = exhaustive.ComputeTruthTables();
+  const std::vector<Cim::OutputSignature> signatures = exhaustive.ComputeSignatures();
+  auto evaluate = [&](Cim::BddEdge f, const uint32_t m) {
+    while (manager.GetTopVar(f) != UINT32_MAX) {
+      const uint32_t v = manager.GetTopVar(f);
+      const uint32_t source = std::find(var_of_source.begin(), var_of_source.end(), v) - var_of_source.begin();
+      f = ((m >> source) & 1) ? manager.GetHigh(f, v) : manager.GetLow(f, v);
+    }
+    return f == Cim::kBddOne;
+  };
+  const Cim::ArrayView<uint32_t> outputs = netlist.GetOutputs();
+  for (uint32_t o = 0; o < outputs.size(); o++) {
+    const Cim::BddEdge f = sim.GetNet(outputs[o]);
+    for (uint32_t m = 0; m < 4096; m++) {
+      assert(evaluate(f, m) == ((tables[o * 64 + m / 64] >> (m % 64)) & 1));
+    }
+    assert(manager.CountSat(f, 12) == static_cast<double>(signatures[o].ones));
+    assert(sim.GetProbability(outputs[o]) * 4096 == static_cast<double>(signatures[o].ones));
+  }
+
+  // internal nets released after their last reader: same probabilities, the rest is garbage
+  Cim::BddManager lean_manager;
+  Cim::BddSim lean(netlist, lean_manager, var_of_source, false);
+  lean_manager.CollectGarbage();
+  assert(lean_manager.GetStats().gc_freed > 0);
+  for (uint32_t o = 0; o < outputs.size(); o++) {
+    assert(lean.GetProbability(outputs[o]) * 4096 == static_cast<double>(signatures[o].ones));
+  }
+  uint32_t internal = 0;
+  while (std::find(outputs.begin(), outputs.end(), netlist.GetProgram()[internal].out_net) != outputs.end()) {
+    internal++;
+  }
+  bool released = false;
+  try {
+    lean.GetNet(netlist.GetProgram()[internal].out_net);
+  } catch (const std::logic_error&) {
+    released = true;
+  }
+  assert(released);
+  // kept by default
+  sim.GetNet(netlist.GetProgram()[internal].out_net);
+
+  // equivalence on a shared manager: an optimized copy has the same output edges
+  Cim::Netlist optimized;
+  Cim::NetlistOptimizer(netlist).Optimize(optimized);
+  Cim::BddSim optimized_sim(optimized, manager, var_of_source);
+  assert(optimized_sim.CheckEquivalence(sim).equivalent);
+  // edges of different orders do not compare
+  std::vector<uint32_t> reversed(var_of_source.rbegin(), var_of_source.rend());
+  Cim::BddSim reversed_sim(optimized, manager, reversed);
+  bool mismatch = false;
+  try {
+    reversed_sim.CheckEquivalence(sim);
+  } catch (const std::invalid_argument&) {
+    mismatch = true;
+  }
+  assert(mismatch);
+
+  // the node limit counts nodes in use: garbage is collected when it is reached
+  Cim::Netlist other;
+  RandomNetlist(other, 12, 400, 10);
+  uint64_t peak = 0;
+  for (const Cim::Netlist* each_netlist : {&netlist, &other}) {
+    Cim::BddManager probe;
+    Cim::BddSim probe_sim(*each_netlist, probe, var_of_source, false);
+    peak = std::max(peak, probe.GetStats().peak_nodes);
+  }
+  Cim::BddManager tight(12, static_cast<uint32_t>(peak) + 16);
+  { Cim::BddSim first(netlist, tight, var_of_source, false); }
+  Cim::BddSim second(other, tight, var_of_source, false);
+  assert(tight.GetStats().gc_runs > 0);
+
+  // 64-bit adders (129 inputs, far beyond enumeration): the depth-first order interleaves the operands
+  auto adder = [](Cim::Netlist& add, const bool broken) {
+    std::vector<uint32_t> a(64), b(64);
+    for (uint32_t i = 0; i < 64; i++) a[i] = add.AddNet();
+    for (uint32_t i = 0; i < 64; i++) b[i] = add.AddNet();
+    uint32_t carry = add.AddNet();
+    for (uint32_t i = 0; i < 64; i++) {
+      const uint32_t p = add.AddNet(), sum = add.AddNet(), g = add.AddNet(), t = add.AddNet(), c = add.AddNet();
+      add.AddGate(Cim::GateKind::XOR, {a[i], b[i]}, p);
+      add.AddGate(Cim::GateKind::XOR, {p, carry}, sum);
+      add.AddGate(Cim::GateKind::AND, {a[i], b[i]}, g);
+      add.AddGate(Cim::GateKind::AND, {p, carry}, t);
+      // the broken adder inverts the carry out of bit 40
+      add.AddGate((broken && i == 40) ? Cim::GateKind::NOR : Cim::GateKind::OR, {g, t}, c);
+      add.AddOutput(sum);
+      carry = c;
+    }
+    add.AddOutput(carry);
+    add.Levelize();
+  };
+  Cim::Netlist add, broken;
+  adder(add, false);
+  adder(broken, true);
+  Cim::BddManager wide_manager;
+  const std::vector<uint32_t> order = Cim::ComputeBddOrder(add, Cim::BddOrder::DepthFirst);
+  Cim::BddSim add_sim(add, wide_manager, order);
+  assert(add_sim.GetOutputNodeNum() < 10000);
+  // carry out of a + b + cin: 1 on (2^128 - 2^64) * 2 / 2 combinations, p = 1/2 - 2^-65
+  const uint32_t carry_out = add.GetOutputs()[64];
+  assert(std::abs(add_sim.GetProbability(carry_out) - 0.5) < 1e-12);
+  // sum bit 0 with weighted sources: p(a0 ^ b0 ^ cin) for p(a0) = 0.9, others 0.5 is still 1/2; a0 & b0 & cin = 1
+  std::vector<double> source_prob(129, 0.5);
+  source_prob[0] = 0.9;
+  assert(std::abs(add_sim.GetProbability(add.GetOutputs()[0], source_prob) - 0.5) < 1e-12);
+  std::fill(source_prob.begin(), source_prob.end(), 1.0);
+  assert(add_sim.GetProbability(carry_out, source_prob) == 1.0);
+  {
+    Cim::BddSim broken_sim(broken, wide_manager, order);
+    const Cim::BddEquivalence result = add_sim.CheckEquivalence(broken_sim);
+    assert(!result.equivalent && result.output == 41 && result.input.size() == 129);
+    // the witness really tells the adders apart
+    std::vector<bool> vector(129);
+    for (uint32_t s = 0; s < 129; s++) vector[s] = result.input[s] == 1;
+    Cim::LevelizedSim good_ref(add), broken_ref(broken);
+    for (uint32_t s = 0; s < 129; s++) {
+      good_ref.SetInput(add.GetInputs()[s], vector[s]);
+      broken_ref.SetInput(broken.GetInputs()[s], vector[s]);
+    }
+    good_ref.Evaluate();
+    broken_ref.Evaluate();
+    assert(good_ref.GetState(add.GetOutputs()[41]) != broken_ref.GetState(broken.GetOutputs()[41]));
+  }
+
+  // garbage collection: once the broken adder is gone only the BDDs of add remain
+  const uint64_t before = wide_manager.GetStats().live_nodes;
+  wide_manager.CollectGarbage();
+  const Cim::BddStats stats = wide_manager.GetStats();
+  assert(stats.gc_runs == 1 && stats.gc_freed > 0 && stats.live_nodes < before);
+  assert(stats.peak_nodes >= before && stats.created_nodes + 1 >= stats.peak_nodes);
+  assert(stats.cache_hits <= stats.cache_lookups && stats.unique_hits <= stats.unique_lookups);
+  // freed nodes are reused and give the same canonical edges
+  Cim::BddSim again(add, wide_manager, order);
+  assert(again.CheckEquivalence(add_sim).equivalent);
+  assert(wide_manager.GetStats().live_nodes == stats.live_nodes);
+
+  // input order puts all of a before b: exponential, stopped by the node limit
+  Cim::BddManager small_manager(12, 100000);
+  bool limited = false;
+  try {
+    Cim::BddSim input_sim(add, small_manager, Cim::ComputeBddOrder(add, Cim::BddOrder::Input));
+  } catch (const std::runtime_error&) {
+    limited = true;
+  }
+  assert(limited);
+  // the failed engine gave its references back: everything is garbage
+  small_manager.CollectGarbage();
+  assert(small_manager.GetStats().live_nodes == 1);
+
+  // registers: their outputs are variables after the primary inputs
+  Cim::Netlist seq;
+  const uint32_t d_in = seq.AddNet(), q = seq.AddNet(), next = seq.AddNet();
+  seq.AddGate(Cim::GateKind::XOR, {d_in, q}, next);
+  seq.AddRegister(Cim::GateKind::DFF, next, q);
+  seq.AddOutput(next);
+  seq.Levelize();
+  Cim::BddManager seq_manager;
+  Cim::BddSim seq_sim(seq, seq_manager, Cim::ComputeBddOrder(seq, Cim::BddOrder::Input));
+  assert(seq_sim.GetVarOfSource() == std::vector<uint32_t>({0, 1}));
+  assert(seq_manager.GetNodeNum(seq_sim.GetNet(next)) == 3 && seq_sim.GetProbability(next) == 0.5);
+}
 
 int main() {
   Cim::Gate g(nullptr, "and_gate", "AND", {"IN1", "IN2"}, false);
+  TestLevelized();
+  TestEvent();
+  TestBitParallel();
+  TestStore();
+  TestHandles();
+  TestPinViews();
+  TestKinds();
+  TestArena();
+  TestParallel();
+  TestImport();
+  TestCache();
+  TestWave();
+  TestSequential();
+  TestFault();
+  TestOptimize();
+  TestNative();
+  TestIncremental();
+  TestProfile();
+  TestLogic4();
+  TestSnapshot();
+  TestDevice();
+  TestStream();
+  TestExhaustive();
+  TestBdd();
 }